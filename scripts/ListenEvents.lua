@@ -143,7 +143,8 @@ App = {
 			stateEventType == Constants.RemoteReleaseControl.stateEventMemoryCardSlotOpen and "stateEventMemoryCardSlotOpen" or
 			stateEventType == Constants.RemoteReleaseControl.stateEventReleaseError and "stateEventReleaseError" or
 			stateEventType == Constants.RemoteReleaseControl.stateEventBulbExposureTime and "stateEventBulbExposureTime" or
-			stateEventType == Constants.RemoteReleaseControl.stateEventInternalError and "stateEventInternalError" or "???";
+			stateEventType == Constants.RemoteReleaseControl.stateEventInternalError and "stateEventInternalError" or
+			stateEventType == Constants.RemoteReleaseControl.stateEventCaptureComplete and "stateEventCaptureComplete" or "???";
 
 		print("onStateEvent! type=" .. stateEventName ..
 			" eventParam=" .. eventParam .. "\n");
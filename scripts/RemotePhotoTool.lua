@@ -223,6 +223,9 @@ App = {
 
 		local capUILock = remoteReleaseControl:getCapability(Constants.RemoteReleaseControl.capUILock);
 		print("   can lock camera UI: " .. (capUILock and "yes" or "no") .. "\n");
+
+		local capBurstMode = remoteReleaseControl:getCapability(Constants.RemoteReleaseControl.capBurstMode);
+		print("   can shoot bursts while transferring images: " .. (capBurstMode and "yes" or "no") .. "\n");
 		print("\n");
 
 	end;
@@ -56,3 +56,51 @@ void File::SetModifiedTime(LPCTSTR filename, time_t modifiedTime)
 
    CloseHandle(fileHandle);
 }
+
+/// converts a FILETIME value to time_t
+time_t FileTimeToUnixTime(const FILETIME& ft)
+{
+   ULARGE_INTEGER ull = {};
+   ull.LowPart = ft.dwLowDateTime;
+   ull.HighPart = ft.dwHighDateTime;
+
+   return static_cast<time_t>((ull.QuadPart - 116444736000000000ULL) / 10000000ULL);
+}
+
+bool File::GetSizeAndModifiedTime(LPCTSTR filename, unsigned long long& size, time_t& modifiedTime)
+{
+   WIN32_FILE_ATTRIBUTE_DATA data = {};
+   if (!GetFileAttributesEx(filename, GetFileExInfoStandard, &data) ||
+      (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0)
+      return false;
+
+   size = (static_cast<unsigned long long>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+   modifiedTime = FileTimeToUnixTime(data.ftLastWriteTime);
+
+   return true;
+}
+
+void File::FlushToDisk(LPCTSTR filename)
+{
+   HANDLE fileHandle = CreateFile(filename,
+      GENERIC_WRITE,
+      FILE_SHARE_READ | FILE_SHARE_WRITE,
+      NULL,
+      OPEN_EXISTING,
+      FILE_ATTRIBUTE_NORMAL,
+      NULL);
+
+   if (fileHandle == INVALID_HANDLE_VALUE)
+   {
+      DWORD error = GetLastError();
+      throw SystemException(Win32::ErrorMessage(error).ToString() + filename, error, __FILE__, __LINE__);
+   }
+
+   BOOL ret = FlushFileBuffers(fileHandle);
+   DWORD error = GetLastError();
+
+   CloseHandle(fileHandle);
+
+   if (!ret)
+      throw SystemException(Win32::ErrorMessage(error).ToString() + filename, error, __FILE__, __LINE__);
+}
@@ -18,4 +18,10 @@ public:
 
    /// sets modified time of file
    static void SetModifiedTime(LPCTSTR filename, time_t modifiedTime);
+
+   /// returns size and modified time of file; returns false when the file doesn't exist
+   static bool GetSizeAndModifiedTime(LPCTSTR filename, unsigned long long& size, time_t& modifiedTime);
+
+   /// flushes file contents and metadata to disk
+   static void FlushToDisk(LPCTSTR filename);
 };
@@ -0,0 +1,39 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file Fnv1aHash.hpp 64-bit FNV-1a hash
+//
+#pragma once
+
+/// computes 64-bit FNV-1a hash over data added in one or more steps; the hash
+/// is fast and good enough for cache filenames and change detection, but not
+/// suitable for cryptographic use
+class Fnv1aHash
+{
+public:
+   /// ctor; starts with the FNV offset basis
+   Fnv1aHash()
+      :m_hash(14695981039346656037ULL)
+   {
+   }
+
+   /// adds data to the hash
+   void Add(const void* data, size_t size)
+   {
+      const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+
+      for (size_t index = 0; index < size; index++)
+      {
+         m_hash ^= bytes[index];
+         m_hash *= 1099511628211ULL;
+      }
+   }
+
+   /// returns hash value of all data added so far
+   unsigned long long Value() const { return m_hash; }
+
+private:
+   /// current hash value
+   unsigned long long m_hash;
+};
@@ -0,0 +1,432 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file MjpegHttpServer.cpp HTTP server for MJPEG streams
+//
+#include "stdafx.h"
+#include "MjpegHttpServer.hpp"
+#include "SingleThreadExecutor.hpp"
+#include "SingleThreadExecutorImpl.hpp"
+#include "Logging.hpp"
+#include <ulib/Exception.hpp>
+#include <asio.hpp>
+#include <array>
+#include <set>
+#include <string>
+#include <atomic>
+
+/// boundary string between the multipart frames
+static const char* c_boundary = "RemotePhotoToolFrame";
+
+/// maximum size of HTTP request header that is accepted
+static const size_t c_maxRequestSize = 8192;
+
+/// a single JPEG frame, shared between all clients
+struct MjpegFrame
+{
+   /// multipart header for this frame
+   std::string m_header;
+
+   /// JPEG data
+   std::vector<unsigned char> m_jpegData;
+};
+
+/// pointer to a shared frame
+typedef std::shared_ptr<const MjpegFrame> MjpegFrameSp;
+
+/// connection to a single HTTP client
+struct MjpegClientConnection : public std::enable_shared_from_this<MjpegClientConnection>
+{
+   /// ctor
+   MjpegClientConnection(asio::io_service& ioService)
+      :m_socket(ioService),
+      m_request(c_maxRequestSize),
+      m_requestTimer(ioService),
+      m_isRequestReceived(false),
+      m_isStreaming(false),
+      m_isWriting(false)
+   {
+   }
+
+   /// client socket
+   asio::ip::tcp::socket m_socket;
+
+   /// buffer for the HTTP request
+   asio::streambuf m_request;
+
+   /// timer that disconnects the client when no request was received in time
+   asio::steady_timer m_requestTimer;
+
+   /// buffer for data that the client sends while streaming; discarded
+   std::array<char, 256> m_readBuffer;
+
+   /// indicates if the HTTP request was received
+   bool m_isRequestReceived;
+
+   /// indicates if the client already received the response header
+   bool m_isStreaming;
+
+   /// indicates if a write operation is currently running
+   bool m_isWriting;
+
+   /// frame that is currently being sent; keeps the buffer alive during write
+   MjpegFrameSp m_currentFrame;
+
+   /// newest frame that is waiting to be sent, if any
+   MjpegFrameSp m_pendingFrame;
+};
+
+/// MjpegHttpServer implementation
+struct MjpegHttpServer::Impl :
+   public std::enable_shared_from_this<MjpegHttpServer::Impl>
+{
+   /// ctor
+   Impl(std::shared_ptr<SingleThreadExecutor::Impl> executorImpl, unsigned short port, bool localhostOnly,
+      unsigned int requestTimeoutInMilliseconds);
+
+   /// starts accepting next client
+   void StartAccept();
+
+   /// called when a client has connected
+   void OnAccept(std::shared_ptr<MjpegClientConnection> client, const std::error_code& error);
+
+   /// called when the HTTP request of a client was read
+   void OnReadRequest(std::shared_ptr<MjpegClientConnection> client, const std::error_code& error);
+
+   /// called when the request timer of a client has elapsed
+   void OnRequestTimeout(std::shared_ptr<MjpegClientConnection> client, const std::error_code& error);
+
+   /// called when the response header was sent
+   void OnWriteResponseHeader(std::shared_ptr<MjpegClientConnection> client, const std::error_code& error);
+
+   /// starts reading from a streaming client, in order to notice when it disconnects
+   void StartReadClient(std::shared_ptr<MjpegClientConnection> client);
+
+   /// called when data was read from a streaming client
+   void OnReadClient(std::shared_ptr<MjpegClientConnection> client, const std::error_code& error);
+
+   /// distributes new frame to all clients
+   void DistributeFrame(MjpegFrameSp frame);
+
+   /// starts sending frame to client
+   void StartWriteFrame(std::shared_ptr<MjpegClientConnection> client, MjpegFrameSp frame);
+
+   /// called when a frame was sent to a client
+   void OnWriteFrame(std::shared_ptr<MjpegClientConnection> client, const std::error_code& error);
+
+   /// closes client connection and removes it from the client list
+   void CloseClient(std::shared_ptr<MjpegClientConnection> client);
+
+   /// stops server and closes all client connections
+   void Stop();
+
+   /// contains the executor's implementation in order to only destroy the
+   /// executor when the server is also destroyed
+   std::shared_ptr<SingleThreadExecutor::Impl> m_executorImpl;
+
+   /// acceptor for incoming connections
+   asio::ip::tcp::acceptor m_acceptor;
+
+   /// port the server listens on
+   unsigned short m_port;
+
+   /// time in which a client has to send its request
+   unsigned int m_requestTimeoutInMilliseconds;
+
+   /// all connected clients; only accessed on the executor thread
+   std::set<std::shared_ptr<MjpegClientConnection>> m_clients;
+
+   /// number of clients that receive the stream
+   std::atomic<size_t> m_streamingClientCount;
+};
+
+MjpegHttpServer::Impl::Impl(std::shared_ptr<SingleThreadExecutor::Impl> executorImpl,
+   unsigned short port, bool localhostOnly, unsigned int requestTimeoutInMilliseconds)
+   :m_executorImpl(executorImpl),
+   m_acceptor(executorImpl->m_ioService),
+   m_port(port),
+   m_requestTimeoutInMilliseconds(requestTimeoutInMilliseconds),
+   m_streamingClientCount(0)
+{
+   asio::ip::tcp::endpoint endpoint(
+      localhostOnly ? asio::ip::address(asio::ip::address_v4::loopback()) : asio::ip::address(asio::ip::address_v4::any()),
+      port);
+
+   std::error_code ec;
+   m_acceptor.open(endpoint.protocol(), ec);
+   if (!ec)
+      m_acceptor.set_option(asio::ip::tcp::acceptor::reuse_address(true), ec);
+   if (!ec)
+      m_acceptor.bind(endpoint, ec);
+   if (!ec)
+      m_acceptor.listen(asio::socket_base::max_connections, ec);
+
+   if (ec)
+   {
+      CString text;
+      text.Format(_T("couldn't start HTTP server on port %u: %hs"), unsigned(port), ec.message().c_str());
+      throw Exception(text, __FILE__, __LINE__);
+   }
+
+   m_port = m_acceptor.local_endpoint().port();
+}
+
+void MjpegHttpServer::Impl::StartAccept()
+{
+   auto client = std::make_shared<MjpegClientConnection>(m_executorImpl->m_ioService);
+
+   m_acceptor.async_accept(client->m_socket,
+      std::bind(&Impl::OnAccept, shared_from_this(), client, std::placeholders::_1));
+}
+
+void MjpegHttpServer::Impl::OnAccept(std::shared_ptr<MjpegClientConnection> client, const std::error_code& error)
+{
+   if (error)
+      return; // acceptor was closed
+
+   std::error_code ec;
+   client->m_socket.set_option(asio::ip::tcp::no_delay(true), ec);
+
+   m_clients.insert(client);
+
+   client->m_requestTimer.expires_after(std::chrono::milliseconds(m_requestTimeoutInMilliseconds));
+   client->m_requestTimer.async_wait(
+      std::bind(&Impl::OnRequestTimeout, shared_from_this(), client, std::placeholders::_1));
+
+   asio::async_read_until(client->m_socket, client->m_request, "\r\n\r\n",
+      std::bind(&Impl::OnReadRequest, shared_from_this(), client, std::placeholders::_1));
+
+   StartAccept();
+}
+
+void MjpegHttpServer::Impl::OnReadRequest(std::shared_ptr<MjpegClientConnection> client, const std::error_code& error)
+{
+   client->m_isRequestReceived = true;
+
+   std::error_code ec;
+   client->m_requestTimer.cancel(ec);
+
+   if (error)
+   {
+      CloseClient(client);
+      return;
+   }
+
+   std::istream requestStream(&client->m_request);
+   std::string method;
+   requestStream >> method;
+
+   static std::string s_responseStream =
+      std::string("HTTP/1.0 200 OK\r\n"
+         "Server: RemotePhotoTool\r\n"
+         "Connection: close\r\n"
+         "Cache-Control: no-cache, no-store, must-revalidate\r\n"
+         "Pragma: no-cache\r\n"
+         "Content-Type: multipart/x-mixed-replace; boundary=") + c_boundary + "\r\n\r\n";
+
+   static std::string s_responseNotAllowed =
+      "HTTP/1.0 405 Method Not Allowed\r\n"
+      "Connection: close\r\n"
+      "Content-Length: 0\r\n\r\n";
+
+   bool isGet = method == "GET";
+
+   const std::string& response = isGet ? s_responseStream : s_responseNotAllowed;
+
+   if (!isGet)
+   {
+      asio::async_write(client->m_socket, asio::buffer(response),
+         std::bind(&Impl::CloseClient, shared_from_this(), client));
+      return;
+   }
+
+   client->m_isWriting = true;
+
+   asio::async_write(client->m_socket, asio::buffer(response),
+      std::bind(&Impl::OnWriteResponseHeader, shared_from_this(), client, std::placeholders::_1));
+}
+
+void MjpegHttpServer::Impl::OnRequestTimeout(std::shared_ptr<MjpegClientConnection> client, const std::error_code& error)
+{
+   if (error || client->m_isRequestReceived)
+      return; // timer was cancelled
+
+   LOG_TRACE(_T("MjpegHttpServer: client didn't send request in time, disconnecting\n"));
+
+   CloseClient(client);
+}
+
+void MjpegHttpServer::Impl::OnWriteResponseHeader(std::shared_ptr<MjpegClientConnection> client, const std::error_code& error)
+{
+   client->m_isWriting = false;
+
+   if (error)
+   {
+      CloseClient(client);
+      return;
+   }
+
+   client->m_isStreaming = true;
+   m_streamingClientCount++;
+
+   LOG_TRACE(_T("MjpegHttpServer: client connected, %Iu client(s) streaming\n"), m_streamingClientCount.load());
+
+   StartReadClient(client);
+
+   if (client->m_pendingFrame != nullptr)
+   {
+      MjpegFrameSp frame;
+      std::swap(frame, client->m_pendingFrame);
+      StartWriteFrame(client, frame);
+   }
+}
+
+/// \details Clients don't send anything after the request, but reading
+/// notices a closed connection right away, not only at the next frame write.
+void MjpegHttpServer::Impl::StartReadClient(std::shared_ptr<MjpegClientConnection> client)
+{
+   client->m_socket.async_read_some(asio::buffer(client->m_readBuffer),
+      std::bind(&Impl::OnReadClient, shared_from_this(), client, std::placeholders::_1));
+}
+
+void MjpegHttpServer::Impl::OnReadClient(std::shared_ptr<MjpegClientConnection> client, const std::error_code& error)
+{
+   if (error)
+   {
+      CloseClient(client);
+      return;
+   }
+
+   StartReadClient(client);
+}
+
+void MjpegHttpServer::Impl::DistributeFrame(MjpegFrameSp frame)
+{
+   for (auto client : m_clients)
+   {
+      if (!client->m_isStreaming || client->m_isWriting)
+      {
+         // replaces any older frame that wasn't sent yet
+         client->m_pendingFrame = frame;
+         continue;
+      }
+
+      StartWriteFrame(client, frame);
+   }
+}
+
+void MjpegHttpServer::Impl::StartWriteFrame(std::shared_ptr<MjpegClientConnection> client, MjpegFrameSp frame)
+{
+   client->m_isWriting = true;
+   client->m_currentFrame = frame;
+
+   static const char c_crlf[] = "\r\n";
+
+   std::array<asio::const_buffer, 3> buffers =
+   {
+      asio::buffer(frame->m_header),
+      asio::buffer(frame->m_jpegData),
+      asio::buffer(c_crlf, 2),
+   };
+
+   asio::async_write(client->m_socket, buffers,
+      std::bind(&Impl::OnWriteFrame, shared_from_this(), client, std::placeholders::_1));
+}
+
+void MjpegHttpServer::Impl::OnWriteFrame(std::shared_ptr<MjpegClientConnection> client, const std::error_code& error)
+{
+   client->m_isWriting = false;
+   client->m_currentFrame.reset();
+
+   if (error)
+   {
+      CloseClient(client);
+      return;
+   }
+
+   if (client->m_pendingFrame != nullptr)
+   {
+      MjpegFrameSp frame;
+      std::swap(frame, client->m_pendingFrame);
+      StartWriteFrame(client, frame);
+   }
+}
+
+void MjpegHttpServer::Impl::CloseClient(std::shared_ptr<MjpegClientConnection> client)
+{
+   if (m_clients.erase(client) == 0)
+      return;
+
+   if (client->m_isStreaming)
+   {
+      m_streamingClientCount--;
+      LOG_TRACE(_T("MjpegHttpServer: client disconnected, %Iu client(s) streaming\n"), m_streamingClientCount.load());
+   }
+
+   std::error_code ec;
+   client->m_requestTimer.cancel(ec);
+   client->m_socket.shutdown(asio::ip::tcp::socket::shutdown_both, ec);
+   client->m_socket.close(ec);
+}
+
+void MjpegHttpServer::Impl::Stop()
+{
+   std::error_code ec;
+   m_acceptor.close(ec);
+
+   std::set<std::shared_ptr<MjpegClientConnection>> allClients = m_clients;
+   for (auto client : allClients)
+      CloseClient(client);
+}
+
+MjpegHttpServer::MjpegHttpServer(SingleThreadExecutor& executor, unsigned short port, bool localhostOnly,
+   unsigned int requestTimeoutInMilliseconds)
+   :m_impl(std::make_shared<Impl>(executor.m_impl, port, localhostOnly, requestTimeoutInMilliseconds))
+{
+   m_impl->m_executorImpl->m_ioService.post(
+      std::bind(&Impl::StartAccept, m_impl));
+}
+
+MjpegHttpServer::~MjpegHttpServer() noexcept
+{
+   try
+   {
+      m_impl->m_executorImpl->m_ioService.post(
+         std::bind(&Impl::Stop, m_impl));
+   }
+   catch (...)
+   {
+   }
+}
+
+unsigned short MjpegHttpServer::Port() const
+{
+   return m_impl->m_port;
+}
+
+size_t MjpegHttpServer::ClientCount() const
+{
+   return m_impl->m_streamingClientCount;
+}
+
+void MjpegHttpServer::PublishFrame(const std::vector<unsigned char>& jpegData)
+{
+   if (jpegData.empty())
+      return;
+
+   // skip copying the frame when nobody is watching
+   if (m_impl->m_streamingClientCount == 0)
+      return;
+
+   auto frame = std::make_shared<MjpegFrame>();
+
+   frame->m_jpegData = jpegData;
+
+   frame->m_header = std::string("--") + c_boundary + "\r\n"
+      "Content-Type: image/jpeg\r\n"
+      "Content-Length: " + std::to_string(jpegData.size()) + "\r\n\r\n";
+
+   m_impl->m_executorImpl->m_ioService.post(
+      std::bind(&Impl::DistributeFrame, m_impl, MjpegFrameSp(frame)));
+}
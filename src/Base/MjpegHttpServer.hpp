@@ -0,0 +1,45 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file MjpegHttpServer.hpp HTTP server for MJPEG streams
+//
+#pragma once
+
+#include <memory>
+#include <vector>
+
+class SingleThreadExecutor;
+
+/// \brief HTTP server that streams JPEG images as multipart/x-mixed-replace
+/// \details Every published frame is stored once in a shared buffer, and all
+/// connected clients send from that buffer. When a client is still sending
+/// the previous frame, only the newest frame is kept for it, so slow clients
+/// drop frames instead of buffering them. Clients that don't send their
+/// request within the request timeout are disconnected. All network
+/// operations run on the executor's thread.
+class MjpegHttpServer
+{
+public:
+   /// ctor; starts listening on given port
+   MjpegHttpServer(SingleThreadExecutor& executor, unsigned short port, bool localhostOnly = false,
+      unsigned int requestTimeoutInMilliseconds = 10000);
+
+   /// dtor; closes all client connections
+   ~MjpegHttpServer() noexcept;
+
+   /// returns port the server listens on
+   unsigned short Port() const;
+
+   /// returns number of clients currently receiving the stream
+   size_t ClientCount() const;
+
+   /// publishes new JPEG frame to all clients
+   void PublishFrame(const std::vector<unsigned char>& jpegData);
+
+private:
+   struct Impl;
+
+   /// implementation
+   std::shared_ptr<Impl> m_impl;
+};
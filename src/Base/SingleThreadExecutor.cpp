@@ -9,12 +9,18 @@
 #include "SingleThreadExecutorImpl.hpp"
 #include <asio.hpp>
 
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+/// flag for CreateWaitableTimerEx(); defined in Windows SDK 10.0.17134 and later
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
 SingleThreadExecutor::Impl::~Impl() noexcept
 {
    try
    {
       m_defaultWork.reset();
       m_ioService.stop();
+      m_wakeupEvent.Set();
 
       if (m_thread.joinable())
          m_thread.join();
@@ -28,27 +34,71 @@ void SingleThreadExecutor::Impl::Run()
 {
    Thread::SetName(m_threadName == nullptr ? _T("SingleThreadExecutor") : m_threadName);
 
-   // run message queue
-   while (!m_isFinished)
+   if (m_messagePumpIntervalInMilliseconds != 0)
+   {
+      RunMessagePump();
+      return;
+   }
+
+   // block until handlers are ready; the default work keeps run() from
+   // returning, until the io service is stopped
+   std::error_code ec;
+   m_ioService.run(ec);
+}
+
+/// \details Functions passed to Schedule() wake up the thread immediately.
+/// Completions of asio timers and sockets don't wake up the thread, so they
+/// are delayed by up to one message pump interval. A high-resolution
+/// waitable timer is used, since the default timer resolution would round
+/// the interval up to 15.6 ms.
+void SingleThreadExecutor::Impl::RunMessagePump()
+{
+   HANDLE timer = ::CreateWaitableTimerEx(nullptr, nullptr,
+      CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+
+   if (timer == nullptr)
+      timer = ::CreateWaitableTimer(nullptr, FALSE, nullptr); // high resolution timers need Windows 10, 1803
+
+   std::shared_ptr<void> timerHandle{ timer, &::CloseHandle };
+
+   LARGE_INTEGER dueTime;
+   dueTime.QuadPart = -10000LL * m_messagePumpIntervalInMilliseconds; // relative, in 100 ns units
+
+   ::SetWaitableTimer(timer, &dueTime, static_cast<LONG>(m_messagePumpIntervalInMilliseconds), nullptr, nullptr, FALSE);
+
+   HANDLE handles[2] = { m_wakeupEvent.Handle(), timer };
+
+   while (!m_isFinished && !m_ioService.stopped())
    {
       // process asio handlers, if any
       std::error_code ec;
+      m_ioService.poll(ec);
 
-      m_ioService.poll_one(ec);
+      MSG msg = { 0 };
+      while (::PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
+      {
+         ::TranslateMessage(&msg);
+         ::DispatchMessage(&msg);
+      }
 
-      // skip current time slice
-      Sleep(1);
+      ::MsgWaitForMultipleObjects(2, handles, FALSE, INFINITE, QS_ALLINPUT);
    }
+
+   ::CancelWaitableTimer(timer);
 }
 
-SingleThreadExecutor::SingleThreadExecutor(LPCTSTR threadName)
-   :m_impl(std::make_unique<Impl>(threadName))
+SingleThreadExecutor::SingleThreadExecutor(LPCTSTR threadName, unsigned int messagePumpIntervalInMilliseconds)
+   :m_impl(std::make_unique<Impl>(threadName, messagePumpIntervalInMilliseconds))
 {
 }
 
 SingleThreadExecutor::~SingleThreadExecutor()
 {
+   // stop thread, even when timers still hold a reference to the implementation
    m_impl->m_isFinished = true;
+   m_impl->m_ioService.stop();
+   m_impl->m_wakeupEvent.Set();
+
    m_impl.reset();
 }
 
@@ -57,5 +107,26 @@ void SingleThreadExecutor::Schedule(std::function<void()> func)
    if (m_impl->m_isFinished)
       return;
 
-   m_impl->m_ioService.post(func);
+   m_impl->m_numPendingFunctions++;
+
+   // the handlers only run on the background thread, which the implementation outlives
+   Impl* impl = m_impl.get();
+   m_impl->m_ioService.post([impl, func]()
+   {
+      impl->m_numPendingFunctions--;
+      func();
+   });
+
+   if (m_impl->m_messagePumpIntervalInMilliseconds != 0)
+      m_impl->m_wakeupEvent.Set();
+}
+
+bool SingleThreadExecutor::IsCurrentThread() const
+{
+   return std::this_thread::get_id() == m_impl->m_thread.get_id();
+}
+
+bool SingleThreadExecutor::HasPendingFunctions() const
+{
+   return m_impl->m_numPendingFunctions > 0;
 }
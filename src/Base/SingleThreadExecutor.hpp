@@ -15,17 +15,28 @@
 class SingleThreadExecutor
 {
 public:
-   /// sets up executor and starts background thread
-   SingleThreadExecutor(LPCTSTR threadName = nullptr);
+   /// sets up executor and starts background thread; when a message pump
+   /// interval is given, window messages are dispatched on the background
+   /// thread at least in this interval, for SDKs that need a message pump
+   SingleThreadExecutor(LPCTSTR threadName = nullptr, unsigned int messagePumpIntervalInMilliseconds = 0);
    /// waits for any executing methods to stop and quits background thread
    ~SingleThreadExecutor() noexcept;
 
    /// Schedules a function to run
    void Schedule(std::function<void()> func);
 
+   /// returns if the calling thread is the background thread; the caller
+   /// must not wait for scheduled functions then
+   bool IsCurrentThread() const;
+
+   /// returns if scheduled functions are waiting to run; a function that is
+   /// currently running isn't counted
+   bool HasPendingFunctions() const;
+
 private:
    friend class PeriodicExecuteTimer;
    friend class OneShotExecuteTimer;
+   friend class MjpegHttpServer;
 
    struct Impl;
 
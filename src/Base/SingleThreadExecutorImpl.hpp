@@ -9,17 +9,21 @@
 #include "SingleThreadExecutor.hpp"
 #include <asio.hpp>
 #include <ulib/thread/Thread.hpp>
+#include <ulib/thread/Event.hpp>
 
 /// SingleThreadExecutor implementation
 struct SingleThreadExecutor::Impl : public std::enable_shared_from_this<SingleThreadExecutor::Impl>
 {
    /// ctor
-   Impl(LPCTSTR threadName)
+   Impl(LPCTSTR threadName, unsigned int messagePumpIntervalInMilliseconds)
       :m_threadName(threadName),
+      m_messagePumpIntervalInMilliseconds(messagePumpIntervalInMilliseconds),
       m_ioService(1),
       m_defaultWork(new asio::io_service::work(m_ioService)),
-      m_thread(std::bind(&Impl::Run, this)),
-      m_isFinished(false)
+      m_wakeupEvent(false),
+      m_isFinished(false),
+      m_numPendingFunctions(0),
+      m_thread(std::bind(&Impl::Run, this))
    {
    }
 
@@ -29,18 +33,30 @@ struct SingleThreadExecutor::Impl : public std::enable_shared_from_this<SingleTh
    /// runs worker thread
    void Run();
 
+   /// runs handlers and dispatches window messages, until the thread should stop
+   void RunMessagePump();
+
    /// thread name, or nullptr if default should be used
    LPCTSTR m_threadName;
 
+   /// interval in which window messages are dispatched; 0 when no messages are dispatched
+   unsigned int m_messagePumpIntervalInMilliseconds;
+
    /// io service
    asio::io_service m_ioService;
 
-   /// default work
+   /// default work; keeps run() from returning while there are no handlers
    std::unique_ptr<asio::io_service::work> m_defaultWork;
 
-   /// background thread
-   std::thread m_thread;
+   /// event to wake up message pump when a function was scheduled
+   AutoResetEvent m_wakeupEvent;
 
    /// indicates that thread should stop
    std::atomic<bool> m_isFinished;
+
+   /// number of functions scheduled, but not yet started
+   std::atomic<unsigned int> m_numPendingFunctions;
+
+   /// background thread; must be the last member, since it's started in the ctor
+   std::thread m_thread;
 };
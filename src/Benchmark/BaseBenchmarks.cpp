@@ -0,0 +1,83 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file BaseBenchmarks.cpp Benchmarks for the Base library
+//
+
+// includes
+#include "stdafx.h"
+#include "Benchmarks.hpp"
+#include "BenchmarkRunner.hpp"
+#include "SingleThreadExecutor.hpp"
+#include <ulib/thread/Event.hpp>
+
+/// number of functions scheduled per iteration of the throughput benchmark
+static const size_t c_numScheduledFunctions = 1000;
+
+/// adds executor benchmarks; when a message pump interval is given, the
+/// executor thread also dispatches window messages, as for camera SDKs
+static void AddExecutorBenchmarks(BenchmarkRunner& runner, const CString& nameSuffix,
+   unsigned int messagePumpIntervalInMilliseconds)
+{
+   // time from scheduling a function until the scheduling thread is notified
+   // that it ran; this is the latency added to every queued camera command
+   runner.Add(_T("Base/SingleThreadExecutor/RoundTrip") + nameSuffix,
+      [messagePumpIntervalInMilliseconds](BenchmarkRunner::Counters& counters)
+      {
+         auto spExecutor = std::make_shared<SingleThreadExecutor>(
+            _T("benchmark executor thread"), messagePumpIntervalInMilliseconds);
+
+         counters.m_itemsPerIteration = 1;
+
+         return [spExecutor](size_t numIterations)
+         {
+            ManualResetEvent eventFinished(false);
+
+            for (size_t iteration = 0; iteration < numIterations; iteration++)
+            {
+               eventFinished.Reset();
+
+               spExecutor->Schedule([&eventFinished]() { eventFinished.Set(); });
+
+               eventFinished.Wait();
+            }
+         };
+      });
+
+   // number of functions the executor thread can run per second
+   runner.Add(_T("Base/SingleThreadExecutor/Throughput") + nameSuffix,
+      [messagePumpIntervalInMilliseconds](BenchmarkRunner::Counters& counters)
+      {
+         auto spExecutor = std::make_shared<SingleThreadExecutor>(
+            _T("benchmark executor thread"), messagePumpIntervalInMilliseconds);
+
+         counters.m_itemsPerIteration = c_numScheduledFunctions;
+
+         return [spExecutor](size_t numIterations)
+         {
+            ManualResetEvent eventFinished(false);
+            size_t counter = 0;
+
+            for (size_t iteration = 0; iteration < numIterations; iteration++)
+            {
+               eventFinished.Reset();
+
+               for (size_t index = 0; index < c_numScheduledFunctions; index++)
+                  spExecutor->Schedule([&counter]() { counter++; });
+
+               spExecutor->Schedule([&eventFinished]() { eventFinished.Set(); });
+
+               eventFinished.Wait();
+            }
+
+            BenchmarkRunner::Consume(counter);
+         };
+      });
+}
+
+void AddBaseBenchmarks(BenchmarkRunner& runner)
+{
+   AddExecutorBenchmarks(runner, _T(""), 0);
+   AddExecutorBenchmarks(runner, _T("/MessagePump"), 10);
+}
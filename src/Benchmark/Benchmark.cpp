@@ -0,0 +1,67 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file Benchmark.cpp Benchmark app main function
+//
+
+// includes
+#include "stdafx.h"
+#include "BenchmarkOptions.hpp"
+#include "BenchmarkRunner.hpp"
+#include "Benchmarks.hpp"
+#include "../version.h"
+#include <ulib/Exception.hpp>
+
+/// benchmark app main function
+int _tmain(int argc, LPCTSTR argv[])
+{
+   try
+   {
+      _tprintf(_T("RemotePhotoTool Benchmark %s\n%s\n\n"),
+         _T(VERSIONINFO_FILEVERSION_DISPLAYSTRING),
+         _T(VERSIONINFO_COPYRIGHT));
+
+      BenchmarkOptions options;
+      options.Parse(argc, argv);
+
+      if (options.IsSelectedHelpOption())
+         return 0;
+
+      BenchmarkRunner runner(options.MinSampleTimeInMilliseconds(), options.NumSamples());
+
+      AddBaseBenchmarks(runner);
+      AddLogicBenchmarks(runner, options.JpegFilename());
+      AddLocationBenchmarks(runner);
+      AddLuaScriptingBenchmarks(runner);
+      AddCameraControlBenchmarks(runner);
+
+      if (options.IsListEnabled())
+      {
+         for (const CString& name : runner.Names())
+            _tprintf(_T("%s\n"), name.GetString());
+
+         return 0;
+      }
+
+      runner.Run(options.Filter());
+
+      if (!options.OutputFilename().IsEmpty())
+      {
+         runner.WriteJson(options.OutputFilename());
+         _tprintf(_T("\nResults written to %s\n"), options.OutputFilename().GetString());
+      }
+
+      return 0;
+   }
+   catch (const Exception& ex)
+   {
+      _tprintf(_T("Exception while running benchmarks: %s\n"), ex.Message().GetString());
+      return -1;
+   }
+   catch (...)
+   {
+      _tprintf(_T("Exception while running benchmarks\n"));
+      return -1;
+   }
+}
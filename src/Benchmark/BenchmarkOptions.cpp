@@ -0,0 +1,57 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file BenchmarkOptions.cpp Benchmark app options
+//
+
+// includes
+#include "stdafx.h"
+#include "BenchmarkOptions.hpp"
+
+BenchmarkOptions::BenchmarkOptions()
+   :m_isListEnabled(false),
+   m_minSampleTimeInMilliseconds(100),
+   m_numSamples(10)
+{
+   RegisterOutputHandler(&ProgramOptions::OutputConsole);
+   RegisterHelpOption();
+
+   RegisterOption(_T("l"), _T("list"), _T("lists all benchmarks"),
+      0, [&]() { m_isListEnabled = true; return true; });
+
+   RegisterOption(_T("f"), _T("filter"), _T("only runs benchmarks whose name contains <arg1>, e.g. Logic/JpegDecode"),
+      1, [&](const std::vector<CString>& vecParam)
+      {
+         m_filter = vecParam[0];
+         return true;
+      });
+
+   RegisterOption(_T("o"), _T("output"), _T("writes results as JSON to file <arg1>, e.g. to compare builds"),
+      1, [&](const std::vector<CString>& vecParam)
+      {
+         m_outputFilename = vecParam[0];
+         return true;
+      });
+
+   RegisterOption(_T(""), _T("jpeg-file"), _T("also runs the JPEG benchmarks with JPEG file <arg1>, e.g. an image of a real camera"),
+      1, [&](const std::vector<CString>& vecParam)
+      {
+         m_jpegFilename = vecParam[0];
+         return true;
+      });
+
+   RegisterOption(_T(""), _T("min-time"), _T("sets minimum time of a sample to <arg1> milliseconds; default is 100"),
+      1, [&](const std::vector<CString>& vecParam)
+      {
+         m_minSampleTimeInMilliseconds = static_cast<unsigned int>(_ttoi(vecParam[0]));
+         return true;
+      });
+
+   RegisterOption(_T(""), _T("samples"), _T("sets number of samples per benchmark to <arg1>; default is 10"),
+      1, [&](const std::vector<CString>& vecParam)
+      {
+         m_numSamples = static_cast<unsigned int>(_ttoi(vecParam[0]));
+         return true;
+      });
+}
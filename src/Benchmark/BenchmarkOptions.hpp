@@ -0,0 +1,55 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file BenchmarkOptions.hpp Benchmark app options
+//
+#pragma once
+
+// includes
+#include <ulib/ProgramOptions.hpp>
+
+/// options for benchmark application
+class BenchmarkOptions : public ProgramOptions
+{
+public:
+   /// ctor
+   BenchmarkOptions();
+
+   /// returns if benchmark names should be listed instead of running benchmarks
+   bool IsListEnabled() const { return m_isListEnabled; }
+
+   /// returns filter text; only benchmarks whose name contains the text are run
+   const CString& Filter() const { return m_filter; }
+
+   /// returns filename of JSON results file; empty when no file should be written
+   const CString& OutputFilename() const { return m_outputFilename; }
+
+   /// returns filename of JPEG file to run additional JPEG benchmarks with
+   const CString& JpegFilename() const { return m_jpegFilename; }
+
+   /// returns minimum time for a sample, in milliseconds
+   unsigned int MinSampleTimeInMilliseconds() const { return m_minSampleTimeInMilliseconds; }
+
+   /// returns number of samples to take for every benchmark
+   unsigned int NumSamples() const { return m_numSamples; }
+
+private:
+   /// indicates if benchmark names should be listed
+   bool m_isListEnabled;
+
+   /// filter text
+   CString m_filter;
+
+   /// filename of JSON results file
+   CString m_outputFilename;
+
+   /// filename of JPEG file
+   CString m_jpegFilename;
+
+   /// minimum time for a sample, in milliseconds
+   unsigned int m_minSampleTimeInMilliseconds;
+
+   /// number of samples
+   unsigned int m_numSamples;
+};
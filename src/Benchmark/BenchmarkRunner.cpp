@@ -0,0 +1,217 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file BenchmarkRunner.cpp Benchmark runner
+//
+
+// includes
+#include "stdafx.h"
+#include "BenchmarkRunner.hpp"
+#include "../version.h"
+#include <ulib/Exception.hpp>
+#include <atltime.h>
+#include <algorithm>
+#include <chrono>
+
+/// sink for consumed values; volatile, so that the stores can't be removed
+static volatile size_t s_consumedValue = 0;
+
+/// maximum factor by which the number of iterations grows per calibration step
+const double c_maxCalibrationFactor = 100.0;
+
+/// escapes text for use as JSON string
+static CStringA EscapeJsonString(const CString& text)
+{
+   CStringA escapedText;
+
+   CStringA utf8Text(CW2A(text, CP_UTF8));
+   for (int index = 0, length = utf8Text.GetLength(); index < length; index++)
+   {
+      char ch = utf8Text[index];
+      if (ch == '\"' || ch == '\\')
+         escapedText.AppendChar('\\');
+
+      if (static_cast<unsigned char>(ch) < 0x20)
+         escapedText.AppendFormat("\\u%04x", static_cast<unsigned int>(ch));
+      else
+         escapedText.AppendChar(ch);
+   }
+
+   return escapedText;
+}
+
+BenchmarkRunner::BenchmarkRunner(unsigned int minSampleTimeInMilliseconds, unsigned int numSamples)
+   :m_minSampleTimeInMilliseconds(minSampleTimeInMilliseconds),
+   m_numSamples(std::max(1U, numSamples))
+{
+}
+
+void BenchmarkRunner::Add(const CString& name, T_fnSetup fnSetup)
+{
+   m_benchmarks.push_back(std::make_pair(name, fnSetup));
+}
+
+std::vector<CString> BenchmarkRunner::Names() const
+{
+   std::vector<CString> names;
+
+   for (const auto& benchmark : m_benchmarks)
+      names.push_back(benchmark.first);
+
+   return names;
+}
+
+void BenchmarkRunner::Run(const CString& filter)
+{
+   m_results.clear();
+
+   for (const auto& benchmark : m_benchmarks)
+   {
+      const CString& name = benchmark.first;
+      if (!filter.IsEmpty() && name.Find(filter) == -1)
+         continue;
+
+      try
+      {
+         BenchmarkResult result = RunBenchmark(name, benchmark.second);
+
+         CString throughput;
+         double medianSeconds = result.m_medianNanoseconds * 1e-9;
+         if (result.m_bytesPerIteration > 0 && medianSeconds > 0.0)
+            throughput.Format(_T("%10.1f MB/s"), result.m_bytesPerIteration / medianSeconds / (1024.0 * 1024.0));
+         else if (result.m_itemsPerIteration > 0 && medianSeconds > 0.0)
+            throughput.Format(_T("%10.0f items/s"), result.m_itemsPerIteration / medianSeconds);
+
+         _tprintf(_T("%-48s %14.0f ns %s\n"),
+            name.GetString(),
+            result.m_medianNanoseconds,
+            throughput.GetString());
+
+         m_results.push_back(result);
+      }
+      catch (const Exception& ex)
+      {
+         _tprintf(_T("%-48s failed: %s\n"), name.GetString(), ex.Message().GetString());
+      }
+      catch (const std::exception& ex)
+      {
+         _tprintf(_T("%-48s failed: %hs\n"), name.GetString(), ex.what());
+      }
+   }
+}
+
+void BenchmarkRunner::WriteJson(const CString& filename) const
+{
+   FILE* fd = nullptr;
+   errno_t err = _tfopen_s(&fd, filename, _T("wt"));
+   if (err != 0 || fd == nullptr)
+      throw Exception(_T("couldn't create benchmark results file: ") + filename, __FILE__, __LINE__);
+
+   std::shared_ptr<FILE> spAutoCloseFile(fd, fclose);
+
+   CStringA timestamp(ATL::CTime::GetCurrentTime().FormatGmt(_T("%Y-%m-%dT%H:%M:%SZ")));
+
+   fprintf(fd, "{\n");
+   fprintf(fd, "  \"version\": \"%s\",\n", VERSIONINFO_FILEVERSION_STRING);
+#ifdef _DEBUG
+   fprintf(fd, "  \"configuration\": \"Debug\",\n");
+#else
+   fprintf(fd, "  \"configuration\": \"Release\",\n");
+#endif
+   fprintf(fd, "  \"timestamp\": \"%s\",\n", timestamp.GetString());
+   fprintf(fd, "  \"minSampleTimeInMilliseconds\": %u,\n", m_minSampleTimeInMilliseconds);
+   fprintf(fd, "  \"numSamples\": %u,\n", m_numSamples);
+   fprintf(fd, "  \"benchmarks\": [");
+
+   for (size_t index = 0; index < m_results.size(); index++)
+   {
+      const BenchmarkResult& result = m_results[index];
+
+      fprintf(fd, "%s\n    {\n", index == 0 ? "" : ",");
+      fprintf(fd, "      \"name\": \"%s\",\n", EscapeJsonString(result.m_name).GetString());
+      fprintf(fd, "      \"samples\": %u,\n", result.m_numSamples);
+      fprintf(fd, "      \"iterationsPerSample\": %zu,\n", result.m_iterationsPerSample);
+      fprintf(fd, "      \"itemsPerIteration\": %zu,\n", result.m_itemsPerIteration);
+      fprintf(fd, "      \"bytesPerIteration\": %zu,\n", result.m_bytesPerIteration);
+      fprintf(fd, "      \"minNanoseconds\": %.1f,\n", result.m_minNanoseconds);
+      fprintf(fd, "      \"medianNanoseconds\": %.1f,\n", result.m_medianNanoseconds);
+      fprintf(fd, "      \"meanNanoseconds\": %.1f,\n", result.m_meanNanoseconds);
+      fprintf(fd, "      \"maxNanoseconds\": %.1f\n", result.m_maxNanoseconds);
+      fprintf(fd, "    }");
+   }
+
+   fprintf(fd, "%s]\n}\n", m_results.empty() ? "" : "\n  ");
+}
+
+void BenchmarkRunner::Consume(size_t value)
+{
+   s_consumedValue = s_consumedValue + value;
+}
+
+BenchmarkResult BenchmarkRunner::RunBenchmark(const CString& name, T_fnSetup fnSetup) const
+{
+   Counters counters;
+   T_fnRun fnRun = fnSetup(counters);
+
+   BenchmarkResult result;
+   result.m_name = name;
+   result.m_numSamples = m_numSamples;
+   result.m_itemsPerIteration = counters.m_itemsPerIteration;
+   result.m_bytesPerIteration = counters.m_bytesPerIteration;
+
+   // calibrating also warms up caches and lazily initialized data
+   size_t numIterations = Calibrate(fnRun);
+   result.m_iterationsPerSample = numIterations;
+
+   std::vector<double> samples;
+   for (unsigned int sampleIndex = 0; sampleIndex < m_numSamples; sampleIndex++)
+      samples.push_back(MeasureSample(fnRun, numIterations) / numIterations);
+
+   std::sort(samples.begin(), samples.end());
+
+   result.m_minNanoseconds = samples.front();
+   result.m_maxNanoseconds = samples.back();
+
+   size_t middle = samples.size() / 2;
+   result.m_medianNanoseconds = (samples.size() & 1) != 0
+      ? samples[middle]
+      : (samples[middle - 1] + samples[middle]) / 2.0;
+
+   double sum = 0.0;
+   for (double sample : samples)
+      sum += sample;
+
+   result.m_meanNanoseconds = sum / samples.size();
+
+   return result;
+}
+
+size_t BenchmarkRunner::Calibrate(T_fnRun fnRun) const
+{
+   double minSampleNanoseconds = m_minSampleTimeInMilliseconds * 1e6;
+
+   size_t numIterations = 1;
+   for (;;)
+   {
+      double elapsedNanoseconds = MeasureSample(fnRun, numIterations);
+      if (elapsedNanoseconds >= minSampleNanoseconds)
+         return numIterations;
+
+      // estimate iterations needed, with a margin, since short samples are imprecise
+      double factor = elapsedNanoseconds > 0.0
+         ? std::min(c_maxCalibrationFactor, 1.2 * minSampleNanoseconds / elapsedNanoseconds)
+         : c_maxCalibrationFactor;
+
+      numIterations = std::max(numIterations + 1, static_cast<size_t>(numIterations * factor));
+   }
+}
+
+double BenchmarkRunner::MeasureSample(T_fnRun fnRun, size_t numIterations)
+{
+   auto startTime = std::chrono::steady_clock::now();
+
+   fnRun(numIterations);
+
+   return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime).count();
+}
@@ -0,0 +1,126 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file BenchmarkRunner.hpp Benchmark runner
+//
+#pragma once
+
+// includes
+#include <vector>
+#include <functional>
+
+/// result of running a single benchmark; all times are per iteration
+struct BenchmarkResult
+{
+   /// ctor
+   BenchmarkResult()
+      :m_numSamples(0),
+      m_iterationsPerSample(0),
+      m_itemsPerIteration(0),
+      m_bytesPerIteration(0),
+      m_minNanoseconds(0.0),
+      m_medianNanoseconds(0.0),
+      m_meanNanoseconds(0.0),
+      m_maxNanoseconds(0.0)
+   {
+   }
+
+   /// benchmark name, e.g. "Logic/JpegDecode/1920x1280"
+   CString m_name;
+
+   /// number of samples taken
+   unsigned int m_numSamples;
+
+   /// number of iterations run per sample
+   size_t m_iterationsPerSample;
+
+   /// number of items processed per iteration; 0 when not applicable
+   size_t m_itemsPerIteration;
+
+   /// number of bytes processed per iteration; 0 when not applicable
+   size_t m_bytesPerIteration;
+
+   double m_minNanoseconds;      ///< fastest sample
+   double m_medianNanoseconds;   ///< median of all samples
+   double m_meanNanoseconds;     ///< mean of all samples
+   double m_maxNanoseconds;      ///< slowest sample
+};
+
+/// \brief runs benchmarks and collects their results
+/// \details Each benchmark is first calibrated, so that a sample takes at
+/// least the minimum sample time; then the given number of samples is taken,
+/// and min, median, mean and max time per iteration are reported. Benchmark
+/// data is only generated when a benchmark is selected to run.
+class BenchmarkRunner
+{
+public:
+   /// counters that a benchmark setup function can set, to report throughput
+   struct Counters
+   {
+      /// ctor
+      Counters()
+         :m_itemsPerIteration(0),
+         m_bytesPerIteration(0)
+      {
+      }
+
+      /// number of items processed per iteration, e.g. images or sentences
+      size_t m_itemsPerIteration;
+
+      /// number of bytes processed per iteration
+      size_t m_bytesPerIteration;
+   };
+
+   /// runs the benchmarked code the given number of times
+   typedef std::function<void(size_t numIterations)> T_fnRun;
+
+   /// sets up benchmark data and returns the function to measure
+   typedef std::function<T_fnRun(Counters& counters)> T_fnSetup;
+
+   /// ctor
+   BenchmarkRunner(unsigned int minSampleTimeInMilliseconds, unsigned int numSamples);
+
+   /// adds benchmark with given name
+   void Add(const CString& name, T_fnSetup fnSetup);
+
+   /// returns names of all benchmarks
+   std::vector<CString> Names() const;
+
+   /// runs all benchmarks whose name contains the filter text; runs all
+   /// benchmarks when the filter text is empty
+   void Run(const CString& filter);
+
+   /// returns results of the last run
+   const std::vector<BenchmarkResult>& Results() const { return m_results; }
+
+   /// writes results as JSON document to given file
+   void WriteJson(const CString& filename) const;
+
+   /// consumes a result value, so that the compiler can't optimize away the
+   /// benchmarked code that calculated it
+   static void Consume(size_t value);
+
+private:
+   /// runs single benchmark and returns its result
+   BenchmarkResult RunBenchmark(const CString& name, T_fnSetup fnSetup) const;
+
+   /// determines number of iterations so that a sample takes at least the minimum sample time
+   size_t Calibrate(T_fnRun fnRun) const;
+
+   /// runs given number of iterations and returns elapsed time, in nanoseconds
+   static double MeasureSample(T_fnRun fnRun, size_t numIterations);
+
+private:
+   /// minimum time for a sample
+   unsigned int m_minSampleTimeInMilliseconds;
+
+   /// number of samples to take for every benchmark
+   unsigned int m_numSamples;
+
+   /// all benchmarks, with name and setup function
+   std::vector<std::pair<CString, T_fnSetup>> m_benchmarks;
+
+   /// results of the last run
+   std::vector<BenchmarkResult> m_results;
+};
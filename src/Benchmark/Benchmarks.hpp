@@ -0,0 +1,25 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file Benchmarks.hpp Benchmarks of all libraries
+//
+#pragma once
+
+class BenchmarkRunner;
+
+/// adds benchmarks for the Base library, e.g. the single thread executor
+void AddBaseBenchmarks(BenchmarkRunner& runner);
+
+/// adds benchmarks for the Logic library; when a JPEG filename is given, the
+/// JPEG benchmarks are also run on that file
+void AddLogicBenchmarks(BenchmarkRunner& runner, const CString& jpegFilename);
+
+/// adds benchmarks for the Location library
+void AddLocationBenchmarks(BenchmarkRunner& runner);
+
+/// adds benchmarks for the LuaScripting library
+void AddLuaScriptingBenchmarks(BenchmarkRunner& runner);
+
+/// adds benchmarks for the CameraControl library, using a simulated camera
+void AddCameraControlBenchmarks(BenchmarkRunner& runner);
@@ -0,0 +1,144 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file CameraControlBenchmarks.cpp Benchmarks for the CameraControl library
+//
+
+// includes
+#include "stdafx.h"
+#include "Benchmarks.hpp"
+#include "BenchmarkRunner.hpp"
+#include "Instance.hpp"
+#include "SourceInfo.hpp"
+#include "SourceDevice.hpp"
+#include "RemoteReleaseControl.hpp"
+#include "ImagePropertyValueList.hpp"
+#include "SimulatedCameraSettings.hpp"
+#include "CameraException.hpp"
+
+/// remote release control of a simulated camera, with the source device it was opened from
+struct SimulatedReleaseControl
+{
+   /// source device; kept open as long as the release control is used
+   std::shared_ptr<SourceDevice> m_spSourceDevice;
+
+   /// remote release control
+   std::shared_ptr<RemoteReleaseControl> m_spReleaseControl;
+
+   /// id of the Tv (shutter speed) image property, with the longest list of values
+   unsigned int m_tvPropertyId;
+};
+
+/// opens first simulated camera and starts remote release control
+static std::shared_ptr<SimulatedReleaseControl> OpenSimulatedCamera()
+{
+   SimulatedCameraSettings settings;
+   settings.m_numCameras = 1;
+
+   Instance::SetSimulatedCameraSettings(settings);
+
+   Instance instance = Instance::Get();
+
+   std::vector<std::shared_ptr<SourceInfo>> sourceInfoList;
+   instance.EnumerateDevices(sourceInfoList);
+
+   for (std::shared_ptr<SourceInfo> spSourceInfo : sourceInfoList)
+   {
+      if (spSourceInfo->DeviceId().Find(_T("simulated:")) != 0)
+         continue;
+
+      auto spCamera = std::make_shared<SimulatedReleaseControl>();
+      spCamera->m_spSourceDevice = spSourceInfo->Open();
+      spCamera->m_spReleaseControl = spCamera->m_spSourceDevice->EnterReleaseControl();
+      spCamera->m_tvPropertyId = spCamera->m_spReleaseControl->MapImagePropertyTypeToId(propTv);
+
+      return spCamera;
+   }
+
+   throw CameraException(_T("OpenSimulatedCamera"), _T("no simulated camera found"), 0, __FILE__, __LINE__);
+}
+
+void AddCameraControlBenchmarks(BenchmarkRunner& runner)
+{
+   // enumerates values from the camera, like the UI did before values were cached
+   runner.Add(_T("CameraControl/EnumImagePropertyValues/Tv"),
+      [](BenchmarkRunner::Counters& counters)
+      {
+         std::shared_ptr<SimulatedReleaseControl> spCamera = OpenSimulatedCamera();
+
+         std::vector<ImageProperty> valuesList;
+         spCamera->m_spReleaseControl->EnumImagePropertyValues(spCamera->m_tvPropertyId, valuesList);
+         counters.m_itemsPerIteration = valuesList.size();
+
+         return [spCamera](size_t numIterations)
+         {
+            for (size_t iteration = 0; iteration < numIterations; iteration++)
+            {
+               std::vector<ImageProperty> valuesList;
+               spCamera->m_spReleaseControl->EnumImagePropertyValues(spCamera->m_tvPropertyId, valuesList);
+
+               BenchmarkRunner::Consume(valuesList.size());
+            }
+         };
+      });
+
+   runner.Add(_T("CameraControl/GetCachedImagePropertyValues/Tv"),
+      [](BenchmarkRunner::Counters& counters)
+      {
+         std::shared_ptr<SimulatedReleaseControl> spCamera = OpenSimulatedCamera();
+
+         counters.m_itemsPerIteration = 1;
+
+         return [spCamera](size_t numIterations)
+         {
+            for (size_t iteration = 0; iteration < numIterations; iteration++)
+            {
+               std::shared_ptr<const ImagePropertyValueList> spValuesList =
+                  spCamera->m_spReleaseControl->GetCachedImagePropertyValues(spCamera->m_tvPropertyId);
+
+               BenchmarkRunner::Consume(spValuesList->Values().size());
+            }
+         };
+      });
+
+   // copying the values copies a Variant per value
+   runner.Add(_T("CameraControl/ImagePropertyValuesCopy/Tv"),
+      [](BenchmarkRunner::Counters& counters)
+      {
+         std::shared_ptr<SimulatedReleaseControl> spCamera = OpenSimulatedCamera();
+
+         auto spValuesList = std::make_shared<std::vector<ImageProperty>>();
+         spCamera->m_spReleaseControl->EnumImagePropertyValues(spCamera->m_tvPropertyId, *spValuesList);
+         counters.m_itemsPerIteration = spValuesList->size();
+
+         return [spValuesList](size_t numIterations)
+         {
+            for (size_t iteration = 0; iteration < numIterations; iteration++)
+            {
+               std::vector<ImageProperty> valuesList = *spValuesList;
+               BenchmarkRunner::Consume(valuesList.size());
+            }
+         };
+      });
+
+   // formats all values, as done when filling a combo box with the values
+   runner.Add(_T("CameraControl/ImagePropertyAsString/Tv"),
+      [](BenchmarkRunner::Counters& counters)
+      {
+         std::shared_ptr<SimulatedReleaseControl> spCamera = OpenSimulatedCamera();
+
+         auto spValuesList = std::make_shared<std::vector<ImageProperty>>();
+         spCamera->m_spReleaseControl->EnumImagePropertyValues(spCamera->m_tvPropertyId, *spValuesList);
+         counters.m_itemsPerIteration = spValuesList->size();
+
+         return [spCamera, spValuesList](size_t numIterations)
+         {
+            for (size_t iteration = 0; iteration < numIterations; iteration++)
+            {
+               for (const ImageProperty& imageProperty : *spValuesList)
+                  BenchmarkRunner::Consume(imageProperty.AsString().GetLength());
+            }
+         };
+      });
+}
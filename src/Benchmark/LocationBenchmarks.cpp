@@ -0,0 +1,112 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file LocationBenchmarks.cpp Benchmarks for the Location library
+//
+
+// includes
+#include "stdafx.h"
+#include "Benchmarks.hpp"
+#include "BenchmarkRunner.hpp"
+#include "SyntheticData.hpp"
+#include "NMEA0183/Parser.hpp"
+#include <random>
+
+/// number of seconds of GPS receiver output for the NMEA 0183 parser benchmark
+static const size_t c_numNmeaSeconds = 1000;
+
+/// numbers of track points for the track benchmarks
+static const size_t c_numTrackPoints[] = { 1000, 10000, 100000 };
+
+/// number of time stamps looked up per iteration of the track lookup benchmark
+static const size_t c_numTrackLookups = 1000;
+
+/// adds track benchmarks for given number of track points
+static void AddTrackBenchmarks(BenchmarkRunner& runner, size_t numPoints)
+{
+   CString numPointsText;
+   numPointsText.Format(_T("%zu"), numPoints);
+
+   runner.Add(_T("Location/TrackAddPoints/") + numPointsText,
+      [numPoints](BenchmarkRunner::Counters& counters)
+      {
+         // time stamps are created up front, so that only AddPoint() is measured
+         auto spTimeStampList = std::make_shared<std::vector<DateTime>>();
+         for (size_t index = 0; index < numPoints; index++)
+            spTimeStampList->push_back(SyntheticData::TimeStamp(index));
+
+         counters.m_itemsPerIteration = numPoints;
+
+         return [spTimeStampList](size_t numIterations)
+         {
+            GPS::WGS84::Coordinate coordinate(48.137, 11.575);
+
+            for (size_t iteration = 0; iteration < numIterations; iteration++)
+            {
+               GPS::Track track;
+               for (const DateTime& timeStamp : *spTimeStampList)
+                  track.AddPoint(coordinate, timeStamp);
+
+               BenchmarkRunner::Consume(track.NumPoints());
+            }
+         };
+      });
+
+   // looks up time stamps like the geo tagger does for each image
+   runner.Add(_T("Location/TrackFindNearest/") + numPointsText,
+      [numPoints](BenchmarkRunner::Counters& counters)
+      {
+         auto spTrack = std::make_shared<GPS::Track>(SyntheticData::CreateTrack(numPoints, 1));
+
+         std::mt19937 random(1);
+         auto spTimeStampList = std::make_shared<std::vector<DateTime>>();
+         for (size_t index = 0; index < c_numTrackLookups; index++)
+            spTimeStampList->push_back(SyntheticData::TimeStamp(random() % numPoints));
+
+         counters.m_itemsPerIteration = c_numTrackLookups;
+
+         return [spTrack, spTimeStampList](size_t numIterations)
+         {
+            for (size_t iteration = 0; iteration < numIterations; iteration++)
+            {
+               for (const DateTime& timeStamp : *spTimeStampList)
+               {
+                  if (spTrack->InTrackRange(timeStamp))
+                     BenchmarkRunner::Consume(spTrack->FindNearest(timeStamp).first.GetSecondLatitude());
+               }
+            }
+         };
+      });
+}
+
+void AddLocationBenchmarks(BenchmarkRunner& runner)
+{
+   runner.Add(_T("Location/NMEA0183Parser"),
+      [](BenchmarkRunner::Counters& counters)
+      {
+         auto spSentenceList = std::make_shared<std::vector<CString>>(
+            SyntheticData::CreateNmeaSentences(c_numNmeaSeconds, 1));
+
+         counters.m_itemsPerIteration = spSentenceList->size();
+
+         for (const CString& sentence : *spSentenceList)
+            counters.m_bytesPerIteration += sentence.GetLength();
+
+         return [spSentenceList](size_t numIterations)
+         {
+            for (size_t iteration = 0; iteration < numIterations; iteration++)
+            {
+               NMEA0183::Parser parser;
+
+               for (const CString& sentence : *spSentenceList)
+                  parser.ParseLine(sentence);
+
+               BenchmarkRunner::Consume(parser.GetSatelliteInfos().size());
+            }
+         };
+      });
+
+   for (size_t numPoints : c_numTrackPoints)
+      AddTrackBenchmarks(runner, numPoints);
+}
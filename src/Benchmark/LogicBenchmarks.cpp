@@ -0,0 +1,236 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file LogicBenchmarks.cpp Benchmarks for the Logic library
+//
+
+// includes
+#include "stdafx.h"
+#include "Benchmarks.hpp"
+#include "BenchmarkRunner.hpp"
+#include "SyntheticData.hpp"
+#include "JpegMemoryReader.hpp"
+#include "JFIFRewriter.hpp"
+#include "Exif.hpp"
+#include "ImageTypeScanner.hpp"
+#include <ulib/Exception.hpp>
+#include <ulib/stream/MemoryReadStream.hpp>
+#include <ulib/stream/MemoryStream.hpp>
+
+/// image size for JPEG benchmarks
+struct ImageSize
+{
+   unsigned int m_width;   ///< width in pixels
+   unsigned int m_height;  ///< height in pixels
+};
+
+/// image sizes for JPEG benchmarks: live view, screen size and full size
+/// image of a 24 MP camera
+static const ImageSize c_imageSizes[] =
+{
+   { 960, 640 },
+   { 1920, 1280 },
+   { 6000, 4000 },
+};
+
+/// numbers of images for the image type scanner benchmarks
+static const size_t c_numScannedImages[] = { 1000, 10000, 100000 };
+
+/// EXIF tags read for each image; same as in PreviousImagesManager
+static const ExifTag c_exifTags[] =
+{
+   EXIF_TAG_APERTURE_VALUE,
+   EXIF_TAG_SHUTTER_SPEED_VALUE,
+   EXIF_TAG_ISO_SPEED_RATINGS,
+   EXIF_TAG_FOCAL_LENGTH,
+   EXIF_TAG_FLASH,
+   EXIF_TAG_DATE_TIME_ORIGINAL
+};
+
+/// loads file into memory
+static std::vector<BYTE> LoadFile(const CString& filename)
+{
+   FILE* fd = nullptr;
+   if (0 != _tfopen_s(&fd, filename, _T("rb")) || fd == nullptr)
+      throw Exception(_T("couldn't open file: ") + filename, __FILE__, __LINE__);
+
+   std::shared_ptr<FILE> spAutoCloseFile(fd, fclose);
+
+   std::vector<BYTE> data;
+
+   BYTE buffer[64 * 1024];
+   size_t numBytesRead = 0;
+   while ((numBytesRead = fread(buffer, 1, sizeof(buffer), fd)) > 0)
+      data.insert(data.end(), buffer, buffer + numBytesRead);
+
+   return data;
+}
+
+/// adds JPEG decode, EXIF and JFIF rewriter benchmarks for JPEG data
+/// returned by given function
+static void AddJpegBenchmarks(BenchmarkRunner& runner, const CString& nameSuffix,
+   std::function<std::vector<BYTE>()> fnGetJpegData)
+{
+   runner.Add(_T("Logic/JpegDecode/") + nameSuffix,
+      [fnGetJpegData](BenchmarkRunner::Counters& counters)
+      {
+         auto spJpegData = std::make_shared<std::vector<BYTE>>(fnGetJpegData());
+         counters.m_itemsPerIteration = 1;
+         counters.m_bytesPerIteration = spJpegData->size();
+
+         return [spJpegData](size_t numIterations)
+         {
+            for (size_t iteration = 0; iteration < numIterations; iteration++)
+            {
+               JpegMemoryReader reader(*spJpegData);
+               reader.Read();
+
+               BenchmarkRunner::Consume(reader.BitmapData().size());
+            }
+         };
+      });
+
+   runner.Add(_T("Logic/ExifLoad/") + nameSuffix,
+      [fnGetJpegData](BenchmarkRunner::Counters& counters)
+      {
+         auto spJpegData = std::make_shared<std::vector<BYTE>>(fnGetJpegData());
+         counters.m_itemsPerIteration = 1;
+
+         return [spJpegData](size_t numIterations)
+         {
+            for (size_t iteration = 0; iteration < numIterations; iteration++)
+            {
+               Exif::Data data(spJpegData->data(), static_cast<unsigned int>(spJpegData->size()));
+
+               BenchmarkRunner::Consume(data.IsContentIfdAvail(EXIF_IFD_EXIF) ? 1 : 0);
+            }
+         };
+      });
+
+   // loads EXIF data and formats the tags shown for previous images
+   runner.Add(_T("Logic/ExifExtract/") + nameSuffix,
+      [fnGetJpegData](BenchmarkRunner::Counters& counters)
+      {
+         auto spJpegData = std::make_shared<std::vector<BYTE>>(fnGetJpegData());
+         counters.m_itemsPerIteration = 1;
+
+         return [spJpegData](size_t numIterations)
+         {
+            for (size_t iteration = 0; iteration < numIterations; iteration++)
+            {
+               Exif::Data data(spJpegData->data(), static_cast<unsigned int>(spJpegData->size()));
+
+               if (!data.IsContentIfdAvail(EXIF_IFD_EXIF))
+                  throw Exception(_T("image contains no EXIF data"), __FILE__, __LINE__);
+
+               Exif::Content content = data.GetContent(EXIF_IFD_EXIF);
+
+               for (ExifTag tag : c_exifTags)
+               {
+                  if (content.IsEntryAvail(tag))
+                     BenchmarkRunner::Consume(content.GetEntry(tag).GetDisplayValue().GetLength());
+               }
+            }
+         };
+      });
+
+   runner.Add(_T("Logic/JFIFRewriter/") + nameSuffix,
+      [fnGetJpegData](BenchmarkRunner::Counters& counters)
+      {
+         auto spJpegData = std::make_shared<std::vector<BYTE>>(fnGetJpegData());
+         counters.m_bytesPerIteration = spJpegData->size();
+
+         return [spJpegData](size_t numIterations)
+         {
+            for (size_t iteration = 0; iteration < numIterations; iteration++)
+            {
+               Stream::MemoryReadStream streamIn(spJpegData->data(), static_cast<DWORD>(spJpegData->size()));
+               Stream::MemoryStream streamOut;
+
+               // the base class copies all blocks unchanged
+               JFIFRewriter rewriter(streamIn, streamOut);
+               rewriter.Start();
+
+               BenchmarkRunner::Consume(streamOut.GetData().size());
+            }
+         };
+      });
+}
+
+/// adds image type scanner benchmark for given number of images
+static void AddImageTypeScannerBenchmarks(BenchmarkRunner& runner, size_t numImages)
+{
+   CString numImagesText;
+   numImagesText.Format(_T("%zu"), numImages);
+
+   // ScanImages() modifies the passed list, so every iteration scans a copy;
+   // this benchmark measures the copy alone
+   runner.Add(_T("Logic/ImageFileInfoCopy/") + numImagesText,
+      [numImages](BenchmarkRunner::Counters& counters)
+      {
+         auto spImageFileList = std::make_shared<std::vector<ImageFileInfo>>(
+            SyntheticData::CreateImageFileInfos(numImages, 1));
+
+         counters.m_itemsPerIteration = numImages;
+
+         return [spImageFileList](size_t numIterations)
+         {
+            for (size_t iteration = 0; iteration < numIterations; iteration++)
+            {
+               std::vector<ImageFileInfo> imageFileList = *spImageFileList;
+               BenchmarkRunner::Consume(imageFileList.size());
+            }
+         };
+      });
+
+   runner.Add(_T("Logic/ImageTypeScanner/") + numImagesText,
+      [numImages](BenchmarkRunner::Counters& counters)
+      {
+         auto spImageFileList = std::make_shared<std::vector<ImageFileInfo>>(
+            SyntheticData::CreateImageFileInfos(numImages, 1));
+
+         counters.m_itemsPerIteration = numImages;
+
+         return [spImageFileList](size_t numIterations)
+         {
+            ImageTypeScannerOptions options;
+            ImageTypeScanner scanner(options);
+
+            for (size_t iteration = 0; iteration < numIterations; iteration++)
+            {
+               std::vector<ImageFileInfo> imageFileList = *spImageFileList;
+
+               std::vector<ImageTypeFilesList> imageTypeFilesList;
+               scanner.ScanImages(imageFileList, imageTypeFilesList);
+
+               BenchmarkRunner::Consume(imageTypeFilesList.size());
+            }
+         };
+      });
+}
+
+void AddLogicBenchmarks(BenchmarkRunner& runner, const CString& jpegFilename)
+{
+   for (const ImageSize& imageSize : c_imageSizes)
+   {
+      CString sizeText;
+      sizeText.Format(_T("%ux%u"), imageSize.m_width, imageSize.m_height);
+
+      AddJpegBenchmarks(runner, sizeText, [imageSize]()
+      {
+         return SyntheticData::CreateJpegImage(imageSize.m_width, imageSize.m_height, 1);
+      });
+   }
+
+   if (!jpegFilename.IsEmpty())
+   {
+      AddJpegBenchmarks(runner, _T("file"), [jpegFilename]()
+      {
+         return LoadFile(jpegFilename);
+      });
+   }
+
+   for (size_t numImages : c_numScannedImages)
+      AddImageTypeScannerBenchmarks(runner, numImages);
+}
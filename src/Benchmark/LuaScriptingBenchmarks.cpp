@@ -0,0 +1,109 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file LuaScriptingBenchmarks.cpp Benchmarks for the LuaScripting library
+//
+
+// includes
+#include "stdafx.h"
+#include "Benchmarks.hpp"
+#include "BenchmarkRunner.hpp"
+#include "Lua.hpp"
+#include "LuaBinding.hpp"
+
+/// number of calls from Lua to C++ per benchmark iteration
+static const unsigned int c_numCallsPerIteration = 1000;
+
+/// class with method to bind to Lua
+class BenchmarkBindingObject
+{
+public:
+   /// adds two numbers
+   double Add(double a, double b) { return a + b; }
+};
+
+/// Lua script with functions that call the bound C++ functions in a loop
+static const TCHAR c_callLoopScript[] = _T(
+   "function runGeneric(n) local sum = 0; for i = 1, n do sum = addGeneric(sum, 1); end return sum; end\n"
+   "function runTyped(n) local sum = 0; for i = 1, n do sum = addTyped(sum, 1); end return sum; end\n"
+   "function add(a, b) return a + b; end\n");
+
+/// creates Lua state with the bound functions and the call loop script
+static std::shared_ptr<Lua::State> CreateState()
+{
+   auto spState = std::make_shared<Lua::State>();
+   auto spObject = std::make_shared<BenchmarkBindingObject>();
+
+   spState->AddFunction(_T("addGeneric"),
+      [spObject](Lua::State&, const std::vector<Lua::Value>& vecParams)
+      {
+         std::vector<Lua::Value> vecRetValues;
+         vecRetValues.push_back(Lua::Value(
+            spObject->Add(vecParams[0].Get<double>(), vecParams[1].Get<double>())));
+         return vecRetValues;
+      });
+
+   spState->AddFunction<&BenchmarkBindingObject::Add>(_T("addTyped"), spObject);
+
+   spState->LoadSourceString(c_callLoopScript);
+
+   return spState;
+}
+
+/// adds benchmark that calls given Lua function, which calls a C++ function in a loop
+static void AddCallFromLuaBenchmark(BenchmarkRunner& runner, const CString& name, LPCTSTR luaFunctionName)
+{
+   CString functionName = luaFunctionName;
+
+   runner.Add(name,
+      [functionName](BenchmarkRunner::Counters& counters)
+      {
+         std::shared_ptr<Lua::State> spState = CreateState();
+
+         counters.m_itemsPerIteration = c_numCallsPerIteration;
+
+         return [spState, functionName](size_t numIterations)
+         {
+            std::vector<Lua::Value> vecParam;
+            vecParam.push_back(Lua::Value(static_cast<double>(c_numCallsPerIteration)));
+
+            for (size_t iteration = 0; iteration < numIterations; iteration++)
+            {
+               std::vector<Lua::Value> vecRetValues = spState->CallFunction(functionName, 1, vecParam);
+
+               BenchmarkRunner::Consume(static_cast<size_t>(vecRetValues[0].Get<double>()));
+            }
+         };
+      });
+}
+
+void AddLuaScriptingBenchmarks(BenchmarkRunner& runner)
+{
+   // calls from Lua to C++, bound as T_fnCFunction and as typed binding
+   AddCallFromLuaBenchmark(runner, _T("LuaScripting/CallFromLua/Generic"), _T("runGeneric"));
+   AddCallFromLuaBenchmark(runner, _T("LuaScripting/CallFromLua/Typed"), _T("runTyped"));
+
+   // calls from C++ to Lua, e.g. for event handlers
+   runner.Add(_T("LuaScripting/CallFromCpp"),
+      [](BenchmarkRunner::Counters& counters)
+      {
+         std::shared_ptr<Lua::State> spState = CreateState();
+
+         counters.m_itemsPerIteration = 1;
+
+         return [spState](size_t numIterations)
+         {
+            std::vector<Lua::Value> vecParam;
+            vecParam.push_back(Lua::Value(1.0));
+            vecParam.push_back(Lua::Value(2.0));
+
+            for (size_t iteration = 0; iteration < numIterations; iteration++)
+            {
+               std::vector<Lua::Value> vecRetValues = spState->CallFunction(_T("add"), 1, vecParam);
+
+               BenchmarkRunner::Consume(static_cast<size_t>(vecRetValues[0].Get<double>()));
+            }
+         };
+      });
+}
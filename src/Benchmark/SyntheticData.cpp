@@ -0,0 +1,409 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file SyntheticData.cpp Synthetic data generators for benchmarks
+//
+
+// includes
+#include "stdafx.h"
+#include "SyntheticData.hpp"
+#include "Simulated/SimulatedJpegGenerator.hpp"
+#include "NMEA0183/Common.hpp"
+#include <random>
+#include <cmath>
+
+/// TIFF field types used in EXIF data
+enum T_enTiffType
+{
+   tiffTypeAscii = 2,
+   tiffTypeShort = 3,
+   tiffTypeLong = 4,
+   tiffTypeRational = 5,
+   tiffTypeUndefined = 7,
+   tiffTypeSRational = 10,
+};
+
+/// single IFD entry; the value is stored in little endian byte order
+struct TiffEntry
+{
+   WORD m_tag;                ///< tag
+   WORD m_type;               ///< field type
+   DWORD m_count;             ///< number of values
+   std::vector<BYTE> m_value; ///< value bytes
+};
+
+/// appends 16-bit little endian value
+static void AppendWordLE(std::vector<BYTE>& data, unsigned int value)
+{
+   data.push_back(static_cast<BYTE>(value & 0xFF));
+   data.push_back(static_cast<BYTE>((value >> 8) & 0xFF));
+}
+
+/// appends 32-bit little endian value
+static void AppendDwordLE(std::vector<BYTE>& data, unsigned int value)
+{
+   AppendWordLE(data, value & 0xFFFF);
+   AppendWordLE(data, value >> 16);
+}
+
+/// creates ASCII entry; the count includes the terminating zero
+static TiffEntry AsciiEntry(WORD tag, const char* text)
+{
+   TiffEntry entry{ tag, tiffTypeAscii, static_cast<DWORD>(strlen(text) + 1), {} };
+   entry.m_value.assign(text, text + entry.m_count);
+   return entry;
+}
+
+/// creates SHORT entry
+static TiffEntry ShortEntry(WORD tag, unsigned int value)
+{
+   TiffEntry entry{ tag, tiffTypeShort, 1, {} };
+   AppendWordLE(entry.m_value, value);
+   return entry;
+}
+
+/// creates LONG entry
+static TiffEntry LongEntry(WORD tag, unsigned int value)
+{
+   TiffEntry entry{ tag, tiffTypeLong, 1, {} };
+   AppendDwordLE(entry.m_value, value);
+   return entry;
+}
+
+/// creates RATIONAL or SRATIONAL entry
+static TiffEntry RationalEntry(WORD tag, int numerator, int denominator, bool isSigned = false)
+{
+   TiffEntry entry{ tag, static_cast<WORD>(isSigned ? tiffTypeSRational : tiffTypeRational), 1, {} };
+   AppendDwordLE(entry.m_value, static_cast<unsigned int>(numerator));
+   AppendDwordLE(entry.m_value, static_cast<unsigned int>(denominator));
+   return entry;
+}
+
+/// returns size of IFD with given entries, including the value data that
+/// doesn't fit into the entries
+static size_t IfdSize(const std::vector<TiffEntry>& entryList)
+{
+   size_t size = 2 + 12 * entryList.size() + 4;
+
+   for (const TiffEntry& entry : entryList)
+   {
+      if (entry.m_value.size() > 4)
+         size += (entry.m_value.size() + 1) & ~size_t(1);
+   }
+
+   return size;
+}
+
+/// appends IFD with given entries to TIFF data; the entries must be sorted
+/// by tag, and the IFD is written at the current end of the TIFF data
+static void AppendIfd(std::vector<BYTE>& tiffData, const std::vector<TiffEntry>& entryList)
+{
+   size_t valueOffset = tiffData.size() + 2 + 12 * entryList.size() + 4;
+
+   std::vector<BYTE> valueData;
+
+   AppendWordLE(tiffData, static_cast<unsigned int>(entryList.size()));
+
+   for (const TiffEntry& entry : entryList)
+   {
+      AppendWordLE(tiffData, entry.m_tag);
+      AppendWordLE(tiffData, entry.m_type);
+      AppendDwordLE(tiffData, entry.m_count);
+
+      if (entry.m_value.size() <= 4)
+      {
+         // value is stored in the entry itself, left-aligned
+         std::vector<BYTE> value = entry.m_value;
+         value.resize(4, 0);
+         tiffData.insert(tiffData.end(), value.begin(), value.end());
+      }
+      else
+      {
+         AppendDwordLE(tiffData, static_cast<unsigned int>(valueOffset + valueData.size()));
+
+         valueData.insert(valueData.end(), entry.m_value.begin(), entry.m_value.end());
+         if ((valueData.size() & 1) != 0)
+            valueData.push_back(0); // values start at word boundaries
+      }
+   }
+
+   AppendDwordLE(tiffData, 0); // no next IFD
+
+   tiffData.insert(tiffData.end(), valueData.begin(), valueData.end());
+}
+
+std::vector<BYTE> SyntheticData::CreateJpegImage(unsigned int width, unsigned int height, unsigned int seed)
+{
+   std::vector<BYTE> jpegData = Simulated::JpegGenerator::Generate(width, height, seed, 0);
+
+   std::vector<BYTE> exifData = CreateExifData(seed);
+
+   // APP1 segment, inserted right after the SOI marker, like cameras do
+   std::vector<BYTE> segment;
+   segment.push_back(0xFF);
+   segment.push_back(0xE1);
+   segment.push_back(static_cast<BYTE>(((exifData.size() + 2) >> 8) & 0xFF));
+   segment.push_back(static_cast<BYTE>((exifData.size() + 2) & 0xFF));
+   segment.insert(segment.end(), exifData.begin(), exifData.end());
+
+   jpegData.insert(jpegData.begin() + 2, segment.begin(), segment.end());
+
+   return jpegData;
+}
+
+std::vector<BYTE> SyntheticData::CreateExifData(unsigned int seed)
+{
+   // values commonly found in images; the seed selects among them
+   static const unsigned int c_shutterSpeedDenominators[] = { 30, 60, 125, 250, 500, 1000 };
+   static const unsigned int c_apertureTimesTen[] = { 28, 40, 56, 80, 110 };
+   static const unsigned int c_isoSpeeds[] = { 100, 200, 400, 800, 1600 };
+   static const unsigned int c_focalLengths[] = { 17, 24, 35, 50, 85 };
+
+   std::mt19937 random(seed);
+
+   unsigned int shutterSpeedDenominator = c_shutterSpeedDenominators[random() % _countof(c_shutterSpeedDenominators)];
+   unsigned int apertureTimesTen = c_apertureTimesTen[random() % _countof(c_apertureTimesTen)];
+   unsigned int isoSpeed = c_isoSpeeds[random() % _countof(c_isoSpeeds)];
+   unsigned int focalLength = c_focalLengths[random() % _countof(c_focalLengths)];
+   int exposureBiasInThirds = static_cast<int>(random() % 7) - 3;
+
+   char dateTimeOriginal[20];
+   sprintf_s(dateTimeOriginal, "2026:05:%02u %02u:%02u:%02u",
+      1 + seed / 86400 % 28, seed / 3600 % 24, seed / 60 % 60, seed % 60);
+
+   // APEX values, in 1/100 units
+   int shutterSpeedValue = static_cast<int>(std::log2(double(shutterSpeedDenominator)) * 100.0 + 0.5);
+   int apertureValue = static_cast<int>(2.0 * std::log2(apertureTimesTen / 10.0) * 100.0 + 0.5);
+
+   static const BYTE c_exifVersion[] = { '0', '2', '3', '0' };
+   TiffEntry exifVersionEntry{ 0x9000, tiffTypeUndefined, 4,
+      std::vector<BYTE>(c_exifVersion, c_exifVersion + sizeof(c_exifVersion)) };
+
+   std::vector<TiffEntry> exifEntryList
+   {
+      RationalEntry(0x829A, 1, static_cast<int>(shutterSpeedDenominator)), // ExposureTime
+      RationalEntry(0x829D, static_cast<int>(apertureTimesTen), 10), // FNumber
+      ShortEntry(0x8822, 2), // ExposureProgram: normal program
+      ShortEntry(0x8827, isoSpeed), // ISOSpeedRatings
+      exifVersionEntry, // ExifVersion
+      AsciiEntry(0x9003, dateTimeOriginal), // DateTimeOriginal
+      RationalEntry(0x9201, shutterSpeedValue, 100, true), // ShutterSpeedValue
+      RationalEntry(0x9202, apertureValue, 100), // ApertureValue
+      RationalEntry(0x9204, exposureBiasInThirds, 3, true), // ExposureBiasValue
+      ShortEntry(0x9209, 16), // Flash: flash did not fire, compulsory flash suppression
+      RationalEntry(0x920A, static_cast<int>(focalLength), 1), // FocalLength
+      ShortEntry(0xA402, exposureBiasInThirds != 0 ? 2 : 0), // ExposureMode: auto bracket or auto
+   };
+
+   std::vector<TiffEntry> ifd0EntryList
+   {
+      AsciiEntry(0x010F, "RemotePhotoTool"), // Make
+      AsciiEntry(0x0110, "Benchmark Camera"), // Model
+      ShortEntry(0x0112, 1), // Orientation
+      LongEntry(0x8769, 0), // ExifIFDPointer; set below
+   };
+
+   static const size_t c_tiffHeaderSize = 8;
+   unsigned int exifIfdOffset = static_cast<unsigned int>(c_tiffHeaderSize + IfdSize(ifd0EntryList));
+
+   ifd0EntryList.back().m_value.clear();
+   AppendDwordLE(ifd0EntryList.back().m_value, exifIfdOffset);
+
+   std::vector<BYTE> tiffData{ 'I', 'I', 0x2A, 0x00 };
+   AppendDwordLE(tiffData, static_cast<unsigned int>(c_tiffHeaderSize)); // offset of IFD0
+
+   AppendIfd(tiffData, ifd0EntryList);
+   ATLASSERT(tiffData.size() == exifIfdOffset);
+
+   AppendIfd(tiffData, exifEntryList);
+
+   std::vector<BYTE> exifData{ 'E', 'x', 'i', 'f', 0, 0 };
+   exifData.insert(exifData.end(), tiffData.begin(), tiffData.end());
+
+   return exifData;
+}
+
+std::vector<ImageFileInfo> SyntheticData::CreateImageFileInfos(size_t numImages, unsigned int seed)
+{
+   static const double c_apertures[] = { 2.8, 4.0, 5.6, 8.0, 11.0 };
+   static const double c_shutterSpeeds[] = { 1 / 1000.0, 1 / 250.0, 1 / 60.0, 1 / 15.0, 1.0 };
+   static const double c_focalLengths[] = { 17.0, 24.0, 35.0, 50.0, 85.0 };
+
+   std::mt19937 random(seed);
+
+   std::vector<ImageFileInfo> imageFileList;
+   imageFileList.reserve(numImages);
+
+   ATL::CTime time(2026, 5, 1, 8, 0, 0);
+
+   while (imageFileList.size() < numImages)
+   {
+      double aperture = c_apertures[random() % _countof(c_apertures)];
+      double shutterSpeed = c_shutterSpeeds[random() % _countof(c_shutterSpeeds)];
+      double focalLength = c_focalLengths[random() % _countof(c_focalLengths)];
+
+      // mix of 60% single images, 30% AEB HDR images and 10% panorama series
+      unsigned int kind = random() % 10;
+
+      unsigned int numImagesInSet = 1;
+      unsigned int secondsBetweenImages = 1;
+      bool isAutoBracket = false;
+
+      if (kind >= 6 && kind <= 8)
+      {
+         numImagesInSet = kind == 8 ? 5 : 3;
+         isAutoBracket = true;
+      }
+      else if (kind == 9)
+      {
+         numImagesInSet = 3 + random() % 6;
+         secondsBetweenImages = 3;
+      }
+
+      for (unsigned int index = 0; index < numImagesInSet && imageFileList.size() < numImages; index++)
+      {
+         CString filename;
+         filename.Format(_T("IMG_%04u.JPG"), static_cast<unsigned int>(imageFileList.size() % 10000));
+
+         ImageFileInfo image(filename);
+         image.Aperture(aperture);
+         image.ShutterSpeed(shutterSpeed);
+         image.FocalLength(focalLength);
+
+         if (isAutoBracket)
+         {
+            // exposure compensation order of cameras: 0, -, +
+            static const double c_exposureComp3[] = { 0.0, -2.0, 2.0 };
+            static const double c_exposureComp5[] = { 0.0, -1.0, 1.0, -2.0, 2.0 };
+
+            image.AutoBracketMode(true);
+            image.ExposureComp(numImagesInSet == 3 ? c_exposureComp3[index] : c_exposureComp5[index]);
+         }
+
+         image.ImageDateStart(time);
+         image.ImageDateEnd(time + ATL::CTimeSpan(0, 0, 0, static_cast<int>(shutterSpeed)));
+
+         imageFileList.push_back(image);
+
+         time += ATL::CTimeSpan(0, 0, 0, static_cast<int>(secondsBetweenImages));
+      }
+
+      // pause before the next image or set
+      time += ATL::CTimeSpan(0, 0, 0, static_cast<int>(20 + random() % 280));
+   }
+
+   return imageFileList;
+}
+
+/// formats coordinate value in NMEA 0183 format, e.g. "4807.0380,N"
+static CString FormatNmeaCoordinate(double value, bool isLatitude)
+{
+   double absValue = std::abs(value);
+   unsigned int degrees = static_cast<unsigned int>(absValue);
+   double minutes = (absValue - degrees) * 60.0;
+
+   CString text;
+   text.Format(isLatitude ? _T("%02u%07.4f,%c") : _T("%03u%07.4f,%c"),
+      degrees, minutes,
+      isLatitude ? (value < 0.0 ? _T('S') : _T('N')) : (value < 0.0 ? _T('W') : _T('E')));
+
+   return text;
+}
+
+/// adds checksum to sentence, e.g. "$GPGSA,..." becomes "$GPGSA,...*0A"
+static CString AddNmeaChecksum(const CString& sentence)
+{
+   BYTE checksum = NMEA0183::Helper::CalculateChecksum(sentence.GetString() + 1,
+      static_cast<UINT>(sentence.GetLength() - 1));
+
+   CString text;
+   text.Format(_T("%s*%02X"), sentence.GetString(), checksum);
+
+   return text;
+}
+
+std::vector<CString> SyntheticData::CreateNmeaSentences(size_t numSeconds, unsigned int seed)
+{
+   std::mt19937 random(seed);
+
+   std::vector<CString> sentenceList;
+   sentenceList.reserve(numSeconds * 6);
+
+   double latitude = 48.137;
+   double longitude = 11.575;
+
+   for (size_t second = 0; second < numSeconds; second++)
+   {
+      // moving with about 5 km/h in changing directions
+      latitude += ((random() % 201) - 100.0) * 1e-7;
+      longitude += ((random() % 201) - 100.0) * 1e-7;
+
+      unsigned int secondOfDay = static_cast<unsigned int>(second % 86400);
+
+      CString time;
+      time.Format(_T("%02u%02u%02u.00"), secondOfDay / 3600, secondOfDay / 60 % 60, secondOfDay % 60);
+
+      CString date;
+      date.Format(_T("%02u0526"), static_cast<unsigned int>(1 + second / 86400 % 28));
+
+      CString latitudeText = FormatNmeaCoordinate(latitude, true);
+      CString longitudeText = FormatNmeaCoordinate(longitude, false);
+
+      CString sentence;
+      sentence.Format(_T("$GPGGA,%s,%s,%s,1,08,1.03,%.1f,M,47.9,M,,"),
+         time.GetString(), latitudeText.GetString(), longitudeText.GetString(),
+         520.0 + (random() % 100) / 10.0);
+      sentenceList.push_back(AddNmeaChecksum(sentence));
+
+      sentenceList.push_back(AddNmeaChecksum(_T("$GPGSA,A,3,10,07,05,02,29,04,08,13,,,,,1.72,1.03,1.38")));
+
+      sentenceList.push_back(AddNmeaChecksum(_T("$GPGSV,3,1,11,10,63,137,17,07,61,098,15,05,59,290,20,08,54,157,30")));
+      sentenceList.push_back(AddNmeaChecksum(_T("$GPGSV,3,2,11,02,39,223,19,13,28,070,17,26,23,252,,04,14,186,14")));
+      sentenceList.push_back(AddNmeaChecksum(_T("$GPGSV,3,3,11,29,09,301,24,16,09,020,,36,,,")));
+
+      sentence.Format(_T("$GPRMC,%s,A,%s,%s,0.%02u,%u.0,%s,,,A"),
+         time.GetString(), latitudeText.GetString(), longitudeText.GetString(),
+         static_cast<unsigned int>(random() % 100),
+         static_cast<unsigned int>(random() % 360),
+         date.GetString());
+      sentenceList.push_back(AddNmeaChecksum(sentence));
+   }
+
+   return sentenceList;
+}
+
+GPS::Track SyntheticData::CreateTrack(size_t numPoints, unsigned int seed)
+{
+   std::mt19937 random(seed);
+
+   GPS::Track track;
+
+   double latitude = 48.137;
+   double longitude = 11.575;
+
+   for (size_t index = 0; index < numPoints; index++)
+   {
+      latitude += ((random() % 201) - 100.0) * 1e-7;
+      longitude += ((random() % 201) - 100.0) * 1e-7;
+
+      track.AddPoint(GPS::WGS84::Coordinate(latitude, longitude), TimeStamp(index));
+   }
+
+   return track;
+}
+
+DateTime SyntheticData::StartTime()
+{
+   return TimeStamp(0);
+}
+
+DateTime SyntheticData::TimeStamp(size_t seconds)
+{
+   unsigned int day = static_cast<unsigned int>(1 + seconds / 86400);
+   ATLASSERT(day <= 31); // only days in May are supported
+
+   unsigned int secondOfDay = static_cast<unsigned int>(seconds % 86400);
+
+   return DateTime(2026, 5, day, secondOfDay / 3600, secondOfDay / 60 % 60, secondOfDay % 60);
+}
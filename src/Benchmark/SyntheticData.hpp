@@ -0,0 +1,46 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file SyntheticData.hpp Synthetic data generators for benchmarks
+//
+#pragma once
+
+// includes
+#include <vector>
+#include "ImageFileInfo.hpp"
+#include "GPS/Track.hpp"
+
+/// \brief generates synthetic, reproducible data for benchmarks
+/// \details All data only depends on the passed parameters. Random numbers
+/// are taken directly from std::mt19937, whose output is defined by the
+/// standard, and not from the std distributions, whose output differs
+/// between standard library implementations.
+class SyntheticData
+{
+public:
+   /// creates JPEG image with given size, with an APP1 segment containing
+   /// EXIF data; the seed varies image content and EXIF values
+   static std::vector<BYTE> CreateJpegImage(unsigned int width, unsigned int height, unsigned int seed);
+
+   /// creates EXIF data block, as stored in the APP1 segment of JPEG images,
+   /// including the "Exif" header
+   static std::vector<BYTE> CreateExifData(unsigned int seed);
+
+   /// creates image file infos of a photo session, with single images, AEB
+   /// HDR images and panorama series, ordered by image date
+   static std::vector<ImageFileInfo> CreateImageFileInfos(size_t numImages, unsigned int seed);
+
+   /// creates NMEA 0183 sentences as sent by a GPS receiver, for given
+   /// number of seconds, with valid checksums
+   static std::vector<CString> CreateNmeaSentences(size_t numSeconds, unsigned int seed);
+
+   /// creates track with one point per second, starting at StartTime()
+   static GPS::Track CreateTrack(size_t numPoints, unsigned int seed);
+
+   /// returns time stamp of the first point in created tracks
+   static DateTime StartTime();
+
+   /// returns time stamp of given number of seconds after StartTime()
+   static DateTime TimeStamp(size_t seconds);
+};
@@ -0,0 +1,9 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file Benchmark\stdafx.cpp Precompiled header support
+//
+
+// includes
+#include "stdafx.h"
@@ -0,0 +1,19 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file Benchmark\stdafx.h Precompiled header support
+//
+#pragma once
+
+// includes
+#include <SDKDDKVer.h>
+#include <ulib/config/Common.hpp>
+#include <ulib/config/Atl.hpp>
+
+// Standard C++ Library includes
+#include <vector>
+#include <set>
+#include <map>
+#include <memory>
+#include <functional>
@@ -0,0 +1,268 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file BurstRelease.cpp Continuous burst release with queued transfers
+//
+
+// includes
+#include "stdafx.h"
+#include "BurstRelease.hpp"
+#include "CameraException.hpp"
+#include <ulib/thread/LightweightMutex.hpp>
+#include <chrono>
+
+/// \brief state of a burst release
+/// \details The state is shared with the event handlers, so that images
+/// transferred after the BurstRelease object was destroyed don't access a
+/// destroyed object. The remote release control is only referenced weakly,
+/// since the release settings with the transfer handler are stored there.
+struct BurstRelease::BurstState
+{
+   /// ctor
+   BurstState(std::shared_ptr<RemoteReleaseControl> remoteReleaseControl, unsigned int maxQueuedTransfers)
+      :m_remoteReleaseControl(remoteReleaseControl),
+      m_maxQueuedTransfers(maxQueuedTransfers),
+      m_maxNumImages(0),
+      m_isDetached(false)
+   {
+   }
+
+   /// remote release control
+   std::weak_ptr<RemoteReleaseControl> m_remoteReleaseControl;
+
+   /// mutex to protect the members below
+   LightweightMutex m_mutex;
+
+   /// maximum number of images in the download queue
+   unsigned int m_maxQueuedTransfers;
+
+   /// maximum number of images to release; 0 when unlimited
+   unsigned int m_maxNumImages;
+
+   /// indicates that the BurstRelease object was destroyed, and the finished
+   /// transfer handler must not be called anymore
+   bool m_isDetached;
+
+   /// current status
+   Status m_status;
+
+   /// time when the burst was started
+   std::chrono::steady_clock::time_point m_startTime;
+
+   /// time when the burst was stopped
+   std::chrono::steady_clock::time_point m_stopTime;
+
+   /// time when the first image was captured
+   std::chrono::steady_clock::time_point m_firstCaptureTime;
+
+   /// time when the last image was captured
+   std::chrono::steady_clock::time_point m_lastCaptureTime;
+};
+
+BurstRelease::BurstRelease(std::shared_ptr<RemoteReleaseControl> remoteReleaseControl, unsigned int maxQueuedTransfers)
+   :m_burstState(std::make_shared<BurstState>(remoteReleaseControl, maxQueuedTransfers)),
+   m_stateEventHandlerId(-1)
+{
+   if (!remoteReleaseControl->GetCapability(RemoteReleaseControl::capBurstMode))
+      throw CameraException(_T("BurstRelease::BurstRelease"),
+         _T("Camera doesn't support burst mode"), 0, __FILE__, __LINE__);
+
+   m_stateEventHandlerId = remoteReleaseControl->AddStateEventHandler(
+      std::bind(&BurstRelease::OnStateEvent, m_burstState, std::placeholders::_1, std::placeholders::_2));
+}
+
+BurstRelease::~BurstRelease()
+{
+   Stop();
+
+   {
+      LightweightMutex::LockType lock(m_burstState->m_mutex);
+      m_burstState->m_isDetached = true;
+   }
+
+   std::shared_ptr<RemoteReleaseControl> remoteReleaseControl = m_burstState->m_remoteReleaseControl.lock();
+   if (remoteReleaseControl != nullptr && m_stateEventHandlerId != -1)
+      remoteReleaseControl->RemoveStateEventHandler(m_stateEventHandlerId);
+}
+
+/// \details The finished transfer handler of the settings is wrapped, so that
+/// the transferred images are counted.
+void BurstRelease::Start(ShutterReleaseSettings settings, unsigned int maxNumImages)
+{
+   std::shared_ptr<RemoteReleaseControl> remoteReleaseControl = m_burstState->m_remoteReleaseControl.lock();
+   if (remoteReleaseControl == nullptr)
+      return;
+
+   {
+      LightweightMutex::LockType lock(m_burstState->m_mutex);
+
+      m_burstState->m_status = Status();
+      m_burstState->m_status.m_maxQueuedTransfers = m_burstState->m_maxQueuedTransfers;
+      m_burstState->m_status.m_transferImages =
+         (settings.SaveTarget() & ShutterReleaseSettings::saveToHost) != 0;
+      m_burstState->m_status.m_isRunning = true;
+      m_burstState->m_maxNumImages = maxNumImages;
+      m_burstState->m_startTime = std::chrono::steady_clock::now();
+   }
+
+   settings.HandlerOnFinishedTransfer(
+      std::bind(&BurstRelease::OnFinishedTransfer, m_burstState,
+         settings.HandlerOnFinishedTransfer(), std::placeholders::_1));
+
+   remoteReleaseControl->SetReleaseSettings(settings);
+
+   ReleaseNext(*m_burstState);
+}
+
+void BurstRelease::Stop()
+{
+   LightweightMutex::LockType lock(m_burstState->m_mutex);
+
+   if (m_burstState->m_status.m_isRunning)
+   {
+      m_burstState->m_status.m_isRunning = false;
+      m_burstState->m_stopTime = std::chrono::steady_clock::now();
+   }
+}
+
+BurstRelease::Status BurstRelease::GetStatus() const
+{
+   LightweightMutex::LockType lock(m_burstState->m_mutex);
+
+   Status status = m_burstState->m_status;
+
+   std::chrono::steady_clock::time_point endTime =
+      status.m_isRunning ? std::chrono::steady_clock::now() : m_burstState->m_stopTime;
+
+   status.m_elapsedTimeInSeconds =
+      std::chrono::duration<double>(endTime - m_burstState->m_startTime).count();
+
+   if (status.m_numCaptured > 1)
+   {
+      double captureTimeInSeconds = std::chrono::duration<double>(
+         m_burstState->m_lastCaptureTime - m_burstState->m_firstCaptureTime).count();
+
+      if (captureTimeInSeconds > 0.0)
+         status.m_framesPerSecond = (status.m_numCaptured - 1) / captureTimeInSeconds;
+   }
+
+   return status;
+}
+
+void BurstRelease::OnStateEvent(std::shared_ptr<BurstState> burstState,
+   RemoteReleaseControl::T_enStateEvent enStateEvent, unsigned int eventData)
+{
+   if (enStateEvent == RemoteReleaseControl::stateEventCaptureComplete)
+   {
+      {
+         LightweightMutex::LockType lock(burstState->m_mutex);
+
+         // ignore images that were released before the burst was started
+         if (burstState->m_status.m_numCaptured >= burstState->m_status.m_numReleased)
+            return;
+
+         std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+         if (burstState->m_status.m_numCaptured == 0)
+            burstState->m_firstCaptureTime = now;
+
+         burstState->m_lastCaptureTime = now;
+         burstState->m_status.m_numCaptured++;
+      }
+
+      ReleaseNext(*burstState);
+   }
+   else if (enStateEvent == RemoteReleaseControl::stateEventTransferError)
+   {
+      {
+         LightweightMutex::LockType lock(burstState->m_mutex);
+
+         LOG_TRACE(_T("Burst image couldn't be transferred, error %08x\n"), eventData);
+
+         burstState->m_status.m_numFailedTransfers++;
+      }
+
+      ReleaseNext(*burstState);
+   }
+   else if (enStateEvent == RemoteReleaseControl::stateEventReleaseError ||
+      enStateEvent == RemoteReleaseControl::stateEventCameraShutdown)
+   {
+      LightweightMutex::LockType lock(burstState->m_mutex);
+
+      // the outstanding release won't be captured anymore
+      if (enStateEvent == RemoteReleaseControl::stateEventReleaseError &&
+         burstState->m_status.m_numCaptured < burstState->m_status.m_numReleased)
+         burstState->m_status.m_numReleased--;
+
+      if (burstState->m_status.m_isRunning)
+      {
+         LOG_TRACE(_T("Burst stopped after %u images, due to state event %u\n"),
+            burstState->m_status.m_numCaptured, static_cast<unsigned int>(enStateEvent));
+
+         burstState->m_status.m_isRunning = false;
+         burstState->m_stopTime = std::chrono::steady_clock::now();
+      }
+   }
+}
+
+void BurstRelease::OnFinishedTransfer(std::shared_ptr<BurstState> burstState,
+   ShutterReleaseSettings::T_fnOnFinishedTransfer fnOnFinishedTransfer,
+   const ShutterReleaseSettings& settings)
+{
+   bool isDetached = false;
+   {
+      LightweightMutex::LockType lock(burstState->m_mutex);
+      burstState->m_status.m_numTransferred++;
+      isDetached = burstState->m_isDetached;
+   }
+
+   if (fnOnFinishedTransfer != nullptr && !isDetached)
+      fnOnFinishedTransfer(settings);
+
+   ReleaseNext(*burstState);
+}
+
+/// \details Only one release is outstanding at a time; the next image is
+/// released when the camera reported the capture of the previous image, or,
+/// when the download queue was full, when an image was transferred.
+void BurstRelease::ReleaseNext(BurstState& burstState)
+{
+   std::shared_ptr<RemoteReleaseControl> remoteReleaseControl = burstState.m_remoteReleaseControl.lock();
+   if (remoteReleaseControl == nullptr)
+      return;
+
+   {
+      LightweightMutex::LockType lock(burstState.m_mutex);
+
+      Status& status = burstState.m_status;
+
+      if (!status.m_isRunning ||
+         status.m_numCaptured < status.m_numReleased ||
+         status.NumQueuedTransfers() >= burstState.m_maxQueuedTransfers)
+         return;
+
+      if (burstState.m_maxNumImages != 0 && status.m_numReleased >= burstState.m_maxNumImages)
+      {
+         status.m_isRunning = false;
+         burstState.m_stopTime = std::chrono::steady_clock::now();
+         return;
+      }
+
+      status.m_numReleased++;
+   }
+
+   try
+   {
+      remoteReleaseControl->Release();
+   }
+   catch (const CameraException& ex)
+   {
+      LOG_TRACE(_T("Exception while releasing burst image: %s\n"), ex.Message().GetString());
+
+      LightweightMutex::LockType lock(burstState.m_mutex);
+      burstState.m_status.m_numReleased--;
+      burstState.m_status.m_isRunning = false;
+      burstState.m_stopTime = std::chrono::steady_clock::now();
+   }
+}
@@ -101,9 +101,8 @@ cdUInt32 DevicePropertyAccess::GetSize(cdDevicePropertyID propId) const
 /// \note vecData is passed by value, since it is modified in this function anyway
 void DevicePropertyAccess::SetRawCdsdk(Variant& v, unsigned int propId, std::vector<unsigned char> vecData)
 {
-   std::any variant;
+   Variant variant;
    Variant::VariantType enType = Variant::typeInvalid;
-   bool bIsArray = false;
 
    switch (propId)
    {
@@ -124,7 +123,7 @@ void DevicePropertyAccess::SetRawCdsdk(Variant& v, unsigned int propId, std::vec
             (static_cast<unsigned int>(vecData[1]) << 8) |
             (static_cast<unsigned int>(vecData[2]) << 16) |
             (static_cast<unsigned int>(vecData[3]) << 24);
-         variant = uiValue;
+         variant.Set(uiValue);
          enType = Variant::typeUInt32;
       }
       break;
@@ -133,14 +132,14 @@ void DevicePropertyAccess::SetRawCdsdk(Variant& v, unsigned int propId, std::vec
    case cdDEVICE_PROP_UPLOAD_FILE_CAP:
    case cdDEVICE_PROP_ROTATION_CAP:
       ATLASSERT(vecData.size() >= 1);
-      variant = static_cast<bool>(vecData[0] != 0);
+      variant.Set(static_cast<bool>(vecData[0] != 0));
       enType = Variant::typeBool;
       break;
 
       // uint8
    case cdDEVICE_PROP_DIRECT_TRANSFER_STATUS:
       ATLASSERT(vecData.size() >= 1);
-      variant = static_cast<unsigned char>(vecData[0]);
+      variant.Set(static_cast<unsigned char>(vecData[0]));
       enType = Variant::typeUInt8;
       break;
 
@@ -149,16 +148,15 @@ void DevicePropertyAccess::SetRawCdsdk(Variant& v, unsigned int propId, std::vec
    case cdDEVICE_PROP_OWNER_NAME:
    case cdDEVICE_PROP_FIRMWARE_VERSION:
       vecData.push_back(0);
-      variant = CString(reinterpret_cast<const char*>(&vecData[0]));
+      variant.Set(CString(reinterpret_cast<const char*>(&vecData[0])));
       enType = Variant::typeString;
       break;
 
       // custom data, as array of uint8
    case cdDEVICE_PROP_THUMB_VALID_AREA: // this property isn't described in cdType.h, but assume it's an array
    case cdDEVICE_PROP_UNKNOWN1:
-      variant = std::vector<unsigned char>(vecData);
+      variant.SetArray(vecData);
       enType = Variant::typeUInt8;
-      bIsArray = true;
       break;
 
    default:
@@ -166,7 +164,9 @@ void DevicePropertyAccess::SetRawCdsdk(Variant& v, unsigned int propId, std::vec
       break;
    }
 
-   v.SetRaw(variant, enType, bIsArray);
+   variant.SetType(enType);
+
+   v = variant;
 }
 
 void DevicePropertyAccess::GetRawCdsdk(const Variant& v, unsigned int propId, std::vector<unsigned char>& vecData)
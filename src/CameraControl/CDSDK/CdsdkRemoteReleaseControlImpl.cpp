@@ -109,6 +109,10 @@ bool RemoteReleaseControlImpl::GetCapability(RemoteReleaseControl::T_enRemoteCap
    case RemoteReleaseControl::capUILock:
       return false;
 
+   case RemoteReleaseControl::capBurstMode:
+      // images are transferred as part of the release
+      return false;
+
    default:
       ATLASSERT(false);
       break;
@@ -236,6 +240,8 @@ void RemoteReleaseControlImpl::SendCommand(RemoteReleaseControl::T_enCameraComma
 
 void RemoteReleaseControlImpl::Release()
 {
+   RecordReleaseStage(releaseStageRequested);
+
    m_executor->Schedule(std::bind(&RemoteReleaseControlImpl::AsyncRelease, this));
 }
 
@@ -247,6 +253,10 @@ void RemoteReleaseControlImpl::AsyncRelease()
    cdUInt32 numData = 0;
    ReleaseShutter(true, numData);
 
+   // the synchronous release returns when the image was captured
+   RecordReleaseStage(releaseStageCommandSent);
+   RecordReleaseStage(releaseStageCaptureComplete);
+
    DownloadReleasedImage(numData);
 }
 
@@ -260,11 +270,19 @@ void RemoteReleaseControlImpl::DownloadReleasedImage(cdUInt32 numData)
 
    // only save to camera? then return now
    if (settings.SaveTarget() == ShutterReleaseSettings::saveToCamera)
+   {
+      FinishReleaseWithoutTransfer();
       return;
+   }
 
    // read data
    CStringA cszaFilename{ settings.Filename() };
+
+   RecordReleaseStage(releaseStageTransferStarted);
    ReadReleaseData(cszaFilename, numData);
+   RecordReleaseStage(releaseStageTransferFinished);
+
+   RecordReleaseStage(releaseStageFileWritten);
 
    // call finished handler
    ShutterReleaseSettings::T_fnOnFinishedTransfer fnHandler = settings.HandlerOnFinishedTransfer();
@@ -382,6 +400,8 @@ void RemoteReleaseControlImpl::OnReleaseEventCallback(cdReleaseEventID EventID,
 
    case cdRELEASE_EVENT_CHANGED_BY_UI:
       // notify that properties have changed; use 0 as id to signal that all must be updated
+      InvalidateCachedImagePropertyValues(0);
+      InvalidateCurrentImagePropertyValue(0);
       m_subjectPropertyEvent.Call(RemoteReleaseControl::propEventPropertyDescChanged, 0);
       m_subjectPropertyEvent.Call(RemoteReleaseControl::propEventPropertyChanged, 0);
       break;
@@ -443,8 +463,12 @@ void RemoteReleaseControlImpl::OnEventCallback(cdEventID eventId)
    switch (realEventId)
    {
    case cdEVENT_BATTERY_LEVEL_CHANGED:
-      m_subjectPropertyEvent.Call(RemoteReleaseControl::propEventPropertyChanged,
-         MapImagePropertyTypeToId(T_enImagePropertyType::propBatteryLevel));
+      {
+         unsigned int uiImagePropertyId = MapImagePropertyTypeToId(T_enImagePropertyType::propBatteryLevel);
+
+         InvalidateCurrentImagePropertyValue(uiImagePropertyId);
+         m_subjectPropertyEvent.Call(RemoteReleaseControl::propEventPropertyChanged, uiImagePropertyId);
+      }
       break;
 
    case cdEVENT_CF_GATE_CHANGED:
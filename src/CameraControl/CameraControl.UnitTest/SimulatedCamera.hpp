@@ -0,0 +1,49 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file SimulatedCamera.hpp Helper to open the simulated camera in unit tests
+//
+#pragma once
+
+// includes
+#include "CppUnitTest.h"
+#include "Instance.hpp"
+#include "SourceInfo.hpp"
+#include "SourceDevice.hpp"
+
+namespace CameraControlUnitTest
+{
+   /// opens source device of the first simulated camera; the simulated camera
+   /// must be set up with Instance::SetSimulatedCameraSettings() before
+   inline std::shared_ptr<SourceDevice> OpenSimulatedSourceDevice()
+   {
+      std::vector<std::shared_ptr<SourceInfo>> sourceInfoList;
+      Instance::Get().EnumerateDevices(sourceInfoList);
+
+      for (auto spSourceInfo : sourceInfoList)
+      {
+         if (spSourceInfo->DeviceId().Find(_T("simulated:")) == 0)
+            return spSourceInfo->Open();
+      }
+
+      Microsoft::VisualStudio::CppUnitTestFramework::Assert::Fail(_T("simulated camera must be enumerated"));
+      return nullptr;
+   }
+
+   /// opens source devices of all simulated cameras
+   inline std::vector<std::shared_ptr<SourceDevice>> OpenAllSimulatedSourceDevices()
+   {
+      std::vector<std::shared_ptr<SourceInfo>> sourceInfoList;
+      Instance::Get().EnumerateDevices(sourceInfoList);
+
+      std::vector<std::shared_ptr<SourceDevice>> sourceDeviceList;
+      for (auto spSourceInfo : sourceInfoList)
+      {
+         if (spSourceInfo->DeviceId().Find(_T("simulated:")) == 0)
+            sourceDeviceList.push_back(spSourceInfo->Open());
+      }
+
+      return sourceDeviceList;
+   }
+} // namespace CameraControlUnitTest
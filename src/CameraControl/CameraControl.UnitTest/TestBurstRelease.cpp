@@ -0,0 +1,191 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file TestBurstRelease.cpp Tests for BurstRelease class
+//
+
+// includes
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "SimulatedCamera.hpp"
+#include "BurstRelease.hpp"
+#include "SimulatedCameraSettings.hpp"
+#include <ulib/Path.hpp>
+#include <atomic>
+#include <thread>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace CameraControlUnitTest
+{
+   /// tests BurstRelease class, using a simulated camera
+   TEST_CLASS(TestBurstRelease)
+   {
+   public:
+      /// sets up output folder
+      TEST_METHOD_INITIALIZE(SetUp)
+      {
+         m_outputFolder = Path::Combine(Path::TempFolder(), _T("TestBurstRelease"));
+         CreateDirectory(m_outputFolder, nullptr);
+      }
+
+      /// removes simulated camera and transferred images again
+      TEST_METHOD_CLEANUP(TearDown)
+      {
+         m_remoteReleaseControl.reset();
+         m_sourceDevice.reset();
+
+         Instance::SetSimulatedCameraSettings(SimulatedCameraSettings());
+
+         for (const CString& filename : m_transferredFilenames)
+            DeleteFile(filename);
+
+         RemoveDirectory(m_outputFolder);
+      }
+
+      /// tests that the burst stops after the max. number of images, and that
+      /// the download queue never exceeds the max. number of queued transfers
+      TEST_METHOD(TestBurstStopsAfterMaxNumImages)
+      {
+         // set up
+         OpenSimulatedCamera(20);
+
+         BurstRelease burstRelease(m_remoteReleaseControl, 2);
+
+         std::atomic<unsigned int> maxNumQueuedTransfers{ 0 };
+         ShutterReleaseSettings settings = CreateReleaseSettings(m_outputFolder,
+            [&](const ShutterReleaseSettings&)
+         {
+            unsigned int numQueuedTransfers = burstRelease.GetStatus().NumQueuedTransfers();
+            if (numQueuedTransfers > maxNumQueuedTransfers)
+               maxNumQueuedTransfers = numQueuedTransfers;
+         });
+
+         // run
+         burstRelease.Start(settings, 5);
+
+         // check
+         Assert::IsTrue(WaitForBurstFinished(burstRelease), _T("burst must finish"));
+
+         BurstRelease::Status status = burstRelease.GetStatus();
+         Assert::AreEqual(5U, status.m_numReleased, _T("all images must be released"));
+         Assert::AreEqual(5U, status.m_numCaptured, _T("all images must be captured"));
+         Assert::AreEqual(5U, status.m_numTransferred, _T("all images must be transferred"));
+         Assert::AreEqual(0U, status.m_numFailedTransfers, _T("no transfer must fail"));
+         Assert::IsTrue(maxNumQueuedTransfers <= 2, _T("download queue must not exceed the max. number of queued transfers"));
+      }
+
+      /// tests a burst when the camera buffer is smaller than the download queue
+      TEST_METHOD(TestBurstWithSmallCameraBuffer)
+      {
+         // set up
+         OpenSimulatedCamera(1);
+
+         BurstRelease burstRelease(m_remoteReleaseControl, 4);
+         ShutterReleaseSettings settings = CreateReleaseSettings(m_outputFolder, nullptr);
+
+         // run
+         burstRelease.Start(settings, 4);
+
+         // check
+         Assert::IsTrue(WaitForBurstFinished(burstRelease), _T("burst must finish"));
+
+         BurstRelease::Status status = burstRelease.GetStatus();
+         Assert::AreEqual(4U, status.m_numCaptured, _T("all images must be captured"));
+         Assert::AreEqual(4U, status.m_numTransferred, _T("all images must be transferred"));
+      }
+
+      /// tests that failed transfers free the download queue, and the burst continues
+      TEST_METHOD(TestBurstContinuesAfterFailedTransfers)
+      {
+         // set up
+         OpenSimulatedCamera(20);
+
+         BurstRelease burstRelease(m_remoteReleaseControl, 1);
+
+         CString invalidFolder = Path::Combine(m_outputFolder, _T("missing"));
+         ShutterReleaseSettings settings = CreateReleaseSettings(invalidFolder, nullptr);
+
+         // run
+         burstRelease.Start(settings, 3);
+
+         // check
+         Assert::IsTrue(WaitForBurstFinished(burstRelease), _T("burst must finish"));
+
+         BurstRelease::Status status = burstRelease.GetStatus();
+         Assert::AreEqual(3U, status.m_numCaptured, _T("all images must be captured"));
+         Assert::AreEqual(0U, status.m_numTransferred, _T("no image must be transferred"));
+         Assert::AreEqual(3U, status.m_numFailedTransfers, _T("all transfers must fail"));
+         Assert::AreEqual(0U, status.NumQueuedTransfers(), _T("failed transfers must not stay in the download queue"));
+      }
+
+   private:
+      /// opens a simulated camera with small images and the given camera buffer size
+      void OpenSimulatedCamera(unsigned int bufferSizeInImages)
+      {
+         SimulatedCameraSettings settings;
+         settings.m_numCameras = 1;
+         settings.m_imageWidth = 600;
+         settings.m_imageHeight = 400;
+         settings.m_captureLatencyInMilliseconds = 20;
+         settings.m_jitterInMilliseconds = 0;
+         settings.m_bufferSizeInImages = bufferSizeInImages;
+
+         Instance::SetSimulatedCameraSettings(settings);
+
+         m_sourceDevice = OpenSimulatedSourceDevice();
+         m_remoteReleaseControl = m_sourceDevice->EnterReleaseControl();
+      }
+
+      /// creates release settings that transfer images to the given folder
+      ShutterReleaseSettings CreateReleaseSettings(const CString& folder,
+         ShutterReleaseSettings::T_fnOnFinishedTransfer fnOnFinishedTransfer)
+      {
+         ShutterReleaseSettings settings(ShutterReleaseSettings::saveToHost,
+            [this, fnOnFinishedTransfer](const ShutterReleaseSettings& transferSettings)
+         {
+            m_transferredFilenames.push_back(transferSettings.Filename());
+
+            if (fnOnFinishedTransfer != nullptr)
+               fnOnFinishedTransfer(transferSettings);
+         });
+
+         settings.Filename(Path::Combine(folder, _T("burst.jpg")));
+
+         return settings;
+      }
+
+      /// waits until the burst has stopped and all images are transferred, or the timeout elapsed
+      static bool WaitForBurstFinished(const BurstRelease& burstRelease)
+      {
+         for (int i = 0; i < 1000; i++)
+         {
+            BurstRelease::Status status = burstRelease.GetStatus();
+
+            if (!status.m_isRunning &&
+               status.m_numCaptured >= status.m_numReleased &&
+               status.NumQueuedTransfers() == 0)
+               return true;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+         }
+
+         return false;
+      }
+
+   private:
+      /// folder for transferred images
+      CString m_outputFolder;
+
+      /// filenames of transferred images; only accessed by the transfer thread
+      /// while the burst is running
+      std::vector<CString> m_transferredFilenames;
+
+      /// source device of the simulated camera
+      std::shared_ptr<SourceDevice> m_sourceDevice;
+
+      /// remote release control of the simulated camera
+      std::shared_ptr<RemoteReleaseControl> m_remoteReleaseControl;
+   };
+} // namespace CameraControlUnitTest
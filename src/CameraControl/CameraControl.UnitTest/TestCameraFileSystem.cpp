@@ -0,0 +1,68 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file TestCameraFileSystem.cpp Tests for CameraFileSystem class
+//
+
+// includes
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "SimulatedCamera.hpp"
+#include "CameraFileSystem.hpp"
+#include "SimulatedCameraSettings.hpp"
+#include <ulib/thread/Event.hpp>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace CameraControlUnitTest
+{
+   /// tests CameraFileSystem class, using the file system of a simulated camera
+   TEST_CLASS(TestCameraFileSystem)
+   {
+   public:
+      /// sets up a simulated camera
+      TEST_METHOD_INITIALIZE(SetUp)
+      {
+         SimulatedCameraSettings settings;
+         settings.m_numCameras = 1;
+         settings.m_jitterInMilliseconds = 0;
+
+         Instance::SetSimulatedCameraSettings(settings);
+      }
+
+      /// removes simulated camera again
+      TEST_METHOD_CLEANUP(TearDown)
+      {
+         Instance::SetSimulatedCameraSettings(SimulatedCameraSettings());
+      }
+
+      /// tests that the download handler is called when the file doesn't exist
+      TEST_METHOD(TestDownloadMissingFileReportsFailure)
+      {
+         // set up
+         std::shared_ptr<CameraFileSystem> spFileSystem = OpenSimulatedSourceDevice()->GetFileSystem();
+
+         FileInfo fileInfo;
+         fileInfo.m_filename = _T("/DCIM/100SIMUL/MISSING.JPG");
+
+         ManualResetEvent eventFinished{ false };
+         bool handlerSucceeded = true;
+         size_t handlerDataSize = 1;
+
+         // run
+         spFileSystem->StartDownload(fileInfo,
+            [&](const FileInfo&, const std::vector<unsigned char>& data, bool succeeded)
+         {
+            handlerSucceeded = succeeded;
+            handlerDataSize = data.size();
+            eventFinished.Set();
+         });
+
+         // check
+         Assert::IsTrue(eventFinished.Wait(5000), _T("download handler must be called"));
+         Assert::IsFalse(handlerSucceeded, _T("download must be reported as failed"));
+         Assert::AreEqual<size_t>(0, handlerDataSize, _T("data of failed download must be empty"));
+      }
+   };
+} // namespace CameraControlUnitTest
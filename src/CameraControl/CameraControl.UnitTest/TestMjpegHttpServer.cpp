@@ -0,0 +1,183 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file TestMjpegHttpServer.cpp Tests for MjpegHttpServer class
+//
+
+// includes
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "MjpegHttpServer.hpp"
+#include "SingleThreadExecutor.hpp"
+#include "SimulatedCamera.hpp"
+#include "RemoteReleaseControl.hpp"
+#include "Viewfinder.hpp"
+#include "SimulatedCameraSettings.hpp"
+#include <asio.hpp>
+#include <chrono>
+#include <thread>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace CameraControlUnitTest
+{
+   /// tests MjpegHttpServer class, using live view images of a simulated camera
+   TEST_CLASS(TestMjpegHttpServer)
+   {
+   public:
+      /// sets up a simulated camera with a small live view image
+      TEST_METHOD_INITIALIZE(SetUp)
+      {
+         SimulatedCameraSettings settings;
+         settings.m_numCameras = 1;
+         settings.m_viewfinderWidth = 320;
+         settings.m_viewfinderHeight = 240;
+         settings.m_jitterInMilliseconds = 0;
+
+         Instance::SetSimulatedCameraSettings(settings);
+      }
+
+      /// removes simulated camera again
+      TEST_METHOD_CLEANUP(TearDown)
+      {
+         Instance::SetSimulatedCameraSettings(SimulatedCameraSettings());
+      }
+
+      /// opens remote release control of the simulated camera
+      static std::shared_ptr<RemoteReleaseControl> OpenSimulatedReleaseControl()
+      {
+         return OpenSimulatedSourceDevice()->EnterReleaseControl();
+      }
+
+      /// connects to the server on localhost
+      static void Connect(asio::ip::tcp::socket& socket, const MjpegHttpServer& server)
+      {
+         socket.connect(asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), server.Port()));
+      }
+
+      /// sends GET request and reads response header
+      static std::string SendRequest(asio::ip::tcp::socket& socket, asio::streambuf& buffer)
+      {
+         std::string request = "GET / HTTP/1.0\r\n\r\n";
+         asio::write(socket, asio::buffer(request));
+
+         size_t headerLength = asio::read_until(socket, buffer, "\r\n\r\n");
+
+         std::string header(asio::buffers_begin(buffer.data()), asio::buffers_begin(buffer.data()) + headerLength);
+         buffer.consume(headerLength);
+
+         return header;
+      }
+
+      /// waits until the server has the given number of streaming clients, or the timeout elapsed
+      static bool WaitForClientCount(const MjpegHttpServer& server, size_t clientCount)
+      {
+         for (int i = 0; i < 200; i++)
+         {
+            if (server.ClientCount() == clientCount)
+               return true;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+         }
+
+         return false;
+      }
+
+      /// tests streaming live view images from a simulated camera
+      TEST_METHOD(TestStreamLiveView)
+      {
+         // set up
+         std::shared_ptr<RemoteReleaseControl> spReleaseControl = OpenSimulatedReleaseControl();
+
+         SingleThreadExecutor executor(_T("MjpegHttpServer"));
+         MjpegHttpServer server(executor, 0, true);
+
+         std::shared_ptr<Viewfinder> spViewfinder = spReleaseControl->StartViewfinder();
+         spViewfinder->SetAvailImageHandler(
+            std::bind(&MjpegHttpServer::PublishFrame, &server, std::placeholders::_1));
+
+         asio::io_service ioService;
+         asio::ip::tcp::socket socket(ioService);
+         asio::streambuf buffer;
+
+         // run
+         Connect(socket, server);
+         std::string header = SendRequest(socket, buffer);
+
+         size_t partHeaderLength = asio::read_until(socket, buffer, "\r\n\r\n");
+         std::string partHeader(asio::buffers_begin(buffer.data()), asio::buffers_begin(buffer.data()) + partHeaderLength);
+         buffer.consume(partHeaderLength);
+
+         size_t contentLengthPos = partHeader.find("Content-Length: ");
+         Assert::IsTrue(contentLengthPos != std::string::npos, _T("part header must contain content length"));
+
+         size_t contentLength = std::stoul(partHeader.substr(contentLengthPos + 16));
+
+         if (buffer.size() < contentLength)
+            asio::read(socket, buffer, asio::transfer_exactly(contentLength - buffer.size()));
+
+         const unsigned char* jpegData = asio::buffer_cast<const unsigned char*>(buffer.data());
+
+         spViewfinder->SetAvailImageHandler();
+         spViewfinder->Close();
+
+         // check
+         Assert::IsTrue(header.find("200 OK") != std::string::npos, _T("response must be successful"));
+         Assert::IsTrue(header.find("multipart/x-mixed-replace") != std::string::npos, _T("response must be multipart stream"));
+         Assert::IsTrue(contentLength > 2, _T("frame must not be empty"));
+         Assert::IsTrue(jpegData[0] == 0xFF && jpegData[1] == 0xD8, _T("frame must start with JPEG SOI marker"));
+      }
+
+      /// tests that a client that doesn't send a request is disconnected
+      TEST_METHOD(TestRequestTimeout)
+      {
+         // set up
+         SingleThreadExecutor executor(_T("MjpegHttpServer"));
+         MjpegHttpServer server(executor, 0, true, 200);
+
+         asio::io_service ioService;
+         asio::ip::tcp::socket socket(ioService);
+
+         // run
+         Connect(socket, server);
+
+         auto start = std::chrono::steady_clock::now();
+
+         char readBuffer[16];
+         std::error_code ec;
+         size_t length = socket.read_some(asio::buffer(readBuffer), ec);
+
+         auto elapsed = std::chrono::steady_clock::now() - start;
+
+         // check
+         Assert::IsTrue(ec == asio::error::eof || ec == asio::error::connection_reset,
+            _T("server must close the connection"));
+         Assert::AreEqual<size_t>(0, length, _T("server must not send anything"));
+         Assert::IsTrue(elapsed < std::chrono::seconds(5), _T("connection must be closed after the request timeout"));
+      }
+
+      /// tests that a streaming client is removed when it disconnects, even when no frames are sent
+      TEST_METHOD(TestClientDisconnect)
+      {
+         // set up
+         SingleThreadExecutor executor(_T("MjpegHttpServer"));
+         MjpegHttpServer server(executor, 0, true);
+
+         asio::io_service ioService;
+         asio::ip::tcp::socket socket(ioService);
+         asio::streambuf buffer;
+
+         Connect(socket, server);
+         SendRequest(socket, buffer);
+
+         Assert::IsTrue(WaitForClientCount(server, 1), _T("client must be streaming"));
+
+         // run
+         socket.close();
+
+         // check
+         Assert::IsTrue(WaitForClientCount(server, 0), _T("client must be removed after disconnecting"));
+      }
+   };
+}
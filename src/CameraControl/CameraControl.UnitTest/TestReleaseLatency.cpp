@@ -0,0 +1,127 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file TestReleaseLatency.cpp Tests for LatencyHistogram class
+//
+
+// includes
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "ReleaseLatency.hpp"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace CameraControlUnitTest
+{
+   /// tests LatencyHistogram class
+   TEST_CLASS(TestReleaseLatency)
+   {
+   public:
+      /// tests assigning latencies to buckets at the bucket boundaries
+      TEST_METHOD(TestBucketBoundaries)
+      {
+         // run + check
+         Assert::AreEqual<size_t>(0, LatencyHistogram::BucketFromLatency(0.0), _T("zero latency must be in first bucket"));
+         Assert::AreEqual<size_t>(0, LatencyHistogram::BucketFromLatency(0.1), _T("0.1 ms must be in first bucket"));
+         Assert::AreEqual<size_t>(1, LatencyHistogram::BucketFromLatency(0.1001), _T("latency above 0.1 ms must be in second bucket"));
+
+         Assert::AreEqual<size_t>(20, LatencyHistogram::BucketFromLatency(1.0), _T("1 ms must be the upper bound of bucket 20"));
+         Assert::AreEqual<size_t>(21, LatencyHistogram::BucketFromLatency(1.001), _T("latency above 1 ms must be in next bucket"));
+         Assert::AreEqual<size_t>(40, LatencyHistogram::BucketFromLatency(9.99), _T("latency below 10 ms must be in bucket 40"));
+
+         Assert::AreEqual<size_t>(120, LatencyHistogram::BucketFromLatency(99990.0), _T("latency below 100 s must be in last regular bucket"));
+         Assert::AreEqual<size_t>(121, LatencyHistogram::BucketFromLatency(100010.0), _T("latency above 100 s must be in overflow bucket"));
+         Assert::AreEqual<size_t>(121, LatencyHistogram::BucketFromLatency(1e9), _T("very large latency must be in overflow bucket"));
+
+         Assert::AreEqual(0.1, LatencyHistogram::BucketUpperBound(0), 1e-9, _T("upper bound of first bucket must match"));
+         Assert::AreEqual(1.0, LatencyHistogram::BucketUpperBound(20), 1e-9, _T("upper bound of bucket 20 must match"));
+
+         for (size_t bucketIndex = 1; bucketIndex <= 120; bucketIndex++)
+         {
+            double upperBound = LatencyHistogram::BucketUpperBound(bucketIndex);
+
+            Assert::AreEqual(bucketIndex, LatencyHistogram::BucketFromLatency(upperBound * 0.999),
+               _T("latency just below upper bound must be in bucket"));
+            Assert::AreEqual(bucketIndex + 1, LatencyHistogram::BucketFromLatency(upperBound * 1.001),
+               _T("latency just above upper bound must be in next bucket"));
+         }
+      }
+
+      /// tests percentiles of latencies from 1 to 100 ms
+      TEST_METHOD(TestPercentilesOfKnownData)
+      {
+         // set up
+         LatencyHistogram histogram;
+
+         // run
+         for (int latency = 1; latency <= 100; latency++)
+            histogram.Add(latency);
+
+         // check
+         Assert::AreEqual<size_t>(100, histogram.Count(), _T("count must match"));
+         Assert::AreEqual(1.0, histogram.Min(), 1e-9, _T("min must match"));
+         Assert::AreEqual(100.0, histogram.Max(), 1e-9, _T("max must match"));
+         Assert::AreEqual(50.5, histogram.Mean(), 1e-9, _T("mean must match"));
+
+         double p50 = histogram.Percentile(50.0);
+         Assert::IsTrue(p50 >= 50.0 && p50 <= 50.0 * 1.13, _T("p50 must match up to the bucket resolution"));
+
+         double p99 = histogram.Percentile(99.0);
+         Assert::IsTrue(p99 >= 99.0 && p99 <= 100.0, _T("p99 must match up to the bucket resolution"));
+
+         Assert::AreEqual(100.0, histogram.Percentile(100.0), 1e-9, _T("p100 must be the maximum"));
+      }
+
+      /// tests that percentiles are limited to the minimum and maximum latency
+      TEST_METHOD(TestPercentilesClampedToMinMax)
+      {
+         // set up
+         LatencyHistogram histogram;
+
+         // run
+         histogram.Add(5.0);
+         histogram.Add(5.0);
+
+         LatencyHistogram negativeHistogram;
+         negativeHistogram.Add(-1.0);
+
+         // check
+         Assert::AreEqual(5.0, histogram.Percentile(0.0), 1e-9, _T("p0 must be the minimum"));
+         Assert::AreEqual(5.0, histogram.Percentile(50.0), 1e-9, _T("p50 must be clamped to the maximum"));
+         Assert::AreEqual(5.0, histogram.Percentile(99.0), 1e-9, _T("p99 must be clamped to the maximum"));
+
+         Assert::AreEqual(0.0, negativeHistogram.Min(), 1e-9, _T("negative latency must be counted as zero"));
+         Assert::AreEqual(0.0, negativeHistogram.Percentile(50.0), 1e-9, _T("percentile must be clamped to the maximum of zero"));
+      }
+
+      /// tests that latencies above 100 seconds return the maximum latency
+      TEST_METHOD(TestPercentileOfOverflowBucket)
+      {
+         // set up
+         LatencyHistogram histogram;
+
+         // run
+         histogram.Add(10.0);
+         histogram.Add(250000.0);
+         histogram.Add(500000.0);
+
+         // check
+         Assert::AreEqual(10.0, histogram.Percentile(30.0), 1e-9, _T("p30 must be the lowest latency"));
+         Assert::AreEqual(500000.0, histogram.Percentile(50.0), 1e-9, _T("percentile in overflow bucket must be the maximum"));
+         Assert::AreEqual(500000.0, histogram.Percentile(99.0), 1e-9, _T("p99 must be the maximum"));
+      }
+
+      /// tests empty histogram
+      TEST_METHOD(TestEmptyHistogram)
+      {
+         // set up
+         LatencyHistogram histogram;
+
+         // check
+         Assert::AreEqual<size_t>(0, histogram.Count(), _T("count must be zero"));
+         Assert::AreEqual(0.0, histogram.Mean(), 1e-9, _T("mean must be zero"));
+         Assert::AreEqual(0.0, histogram.Percentile(50.0), 1e-9, _T("percentile must be zero"));
+      }
+   };
+} // namespace CameraControlUnitTest
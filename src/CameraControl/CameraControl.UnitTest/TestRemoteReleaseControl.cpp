@@ -0,0 +1,92 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file TestRemoteReleaseControl.cpp Tests for RemoteReleaseControl class
+//
+
+// includes
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "SimulatedCamera.hpp"
+#include "RemoteReleaseControl.hpp"
+#include "SimulatedCameraSettings.hpp"
+#include <ulib/thread/Event.hpp>
+#include <atomic>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace CameraControlUnitTest
+{
+   /// tests RemoteReleaseControl class, using a simulated camera
+   TEST_CLASS(TestRemoteReleaseControl)
+   {
+   public:
+      /// sets up a simulated camera
+      TEST_METHOD_INITIALIZE(SetUp)
+      {
+         SimulatedCameraSettings settings;
+         settings.m_numCameras = 1;
+         settings.m_jitterInMilliseconds = 0;
+
+         Instance::SetSimulatedCameraSettings(settings);
+      }
+
+      /// removes simulated camera again
+      TEST_METHOD_CLEANUP(TearDown)
+      {
+         Instance::SetSimulatedCameraSettings(SimulatedCameraSettings());
+      }
+
+      /// tests that SetImageProperties() sets a value again when it was
+      /// changed on the camera since the last call
+      TEST_METHOD(TestSetImagePropertiesAfterValueChangedOnCamera)
+      {
+         // set up
+         std::shared_ptr<SourceDevice> spSourceDevice = OpenSimulatedSourceDevice();
+         std::shared_ptr<RemoteReleaseControl> spRemoteReleaseControl = spSourceDevice->EnterReleaseControl();
+
+         unsigned int shutterSpeedPropertyId =
+            spRemoteReleaseControl->MapImagePropertyTypeToId(T_enImagePropertyType::propTv);
+
+         const std::vector<ImageProperty>& values =
+            spRemoteReleaseControl->GetCachedImagePropertyValues(shutterSpeedPropertyId)->Values();
+         Assert::IsTrue(values.size() >= 2, _T("shutter speed must have at least two values"));
+
+         std::atomic<unsigned int> numChangedEvents{ 0 };
+         AutoResetEvent eventChanged{ false };
+
+         int handlerId = spRemoteReleaseControl->AddPropertyEventHandler(
+            [&](RemoteReleaseControl::T_enPropertyEvent propertyEvent, unsigned int propertyId)
+         {
+            if (propertyEvent == RemoteReleaseControl::propEventPropertyChanged &&
+               propertyId == shutterSpeedPropertyId)
+            {
+               numChangedEvents++;
+               eventChanged.Set();
+            }
+         });
+
+         auto waitForChangedEvents = [&](unsigned int count)
+         {
+            while (numChangedEvents < count)
+               Assert::IsTrue(eventChanged.Wait(5000), _T("property event must be sent"));
+         };
+
+         spRemoteReleaseControl->SetImageProperties({ values[0] });
+         waitForChangedEvents(1);
+
+         spRemoteReleaseControl->SetImageProperty(values[1]);
+         waitForChangedEvents(2);
+
+         // run
+         spRemoteReleaseControl->SetImageProperties({ values[0] });
+
+         // check
+         Assert::IsTrue(values[0] == spRemoteReleaseControl->GetImageProperty(shutterSpeedPropertyId),
+            _T("value changed on the camera must be set again"));
+
+         spRemoteReleaseControl->RemovePropertyEventHandler(handlerId);
+      }
+   };
+} // namespace CameraControlUnitTest
@@ -0,0 +1,95 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file TestSynchronizedRelease.cpp Tests for SynchronizedRelease class
+//
+
+// includes
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "SimulatedCamera.hpp"
+#include "SynchronizedRelease.hpp"
+#include "SimulatedCameraSettings.hpp"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace CameraControlUnitTest
+{
+   /// tests SynchronizedRelease class, using simulated cameras
+   TEST_CLASS(TestSynchronizedRelease)
+   {
+   public:
+      /// sets up three simulated cameras
+      TEST_METHOD_INITIALIZE(SetUp)
+      {
+         SimulatedCameraSettings settings;
+         settings.m_numCameras = 3;
+         settings.m_jitterInMilliseconds = 0;
+
+         Instance::SetSimulatedCameraSettings(settings);
+
+         m_sourceDeviceList = OpenAllSimulatedSourceDevices();
+         Assert::AreEqual<size_t>(3, m_sourceDeviceList.size(), _T("all simulated cameras must be opened"));
+
+         for (auto spSourceDevice : m_sourceDeviceList)
+            m_remoteReleaseControlList.push_back(spSourceDevice->EnterReleaseControl());
+      }
+
+      /// removes simulated cameras again
+      TEST_METHOD_CLEANUP(TearDown)
+      {
+         m_remoteReleaseControlList.clear();
+         m_sourceDeviceList.clear();
+
+         Instance::SetSimulatedCameraSettings(SimulatedCameraSettings());
+      }
+
+      /// tests that all cameras are released, not before the fire time
+      TEST_METHOD(TestReleaseAllCameras)
+      {
+         // set up
+         SynchronizedRelease synchronizedRelease(m_remoteReleaseControlList);
+
+         // run
+         SynchronizedRelease::Result result = synchronizedRelease.Release();
+
+         // check
+         Assert::AreEqual<size_t>(3, result.m_cameraResultList.size(), _T("there must be a result for each camera"));
+
+         for (const SynchronizedRelease::CameraResult& cameraResult : result.m_cameraResultList)
+         {
+            Assert::IsTrue(cameraResult.m_isTriggered, _T("camera must be triggered"));
+            Assert::IsTrue(cameraResult.m_triggerOffsetInMilliseconds >= 0.0,
+               _T("release command must not be sent before the fire time"));
+         }
+
+         Assert::IsTrue(result.SkewInMilliseconds() >= 0.0, _T("skew must not be negative"));
+      }
+
+      /// tests that a camera that doesn't send the release command after the
+      /// trigger isn't reported as triggered
+      TEST_METHOD(TestReleaseReportsCameraWithoutReleaseCommand)
+      {
+         // set up
+         m_remoteReleaseControlList[1]->Close();
+
+         SynchronizedRelease synchronizedRelease(m_remoteReleaseControlList);
+
+         // run
+         SynchronizedRelease::Result result = synchronizedRelease.Release(500);
+
+         // check
+         Assert::IsTrue(result.m_cameraResultList[0].m_isTriggered, _T("first camera must be triggered"));
+         Assert::IsFalse(result.m_cameraResultList[1].m_isTriggered, _T("closed camera must not be triggered"));
+         Assert::IsTrue(result.m_cameraResultList[2].m_isTriggered, _T("third camera must be triggered"));
+      }
+
+   private:
+      /// source devices of all simulated cameras
+      std::vector<std::shared_ptr<SourceDevice>> m_sourceDeviceList;
+
+      /// remote release controls of all simulated cameras
+      std::vector<std::shared_ptr<RemoteReleaseControl>> m_remoteReleaseControlList;
+   };
+} // namespace CameraControlUnitTest
@@ -0,0 +1,210 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file TestVariant.cpp Tests for Variant class
+//
+
+// includes
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "Variant.hpp"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace CameraControlUnitTest
+{
+   /// tests Variant class
+   TEST_CLASS(TestVariant)
+   {
+   public:
+      /// tests setting and getting values of all scalar types
+      TEST_METHOD(TestSetGetRoundTrip)
+      {
+         Assert::IsTrue(RoundTrip(true), _T("bool value must be returned"));
+         Assert::IsTrue(RoundTrip<char>('x'), _T("char value must be returned"));
+         Assert::IsTrue(RoundTrip<signed char>(-8), _T("signed char value must be returned"));
+         Assert::IsTrue(RoundTrip<unsigned char>(200), _T("unsigned char value must be returned"));
+         Assert::IsTrue(RoundTrip<short>(-1234), _T("short value must be returned"));
+         Assert::IsTrue(RoundTrip<unsigned short>(0xfedc), _T("unsigned short value must be returned"));
+         Assert::IsTrue(RoundTrip<int>(-123456), _T("int value must be returned"));
+         Assert::IsTrue(RoundTrip<unsigned int>(0xfedcba98), _T("unsigned int value must be returned"));
+         Assert::IsTrue(RoundTrip<long long>(-1234567890123LL), _T("long long value must be returned"));
+         Assert::IsTrue(RoundTrip<unsigned long long>(0xfedcba9876543210ULL), _T("unsigned long long value must be returned"));
+         Assert::IsTrue(RoundTrip(1.5f), _T("float value must be returned"));
+         Assert::IsTrue(RoundTrip(-2.25), _T("double value must be returned"));
+         Assert::IsTrue(RoundTrip(CString(_T("abc"))), _T("string value must be returned"));
+
+         Variant::Rational rational = { -1, 3 };
+         Assert::IsTrue(RoundTrip(rational), _T("rational value must be returned"));
+
+         Variant::Point point = { 4, -5 };
+         Assert::IsTrue(RoundTrip(point), _T("point value must be returned"));
+
+         Variant::Rect rect = { 1, 2, 300, 400 };
+         Assert::IsTrue(RoundTrip(rect), _T("rect value must be returned"));
+      }
+
+      /// tests that long and unsigned long are stored as fixed size types
+      TEST_METHOD(TestLongMapping)
+      {
+         // set up
+         Variant value;
+         Variant unsignedValue;
+
+         // run
+         value.Set<long>(-42L);
+         unsignedValue.Set<unsigned long>(42UL);
+
+         // check
+         Assert::AreEqual(-42L, value.Get<long>(), _T("long value must be returned"));
+         Assert::AreEqual(42UL, unsignedValue.Get<unsigned long>(), _T("unsigned long value must be returned"));
+
+         if (sizeof(long) == sizeof(int))
+         {
+            Assert::AreEqual(-42, value.Get<int>(), _T("long value must be stored as int"));
+            Assert::AreEqual(42U, unsignedValue.Get<unsigned int>(), _T("unsigned long value must be stored as unsigned int"));
+         }
+         else
+         {
+            Assert::AreEqual(-42LL, value.Get<long long>(), _T("long value must be stored as long long"));
+            Assert::AreEqual(42ULL, unsignedValue.Get<unsigned long long>(), _T("unsigned long value must be stored as unsigned long long"));
+         }
+      }
+
+      /// tests that getting a value with another type throws
+      TEST_METHOD(TestGetWithOtherTypeThrows)
+      {
+         // set up
+         Variant value;
+         value.Set<unsigned short>(42);
+
+         // run + check
+         try
+         {
+            value.Get<int>();
+         }
+         catch (const std::bad_variant_access&)
+         {
+            return;
+         }
+
+         Assert::Fail(_T("must throw exception"));
+      }
+
+      /// tests arrays that are stored inline and on the heap
+      TEST_METHOD(TestArrayInlineAndHeap)
+      {
+         // set up
+         std::vector<unsigned short> smallArray = { 1, 2, 3 };
+
+         std::vector<unsigned int> largeArray(100);
+         for (size_t index = 0; index < largeArray.size(); index++)
+            largeArray[index] = static_cast<unsigned int>(index * 3);
+
+         std::vector<int> emptyArray;
+
+         Variant smallValue, largeValue, emptyValue;
+
+         // run
+         smallValue.SetArray(smallArray);
+         largeValue.SetArray(largeArray);
+         emptyValue.SetArray(emptyArray);
+
+         Variant largeCopy = largeValue;
+         largeValue.SetArray(smallArray);
+
+         // check
+         Assert::IsTrue(smallValue.IsArray(), _T("value must be an array"));
+         Assert::IsTrue(smallArray == smallValue.GetArray<unsigned short>(), _T("inline array must be returned"));
+         Assert::IsTrue(largeArray == largeCopy.GetArray<unsigned int>(), _T("heap array must be returned, and copy must be unchanged"));
+         Assert::IsTrue(emptyValue.GetArray<int>().empty(), _T("empty array must be returned"));
+      }
+
+      /// tests that byte arrays can be returned as other element types, and other arrays can't
+      TEST_METHOD(TestGetArrayReinterpretsBytes)
+      {
+         // set up
+         std::vector<unsigned char> bytes = { 0x01, 0x00, 0x02, 0x00 };
+         std::vector<unsigned short> words = { 1, 2 };
+
+         Variant byteValue, wordValue;
+         byteValue.SetArray(bytes);
+         wordValue.SetArray(words);
+
+         // run
+         std::vector<unsigned short> bytesAsWords = byteValue.GetArray<unsigned short>();
+
+         // check
+         Assert::AreEqual<size_t>(2, bytesAsWords.size(), _T("byte array must be returned as two words"));
+         Assert::IsTrue(memcmp(bytes.data(), bytesAsWords.data(), bytes.size()) == 0, _T("bytes must be returned unchanged"));
+
+         try
+         {
+            wordValue.GetArray<unsigned int>();
+         }
+         catch (const std::bad_variant_access&)
+         {
+            return;
+         }
+
+         Assert::Fail(_T("getting word array as other element type must throw exception"));
+      }
+
+      /// tests equality operator
+      TEST_METHOD(TestEquality)
+      {
+         // set up
+         Variant intValue, sameIntValue, otherIntValue, otherTypeValue;
+
+         intValue.Set<int>(42);
+         intValue.SetType(Variant::typeInt32);
+
+         sameIntValue.Set<int>(42);
+         sameIntValue.SetType(Variant::typeInt32);
+
+         otherIntValue.Set<int>(43);
+         otherIntValue.SetType(Variant::typeInt32);
+
+         otherTypeValue.Set<int>(42);
+         otherTypeValue.SetType(Variant::typeUInt32);
+
+         Variant stringValue, sameStringValue;
+         stringValue.Set(CString(_T("abc")));
+         stringValue.SetType(Variant::typeString);
+
+         sameStringValue.Set(CString(_T("abc")));
+         sameStringValue.SetType(Variant::typeString);
+
+         Variant arrayValue, sameArrayValue;
+         arrayValue.SetArray(std::vector<int>{ 42 });
+         arrayValue.SetType(Variant::typeInt32);
+
+         sameArrayValue.SetArray(std::vector<int>{ 42 });
+         sameArrayValue.SetType(Variant::typeInt32);
+
+         // check
+         Assert::IsTrue(Variant() == Variant(), _T("empty values must be equal"));
+         Assert::IsTrue(intValue == sameIntValue, _T("same values must be equal"));
+         Assert::IsFalse(intValue == otherIntValue, _T("different values must not be equal"));
+         Assert::IsFalse(intValue == otherTypeValue, _T("values of different variant type must not be equal"));
+         Assert::IsTrue(stringValue == sameStringValue, _T("same strings must be equal"));
+         Assert::IsTrue(arrayValue == sameArrayValue, _T("same arrays must be equal"));
+         Assert::IsFalse(arrayValue == intValue, _T("array must not be equal to scalar value"));
+
+         Assert::IsTrue(intValue.IsValueEqual<int>(sameIntValue), _T("IsValueEqual() must compare values"));
+         Assert::IsFalse(intValue.IsValueEqual<unsigned int>(sameIntValue), _T("IsValueEqual() must not match other stored type"));
+      }
+
+   private:
+      /// sets and gets value, and returns if the value was returned unchanged
+      template <typename T>
+      static bool RoundTrip(const T& value)
+      {
+         Variant variant;
+         variant.Set(value);
+
+         return !variant.IsArray() && variant.Get<T>() == value;
+      }
+   };
+} // namespace CameraControlUnitTest
@@ -0,0 +1,20 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file CameraControl.UnitTest\stdafx.h Precompiled header support
+//
+#pragma once
+
+// includes
+#include <SDKDDKVer.h>
+#include <ulib/config/Common.hpp>
+#include <ulib/config/Atl.hpp>
+#include "CppUnitTest.h"
+
+// Standard C++ Library includes
+#include <vector>
+#include <set>
+#include <map>
+#include <memory>
+#include <functional>
@@ -0,0 +1,87 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file CameraFileSystem.cpp Canon control - Camera file system class
+//
+
+// includes
+#include "stdafx.h"
+#include "CameraFileSystem.hpp"
+#include "CameraException.hpp"
+
+void CameraFileSystem::StartDownloadToFile(const FileInfo& fileInfo, const CString& targetFilename,
+   unsigned long long startOffset,
+   T_fnDownloadProgress fnDownloadProgress,
+   T_fnDownloadToFileFinished fnDownloadFinished)
+{
+   StartDownload(fileInfo,
+      [targetFilename, startOffset, fnDownloadProgress, fnDownloadFinished](
+         const FileInfo& downloadedFileInfo, const std::vector<unsigned char>& data, bool succeeded)
+   {
+      unsigned long long bytesWritten = startOffset;
+
+      if (!succeeded)
+      {
+         if (fnDownloadFinished != nullptr)
+            fnDownloadFinished(downloadedFileInfo, bytesWritten, false);
+
+         return;
+      }
+
+      try
+      {
+         std::shared_ptr<FILE> targetFile = OpenDownloadTargetFile(targetFilename, startOffset);
+
+         if (startOffset < data.size())
+         {
+            size_t size = data.size() - static_cast<size_t>(startOffset);
+            if (fwrite(data.data() + startOffset, 1, size, targetFile.get()) != size)
+               throw CameraException(_T("CameraFileSystem::StartDownloadToFile"),
+                  _T("Couldn't write file: ") + targetFilename, 0, __FILE__, __LINE__);
+
+            bytesWritten += size;
+         }
+      }
+      catch (const CameraException& ex)
+      {
+         LOG_TRACE(_T("Exception while downloading file: %s\n"), ex.Message().GetString());
+
+         if (fnDownloadFinished != nullptr)
+            fnDownloadFinished(downloadedFileInfo, bytesWritten, false);
+
+         return;
+      }
+
+      if (fnDownloadProgress != nullptr)
+         fnDownloadProgress(downloadedFileInfo, bytesWritten);
+
+      if (fnDownloadFinished != nullptr)
+         fnDownloadFinished(downloadedFileInfo, bytesWritten, true);
+   });
+}
+
+void CameraFileSystem::GetThumbnail(const FileInfo& fileInfo, T_fnThumbnailAvailable fnThumbnailAvailable,
+   T_enThumbnailPriority /*priority*/)
+{
+   if (fnThumbnailAvailable != nullptr)
+      fnThumbnailAvailable(fileInfo, std::vector<unsigned char>());
+}
+
+std::shared_ptr<FILE> CameraFileSystem::OpenDownloadTargetFile(const CString& targetFilename, unsigned long long startOffset)
+{
+   FILE* fd = nullptr;
+   errno_t err = _tfopen_s(&fd, targetFilename, startOffset == 0 ? _T("wb") : _T("r+b"));
+   if (err != 0 || fd == nullptr)
+      throw CameraException(_T("CameraFileSystem::OpenDownloadTargetFile"),
+         _T("Couldn't open file: ") + targetFilename, 0, __FILE__, __LINE__);
+
+   std::shared_ptr<FILE> targetFile{ fd, fclose };
+
+   if (startOffset != 0 &&
+      _fseeki64(fd, static_cast<__int64>(startOffset), SEEK_SET) != 0)
+      throw CameraException(_T("CameraFileSystem::OpenDownloadTargetFile"),
+         _T("Couldn't resume download to file: ") + targetFilename, 0, __FILE__, __LINE__);
+
+   return targetFile;
+}
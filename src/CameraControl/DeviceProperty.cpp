@@ -14,6 +14,7 @@
 #include "gPhoto2/GPhoto2PropertyAccess.hpp"
 #include "gPhoto2/GPhoto2SourceDeviceImpl.hpp"
 #include "WIA/WiaPropertyAccess.hpp"
+#include "Simulated/SimulatedPropertyAccess.hpp"
 
 CString DeviceProperty::Name() const
 {
@@ -29,6 +30,7 @@ CString DeviceProperty::Name() const
       case variantGphoto2:
          return std::static_pointer_cast<GPhoto2::PropertyAccess>(m_spImpl)->NameFromId(m_uiPropertyId);
       case variantWia: cszName = WIA::PropertyAccess::NameFromId(m_uiPropertyId); break;
+      case variantSimulated: cszName = Simulated::PropertyAccess::NameFromId(m_uiPropertyId); break;
       default:
          ATLASSERT(false);
          LOG_TRACE(_T("invalid SDK variant in DeviceProperty::Name()\n"));
@@ -61,6 +63,7 @@ CString DeviceProperty::ValueAsString(Variant value) const
       case variantGphoto2:
          return std::static_pointer_cast<GPhoto2::PropertyAccess>(m_spImpl)->DisplayTextFromIdAndValue(m_uiPropertyId, value);
       case variantWia: return value.ToString();
+      case variantSimulated: return Simulated::PropertyAccess::DisplayTextFromIdAndValue(m_uiPropertyId, value);
       default:
          ATLASSERT(false);
          LOG_TRACE(_T("invalid SDK variant in DeviceProperty::ValueAsString()\n"));
@@ -72,9 +75,9 @@ CString DeviceProperty::ValueAsString(Variant value) const
       LOG_TRACE(_T("camera exception in DeviceProperty::ValueAsString(): %s\n"), ex.Message().GetString());
       return CString();
    }
-   catch (const std::bad_any_cast&)
+   catch (const std::bad_variant_access&)
    {
-      LOG_TRACE(_T("bad_any_cast exception in DeviceProperty::ValueAsString()\n"));
+      LOG_TRACE(_T("bad_variant_access exception in DeviceProperty::ValueAsString()\n"));
       return CString();
    }
    catch (...)
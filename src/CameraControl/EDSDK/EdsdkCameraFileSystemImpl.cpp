@@ -100,7 +100,13 @@ void CameraFileSystemImpl::StartDownload(const FileInfo& fileInfo, T_fnDownloadF
    Handle fileHandle = FollowPath(m_hCamera, fileInfo.m_filename, pathLevel);
 
    if (!fileHandle.IsValid())
-      return; // not a file or folder
+   {
+      // not a file or folder
+      if (fnDownloadFinished != nullptr)
+         fnDownloadFinished(fileInfo, std::vector<BYTE>(), false);
+
+      return;
+   }
 
    CString filename;
 
@@ -156,14 +162,15 @@ void CameraFileSystemImpl::StartDownload(const FileInfo& fileInfo, T_fnDownloadF
    err = EdsGetPointer(streamRef, &pData);
    EDSDK::CheckError(_T("EdsGetPointer"), err, __FILE__, __LINE__);
 
+   std::vector<BYTE> imageData;
    if (pData != 0 && length > 0)
    {
-      std::vector<BYTE> imageData;
       const BYTE* pbData = reinterpret_cast<BYTE*>(pData);
       imageData.assign(pbData, pbData + length);
-
-      fnDownloadFinished(fileInfo, imageData);
    }
+
+   if (fnDownloadFinished != nullptr)
+      fnDownloadFinished(fileInfo, imageData, true);
 }
 
 Handle CameraFileSystemImpl::FollowPath(Handle baseElement, const CString& path, unsigned int& pathLevel) const
@@ -350,7 +357,7 @@ std::vector<FileInfo> CameraFileSystemImpl::EnumFiles(const CString& path, const
       {
          FileInfo fileInfo;
          fileInfo.m_filename = path + _T("/") + dirItemInfo.szFileName;
-         fileInfo.m_fileSize = static_cast<unsigned long>(dirItemInfo.size);
+         fileInfo.m_fileSize = dirItemInfo.size;
          fileInfo.m_modifiedTime = dirItemInfo.dateTime;
 
          allFilesList.push_back(fileInfo);
@@ -163,7 +163,7 @@ void Ref::AsyncWaitForCamera(bool bStart, std::function<void()> fnOnCameraConnec
    }
 }
 
-void Ref::OnIdle()
+bool Ref::OnIdle()
 {
    MSG msg = { 0 };
    const unsigned int c_uiMaxMessages = 100;
@@ -180,6 +180,8 @@ void Ref::OnIdle()
       if (err != EDS_ERR_OK && err != EDS_ERR_INTERNAL_ERROR)
          LOG_TRACE(_T("EdsGetEvent() returned %08x\n"), err);
    }
+
+   return uiCountMessages > 0;
 }
 
 void EDSDK::MsgWaitForEvent(ManualResetEvent& evt)
@@ -44,8 +44,8 @@ public:
    /// starts waiting for camera
    virtual void AsyncWaitForCamera(bool bStart, std::function<void()> fnOnCameraConnected = std::function<void()>()) override;
 
-   /// called to do idle processing
-   static void OnIdle();
+   /// called to do idle processing; returns true when SDK messages were processed
+   static bool OnIdle();
 
    /// returns SDK function mutex
    RecursiveMutex& SdkFunctionMutex() { return m_mtxSdkFunctions; }
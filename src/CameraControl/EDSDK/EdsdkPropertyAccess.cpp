@@ -808,44 +808,43 @@ void PropertyAccess::EnumImageIds(std::vector<unsigned int>& vecImageIds)
 
 void PropertyAccess::SetRawEdsdk(Variant& v, unsigned int datatype, std::vector<unsigned char> vecData)
 {
-   std::any variant;
+   Variant variant;
    Variant::VariantType enType = Variant::typeInvalid;
-   bool bIsArray = false;
 
    switch (datatype)
    {
    case kEdsDataType_Bool:
-      variant = vecData[0] != 0;
+      variant.Set(vecData[0] != 0);
       enType = Variant::typeBool;
       break;
 
    case kEdsDataType_String:
       vecData.push_back(0);
-      variant = CString(reinterpret_cast<const char*>(&vecData[0]));
+      variant.Set(CString(reinterpret_cast<const char*>(&vecData[0])));
       enType = Variant::typeString;
       break;
 
    case kEdsDataType_Int8:
-      variant = static_cast<char>(vecData[0]);
+      variant.Set(static_cast<char>(vecData[0]));
       enType = Variant::typeInt8;
       break;
 
    case kEdsDataType_UInt8:
-      variant = static_cast<unsigned char>(vecData[0]);
+      variant.Set(static_cast<unsigned char>(vecData[0]));
       enType = Variant::typeUInt8;
       break;
 
    case kEdsDataType_Int16:
-      variant = static_cast<short>(
+      variant.Set(static_cast<short>(
          static_cast<unsigned short>(vecData[0]) |
-         (static_cast<unsigned short>(vecData[1]) << 8));
+         (static_cast<unsigned short>(vecData[1]) << 8)));
       enType = Variant::typeInt16;
       break;
 
    case kEdsDataType_UInt16:
-      variant =
+      variant.Set(static_cast<unsigned short>(
          static_cast<unsigned short>(vecData[0]) |
-         (static_cast<unsigned short>(vecData[1]) << 8);
+         (static_cast<unsigned short>(vecData[1]) << 8)));
       enType = Variant::typeUInt16;
       break;
 
@@ -856,7 +855,7 @@ void PropertyAccess::SetRawEdsdk(Variant& v, unsigned int datatype, std::vector<
             (static_cast<unsigned int>(vecData[1]) << 8) |
             (static_cast<unsigned int>(vecData[2]) << 16) |
             (static_cast<unsigned int>(vecData[3]) << 24);
-         variant = static_cast<int>(uiValue);
+         variant.Set(static_cast<int>(uiValue));
       }
       enType = Variant::typeInt32;
       break;
@@ -869,7 +868,7 @@ void PropertyAccess::SetRawEdsdk(Variant& v, unsigned int datatype, std::vector<
             (static_cast<unsigned int>(vecData[1]) << 8) |
             (static_cast<unsigned int>(vecData[2]) << 16) |
             (static_cast<unsigned int>(vecData[3]) << 24);
-         variant = uiValue;
+         variant.Set(uiValue);
          enType = Variant::typeUInt32;
       }
       break;
@@ -892,9 +891,8 @@ void PropertyAccess::SetRawEdsdk(Variant& v, unsigned int datatype, std::vector<
             vecValues.push_back(static_cast<int>(uiValue));
          }
 
-         variant = vecValues;
+         variant.SetArray(vecValues);
 
-         bIsArray = true;
          enType = Variant::typeInt32;
       }
       break;
@@ -921,9 +919,8 @@ void PropertyAccess::SetRawEdsdk(Variant& v, unsigned int datatype, std::vector<
    case kEdsDataType_FocusInfo:
    case kEdsDataType_PictureStyleDesc:
       // use all types as vector array
-      variant = std::vector<unsigned char>(vecData);
+      variant.SetArray(vecData);
       enType = Variant::typeUInt8;
-      bIsArray = true;
       break;
 
    default:
@@ -931,7 +928,9 @@ void PropertyAccess::SetRawEdsdk(Variant& v, unsigned int datatype, std::vector<
       break;
    }
 
-   v.SetRaw(variant, enType, bIsArray);
+   variant.SetType(enType);
+
+   v = variant;
 }
 
 void PropertyAccess::GetRawEdsdk(const Variant& v, unsigned int datatype, std::vector<unsigned char>& vecData)
@@ -12,10 +12,15 @@
 
 using namespace EDSDK;
 
+/// interval in which the executor thread dispatches window messages, so that
+/// EDSDK events for commands sent on this thread are delivered while the
+/// thread is idle; same cycle as in EDSDK::MsgWaitForEvent()
+const unsigned int c_uiExecutorMessagePumpIntervalInMilliseconds = 10;
+
 RemoteReleaseControlImpl::RemoteReleaseControlImpl(std::shared_ptr<SourceDevice> spSourceDevice, const Handle& hCamera)
 :m_spSourceDevice(spSourceDevice),
  m_hCamera(hCamera),
- m_executor(new SingleThreadExecutor),
+ m_executor(new SingleThreadExecutor(_T("EDSDK release control thread"), c_uiExecutorMessagePumpIntervalInMilliseconds)),
  m_spMtxLock(new LightweightMutex),
  m_shutterReleaseSettings(ShutterReleaseSettings::saveToCamera), // default is to just save to camera
  m_evtShutterReleaseOccured(false),
@@ -98,6 +103,9 @@ EdsError RemoteReleaseControlImpl::OnPropertyChange_(
 
    prrc->OnPropertyChange(inEvent, inPropertyID, inParam);
 
+   // property events usually come in bursts; let the remaining ones be pumped right away
+   SdkReferenceBase::NotifyEventsPending();
+
    return EDS_ERR_OK;
 }
 
@@ -131,6 +139,9 @@ void RemoteReleaseControlImpl::OnPropertyChange(EdsPropertyEvent inEvent, EdsPro
             RemoteReleaseControl::propEventPropertyChanged :
             RemoteReleaseControl::propEventPropertyDescChanged;
 
+      if (enPropertyEvent == RemoteReleaseControl::propEventPropertyDescChanged)
+         InvalidateCachedImagePropertyValues(uiCombinedPropertyId);
+
       m_subjectPropertyEvent.Call(enPropertyEvent, uiCombinedPropertyId);
    }
    catch (...)
@@ -156,6 +167,8 @@ EdsError RemoteReleaseControlImpl::OnStateChange_(EdsStateEvent inEvent, EdsUInt
 
    prrc->OnStateChange(inEvent, inEventData);
 
+   SdkReferenceBase::NotifyEventsPending();
+
    LOG_TRACE(_T("OnStateChange finished\n"));
 
    return EDS_ERR_OK;
@@ -232,6 +245,9 @@ EdsError RemoteReleaseControlImpl::OnObjectChange_(EdsObjectEvent inEvent, EdsBa
       LOG_TRACE(_T("unknown exception during ObjectEvent handler\n"));
    }
 
+   // e.g. a transfer request is followed by events of the downloaded item
+   SdkReferenceBase::NotifyEventsPending();
+
    LOG_TRACE(_T("OnObjectChange finished\n"));
 
    return EDS_ERR_OK;
@@ -296,6 +312,10 @@ bool RemoteReleaseControlImpl::GetCapability(RemoteReleaseControl::T_enRemoteCap
          // generally supported through kEdsCameraStatusCommand_UILock command
          return true;
 
+      case RemoteReleaseControl::capBurstMode:
+         // not tested yet with continuous shooting
+         return false;
+
       default:
          ATLASSERT(false);
          break;
@@ -357,6 +377,30 @@ void RemoteReleaseControlImpl::SyncSetImageProperty(const ImageProperty& imagePr
       OnPropertyChange(kEdsPropertyEvent_PropertyChanged, kEdsPropID_Evf_Zoom, 0);
 }
 
+/// \details All properties are set in one worker thread task, instead of one
+/// task per property.
+void RemoteReleaseControlImpl::SetImageProperties(const std::vector<ImageProperty>& vecImageProperties)
+{
+   std::vector<ImageProperty> vecCoalescedImageProperties = CoalesceImageProperties(vecImageProperties);
+
+   for (const ImageProperty& imageProperty : vecCoalescedImageProperties)
+   {
+      if (imageProperty.Id() == kEdsPropID_Evf_Zoom)
+         m_uiCurrentZoomPos = imageProperty.Value().Get<unsigned int>();
+   }
+
+   m_executor->Schedule(
+      std::bind(&RemoteReleaseControlImpl::SyncSetImageProperties, this, vecCoalescedImageProperties));
+}
+
+void RemoteReleaseControlImpl::SyncSetImageProperties(const std::vector<ImageProperty>& vecImageProperties)
+{
+   LightweightMutex::LockType lock(*m_spMtxLock);
+
+   for (const ImageProperty& imageProperty : vecImageProperties)
+      SyncSetImageProperty(imageProperty);
+}
+
 std::shared_ptr<Viewfinder> RemoteReleaseControlImpl::StartViewfinder() const
 {
    return std::shared_ptr<Viewfinder>(
@@ -365,7 +409,14 @@ std::shared_ptr<Viewfinder> RemoteReleaseControlImpl::StartViewfinder() const
 
 void RemoteReleaseControlImpl::Release()
 {
-   m_executor->Schedule(std::bind(&RemoteReleaseControlImpl::AsyncRelease, this));
+   RecordReleaseStage(releaseStageRequested);
+
+   m_executor->Schedule(std::bind(&RemoteReleaseControlImpl::AsyncRelease, this, T_fnReleaseTrigger()));
+}
+
+void RemoteReleaseControlImpl::ReleaseOnTrigger(T_fnReleaseTrigger fnReleaseTrigger)
+{
+   m_executor->Schedule(std::bind(&RemoteReleaseControlImpl::AsyncRelease, this, fnReleaseTrigger));
 }
 
 void RemoteReleaseControlImpl::SetSaveToFlag(ShutterReleaseSettings::T_enSaveTarget enSaveTarget, bool bAsynchronous)
@@ -395,7 +446,7 @@ void RemoteReleaseControlImpl::SetCapacity()
    EDSDK::CheckError(_T("EdsSetCapacity"), err, __FILE__, __LINE__);
 }
 
-void RemoteReleaseControlImpl::AsyncRelease()
+void RemoteReleaseControlImpl::AsyncRelease(T_fnReleaseTrigger fnReleaseTrigger)
 {
    m_evtShutterReleaseOccured.Reset();
 
@@ -415,9 +466,24 @@ void RemoteReleaseControlImpl::AsyncRelease()
    EdsError errUILock = EdsSendStatusCommand(m_hCamera.Get(), kEdsCameraStatusCommand_UILock, 0);
    LOG_TRACE(_T("EdsSendCommand(%08x, UILock, 0) returned %08x\n"), m_hCamera.Get(), errUILock);
 
+   // wait for trigger; all preparations are done, so that the picture is taken right away
+   bool bRelease = fnReleaseTrigger == nullptr || fnReleaseTrigger();
+
    // send command
-   EdsError errTakePicture = EdsSendCommand(m_hCamera.Get(), kEdsCameraCommand_TakePicture, 0);
-   LOG_TRACE(_T("EdsSendCommand(%08x, TakePicture, 0) returned %08x\n"), m_hCamera.Get(), errTakePicture);
+   EdsError errTakePicture = EDS_ERR_OK;
+   if (bRelease)
+   {
+      if (fnReleaseTrigger != nullptr)
+         RecordReleaseStage(releaseStageRequested);
+
+      errTakePicture = EdsSendCommand(m_hCamera.Get(), kEdsCameraCommand_TakePicture, 0);
+      LOG_TRACE(_T("EdsSendCommand(%08x, TakePicture, 0) returned %08x\n"), m_hCamera.Get(), errTakePicture);
+
+      if (errTakePicture == EDS_ERR_OK)
+         RecordReleaseStage(releaseStageCommandSent);
+      else
+         FinishReleaseWithoutTransfer();
+   }
 
    // unlock UI
    errUILock = EdsSendStatusCommand(m_hCamera.Get(), kEdsCameraStatusCommand_UIUnLock, 0);
@@ -430,6 +496,8 @@ void RemoteReleaseControlImpl::AsyncRelease()
 
 void RemoteReleaseControlImpl::OnReceivedObjectEventRequestTransfer(Handle hDirectoryItem)
 {
+   RecordReleaseStage(releaseStageCaptureComplete);
+
    // received an event request; put current shutter release settings into queue
    ShutterReleaseSettings settings;
    {
@@ -437,11 +505,15 @@ void RemoteReleaseControlImpl::OnReceivedObjectEventRequestTransfer(Handle hDire
       settings = m_shutterReleaseSettings;
    }
 
+   m_subjectStateEvent.Call(RemoteReleaseControl::stateEventCaptureComplete, 0);
+
    // only save to camera? then return now
    if (settings.SaveTarget() == ShutterReleaseSettings::saveToCamera)
    {
       EdsError err = EdsDownloadCancel(hDirectoryItem);
       LOG_TRACE(_T("EdsDownloadCancel(dirItem = %08x) returned %08x\n"), hDirectoryItem.Get(), err);
+
+      FinishReleaseWithoutTransfer();
       return;
    }
 
@@ -451,7 +523,19 @@ void RemoteReleaseControlImpl::OnReceivedObjectEventRequestTransfer(Handle hDire
 
 void RemoteReleaseControlImpl::AsyncDownloadImage(Handle hDirectoryItem, ShutterReleaseSettings& settings)
 {
-   DownloadImage(hDirectoryItem, settings);
+   try
+   {
+      DownloadImage(hDirectoryItem, settings);
+   }
+   catch (const CameraException& ex)
+   {
+      FinishReleaseWithoutTransfer();
+
+      m_subjectStateEvent.Call(RemoteReleaseControl::stateEventTransferError, ex.ErrorCode());
+      return;
+   }
+
+   RecordReleaseStage(releaseStageFileWritten);
 
    // call finished handler
    ShutterReleaseSettings::T_fnOnFinishedTransfer fnHandler = settings.HandlerOnFinishedTransfer();
@@ -461,6 +545,8 @@ void RemoteReleaseControlImpl::AsyncDownloadImage(Handle hDirectoryItem, Shutter
 
 void RemoteReleaseControlImpl::DownloadImage(Handle hDirectoryItem, ShutterReleaseSettings& settings)
 {
+   RecordReleaseStage(releaseStageTransferStarted);
+
    m_subjectDownloadEvent.Call(RemoteReleaseControl::downloadEventStarted, 0);
 
    try
@@ -518,6 +604,8 @@ void RemoteReleaseControlImpl::DownloadImage(Handle hDirectoryItem, ShutterRelea
    LOG_TRACE(_T("EdsDownloadComplete(dirItem = %08x) returned %08x\n"), hDirectoryItem.Get(), err);
    EDSDK::CheckError(_T("EdsDownloadComplete"), err, __FILE__, __LINE__);
 
+   RecordReleaseStage(releaseStageTransferFinished);
+
    m_subjectDownloadEvent.Call(RemoteReleaseControl::downloadEventFinished, 0);
 }
 
@@ -175,6 +175,8 @@ public:
 
    virtual void SetImageProperty(const ImageProperty& imageProperty) override;
 
+   virtual void SetImageProperties(const std::vector<ImageProperty>& vecImageProperties) override;
+
    virtual void EnumImagePropertyValues(unsigned int uiImageProperty, std::vector<ImageProperty>& vecValues) const override
    {
       PropertyAccess p(m_hCamera);
@@ -239,6 +241,8 @@ public:
 
    virtual void Release() override;
 
+   virtual void ReleaseOnTrigger(T_fnReleaseTrigger fnReleaseTrigger) override;
+
    virtual std::shared_ptr<BulbReleaseControl> StartBulb() override
    {
       return std::shared_ptr<BulbReleaseControl>(new BulbReleaseControlImpl(m_hCamera));
@@ -249,14 +253,17 @@ public:
    /// synchronous method to set image property (called in worker thread by SetImageProperty)
    void SyncSetImageProperty(const ImageProperty& imageProperty);
 
+   /// synchronous method to set multiple image properties (called in worker thread by SetImageProperties)
+   void SyncSetImageProperties(const std::vector<ImageProperty>& vecImageProperties);
+
    /// sets SaveTo flag
    void SetSaveToFlag(ShutterReleaseSettings::T_enSaveTarget enSaveTarget, bool bAsynchronous);
 
    /// sets capacity of host system
    void SetCapacity();
 
-   /// asynchronous release method
-   void AsyncRelease();
+   /// asynchronous release method; waits for the trigger function, if set
+   void AsyncRelease(T_fnReleaseTrigger fnReleaseTrigger);
 
 private:
    /// called when transfer request is received
@@ -11,6 +11,7 @@
 #include "EDSDK/EdsdkPropertyAccess.hpp"
 #include "CDSDK/CdsdkImagePropertyAccess.hpp"
 #include "PSREC/PsrecPropertyAccess.hpp"
+#include "Simulated/SimulatedPropertyAccess.hpp"
 
 CString ImageFormat::ToString() const
 {
@@ -28,6 +29,9 @@ CString ImageFormat::ToString() const
    case T_enSDKVariant::variantGphoto2:
       return m_value.Value().ToString();
 
+   case T_enSDKVariant::variantSimulated:
+      return Simulated::PropertyAccess::DisplayTextFromIdAndValue(m_value.Id(), m_value.Value());
+
    default:
       ATLASSERT(false);
       break;
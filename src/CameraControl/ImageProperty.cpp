@@ -12,6 +12,7 @@
 #include "EDSDK/EdsdkPropertyAccess.hpp"
 #include "PSREC/PsrecPropertyAccess.hpp"
 #include "gPhoto2/GPhoto2PropertyAccess.hpp"
+#include "Simulated/SimulatedPropertyAccess.hpp"
 
 CString ImageProperty::Name() const
 {
@@ -27,6 +28,7 @@ CString ImageProperty::Name() const
       case variantGphoto2:
          cszName = std::static_pointer_cast<GPhoto2::PropertyAccess>(m_spImpl)->NameFromId(m_uiImageProperty); break;
       case variantWia: break;
+      case variantSimulated: cszName = Simulated::PropertyAccess::NameFromId(m_uiImageProperty); break;
       default:
          ATLASSERT(false);
          LOG_TRACE(_T("invalid SDK variant in DeviceProperty::Name()\n"));
@@ -59,6 +61,7 @@ CString ImageProperty::ValueAsString(Variant value) const
       case variantGphoto2:
          return std::static_pointer_cast<GPhoto2::PropertyAccess>(m_spImpl)->DisplayTextFromIdAndValue(m_uiImageProperty, value);
       case variantWia: return CString();
+      case variantSimulated: return Simulated::PropertyAccess::DisplayTextFromIdAndValue(m_uiImageProperty, value);
       default:
          ATLASSERT(false);
          LOG_TRACE(_T("invalid SDK variant in ImageProperty::ValueAsString()\n"));
@@ -70,9 +73,9 @@ CString ImageProperty::ValueAsString(Variant value) const
       LOG_TRACE(_T("camera exception in ImageProperty::ValueAsString(): %s\n"), ex.Message().GetString());
       return CString();
    }
-   catch (const std::bad_any_cast&)
+   catch (const std::bad_variant_access&)
    {
-      LOG_TRACE(_T("bad_any_cast exception in ImageProperty::ValueAsString()\n"));
+      LOG_TRACE(_T("bad_variant_access exception in ImageProperty::ValueAsString()\n"));
       return CString();
    }
    catch (...)
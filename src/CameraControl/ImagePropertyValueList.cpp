@@ -0,0 +1,60 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file ImagePropertyValueList.cpp Canon control - List of valid image property values
+//
+
+// includes
+#include "stdafx.h"
+#include "ImagePropertyValueList.hpp"
+
+ImagePropertyValueList::ImagePropertyValueList(std::vector<ImageProperty> vecValues)
+   :m_vecValues(std::move(vecValues))
+{
+   m_mapRawValueToIndex.reserve(m_vecValues.size());
+
+   for (size_t uiIndex = 0; uiIndex < m_vecValues.size(); uiIndex++)
+   {
+      unsigned int uiRawValue = 0;
+      if (GetRawValue(m_vecValues[uiIndex].Value(), uiRawValue))
+         m_mapRawValueToIndex.insert(std::make_pair(uiRawValue, uiIndex)); // first value wins
+   }
+}
+
+bool ImagePropertyValueList::FindRawValue(unsigned int uiRawValue, size_t& uiIndex) const
+{
+   auto iter = m_mapRawValueToIndex.find(uiRawValue);
+   if (iter == m_mapRawValueToIndex.end())
+      return false;
+
+   uiIndex = iter->second;
+   return true;
+}
+
+bool ImagePropertyValueList::GetRawValue(const Variant& value, unsigned int& uiRawValue)
+{
+   if (value.IsArray())
+      return false;
+
+   try
+   {
+      switch (value.Type())
+      {
+      case Variant::typeInt8: uiRawValue = static_cast<unsigned char>(value.Get<char>()); break;
+      case Variant::typeUInt8: uiRawValue = value.Get<unsigned char>(); break;
+      case Variant::typeInt16: uiRawValue = static_cast<unsigned short>(value.Get<short>()); break;
+      case Variant::typeUInt16: uiRawValue = value.Get<unsigned short>(); break;
+      case Variant::typeInt32: uiRawValue = static_cast<unsigned int>(value.Get<int>()); break;
+      case Variant::typeUInt32: uiRawValue = value.Get<unsigned int>(); break;
+      default:
+         return false;
+      }
+   }
+   catch (const std::bad_variant_access&)
+   {
+      return false;
+   }
+
+   return true;
+}
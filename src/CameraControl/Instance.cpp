@@ -12,6 +12,7 @@
 #include "PSREC/PsrecCommon.hpp"
 #include "gPhoto2/GPhoto2Common.hpp"
 #include "WIA/WiaCommon.hpp"
+#include "Simulated/SimulatedCommon.hpp"
 #include <ulib/thread/LightweightMutex.hpp>
 #include "SingleThreadExecutor.hpp"
 #include "PeriodicExecuteTimer.hpp"
@@ -86,6 +87,7 @@ Instance::Impl::Impl()
    m_allSdkReferences.push_back(std::make_shared<EDSDK::Ref>());
    m_allSdkReferences.push_back(std::make_shared<PSREC::Ref>());
    m_allSdkReferences.push_back(std::make_shared<GPhoto2::Ref>());
+   m_allSdkReferences.push_back(std::make_shared<Simulated::Ref>());
    m_allSdkReferences.push_back(std::make_shared<CDSDK::Ref>());
    m_allSdkReferences.push_back(std::make_shared<WIA::Ref>());
 }
@@ -145,6 +147,33 @@ void Instance::Impl::PollCamera()
 }
 
 
+// SdkReferenceBase
+
+/// mutex to protect s_fnOnEventsPending
+static LightweightMutex s_mtxFnOnEventsPending;
+
+/// function to call when camera events are pending
+static Instance::T_fnOnEventsPending s_fnOnEventsPending;
+
+void SdkReferenceBase::NotifyEventsPending()
+{
+   Instance::T_fnOnEventsPending fnOnEventsPending;
+   {
+      LightweightMutex::LockType lock(s_mtxFnOnEventsPending);
+      fnOnEventsPending = s_fnOnEventsPending;
+   }
+
+   if (fnOnEventsPending != nullptr)
+   try
+   {
+      fnOnEventsPending();
+   }
+   catch (...)
+   {
+   }
+}
+
+
 // Instance
 
 Instance::Instance(std::shared_ptr<Impl> spImpl)
@@ -196,6 +225,11 @@ void Instance::EnableLogging(bool bEnable, const CString& cszLogfilePath)
    LogConfigure(bEnable, cszLogfilePath);
 }
 
+void Instance::SetSimulatedCameraSettings(const SimulatedCameraSettings& settings)
+{
+   Simulated::Ref::SetSettings(settings);
+}
+
 void Instance::OnCameraAddedHandler()
 {
    LightweightMutex::LockType lock(m_spImpl->m_mtxFnOnCameraAdded);
@@ -255,7 +289,13 @@ void Instance::EnumerateDevices(std::vector<std::shared_ptr<SourceInfo>>& source
    }
 }
 
-void Instance::OnIdle()
+bool Instance::OnIdle()
+{
+   return EDSDK::Ref::OnIdle();
+}
+
+void Instance::SetEventsPendingHandler(T_fnOnEventsPending fnOnEventsPending)
 {
-   EDSDK::Ref::OnIdle();
+   LightweightMutex::LockType lock(s_mtxFnOnEventsPending);
+   s_fnOnEventsPending = fnOnEventsPending;
 }
@@ -132,6 +132,10 @@ bool RemoteReleaseControlImpl::GetCapability(RemoteReleaseControl::T_enRemoteCap
       case RemoteReleaseControl::capUILock:
          return false;
 
+      case RemoteReleaseControl::capBurstMode:
+         // images are transferred as part of the release
+         return false;
+
       default:
          ATLASSERT(false);
          break;
@@ -290,6 +294,8 @@ void RemoteReleaseControlImpl::SendCommand(RemoteReleaseControl::T_enCameraComma
 
 void RemoteReleaseControlImpl::Release()
 {
+   RecordReleaseStage(releaseStageRequested);
+
    m_releaseThread->Schedule(std::bind(&RemoteReleaseControlImpl::AsyncRelease, this));
 }
 
@@ -328,16 +334,23 @@ void RemoteReleaseControlImpl::AsyncRelease()
    LOG_TRACE(_T("PR_RC_Release(%08x) returned %08x\n"), m_hCamera, err);
 
    if (err != prOK)
+   {
+      FinishReleaseWithoutTransfer();
       m_subjectStateEvent.Call(RemoteReleaseControl::stateEventReleaseError, 0);
+   }
 
    CheckError(_T("PR_RC_Release"), err, __FILE__, __LINE__);
 
+   RecordReleaseStage(releaseStageCommandSent);
+
    releaseTimer.Stop();
    LOG_TRACE(_T("PR_RC_Release took %u ms\n"), unsigned(releaseTimer.Elapsed() * 1000));
 
    // wait for event
    m_evtReleaseImageReady.Wait();
 
+   RecordReleaseStage(releaseStageCaptureComplete);
+
    try
    {
       StartImageDownload(m_hReleaseImage, true);
@@ -565,8 +578,12 @@ void RemoteReleaseControlImpl::OnEventPropertyChanged(prUInt16 propId, bool bAls
          std::for_each(vecChangedProperties.begin(), vecChangedProperties.end(), [&](std::vector<prUInt16>::value_type& val)
          {
             if (bAlsoUpdateDescription)
+            {
+               InvalidateCachedImagePropertyValues(val);
                m_subjectPropertyEvent.Call(RemoteReleaseControl::propEventPropertyDescChanged, val);
+            }
 
+            InvalidateCurrentImagePropertyValue(val);
             m_subjectPropertyEvent.Call(RemoteReleaseControl::propEventPropertyChanged, val);
          });
          return;
@@ -576,8 +593,12 @@ void RemoteReleaseControlImpl::OnEventPropertyChanged(prUInt16 propId, bool bAls
    try
    {
       if (bAlsoUpdateDescription)
+      {
+         InvalidateCachedImagePropertyValues(propId);
          m_subjectPropertyEvent.Call(RemoteReleaseControl::propEventPropertyDescChanged, propId);
+      }
 
+      InvalidateCurrentImagePropertyValue(propId);
       m_subjectPropertyEvent.Call(RemoteReleaseControl::propEventPropertyChanged, propId);
    }
    catch (...)
@@ -620,6 +641,8 @@ void RemoteReleaseControlImpl::OnEventStateChanged(prUInt16 code)
 
 void RemoteReleaseControlImpl::StartImageDownload(prObjectHandle hObject, bool bFullView)
 {
+   RecordReleaseStage(releaseStageTransferStarted);
+
    m_subjectDownloadEvent.Call(RemoteReleaseControl::downloadEventStarted, 0);
 
    m_evtReleaseImageTransferInProgress.Set(); // start transfer progress
@@ -709,6 +732,10 @@ void RemoteReleaseControlImpl::OnFinishedDownloadImageData()
    fclose(m_fdImageTransfer);
    m_fdImageTransfer = nullptr;
 
+   // the data is written to the file while transferring
+   RecordReleaseStage(releaseStageTransferFinished);
+   RecordReleaseStage(releaseStageFileWritten);
+
    // need to set this before notifying client
    m_evtReleaseImageTransferDone.Set();
 
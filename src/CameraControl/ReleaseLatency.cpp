@@ -0,0 +1,126 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file ReleaseLatency.cpp Canon control - Release latency statistics
+//
+
+// includes
+#include "stdafx.h"
+#include "ReleaseLatency.hpp"
+#include <cmath>
+
+/// upper bound of the first bucket, in milliseconds
+const double c_firstBucketUpperBound = 0.1;
+
+/// number of buckets per decade
+const size_t c_numBucketsPerDecade = 20;
+
+/// number of buckets; a first bucket for latencies up to 0.1 ms, six decades
+/// of buckets for latencies up to 100 seconds, and a last bucket for all
+/// larger latencies
+const size_t c_numBuckets = 6 * c_numBucketsPerDecade + 2;
+
+LatencyHistogram::LatencyHistogram()
+   :m_bucketCountList(c_numBuckets, 0),
+   m_count(0),
+   m_min(0.0),
+   m_max(0.0),
+   m_sum(0.0)
+{
+}
+
+void LatencyHistogram::Add(double latencyInMilliseconds)
+{
+   if (latencyInMilliseconds < 0.0)
+      latencyInMilliseconds = 0.0;
+
+   m_bucketCountList[BucketFromLatency(latencyInMilliseconds)]++;
+
+   if (m_count == 0 || latencyInMilliseconds < m_min)
+      m_min = latencyInMilliseconds;
+
+   if (m_count == 0 || latencyInMilliseconds > m_max)
+      m_max = latencyInMilliseconds;
+
+   m_count++;
+   m_sum += latencyInMilliseconds;
+}
+
+/// \details The upper bound of the bucket containing the percentile is
+/// returned, limited to the range of the actual latencies. The last bucket
+/// has no upper bound, so the maximum latency is returned for it.
+double LatencyHistogram::Percentile(double percentile) const
+{
+   if (m_count == 0)
+      return 0.0;
+
+   size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * m_count));
+   rank = std::max<size_t>(1, std::min(rank, m_count));
+
+   size_t cumulativeCount = 0;
+   for (size_t bucketIndex = 0; bucketIndex < c_numBuckets; bucketIndex++)
+   {
+      cumulativeCount += m_bucketCountList[bucketIndex];
+
+      if (cumulativeCount >= rank)
+      {
+         if (bucketIndex == c_numBuckets - 1)
+            return m_max;
+
+         return std::max(m_min, std::min(m_max, BucketUpperBound(bucketIndex)));
+      }
+   }
+
+   return m_max;
+}
+
+size_t LatencyHistogram::BucketFromLatency(double latencyInMilliseconds)
+{
+   if (latencyInMilliseconds <= c_firstBucketUpperBound)
+      return 0;
+
+   double bucketIndex = std::ceil(std::log10(latencyInMilliseconds / c_firstBucketUpperBound) * c_numBucketsPerDecade);
+
+   return std::min(static_cast<size_t>(bucketIndex), c_numBuckets - 1);
+}
+
+double LatencyHistogram::BucketUpperBound(size_t bucketIndex)
+{
+   return c_firstBucketUpperBound * std::pow(10.0, double(bucketIndex) / c_numBucketsPerDecade);
+}
+
+ReleaseLatencyStatistics::ReleaseLatencyStatistics()
+   :m_histogramList(releaseStageMax)
+{
+}
+
+void ReleaseLatencyStatistics::Add(T_enReleaseStage stage, double latencyInMilliseconds)
+{
+   ATLASSERT(stage < releaseStageMax);
+
+   m_histogramList[stage].Add(latencyInMilliseconds);
+}
+
+const LatencyHistogram& ReleaseLatencyStatistics::Histogram(T_enReleaseStage stage) const
+{
+   ATLASSERT(stage < releaseStageMax);
+
+   return m_histogramList[stage];
+}
+
+LPCTSTR ReleaseLatencyStatistics::StageName(T_enReleaseStage stage)
+{
+   switch (stage)
+   {
+   case releaseStageRequested: return _T("releaseRequested");
+   case releaseStageCommandSent: return _T("commandSent");
+   case releaseStageCaptureComplete: return _T("captureComplete");
+   case releaseStageTransferStarted: return _T("transferStarted");
+   case releaseStageTransferFinished: return _T("transferFinished");
+   case releaseStageFileWritten: return _T("fileWritten");
+   default:
+      ATLASSERT(false);
+      return _T("???");
+   }
+}
@@ -0,0 +1,354 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file RemoteReleaseControl.cpp Canon control - Remote release control
+//
+
+// includes
+#include "stdafx.h"
+#include "RemoteReleaseControl.hpp"
+#include <ulib/thread/LightweightMutex.hpp>
+#include <chrono>
+#include <deque>
+
+/// max. number of pending shots; older shots are dropped, e.g. when the camera
+/// never reports a transfer
+const size_t c_maxPendingShots = 32;
+
+/// \brief cache for possible image property values, and for the current
+/// values set with SetImageProperties()
+/// \details The values are enumerated outside of the lock, since enumerating
+/// may take a while. A generation counter ensures that values enumerated
+/// while the cache was invalidated are not stored. The same is done for
+/// current values that change on the camera while they are being set.
+class RemoteReleaseControl::ImagePropertyValueCache
+{
+public:
+   /// ctor
+   ImagePropertyValueCache()
+      :m_uiGeneration(0),
+      m_uiCurrentValueGeneration(0)
+   {
+   }
+
+   /// returns cached value list, or nullptr when not cached; also returns current generation
+   std::shared_ptr<const ImagePropertyValueList> Find(unsigned int uiImagePropertyId, unsigned int& uiGeneration) const
+   {
+      LightweightMutex::LockType lock(m_mtxLock);
+
+      uiGeneration = m_uiGeneration;
+
+      auto iter = m_mapValueLists.find(uiImagePropertyId);
+      return iter != m_mapValueLists.end() ? iter->second : nullptr;
+   }
+
+   /// stores value list, when the cache wasn't invalidated since given generation
+   void Store(unsigned int uiImagePropertyId, unsigned int uiGeneration,
+      std::shared_ptr<const ImagePropertyValueList> spValueList)
+   {
+      LightweightMutex::LockType lock(m_mtxLock);
+
+      if (uiGeneration == m_uiGeneration)
+         m_mapValueLists[uiImagePropertyId] = spValueList;
+   }
+
+   /// invalidates value list of given image property, or all lists when 0 is passed
+   void Invalidate(unsigned int uiImagePropertyId)
+   {
+      LightweightMutex::LockType lock(m_mtxLock);
+
+      if (uiImagePropertyId == 0)
+         m_mapValueLists.clear();
+      else
+         m_mapValueLists.erase(uiImagePropertyId);
+
+      m_uiGeneration++;
+   }
+
+   /// returns if the image property is known to have given value on the camera;
+   /// also returns current value generation
+   bool IsCurrentValue(const ImageProperty& imageProperty, unsigned int& uiCurrentValueGeneration) const
+   {
+      LightweightMutex::LockType lock(m_mtxLock);
+
+      uiCurrentValueGeneration = m_uiCurrentValueGeneration;
+
+      auto iter = m_mapCurrentValues.find(imageProperty.Id());
+      return iter != m_mapCurrentValues.end() && iter->second == imageProperty;
+   }
+
+   /// stores current value, when no current value was invalidated since given generation
+   void StoreCurrentValue(const ImageProperty& imageProperty, unsigned int uiCurrentValueGeneration)
+   {
+      LightweightMutex::LockType lock(m_mtxLock);
+
+      if (uiCurrentValueGeneration == m_uiCurrentValueGeneration)
+         m_mapCurrentValues.insert_or_assign(imageProperty.Id(), imageProperty);
+   }
+
+   /// invalidates current value of given image property, or all values when 0 is passed
+   void InvalidateCurrentValue(unsigned int uiImagePropertyId)
+   {
+      LightweightMutex::LockType lock(m_mtxLock);
+
+      if (uiImagePropertyId == 0)
+         m_mapCurrentValues.clear();
+      else
+         m_mapCurrentValues.erase(uiImagePropertyId);
+
+      m_uiCurrentValueGeneration++;
+   }
+
+private:
+   /// mutex to protect the maps and generations
+   mutable LightweightMutex m_mtxLock;
+
+   /// cached value lists, by image property id
+   std::map<unsigned int, std::shared_ptr<const ImagePropertyValueList>> m_mapValueLists;
+
+   /// generation; incremented on every invalidation
+   unsigned int m_uiGeneration;
+
+   /// current values, as set by SetImageProperties(), by image property id
+   std::map<unsigned int, ImageProperty> m_mapCurrentValues;
+
+   /// current value generation; incremented on every invalidation of a current value
+   unsigned int m_uiCurrentValueGeneration;
+};
+
+/// \brief records release latencies
+/// \details Shots are assumed to pass all stages in the order they were
+/// released, so that each stage is assigned to the oldest pending shot that
+/// didn't reach the stage yet.
+class RemoteReleaseControl::ReleaseLatencyRecorder
+{
+public:
+   /// records release stage
+   void Record(T_enReleaseStage enReleaseStage)
+   {
+      std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+      T_fnReleaseCommandSent fnReleaseCommandSent;
+
+      {
+         LightweightMutex::LockType lock(m_mtxLock);
+
+         if (enReleaseStage == releaseStageRequested)
+         {
+            if (m_deqPendingShots.size() >= c_maxPendingShots)
+               m_deqPendingShots.pop_front();
+
+            PendingShot shot;
+            shot.m_requestTime = now;
+            shot.m_uiReachedStages = 1 << releaseStageRequested;
+            shot.m_fnReleaseCommandSent.swap(m_fnNextReleaseCommandSent);
+
+            m_deqPendingShots.push_back(shot);
+            m_statistics.Add(releaseStageRequested, 0.0);
+            return;
+         }
+
+         auto iter = std::find_if(m_deqPendingShots.begin(), m_deqPendingShots.end(),
+            [enReleaseStage](const PendingShot& shot) { return (shot.m_uiReachedStages & (1 << enReleaseStage)) == 0; });
+
+         if (iter == m_deqPendingShots.end())
+            return; // e.g. released using the camera's shutter button
+
+         iter->m_uiReachedStages |= 1 << enReleaseStage;
+
+         m_statistics.Add(enReleaseStage,
+            std::chrono::duration<double, std::milli>(now - iter->m_requestTime).count());
+
+         if (enReleaseStage == releaseStageCommandSent)
+            fnReleaseCommandSent.swap(iter->m_fnReleaseCommandSent);
+
+         if (enReleaseStage == releaseStageFileWritten)
+            m_deqPendingShots.erase(iter);
+      }
+
+      // called outside the lock, since the function may block or record stages itself
+      if (fnReleaseCommandSent != nullptr)
+         fnReleaseCommandSent();
+   }
+
+   /// sets function that is called when the release command of the next
+   /// requested shot was sent
+   void SetNextReleaseCommandSent(T_fnReleaseCommandSent fnReleaseCommandSent)
+   {
+      LightweightMutex::LockType lock(m_mtxLock);
+
+      m_fnNextReleaseCommandSent = fnReleaseCommandSent;
+   }
+
+   /// finishes oldest pending shot
+   void FinishOldestShot()
+   {
+      LightweightMutex::LockType lock(m_mtxLock);
+
+      if (!m_deqPendingShots.empty())
+         m_deqPendingShots.pop_front();
+   }
+
+   /// returns statistics
+   ReleaseLatencyStatistics Statistics() const
+   {
+      LightweightMutex::LockType lock(m_mtxLock);
+      return m_statistics;
+   }
+
+   /// resets statistics
+   void Reset()
+   {
+      LightweightMutex::LockType lock(m_mtxLock);
+
+      m_statistics = ReleaseLatencyStatistics();
+      m_deqPendingShots.clear();
+   }
+
+private:
+   /// shot that didn't reach all stages yet
+   struct PendingShot
+   {
+      /// time of release request
+      std::chrono::steady_clock::time_point m_requestTime;
+
+      /// bit mask of reached stages
+      unsigned int m_uiReachedStages;
+
+      /// function to call when the release command was sent; may be empty
+      T_fnReleaseCommandSent m_fnReleaseCommandSent;
+   };
+
+   /// mutex to protect pending shots and statistics
+   mutable LightweightMutex m_mtxLock;
+
+   /// pending shots, oldest first
+   std::deque<PendingShot> m_deqPendingShots;
+
+   /// function to call when the release command of the next requested shot was sent
+   T_fnReleaseCommandSent m_fnNextReleaseCommandSent;
+
+   /// statistics
+   ReleaseLatencyStatistics m_statistics;
+};
+
+RemoteReleaseControl::RemoteReleaseControl()
+   :m_spImagePropertyValueCache(std::make_shared<ImagePropertyValueCache>()),
+   m_spReleaseLatencyRecorder(std::make_shared<ReleaseLatencyRecorder>())
+{
+}
+
+/// \details Properties that were set to the same value by a previous call
+/// are skipped, so that a bracketing shot only sends the values that change.
+/// The camera isn't asked for the current values, since that would cost a
+/// round trip per property; properties without a known current value are
+/// always set. A known value is forgotten as soon as the camera reports that
+/// the property changed, e.g. because the dial was turned.
+void RemoteReleaseControl::SetImageProperties(const std::vector<ImageProperty>& vecImageProperties)
+{
+   std::vector<ImageProperty> vecCoalescedImageProperties = CoalesceImageProperties(vecImageProperties);
+
+   for (const ImageProperty& imageProperty : vecCoalescedImageProperties)
+   {
+      unsigned int uiCurrentValueGeneration = 0;
+      if (m_spImagePropertyValueCache->IsCurrentValue(imageProperty, uiCurrentValueGeneration))
+         continue;
+
+      SetImageProperty(imageProperty);
+
+      m_spImagePropertyValueCache->StoreCurrentValue(imageProperty, uiCurrentValueGeneration);
+   }
+}
+
+std::shared_ptr<const ImagePropertyValueList> RemoteReleaseControl::GetCachedImagePropertyValues(unsigned int uiImagePropertyId) const
+{
+   unsigned int uiGeneration = 0;
+   std::shared_ptr<const ImagePropertyValueList> spValueList =
+      m_spImagePropertyValueCache->Find(uiImagePropertyId, uiGeneration);
+
+   if (spValueList != nullptr)
+      return spValueList;
+
+   std::vector<ImageProperty> vecValues;
+   EnumImagePropertyValues(uiImagePropertyId, vecValues);
+
+   spValueList = std::make_shared<const ImagePropertyValueList>(std::move(vecValues));
+
+   m_spImagePropertyValueCache->Store(uiImagePropertyId, uiGeneration, spValueList);
+
+   return spValueList;
+}
+
+void RemoteReleaseControl::InvalidateCachedImagePropertyValues(unsigned int uiImagePropertyId)
+{
+   m_spImagePropertyValueCache->Invalidate(uiImagePropertyId);
+}
+
+void RemoteReleaseControl::InvalidateCurrentImagePropertyValue(unsigned int uiImagePropertyId)
+{
+   m_spImagePropertyValueCache->InvalidateCurrentValue(uiImagePropertyId);
+}
+
+ReleaseLatencyStatistics RemoteReleaseControl::GetReleaseLatencyStatistics() const
+{
+   return m_spReleaseLatencyRecorder->Statistics();
+}
+
+void RemoteReleaseControl::ResetReleaseLatencyStatistics()
+{
+   m_spReleaseLatencyRecorder->Reset();
+}
+
+void RemoteReleaseControl::RecordReleaseStage(T_enReleaseStage enReleaseStage)
+{
+   m_spReleaseLatencyRecorder->Record(enReleaseStage);
+}
+
+void RemoteReleaseControl::FinishReleaseWithoutTransfer()
+{
+   m_spReleaseLatencyRecorder->FinishOldestShot();
+}
+
+void RemoteReleaseControl::ReleaseOnTrigger(T_fnReleaseTrigger fnReleaseTrigger)
+{
+   if (fnReleaseTrigger())
+      Release();
+}
+
+/// \details All implementations request the shot right after the trigger
+/// function returned, on the same thread, so the command sent function is
+/// attached to the next requested shot and called when the implementation
+/// records releaseStageCommandSent for that shot.
+void RemoteReleaseControl::ReleaseOnTrigger(T_fnReleaseTrigger fnReleaseTrigger, T_fnReleaseCommandSent fnReleaseCommandSent)
+{
+   std::shared_ptr<ReleaseLatencyRecorder> spReleaseLatencyRecorder = m_spReleaseLatencyRecorder;
+
+   ReleaseOnTrigger(
+      [fnReleaseTrigger, fnReleaseCommandSent, spReleaseLatencyRecorder]()
+      {
+         if (!fnReleaseTrigger())
+            return false;
+
+         spReleaseLatencyRecorder->SetNextReleaseCommandSent(fnReleaseCommandSent);
+         return true;
+      });
+}
+
+/// \details The properties are kept in the order of their last occurrence,
+/// since e.g. the shooting mode may have to be set before other properties.
+std::vector<ImageProperty> RemoteReleaseControl::CoalesceImageProperties(const std::vector<ImageProperty>& vecImageProperties)
+{
+   std::vector<ImageProperty> vecCoalescedImageProperties;
+   std::set<unsigned int> setImagePropertyIds;
+
+   for (auto iter = vecImageProperties.rbegin(); iter != vecImageProperties.rend(); ++iter)
+   {
+      if (setImagePropertyIds.insert(iter->Id()).second)
+         vecCoalescedImageProperties.push_back(*iter);
+   }
+
+   std::reverse(vecCoalescedImageProperties.begin(), vecCoalescedImageProperties.end());
+
+   return vecCoalescedImageProperties;
+}
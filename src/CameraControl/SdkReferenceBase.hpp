@@ -32,4 +32,8 @@ public:
       UNUSED(start);
       UNUSED(fnOnCameraConnected);
    };
+
+   /// notifies the handler set with Instance::SetEventsPendingHandler() that
+   /// events are pending; can be called from any thread
+   static void NotifyEventsPending();
 };
@@ -57,32 +57,11 @@ void ShutterSpeedValue::SetAndCheckNewRaw(unsigned int uiValue)
    newProp.SetValue(newVal);
 
    // ... and check if value is available
-   std::vector<ImageProperty> vecValues;
-   m_spRemoteReleaseControl->EnumImagePropertyValues(m_value.Id(), vecValues);
+   std::shared_ptr<const ImagePropertyValueList> spValueList =
+      m_spRemoteReleaseControl->GetCachedImagePropertyValues(m_value.Id());
 
-   std::vector<ImageProperty>::iterator iterValues = std::find_if(vecValues.begin(), vecValues.end(),
-      [uiValue](const ImageProperty& prop)
-      {
-         unsigned int uiRawValue = 0;
-         try
-         {
-            if (prop.Value().Type() == Variant::typeUInt16)
-               uiRawValue = prop.Value().Get<unsigned short>();
-            else
-            if (prop.Value().Type() == Variant::typeUInt32)
-               uiRawValue = prop.Value().Get<unsigned int>();
-            else
-               ATLASSERT(false);
-         }
-         catch (...)
-         {
-            return false;
-         }
-
-         return uiRawValue == uiValue;
-      });
-
-   if (iterValues == vecValues.end())
+   size_t uiIndex = 0;
+   if (!spValueList->FindRawValue(uiValue, uiIndex))
       return; // not found; don't set it
 
    // valid value; set it
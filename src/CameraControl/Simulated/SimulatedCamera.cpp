@@ -0,0 +1,260 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file SimulatedCamera.cpp Simulated camera - Camera
+//
+#include "stdafx.h"
+#include "SimulatedCamera.hpp"
+#include "SimulatedPropertyAccess.hpp"
+#include "SimulatedJpegGenerator.hpp"
+#include "CameraException.hpp"
+
+using Simulated::Camera;
+
+/// folder containing the image files
+static LPCTSTR c_imageFolderPath = _T("/DCIM/100SIMUL");
+
+/// width of thumbnail images
+static const unsigned int c_thumbnailWidth = 160;
+
+Camera::Camera(unsigned int cameraIndex, const SimulatedCameraSettings& settings)
+   :m_cameraIndex(cameraIndex),
+   m_settings(settings),
+   m_nextImageNumber(1),
+   m_viewfinderFrameNumber(0),
+   m_randomGenerator(cameraIndex)
+{
+   for (unsigned int imagePropertyId : PropertyAccess::EnumImageProperties())
+      m_propertyValueMap[imagePropertyId] = PropertyAccess::DefaultValue(imagePropertyId);
+}
+
+CString Camera::ModelName() const
+{
+   return _T("Simulated Camera");
+}
+
+CString Camera::SerialNumber() const
+{
+   CString serialNumber;
+   serialNumber.Format(_T("SIM%05u"), m_cameraIndex + 1);
+
+   return serialNumber;
+}
+
+Variant Camera::GetPropertyValue(unsigned int imagePropertyId) const
+{
+   if (imagePropertyId == imagePropertyAvailableShots)
+   {
+      Variant value;
+      value.Set(NumAvailableShots());
+      value.SetType(Variant::typeUInt32);
+
+      return value;
+   }
+
+   LightweightMutex::LockType lock(m_mutex);
+
+   auto iter = m_propertyValueMap.find(imagePropertyId);
+   if (iter == m_propertyValueMap.end())
+      throw CameraException(_T("Simulated::Camera::GetPropertyValue"),
+         _T("Invalid property id"), 0, __FILE__, __LINE__);
+
+   return iter->second;
+}
+
+void Camera::SetPropertyValue(unsigned int imagePropertyId, const Variant& value)
+{
+   if (PropertyAccess::IsReadOnly(imagePropertyId))
+      throw CameraException(_T("Simulated::Camera::SetPropertyValue"),
+         _T("Property is read only"), 0, __FILE__, __LINE__);
+
+   if (value.Type() != Variant::typeUInt32)
+      throw CameraException(_T("Simulated::Camera::SetPropertyValue"),
+         _T("Invalid property value type"), 0, __FILE__, __LINE__);
+
+   std::vector<Variant> validValuesList = PropertyAccess::ValidValues(imagePropertyId);
+
+   auto iter = std::find_if(validValuesList.begin(), validValuesList.end(),
+      [&value](const Variant& validValue) { return validValue.Get<unsigned int>() == value.Get<unsigned int>(); });
+
+   if (iter == validValuesList.end())
+      throw CameraException(_T("Simulated::Camera::SetPropertyValue"),
+         _T("Invalid property value"), 0, __FILE__, __LINE__);
+
+   LightweightMutex::LockType lock(m_mutex);
+
+   m_propertyValueMap[imagePropertyId] = value;
+}
+
+unsigned int Camera::NumAvailableShots() const
+{
+   LightweightMutex::LockType lock(m_mutex);
+
+   size_t numImages = m_imageFileList.size();
+
+   return numImages >= m_settings.m_numAvailableShots
+      ? 0
+      : m_settings.m_numAvailableShots - static_cast<unsigned int>(numImages);
+}
+
+/// \details The image size depends on the image format property; medium
+/// images have 2/3 and small images 1/2 of the width and height of large
+/// images.
+FileInfo Camera::CaptureImage()
+{
+   if (NumAvailableShots() == 0)
+      throw CameraException(_T("Simulated::Camera::CaptureImage"),
+         _T("Memory card is full"), 0, __FILE__, __LINE__);
+
+   unsigned int imageFormat = GetPropertyValue(imagePropertyImageFormat).Get<unsigned int>();
+
+   LightweightMutex::LockType lock(m_mutex);
+
+   ImageFile imageFile;
+   imageFile.m_frameNumber = m_nextImageNumber++;
+   imageFile.m_width = m_settings.m_imageWidth;
+   imageFile.m_height = m_settings.m_imageHeight;
+
+   if (imageFormat == 1)
+   {
+      imageFile.m_width = imageFile.m_width * 2 / 3;
+      imageFile.m_height = imageFile.m_height * 2 / 3;
+   }
+   else if (imageFormat == 2)
+   {
+      imageFile.m_width /= 2;
+      imageFile.m_height /= 2;
+   }
+
+   imageFile.m_width = std::max(imageFile.m_width, 1U);
+   imageFile.m_height = std::max(imageFile.m_height, 1U);
+
+   imageFile.m_fileInfo.m_filename.Format(_T("%s/IMG_%04u.JPG"),
+      c_imageFolderPath, imageFile.m_frameNumber % 10000);
+
+   imageFile.m_fileInfo.m_fileSize = static_cast<unsigned long long>(
+      static_cast<double>(imageFile.m_width) * imageFile.m_height * m_settings.m_imageBitsPerPixel / 8.0);
+
+   imageFile.m_fileInfo.m_modifiedTime = time(nullptr);
+
+   m_imageFileList.push_back(imageFile);
+
+   return imageFile.m_fileInfo;
+}
+
+void Camera::RemoveFile(const CString& filename)
+{
+   LightweightMutex::LockType lock(m_mutex);
+
+   m_imageFileList.erase(
+      std::remove_if(m_imageFileList.begin(), m_imageFileList.end(),
+         [&filename](const ImageFile& imageFile) { return imageFile.m_fileInfo.m_filename == filename; }),
+      m_imageFileList.end());
+}
+
+std::vector<CString> Camera::EnumFolders(const CString& path) const
+{
+   if (path.IsEmpty() || path == CameraFileSystem::PathSeparator)
+      return std::vector<CString> { _T("DCIM") };
+
+   if (path == _T("/DCIM") || path == _T("/DCIM/"))
+      return std::vector<CString> { _T("100SIMUL") };
+
+   return std::vector<CString>();
+}
+
+std::vector<FileInfo> Camera::EnumFiles(const CString& path) const
+{
+   CString folderPath = path;
+   folderPath.TrimRight(CameraFileSystem::PathSeparator);
+
+   std::vector<FileInfo> fileInfoList;
+
+   if (folderPath != c_imageFolderPath)
+      return fileInfoList;
+
+   LightweightMutex::LockType lock(m_mutex);
+
+   for (const ImageFile& imageFile : m_imageFileList)
+      fileInfoList.push_back(imageFile.m_fileInfo);
+
+   return fileInfoList;
+}
+
+std::vector<BYTE> Camera::ReadFile(const CString& filename) const
+{
+   ImageFile imageFile;
+   {
+      LightweightMutex::LockType lock(m_mutex);
+
+      const ImageFile* foundImageFile = FindImageFile(filename);
+      if (foundImageFile == nullptr)
+         throw CameraException(_T("Simulated::Camera::ReadFile"),
+            _T("File not found: ") + filename, 0, __FILE__, __LINE__);
+
+      imageFile = *foundImageFile;
+   }
+
+   return JpegGenerator::Generate(imageFile.m_width, imageFile.m_height,
+      imageFile.m_frameNumber, static_cast<size_t>(imageFile.m_fileInfo.m_fileSize));
+}
+
+std::vector<BYTE> Camera::ReadThumbnail(const CString& filename) const
+{
+   ImageFile imageFile;
+   {
+      LightweightMutex::LockType lock(m_mutex);
+
+      const ImageFile* foundImageFile = FindImageFile(filename);
+      if (foundImageFile == nullptr)
+         return std::vector<BYTE>();
+
+      imageFile = *foundImageFile;
+   }
+
+   unsigned int thumbnailHeight = std::max(1U, c_thumbnailWidth * imageFile.m_height / imageFile.m_width);
+
+   return JpegGenerator::Generate(c_thumbnailWidth, thumbnailHeight, imageFile.m_frameNumber, 0);
+}
+
+std::vector<BYTE> Camera::CreateViewfinderImage(std::vector<unsigned int>& histogram)
+{
+   unsigned int frameNumber = 0;
+   {
+      LightweightMutex::LockType lock(m_mutex);
+      frameNumber = m_viewfinderFrameNumber++;
+   }
+
+   return JpegGenerator::Generate(m_settings.m_viewfinderWidth, m_settings.m_viewfinderHeight,
+      frameNumber, 0, &histogram);
+}
+
+unsigned int Camera::RandomJitterInMilliseconds() const
+{
+   if (m_settings.m_jitterInMilliseconds == 0)
+      return 0;
+
+   LightweightMutex::LockType lock(m_mutex);
+
+   std::uniform_int_distribution<unsigned int> distribution(0, m_settings.m_jitterInMilliseconds);
+   return distribution(m_randomGenerator);
+}
+
+unsigned int Camera::TransferTimeInMilliseconds(unsigned long long numBytes) const
+{
+   if (m_settings.m_bandwidthInMegabytesPerSecond <= 0.0)
+      return 0;
+
+   return static_cast<unsigned int>(
+      static_cast<double>(numBytes) / (m_settings.m_bandwidthInMegabytesPerSecond * 1024.0 * 1024.0) * 1000.0);
+}
+
+const Camera::ImageFile* Camera::FindImageFile(const CString& filename) const
+{
+   for (const ImageFile& imageFile : m_imageFileList)
+      if (imageFile.m_fileInfo.m_filename == filename)
+         return &imageFile;
+
+   return nullptr;
+}
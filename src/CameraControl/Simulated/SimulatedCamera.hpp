@@ -0,0 +1,123 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file SimulatedCamera.hpp Simulated camera - Camera
+//
+#pragma once
+
+#include "SimulatedCameraSettings.hpp"
+#include "CameraFileSystem.hpp"
+#include "Variant.hpp"
+#include <ulib/thread/LightweightMutex.hpp>
+#include <map>
+#include <random>
+
+namespace Simulated
+{
+   /// \brief simulated camera hardware
+   /// \details Holds the property values and the memory card contents of a
+   /// simulated camera; it is shared by the source device, the remote
+   /// release control and the file system, and can be accessed from any
+   /// thread. Only the frame numbers of captured images are stored, and the
+   /// image data is generated again when the file is read.
+   class Camera
+   {
+   public:
+      /// ctor
+      Camera(unsigned int cameraIndex, const SimulatedCameraSettings& settings);
+
+      /// returns camera settings
+      const SimulatedCameraSettings& Settings() const { return m_settings; }
+
+      /// returns model name
+      CString ModelName() const;
+
+      /// returns serial number; unique for each simulated camera
+      CString SerialNumber() const;
+
+      /// returns value of image property
+      Variant GetPropertyValue(unsigned int imagePropertyId) const;
+
+      /// sets value of image property; throws exception when the property is
+      /// read only, or the value isn't valid
+      void SetPropertyValue(unsigned int imagePropertyId, const Variant& value);
+
+      /// returns number of images that still fit onto the memory card
+      unsigned int NumAvailableShots() const;
+
+      /// captures image and stores it on the memory card; throws exception
+      /// when the memory card is full
+      FileInfo CaptureImage();
+
+      /// removes file from memory card
+      void RemoveFile(const CString& filename);
+
+      /// returns list of subfolders in this folder
+      std::vector<CString> EnumFolders(const CString& path) const;
+
+      /// returns list of files in the folder
+      std::vector<FileInfo> EnumFiles(const CString& path) const;
+
+      /// returns data of file; throws exception when the file doesn't exist
+      std::vector<BYTE> ReadFile(const CString& filename) const;
+
+      /// returns thumbnail of file; empty when the file doesn't exist
+      std::vector<BYTE> ReadThumbnail(const CString& filename) const;
+
+      /// returns next live view image, and its luminance histogram
+      std::vector<BYTE> CreateViewfinderImage(std::vector<unsigned int>& histogram);
+
+      /// returns random delay, up to the jitter in the settings
+      unsigned int RandomJitterInMilliseconds() const;
+
+      /// returns time needed to transfer given number of bytes
+      unsigned int TransferTimeInMilliseconds(unsigned long long numBytes) const;
+
+   private:
+      /// image file stored on the memory card
+      struct ImageFile
+      {
+         /// file info
+         FileInfo m_fileInfo;
+
+         /// frame number used to generate the image
+         unsigned int m_frameNumber;
+
+         /// image width
+         unsigned int m_width;
+
+         /// image height
+         unsigned int m_height;
+      };
+
+      /// finds image file by filename; returns nullptr when not found
+      const ImageFile* FindImageFile(const CString& filename) const;
+
+   private:
+      /// mutex to protect all members below
+      mutable LightweightMutex m_mutex;
+
+      /// camera index; used for the serial number
+      unsigned int m_cameraIndex;
+
+      /// camera settings
+      SimulatedCameraSettings m_settings;
+
+      /// values of all image properties, by property id
+      std::map<unsigned int, Variant> m_propertyValueMap;
+
+      /// image files on the memory card, in the image folder
+      std::vector<ImageFile> m_imageFileList;
+
+      /// number of next captured image; used for the filename
+      unsigned int m_nextImageNumber;
+
+      /// frame number of next live view image
+      unsigned int m_viewfinderFrameNumber;
+
+      /// random generator for jitter
+      mutable std::mt19937 m_randomGenerator;
+   };
+
+} // namespace Simulated
@@ -0,0 +1,82 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file SimulatedCameraFileSystemImpl.cpp Simulated camera - CameraFileSystem impl
+//
+#include "stdafx.h"
+#include "SimulatedCameraFileSystemImpl.hpp"
+#include "SimulatedCamera.hpp"
+#include "SingleThreadExecutor.hpp"
+
+using Simulated::CameraFileSystemImpl;
+
+CameraFileSystemImpl::CameraFileSystemImpl(std::shared_ptr<Camera> camera)
+   :m_camera(camera),
+   m_downloadThread(std::make_unique<SingleThreadExecutor>(_T("simulated file system thread")))
+{
+}
+
+CameraFileSystemImpl::~CameraFileSystemImpl()
+{
+   // finish downloads before the camera is released
+   m_downloadThread.reset();
+}
+
+std::vector<CString> CameraFileSystemImpl::EnumFolders(const CString& path) const
+{
+   return m_camera->EnumFolders(path);
+}
+
+std::vector<FileInfo> CameraFileSystemImpl::EnumFiles(const CString& path) const
+{
+   return m_camera->EnumFiles(path);
+}
+
+void CameraFileSystemImpl::StartDownload(const FileInfo& fileInfo, T_fnDownloadFinished fnDownloadFinished)
+{
+   m_downloadThread->Schedule(
+      std::bind(&CameraFileSystemImpl::AsyncDownload, this, fileInfo, fnDownloadFinished));
+}
+
+/// \details Thumbnails are small, so they are generated right away, without
+/// delay; the priority is ignored, since requests are processed immediately.
+void CameraFileSystemImpl::GetThumbnail(const FileInfo& fileInfo, T_fnThumbnailAvailable fnThumbnailAvailable,
+   T_enThumbnailPriority priority)
+{
+   UNUSED(priority);
+
+   std::shared_ptr<Camera> camera = m_camera;
+
+   m_downloadThread->Schedule([camera, fileInfo, fnThumbnailAvailable]()
+   {
+      std::vector<BYTE> thumbnailData = camera->ReadThumbnail(fileInfo.m_filename);
+
+      if (fnThumbnailAvailable != nullptr)
+         fnThumbnailAvailable(fileInfo, thumbnailData);
+   });
+}
+
+void CameraFileSystemImpl::AsyncDownload(const FileInfo& fileInfo, T_fnDownloadFinished fnDownloadFinished)
+{
+   std::vector<BYTE> data;
+   try
+   {
+      data = m_camera->ReadFile(fileInfo.m_filename);
+   }
+   catch (const CameraException& ex)
+   {
+      LOG_TRACE(_T("Exception while downloading file: %s\n"), ex.Message().GetString());
+
+      // file not available anymore
+      if (fnDownloadFinished != nullptr)
+         fnDownloadFinished(fileInfo, std::vector<BYTE>(), false);
+
+      return;
+   }
+
+   Sleep(m_camera->TransferTimeInMilliseconds(data.size()) + m_camera->RandomJitterInMilliseconds());
+
+   if (fnDownloadFinished != nullptr)
+      fnDownloadFinished(fileInfo, data, true);
+}
@@ -0,0 +1,49 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file SimulatedCameraFileSystemImpl.hpp Simulated camera - CameraFileSystem impl
+//
+#pragma once
+
+#include "CameraFileSystem.hpp"
+#include "SimulatedCommon.hpp"
+
+class SingleThreadExecutor;
+
+namespace Simulated
+{
+   /// \brief file system implementation for simulated cameras
+   /// \details Shows the images on the simulated memory card. Downloads are
+   /// slowed down to the bandwidth in the camera settings.
+   class CameraFileSystemImpl : public CameraFileSystem
+   {
+   public:
+      /// ctor
+      explicit CameraFileSystemImpl(std::shared_ptr<Camera> camera);
+
+      /// dtor
+      virtual ~CameraFileSystemImpl();
+
+      virtual std::vector<CString> EnumFolders(const CString& path) const override;
+
+      virtual std::vector<FileInfo> EnumFiles(const CString& path) const override;
+
+      virtual void StartDownload(const FileInfo& fileInfo, T_fnDownloadFinished fnDownloadFinished) override;
+
+      virtual void GetThumbnail(const FileInfo& fileInfo, T_fnThumbnailAvailable fnThumbnailAvailable,
+         T_enThumbnailPriority priority) override;
+
+   private:
+      /// downloads file; called in worker thread
+      void AsyncDownload(const FileInfo& fileInfo, T_fnDownloadFinished fnDownloadFinished);
+
+   private:
+      /// simulated camera
+      std::shared_ptr<Camera> m_camera;
+
+      /// background thread executor for downloads and thumbnails
+      std::unique_ptr<SingleThreadExecutor> m_downloadThread;
+   };
+
+} // namespace Simulated
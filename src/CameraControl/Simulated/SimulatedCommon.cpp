@@ -0,0 +1,76 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file SimulatedCommon.cpp Simulated camera - Common functions
+//
+#include "stdafx.h"
+#include "SimulatedCommon.hpp"
+#include "SimulatedCamera.hpp"
+#include "SimulatedSourceInfoImpl.hpp"
+
+/// mutex to protect s_settings and s_settingsChangeCount
+static LightweightMutex s_mutexSettings;
+
+/// settings for all simulated cameras
+static SimulatedCameraSettings s_settings;
+
+/// number of times the settings were changed
+static unsigned int s_settingsChangeCount = 0;
+
+Simulated::Ref::Ref()
+   :m_settingsChangeCount(0)
+{
+}
+
+Simulated::Ref::~Ref()
+{
+}
+
+void Simulated::Ref::SetSettings(const SimulatedCameraSettings& settings)
+{
+   LightweightMutex::LockType lock(s_mutexSettings);
+
+   s_settings = settings;
+   s_settingsChangeCount++;
+}
+
+void Simulated::Ref::AddVersionText(CString& versionText) const
+{
+   LightweightMutex::LockType lock(s_mutexSettings);
+
+   if (s_settings.m_numCameras == 0)
+      return;
+
+   versionText.AppendFormat(_T("Simulated cameras: %u\n\n"), s_settings.m_numCameras);
+}
+
+void Simulated::Ref::EnumerateDevices(std::vector<std::shared_ptr<SourceInfo>>& sourceDevicesList) const
+{
+   SimulatedCameraSettings settings;
+   unsigned int settingsChangeCount = 0;
+   {
+      LightweightMutex::LockType lock(s_mutexSettings);
+      settings = s_settings;
+      settingsChangeCount = s_settingsChangeCount;
+   }
+
+   LightweightMutex::LockType lock(m_mutex);
+
+   if (m_settingsChangeCount != settingsChangeCount)
+   {
+      m_settingsChangeCount = settingsChangeCount;
+
+      m_cameraList.clear();
+      for (unsigned int cameraIndex = 0; cameraIndex < settings.m_numCameras; cameraIndex++)
+         m_cameraList.push_back(std::make_shared<Camera>(cameraIndex, settings));
+   }
+
+   RefSp ref = const_cast<Ref*>(this)->shared_from_this();
+
+   for (size_t cameraIndex = 0; cameraIndex < m_cameraList.size(); cameraIndex++)
+   {
+      sourceDevicesList.push_back(
+         std::make_shared<SourceInfoImpl>(ref, m_cameraList[cameraIndex], static_cast<unsigned int>(cameraIndex)));
+   }
+}
@@ -0,0 +1,59 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file SimulatedCommon.hpp Simulated camera - Common functions
+//
+#pragma once
+
+#include "Instance.hpp"
+#include "CameraException.hpp"
+#include "SdkReferenceBase.hpp"
+#include "SimulatedCameraSettings.hpp"
+#include <ulib/thread/LightweightMutex.hpp>
+
+/// simulated camera classes
+namespace Simulated
+{
+   class Camera;
+
+   /// \brief simulated camera reference
+   /// \details Enumerates the simulated cameras, when enabled with
+   /// Instance::SetSimulatedCameraSettings(). The cameras are kept as long
+   /// as the settings aren't changed, so that e.g. the memory card contents
+   /// are still there when a camera is opened again.
+   class Ref : public SdkReferenceBase, public std::enable_shared_from_this<Ref>
+   {
+   public:
+      /// ctor
+      Ref();
+      /// dtor
+      ~Ref();
+
+      /// sets settings for all simulated cameras
+      static void SetSettings(const SimulatedCameraSettings& settings);
+
+      /// adds simulated camera text, when enabled
+      virtual void AddVersionText(CString& versionText) const override;
+
+      /// enumerates simulated cameras
+      virtual void EnumerateDevices(std::vector<std::shared_ptr<SourceInfo>>& sourceDevicesList) const override;
+
+      /// returns if AsyncWaitForCamera() is possible for this SDK
+      virtual bool IsAsyncWaitPossible() const override { return false; }
+
+   private:
+      /// mutex to protect m_cameraList and m_settingsChangeCount
+      mutable LightweightMutex m_mutex;
+
+      /// list of simulated cameras
+      mutable std::vector<std::shared_ptr<Camera>> m_cameraList;
+
+      /// settings change count the cameras were created with
+      mutable unsigned int m_settingsChangeCount;
+   };
+
+   /// smart pointer to simulated camera reference
+   typedef std::shared_ptr<Ref> RefSp;
+
+} // namespace Simulated
@@ -0,0 +1,259 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file SimulatedJpegGenerator.cpp Simulated camera - JPEG image generator
+//
+#include "stdafx.h"
+#include "SimulatedJpegGenerator.hpp"
+
+using Simulated::JpegGenerator;
+
+/// number of codes per code length of the DC table; standard luminance DC
+/// table from ITU T.81, Annex K.3, with the category values 0 to 11
+static const BYTE c_dcTableBits[16] = { 0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0 };
+
+/// number of codes per code length of the AC table; the only AC symbol used
+/// is EOB (0x00), which is coded with a single bit
+static const BYTE c_acTableBits[16] = { 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+/// quantization value; with a DC quantization value of 8, the quantized DC
+/// coefficient of a uniform block equals its level shifted gray value
+static const BYTE c_quantizationValue = 8;
+
+/// max. payload size of a comment segment
+static const size_t c_maxCommentSegmentPayload = 65533;
+
+/// Huffman code with its length in bits
+struct HuffmanCode
+{
+   unsigned int m_code;    ///< code bits
+   unsigned int m_length;  ///< code length
+};
+
+/// writes entropy coded data, with byte stuffing
+class BitWriter
+{
+public:
+   /// ctor
+   explicit BitWriter(std::vector<BYTE>& data)
+      :m_data(data),
+      m_bitBuffer(0),
+      m_numBits(0)
+   {
+   }
+
+   /// writes given number of bits, MSB first
+   void Write(unsigned int bits, unsigned int length)
+   {
+      m_bitBuffer = (m_bitBuffer << length) | (bits & ((1U << length) - 1));
+      m_numBits += length;
+
+      while (m_numBits >= 8)
+      {
+         m_numBits -= 8;
+         WriteByte(static_cast<BYTE>((m_bitBuffer >> m_numBits) & 0xFF));
+      }
+   }
+
+   /// pads last byte with 1 bits
+   void Flush()
+   {
+      if (m_numBits > 0)
+         Write(0x7F, 8 - m_numBits);
+   }
+
+private:
+   /// writes byte, inserting a stuffed zero byte after 0xFF
+   void WriteByte(BYTE value)
+   {
+      m_data.push_back(value);
+      if (value == 0xFF)
+         m_data.push_back(0x00);
+   }
+
+private:
+   /// data to write to
+   std::vector<BYTE>& m_data;
+
+   /// bits not written yet
+   unsigned int m_bitBuffer;
+
+   /// number of bits in bit buffer
+   unsigned int m_numBits;
+};
+
+/// generates canonical Huffman codes from the code length counts
+static std::vector<HuffmanCode> GenerateHuffmanCodes(const BYTE(&bits)[16])
+{
+   std::vector<HuffmanCode> codeList;
+
+   unsigned int code = 0;
+   for (unsigned int length = 1; length <= 16; length++)
+   {
+      for (unsigned int i = 0; i < bits[length - 1]; i++)
+         codeList.push_back(HuffmanCode{ code++, length });
+
+      code <<= 1;
+   }
+
+   return codeList;
+}
+
+/// returns number of bits needed for the magnitude of value
+static unsigned int MagnitudeCategory(int value)
+{
+   unsigned int magnitude = static_cast<unsigned int>(value < 0 ? -value : value);
+
+   unsigned int category = 0;
+   while (magnitude != 0)
+   {
+      category++;
+      magnitude >>= 1;
+   }
+
+   return category;
+}
+
+/// appends 16-bit big endian value
+static void AppendWord(std::vector<BYTE>& data, unsigned int value)
+{
+   data.push_back(static_cast<BYTE>((value >> 8) & 0xFF));
+   data.push_back(static_cast<BYTE>(value & 0xFF));
+}
+
+/// appends marker segment, with marker, length and payload
+static void AppendSegment(std::vector<BYTE>& data, BYTE marker, const std::vector<BYTE>& payload)
+{
+   data.push_back(0xFF);
+   data.push_back(marker);
+   AppendWord(data, static_cast<unsigned int>(payload.size() + 2));
+   data.insert(data.end(), payload.begin(), payload.end());
+}
+
+/// appends Huffman table segment
+static void AppendHuffmanTable(std::vector<BYTE>& data, BYTE tableClassAndId, const BYTE(&bits)[16])
+{
+   std::vector<BYTE> payload;
+   payload.push_back(tableClassAndId);
+   payload.insert(payload.end(), bits, bits + 16);
+
+   unsigned int numValues = 0;
+   for (BYTE count : bits)
+      numValues += count;
+
+   for (unsigned int value = 0; value < numValues; value++)
+      payload.push_back(static_cast<BYTE>(value));
+
+   AppendSegment(data, 0xC4, payload);
+}
+
+/// returns gray value of block; diagonal stripes that move with the frame number
+static BYTE BlockGrayValue(unsigned int blockX, unsigned int blockY, unsigned int frameNumber)
+{
+   return static_cast<BYTE>(64 + ((blockX * 5 + blockY * 3 + frameNumber * 4) & 0x7F));
+}
+
+std::vector<BYTE> JpegGenerator::Generate(unsigned int width, unsigned int height,
+   unsigned int frameNumber, size_t minimumSize,
+   std::vector<unsigned int>* histogram)
+{
+   ATLASSERT(width > 0 && width <= 0xFFFF);
+   ATLASSERT(height > 0 && height <= 0xFFFF);
+
+   static const std::vector<HuffmanCode> dcCodeList = GenerateHuffmanCodes(c_dcTableBits);
+   static const HuffmanCode endOfBlockCode = GenerateHuffmanCodes(c_acTableBits)[0];
+
+   if (histogram != nullptr)
+      histogram->assign(256, 0);
+
+   // encode scan first, so that the padding can be calculated
+   unsigned int numBlocksX = (width + 7) / 8;
+   unsigned int numBlocksY = (height + 7) / 8;
+
+   std::vector<BYTE> scanData;
+   scanData.reserve(numBlocksX * numBlocksY);
+
+   BitWriter writer{ scanData };
+
+   int lastDcValue = 0;
+   for (unsigned int blockY = 0; blockY < numBlocksY; blockY++)
+   {
+      for (unsigned int blockX = 0; blockX < numBlocksX; blockX++)
+      {
+         BYTE grayValue = BlockGrayValue(blockX, blockY, frameNumber);
+
+         int dcValue = static_cast<int>(grayValue) - 128;
+         int diff = dcValue - lastDcValue;
+         lastDcValue = dcValue;
+
+         unsigned int category = MagnitudeCategory(diff);
+         writer.Write(dcCodeList[category].m_code, dcCodeList[category].m_length);
+
+         if (category > 0)
+            writer.Write(static_cast<unsigned int>(diff < 0 ? diff - 1 : diff), category);
+
+         writer.Write(endOfBlockCode.m_code, endOfBlockCode.m_length);
+
+         if (histogram != nullptr)
+         {
+            unsigned int blockWidth = std::min(8U, width - blockX * 8);
+            unsigned int blockHeight = std::min(8U, height - blockY * 8);
+            (*histogram)[grayValue] += blockWidth * blockHeight;
+         }
+      }
+   }
+
+   writer.Flush();
+
+   // headers
+   std::vector<BYTE> data;
+   data.reserve(std::max(minimumSize, scanData.size() + 1024));
+
+   data.push_back(0xFF);
+   data.push_back(0xD8); // SOI
+
+   static const BYTE c_jfifHeader[] = { 'J', 'F', 'I', 'F', 0, 1, 1, 0, 0, 1, 0, 1, 0, 0 };
+   AppendSegment(data, 0xE0, std::vector<BYTE>(c_jfifHeader, c_jfifHeader + sizeof(c_jfifHeader)));
+
+   std::vector<BYTE> quantizationTable(65, c_quantizationValue);
+   quantizationTable[0] = 0; // 8-bit precision, table 0
+   AppendSegment(data, 0xDB, quantizationTable);
+
+   std::vector<BYTE> frameHeader;
+   frameHeader.push_back(8); // precision
+   AppendWord(frameHeader, height);
+   AppendWord(frameHeader, width);
+   frameHeader.push_back(1); // one component
+   frameHeader.push_back(1); // component id
+   frameHeader.push_back(0x11); // no subsampling
+   frameHeader.push_back(0); // quantization table 0
+   AppendSegment(data, 0xC0, frameHeader); // SOF0
+
+   AppendHuffmanTable(data, 0x00, c_dcTableBits);
+   AppendHuffmanTable(data, 0x10, c_acTableBits);
+
+   // padding
+   static const size_t c_scanHeaderAndTrailerSize = 10 + 2; // SOS segment and EOI marker
+   size_t currentSize = data.size() + scanData.size() + c_scanHeaderAndTrailerSize;
+
+   while (currentSize < minimumSize)
+   {
+      // each segment needs 4 bytes for marker and length
+      size_t remainingSize = minimumSize - currentSize;
+      size_t payloadSize = std::min(c_maxCommentSegmentPayload, remainingSize > 4 ? remainingSize - 4 : 0);
+
+      AppendSegment(data, 0xFE, std::vector<BYTE>(payloadSize, 0));
+      currentSize += payloadSize + 4;
+   }
+
+   static const BYTE c_scanHeader[] = { 1, 1, 0x00, 0, 63, 0 };
+   AppendSegment(data, 0xDA, std::vector<BYTE>(c_scanHeader, c_scanHeader + sizeof(c_scanHeader))); // SOS
+
+   data.insert(data.end(), scanData.begin(), scanData.end());
+
+   data.push_back(0xFF);
+   data.push_back(0xD9); // EOI
+
+   return data;
+}
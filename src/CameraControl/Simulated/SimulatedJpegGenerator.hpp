@@ -0,0 +1,34 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file SimulatedJpegGenerator.hpp Simulated camera - JPEG image generator
+//
+#pragma once
+
+#include <vector>
+
+namespace Simulated
+{
+   /// \brief generates synthetic baseline JPEG images
+   /// \details The images are grayscale, with a single gray value per 8x8
+   /// block, so that only DC coefficients have to be encoded; this is fast
+   /// enough even for full resolution images. The pattern moves with the
+   /// frame number, so that consecutive images differ.
+   class JpegGenerator
+   {
+   public:
+      /// \brief generates JPEG image
+      /// \param width image width, in pixels
+      /// \param height image height, in pixels
+      /// \param frameNumber frame number; determines the position of the pattern
+      /// \param minimumSize minimum image size in bytes; smaller images are
+      /// padded with comment segments, so that the size resembles a real image
+      /// \param histogram when not null, receives the luminance histogram
+      /// of the image, with 256 entries
+      static std::vector<BYTE> Generate(unsigned int width, unsigned int height,
+         unsigned int frameNumber, size_t minimumSize,
+         std::vector<unsigned int>* histogram = nullptr);
+   };
+
+} // namespace Simulated
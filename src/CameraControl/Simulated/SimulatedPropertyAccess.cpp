@@ -0,0 +1,289 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file SimulatedPropertyAccess.cpp Simulated camera - Property access
+//
+#include "stdafx.h"
+#include "SimulatedPropertyAccess.hpp"
+#include "CameraException.hpp"
+
+using Simulated::PropertyAccess;
+
+/// property value and its display text
+struct ValueText
+{
+   unsigned int m_value;   ///< value
+   LPCTSTR m_text;         ///< display text
+};
+
+/// shooting mode values; same order as RemoteReleaseControl::T_enShootingMode
+static const ValueText c_shootingModeValues[] =
+{
+   { 0, _T("P") },
+   { 1, _T("Tv") },
+   { 2, _T("Av") },
+   { 3, _T("M") },
+};
+
+/// Av values, in 1/3 EV steps
+static const ValueText c_avValues[] =
+{
+   { 0x20, _T("f/2.8") }, { 0x23, _T("f/3.2") }, { 0x25, _T("f/3.5") },
+   { 0x28, _T("f/4.0") }, { 0x2B, _T("f/4.5") }, { 0x2D, _T("f/5.0") },
+   { 0x30, _T("f/5.6") }, { 0x33, _T("f/6.3") }, { 0x35, _T("f/7.1") },
+   { 0x38, _T("f/8.0") }, { 0x3B, _T("f/9.0") }, { 0x3D, _T("f/10") },
+   { 0x40, _T("f/11") }, { 0x43, _T("f/13") }, { 0x45, _T("f/14") },
+   { 0x48, _T("f/16") }, { 0x4B, _T("f/18") }, { 0x4D, _T("f/20") },
+   { 0x50, _T("f/22") },
+};
+
+/// Tv values, in 1/3 EV steps, from 30" to 1/8000
+static const ValueText c_tvValues[] =
+{
+   { 0x10, _T("30\"") }, { 0x13, _T("25\"") }, { 0x15, _T("20\"") },
+   { 0x18, _T("15\"") }, { 0x1B, _T("13\"") }, { 0x1D, _T("10\"") },
+   { 0x20, _T("8\"") }, { 0x23, _T("6\"") }, { 0x25, _T("5\"") },
+   { 0x28, _T("4\"") }, { 0x2B, _T("3\"2") }, { 0x2D, _T("2\"5") },
+   { 0x30, _T("2\"") }, { 0x33, _T("1\"6") }, { 0x35, _T("1\"3") },
+   { 0x38, _T("1\"") }, { 0x3B, _T("0\"8") }, { 0x3D, _T("0\"6") },
+   { 0x40, _T("0\"5") }, { 0x43, _T("0\"4") }, { 0x45, _T("0\"3") },
+   { 0x48, _T("1/4") }, { 0x4B, _T("1/5") }, { 0x4D, _T("1/6") },
+   { 0x50, _T("1/8") }, { 0x53, _T("1/10") }, { 0x55, _T("1/13") },
+   { 0x58, _T("1/15") }, { 0x5B, _T("1/20") }, { 0x5D, _T("1/25") },
+   { 0x60, _T("1/30") }, { 0x63, _T("1/40") }, { 0x65, _T("1/50") },
+   { 0x68, _T("1/60") }, { 0x6B, _T("1/80") }, { 0x6D, _T("1/100") },
+   { 0x70, _T("1/125") }, { 0x73, _T("1/160") }, { 0x75, _T("1/200") },
+   { 0x78, _T("1/250") }, { 0x7B, _T("1/320") }, { 0x7D, _T("1/400") },
+   { 0x80, _T("1/500") }, { 0x83, _T("1/640") }, { 0x85, _T("1/800") },
+   { 0x88, _T("1/1000") }, { 0x8B, _T("1/1250") }, { 0x8D, _T("1/1600") },
+   { 0x90, _T("1/2000") }, { 0x93, _T("1/2500") }, { 0x95, _T("1/3200") },
+   { 0x98, _T("1/4000") }, { 0x9B, _T("1/5000") }, { 0x9D, _T("1/6400") },
+   { 0xA0, _T("1/8000") },
+};
+
+/// ISO speed values, in 1/3 EV steps
+static const ValueText c_isoSpeedValues[] =
+{
+   { 0x48, _T("100") }, { 0x4B, _T("125") }, { 0x4D, _T("160") },
+   { 0x50, _T("200") }, { 0x53, _T("250") }, { 0x55, _T("320") },
+   { 0x58, _T("400") }, { 0x5B, _T("500") }, { 0x5D, _T("640") },
+   { 0x60, _T("800") }, { 0x63, _T("1000") }, { 0x65, _T("1250") },
+   { 0x68, _T("1600") }, { 0x6B, _T("2000") }, { 0x6D, _T("2500") },
+   { 0x70, _T("3200") }, { 0x73, _T("4000") }, { 0x75, _T("5000") },
+   { 0x78, _T("6400") },
+};
+
+/// exposure compensation values, in 1/3 EV steps; negative values are
+/// stored as signed byte
+static const ValueText c_exposureCompensationValues[] =
+{
+   { 0xE8, _T("-3") }, { 0xEB, _T("-2 2/3") }, { 0xED, _T("-2 1/3") },
+   { 0xF0, _T("-2") }, { 0xF3, _T("-1 2/3") }, { 0xF5, _T("-1 1/3") },
+   { 0xF8, _T("-1") }, { 0xFB, _T("-2/3") }, { 0xFD, _T("-1/3") },
+   { 0x00, _T("0") },
+   { 0x03, _T("+1/3") }, { 0x05, _T("+2/3") }, { 0x08, _T("+1") },
+   { 0x0B, _T("+1 1/3") }, { 0x0D, _T("+1 2/3") }, { 0x10, _T("+2") },
+   { 0x13, _T("+2 1/3") }, { 0x15, _T("+2 2/3") }, { 0x18, _T("+3") },
+};
+
+/// image format values
+static const ValueText c_imageFormatValues[] =
+{
+   { 0, _T("JPEG Large") },
+   { 1, _T("JPEG Medium") },
+   { 2, _T("JPEG Small") },
+};
+
+/// returns begin of value table, and its number of entries
+template <size_t N>
+static const ValueText* TableBegin(const ValueText(&table)[N], size_t& size)
+{
+   size = N;
+   return table;
+}
+
+/// returns value table of image property; size is 0 when there's no table
+static const ValueText* GetValueTable(unsigned int imagePropertyId, size_t& size)
+{
+   switch (imagePropertyId)
+   {
+   case Simulated::imagePropertyShootingMode: return TableBegin(c_shootingModeValues, size);
+   case Simulated::imagePropertyAv: return TableBegin(c_avValues, size);
+   case Simulated::imagePropertyTv: return TableBegin(c_tvValues, size);
+   case Simulated::imagePropertyISOSpeed: return TableBegin(c_isoSpeedValues, size);
+   case Simulated::imagePropertyExposureCompensation: return TableBegin(c_exposureCompensationValues, size);
+   case Simulated::imagePropertyImageFormat: return TableBegin(c_imageFormatValues, size);
+   default:
+      size = 0;
+      return nullptr;
+   }
+}
+
+/// returns UInt32 variant value
+static Variant UInt32Value(unsigned int value)
+{
+   Variant variant;
+   variant.Set(value);
+   variant.SetType(Variant::typeUInt32);
+
+   return variant;
+}
+
+CString PropertyAccess::NameFromId(unsigned int propertyId)
+{
+   switch (propertyId)
+   {
+   case imagePropertyShootingMode: return _T("Shooting mode");
+   case imagePropertyAv: return _T("Aperture");
+   case imagePropertyTv: return _T("Shutter speed");
+   case imagePropertyISOSpeed: return _T("ISO speed");
+   case imagePropertyExposureCompensation: return _T("Exposure compensation");
+   case imagePropertyImageFormat: return _T("Image format");
+   case imagePropertyAvailableShots: return _T("Available shots");
+   case imagePropertyBatteryLevel: return _T("Battery level");
+   case devicePropertyModelName: return _T("Model name");
+   case devicePropertySerialNumber: return _T("Serial number");
+   case devicePropertyFirmwareVersion: return _T("Firmware version");
+   case devicePropertyBatteryLevel: return _T("Battery level");
+   default:
+      ATLASSERT(false);
+      return _T("???");
+   }
+}
+
+CString PropertyAccess::DisplayTextFromIdAndValue(unsigned int propertyId, const Variant& value)
+{
+   size_t size = 0;
+   const ValueText* table = GetValueTable(propertyId, size);
+
+   if (table != nullptr)
+   {
+      unsigned int rawValue = value.Get<unsigned int>();
+
+      for (size_t index = 0; index < size; index++)
+         if (table[index].m_value == rawValue)
+            return table[index].m_text;
+
+      CString text;
+      text.Format(_T("??? (0x%02x)"), rawValue);
+      return text;
+   }
+
+   CString text;
+   switch (propertyId)
+   {
+   case imagePropertyBatteryLevel:
+   case devicePropertyBatteryLevel:
+      text.Format(_T("%u%%"), value.Get<unsigned int>());
+      break;
+
+   case imagePropertyAvailableShots:
+      text.Format(_T("%u"), value.Get<unsigned int>());
+      break;
+
+   default:
+      text = value.ToString();
+      break;
+   }
+
+   return text;
+}
+
+std::vector<unsigned int> PropertyAccess::EnumImageProperties()
+{
+   return std::vector<unsigned int>
+   {
+      imagePropertyShootingMode,
+      imagePropertyAv,
+      imagePropertyTv,
+      imagePropertyISOSpeed,
+      imagePropertyExposureCompensation,
+      imagePropertyImageFormat,
+      imagePropertyAvailableShots,
+      imagePropertyBatteryLevel,
+   };
+}
+
+std::vector<unsigned int> PropertyAccess::EnumDeviceProperties()
+{
+   return std::vector<unsigned int>
+   {
+      devicePropertyModelName,
+      devicePropertySerialNumber,
+      devicePropertyFirmwareVersion,
+      devicePropertyBatteryLevel,
+   };
+}
+
+unsigned int PropertyAccess::MapImagePropertyTypeToId(T_enImagePropertyType imagePropertyType)
+{
+   switch (imagePropertyType)
+   {
+   case propShootingMode: return imagePropertyShootingMode;
+   case propISOSpeed: return imagePropertyISOSpeed;
+   case propAv: return imagePropertyAv;
+   case propTv: return imagePropertyTv;
+   case propExposureCompensation: return imagePropertyExposureCompensation;
+   case propAvailableShots: return imagePropertyAvailableShots;
+   case propBatteryLevel: return imagePropertyBatteryLevel;
+   case propImageFormat: return imagePropertyImageFormat;
+   default:
+      break;
+   }
+
+   return static_cast<unsigned int>(-1);
+}
+
+Variant PropertyAccess::MapShootingModeToValue(RemoteReleaseControl::T_enShootingMode shootingMode)
+{
+   return UInt32Value(static_cast<unsigned int>(shootingMode));
+}
+
+bool PropertyAccess::IsReadOnly(unsigned int imagePropertyId)
+{
+   return imagePropertyId == imagePropertyAvailableShots ||
+      imagePropertyId == imagePropertyBatteryLevel;
+}
+
+Variant PropertyAccess::DefaultValue(unsigned int imagePropertyId)
+{
+   switch (imagePropertyId)
+   {
+   case imagePropertyShootingMode: return UInt32Value(3); // M
+   case imagePropertyAv: return UInt32Value(0x30); // f/5.6
+   case imagePropertyTv: return UInt32Value(0x70); // 1/125
+   case imagePropertyISOSpeed: return UInt32Value(0x48); // ISO 100
+   case imagePropertyExposureCompensation: return UInt32Value(0x00);
+   case imagePropertyImageFormat: return UInt32Value(0); // JPEG Large
+   case imagePropertyAvailableShots: return UInt32Value(0);
+   case imagePropertyBatteryLevel: return UInt32Value(100);
+   default:
+      throw CameraException(_T("Simulated::PropertyAccess::DefaultValue"),
+         _T("Invalid property id"), 0, __FILE__, __LINE__);
+   }
+}
+
+std::vector<Variant> PropertyAccess::ValidValues(unsigned int imagePropertyId)
+{
+   std::vector<Variant> valuesList;
+
+   size_t size = 0;
+   const ValueText* table = GetValueTable(imagePropertyId, size);
+
+   valuesList.reserve(size);
+   for (size_t index = 0; index < size; index++)
+      valuesList.push_back(UInt32Value(table[index].m_value));
+
+   return valuesList;
+}
+
+ImageProperty PropertyAccess::CreateImageProperty(unsigned int imagePropertyId, const Variant& value)
+{
+   return ImageProperty(variantSimulated, imagePropertyId, value, IsReadOnly(imagePropertyId));
+}
+
+DeviceProperty PropertyAccess::CreateDeviceProperty(unsigned int devicePropertyId, const Variant& value)
+{
+   return DeviceProperty(variantSimulated, devicePropertyId, value, true);
+}
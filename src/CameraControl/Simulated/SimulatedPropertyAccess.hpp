@@ -0,0 +1,78 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file SimulatedPropertyAccess.hpp Simulated camera - Property access
+//
+#pragma once
+
+#include "ImageProperty.hpp"
+#include "DeviceProperty.hpp"
+#include "RemoteReleaseControl.hpp"
+
+namespace Simulated
+{
+   /// image property ids of simulated cameras
+   enum T_enImagePropertyId
+   {
+      imagePropertyShootingMode = 1,
+      imagePropertyAv = 2,
+      imagePropertyTv = 3,
+      imagePropertyISOSpeed = 4,
+      imagePropertyExposureCompensation = 5,
+      imagePropertyImageFormat = 6,
+      imagePropertyAvailableShots = 7,
+      imagePropertyBatteryLevel = 8,
+   };
+
+   /// device property ids of simulated cameras; distinct from the image property ids
+   enum T_enDevicePropertyId
+   {
+      devicePropertyModelName = 0x101,
+      devicePropertySerialNumber = 0x102,
+      devicePropertyFirmwareVersion = 0x103,
+      devicePropertyBatteryLevel = 0x104,
+   };
+
+   /// \brief property access for simulated cameras
+   /// \details Av, Tv and ISO speed values use the same codes as EDSDK, so
+   /// that e.g. ShutterSpeedValue works with simulated cameras.
+   class PropertyAccess
+   {
+   public:
+      /// returns name of image or device property
+      static CString NameFromId(unsigned int propertyId);
+
+      /// returns display text of image or device property value
+      static CString DisplayTextFromIdAndValue(unsigned int propertyId, const Variant& value);
+
+      /// returns all image property ids
+      static std::vector<unsigned int> EnumImageProperties();
+
+      /// returns all device property ids
+      static std::vector<unsigned int> EnumDeviceProperties();
+
+      /// maps image property type to id; returns -1 when the simulated camera
+      /// doesn't have the property
+      static unsigned int MapImagePropertyTypeToId(T_enImagePropertyType imagePropertyType);
+
+      /// maps shooting mode to the value of the shooting mode image property
+      static Variant MapShootingModeToValue(RemoteReleaseControl::T_enShootingMode shootingMode);
+
+      /// returns if image property is read only
+      static bool IsReadOnly(unsigned int imagePropertyId);
+
+      /// returns initial value of image property
+      static Variant DefaultValue(unsigned int imagePropertyId);
+
+      /// returns valid values of image property; empty for read only properties
+      static std::vector<Variant> ValidValues(unsigned int imagePropertyId);
+
+      /// creates image property object
+      static ImageProperty CreateImageProperty(unsigned int imagePropertyId, const Variant& value);
+
+      /// creates device property object
+      static DeviceProperty CreateDeviceProperty(unsigned int devicePropertyId, const Variant& value);
+   };
+
+} // namespace Simulated
@@ -0,0 +1,330 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file SimulatedRemoteReleaseControlImpl.cpp Simulated camera - Remote release control impl
+//
+#include "stdafx.h"
+#include "SimulatedRemoteReleaseControlImpl.hpp"
+#include "SimulatedCamera.hpp"
+#include "SimulatedPropertyAccess.hpp"
+#include "SimulatedViewfinderImpl.hpp"
+#include "SingleThreadExecutor.hpp"
+#include <ulib/Path.hpp>
+#include <chrono>
+
+using Simulated::RemoteReleaseControlImpl;
+
+/// size of chunks in which images are transferred; a progress event is sent
+/// for every chunk
+const size_t c_transferChunkSize = 1024 * 1024;
+
+/// maximum time to wait for a transfer when the camera buffer is full; the
+/// closed flag is checked after this time
+const DWORD c_bufferFullWaitTimeInMilliseconds = 100;
+
+RemoteReleaseControlImpl::RemoteReleaseControlImpl(RefSp ref, std::shared_ptr<Camera> camera)
+   :m_ref(ref),
+   m_camera(camera),
+   m_isClosed(false),
+   m_numQueuedTransfers(0),
+   m_eventTransferFinished(false),
+   m_releaseThread(std::make_unique<SingleThreadExecutor>(_T("simulated release control thread"))),
+   m_transferThread(std::make_unique<SingleThreadExecutor>(_T("simulated transfer thread")))
+{
+}
+
+RemoteReleaseControlImpl::~RemoteReleaseControlImpl()
+{
+   try
+   {
+      Close();
+   }
+   catch (...)
+   {
+   }
+
+   // finish captures and transfers before the subjects and settings are destroyed
+   m_releaseThread.reset();
+   m_transferThread.reset();
+}
+
+bool RemoteReleaseControlImpl::GetCapability(T_enRemoteCapability remoteCapability) const
+{
+   switch (remoteCapability)
+   {
+   case RemoteReleaseControl::capChangeShootingParameter:
+   case RemoteReleaseControl::capChangeShootingMode:
+   case RemoteReleaseControl::capViewfinder:
+   case RemoteReleaseControl::capReleaseWhileViewfinder:
+   case RemoteReleaseControl::capBurstMode:
+      return true;
+
+   case RemoteReleaseControl::capZoomControl:
+   case RemoteReleaseControl::capAFLock:
+   case RemoteReleaseControl::capBulbMode:
+   case RemoteReleaseControl::capUILock:
+      return false;
+
+   default:
+      ATLASSERT(false);
+      break;
+   }
+
+   return false;
+}
+
+void RemoteReleaseControlImpl::SetReleaseSettings(const ShutterReleaseSettings& settings)
+{
+   LightweightMutex::LockType lock(m_mutexShutterReleaseSettings);
+
+   m_shutterReleaseSettings = settings;
+}
+
+unsigned int RemoteReleaseControlImpl::MapImagePropertyTypeToId(T_enImagePropertyType imagePropertyType) const
+{
+   return PropertyAccess::MapImagePropertyTypeToId(imagePropertyType);
+}
+
+ImageProperty RemoteReleaseControlImpl::MapShootingModeToImagePropertyValue(T_enShootingMode shootingMode) const
+{
+   return PropertyAccess::CreateImageProperty(imagePropertyShootingMode,
+      PropertyAccess::MapShootingModeToValue(shootingMode));
+}
+
+std::vector<unsigned int> RemoteReleaseControlImpl::EnumImageProperties() const
+{
+   return PropertyAccess::EnumImageProperties();
+}
+
+ImageProperty RemoteReleaseControlImpl::GetImageProperty(unsigned int imagePropertyId) const
+{
+   return PropertyAccess::CreateImageProperty(imagePropertyId, m_camera->GetPropertyValue(imagePropertyId));
+}
+
+/// \details Like real cameras, the property event is sent asynchronously.
+/// Changing the shooting mode also signals that the possible values of all
+/// properties have changed.
+void RemoteReleaseControlImpl::SetImageProperty(const ImageProperty& imageProperty)
+{
+   m_camera->SetPropertyValue(imageProperty.Id(), imageProperty.Value());
+
+   m_releaseThread->Schedule(
+      std::bind(&RemoteReleaseControlImpl::AsyncPropertyChanged, this, imageProperty.Id()));
+}
+
+void RemoteReleaseControlImpl::EnumImagePropertyValues(unsigned int imagePropertyId, std::vector<ImageProperty>& valuesList) const
+{
+   valuesList.clear();
+
+   for (const Variant& value : PropertyAccess::ValidValues(imagePropertyId))
+      valuesList.push_back(PropertyAccess::CreateImageProperty(imagePropertyId, value));
+}
+
+std::shared_ptr<Viewfinder> RemoteReleaseControlImpl::StartViewfinder() const
+{
+   return std::make_shared<ViewfinderImpl>(m_camera);
+}
+
+unsigned int RemoteReleaseControlImpl::NumAvailableShots() const
+{
+   return m_camera->NumAvailableShots();
+}
+
+void RemoteReleaseControlImpl::SendCommand(T_enCameraCommand cameraCommand)
+{
+   // nothing to adjust for simulated cameras
+   UNUSED(cameraCommand);
+}
+
+void RemoteReleaseControlImpl::Release()
+{
+   RecordReleaseStage(releaseStageRequested);
+
+   m_releaseThread->Schedule(std::bind(&RemoteReleaseControlImpl::AsyncRelease, this, T_fnReleaseTrigger()));
+}
+
+void RemoteReleaseControlImpl::ReleaseOnTrigger(T_fnReleaseTrigger releaseTrigger)
+{
+   m_releaseThread->Schedule(std::bind(&RemoteReleaseControlImpl::AsyncRelease, this, releaseTrigger));
+}
+
+std::shared_ptr<BulbReleaseControl> RemoteReleaseControlImpl::StartBulb()
+{
+   throw CameraException(_T("Simulated::RemoteReleaseControl::StartBulb"),
+      _T("Not supported"), 0, __FILE__, __LINE__);
+}
+
+void RemoteReleaseControlImpl::Close()
+{
+   m_isClosed = true;
+}
+
+void RemoteReleaseControlImpl::AsyncPropertyChanged(unsigned int imagePropertyId)
+{
+   if (imagePropertyId == imagePropertyShootingMode)
+   {
+      InvalidateCachedImagePropertyValues(0);
+      m_subjectPropertyEvent.Call(RemoteReleaseControl::propEventPropertyDescChanged, 0);
+   }
+
+   InvalidateCurrentImagePropertyValue(imagePropertyId);
+   m_subjectPropertyEvent.Call(RemoteReleaseControl::propEventPropertyChanged, imagePropertyId);
+}
+
+/// \details The capture blocks the release thread for the capture latency,
+/// so that further releases are queued, like on a real camera. The
+/// transfer runs in the transfer thread. When the camera buffer is full of
+/// images waiting for transfer, the capture waits until an image was
+/// transferred.
+void RemoteReleaseControlImpl::AsyncRelease(T_fnReleaseTrigger releaseTrigger)
+{
+   if (releaseTrigger != nullptr)
+   {
+      if (!releaseTrigger())
+         return;
+
+      RecordReleaseStage(releaseStageRequested);
+   }
+
+   if (m_isClosed)
+   {
+      FinishReleaseWithoutTransfer();
+      return;
+   }
+
+   RecordReleaseStage(releaseStageCommandSent);
+
+   while (m_numQueuedTransfers >= m_camera->Settings().m_bufferSizeInImages && !m_isClosed)
+      m_eventTransferFinished.Wait(c_bufferFullWaitTimeInMilliseconds);
+
+   Sleep(m_camera->Settings().m_captureLatencyInMilliseconds + m_camera->RandomJitterInMilliseconds());
+
+   FileInfo fileInfo;
+   try
+   {
+      fileInfo = m_camera->CaptureImage();
+   }
+   catch (const CameraException& ex)
+   {
+      LOG_TRACE(_T("Simulated camera: couldn't capture image: %s\n"), ex.Message().GetString());
+      FinishReleaseWithoutTransfer();
+      m_subjectStateEvent.Call(RemoteReleaseControl::stateEventReleaseError, ex.ErrorCode());
+      return;
+   }
+
+   RecordReleaseStage(releaseStageCaptureComplete);
+
+   m_subjectPropertyEvent.Call(RemoteReleaseControl::propEventPropertyChanged, imagePropertyAvailableShots);
+
+   // put current shutter release settings into queue
+   ShutterReleaseSettings settings;
+   {
+      LightweightMutex::LockType lock(m_mutexShutterReleaseSettings);
+      settings = m_shutterReleaseSettings;
+   }
+
+   m_subjectStateEvent.Call(RemoteReleaseControl::stateEventCaptureComplete, 0);
+
+   // only save to camera? then return now
+   if ((settings.SaveTarget() & ShutterReleaseSettings::saveToHost) == 0)
+   {
+      FinishReleaseWithoutTransfer();
+      return;
+   }
+
+   m_numQueuedTransfers++;
+
+   m_transferThread->Schedule(
+      std::bind(&RemoteReleaseControlImpl::AsyncTransfer, this, fileInfo, settings));
+}
+
+void RemoteReleaseControlImpl::AsyncTransfer(const FileInfo& fileInfo, ShutterReleaseSettings settings)
+{
+   try
+   {
+      TransferFile(fileInfo, settings);
+   }
+   catch (const CameraException& ex)
+   {
+      LOG_TRACE(_T("Exception while transferring image: %s\n"), ex.Message().GetString());
+      FinishReleaseWithoutTransfer();
+
+      m_numQueuedTransfers--;
+      m_eventTransferFinished.Set();
+
+      m_subjectStateEvent.Call(RemoteReleaseControl::stateEventTransferError, ex.ErrorCode());
+      return;
+   }
+
+   m_numQueuedTransfers--;
+   m_eventTransferFinished.Set();
+
+   if (settings.SaveTarget() == ShutterReleaseSettings::saveToHost)
+   {
+      m_camera->RemoveFile(fileInfo.m_filename);
+      m_subjectPropertyEvent.Call(RemoteReleaseControl::propEventPropertyChanged, imagePropertyAvailableShots);
+   }
+
+   RecordReleaseStage(releaseStageFileWritten);
+
+   // call finished handler
+   ShutterReleaseSettings::T_fnOnFinishedTransfer fnHandler = settings.HandlerOnFinishedTransfer();
+   if (fnHandler != nullptr)
+      fnHandler(settings);
+}
+
+/// \details The data is written in chunks, and the transfer is slowed down
+/// to the bandwidth in the settings, so that the progress events arrive like
+/// for a real camera.
+void RemoteReleaseControlImpl::TransferFile(const FileInfo& fileInfo, ShutterReleaseSettings& settings)
+{
+   RecordReleaseStage(releaseStageTransferStarted);
+
+   m_subjectDownloadEvent.Call(RemoteReleaseControl::downloadEventStarted, 0);
+
+   // camera tells us name of file; add to output folder here
+   CString filename = Path::Combine(
+      Path::FolderName(settings.Filename()),
+      Path::FilenameAndExt(fileInfo.m_filename));
+
+   settings.Filename(filename);
+
+   std::vector<BYTE> data = m_camera->ReadFile(fileInfo.m_filename);
+
+   FILE* fd = nullptr;
+   errno_t err = _tfopen_s(&fd, filename, _T("wb"));
+   if (err != 0 || fd == nullptr)
+      throw CameraException(_T("Simulated::RemoteReleaseControl::TransferFile"),
+         _T("Couldn't create file: ") + filename, 0, __FILE__, __LINE__);
+
+   std::shared_ptr<FILE> spAutoCloseFile(fd, fclose);
+
+   auto startTime = std::chrono::steady_clock::now();
+   unsigned int jitterInMilliseconds = m_camera->RandomJitterInMilliseconds();
+
+   for (size_t offset = 0; offset < data.size(); )
+   {
+      size_t size = std::min(c_transferChunkSize, data.size() - offset);
+
+      if (fwrite(data.data() + offset, 1, size, fd) != size)
+         throw CameraException(_T("Simulated::RemoteReleaseControl::TransferFile"),
+            _T("Couldn't write file: ") + filename, 0, __FILE__, __LINE__);
+
+      offset += size;
+
+      long long targetTimeInMilliseconds = jitterInMilliseconds + m_camera->TransferTimeInMilliseconds(offset);
+      long long elapsedTimeInMilliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(
+         std::chrono::steady_clock::now() - startTime).count();
+
+      if (targetTimeInMilliseconds > elapsedTimeInMilliseconds)
+         Sleep(static_cast<DWORD>(targetTimeInMilliseconds - elapsedTimeInMilliseconds));
+
+      m_subjectDownloadEvent.Call(RemoteReleaseControl::downloadEventInProgress,
+         static_cast<unsigned int>(offset * 100 / data.size()));
+   }
+
+   RecordReleaseStage(releaseStageTransferFinished);
+
+   m_subjectDownloadEvent.Call(RemoteReleaseControl::downloadEventFinished, 0);
+}
@@ -0,0 +1,148 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file SimulatedRemoteReleaseControlImpl.hpp Simulated camera - Remote release control impl
+//
+#pragma once
+
+#include "SimulatedCommon.hpp"
+#include "RemoteReleaseControl.hpp"
+#include "ShutterReleaseSettings.hpp"
+#include "CameraFileSystem.hpp"
+#include <ulib/Observer.hpp>
+#include <ulib/thread/LightweightMutex.hpp>
+#include <ulib/thread/Event.hpp>
+#include <atomic>
+
+class SingleThreadExecutor;
+
+namespace Simulated
+{
+   /// \brief implementation of RemoteReleaseControl for simulated cameras
+   /// \details Captures are done in the release thread, and transfers in a
+   /// separate transfer thread, so that the next image can be captured while
+   /// the previous one is still transferred, like real cameras do with their
+   /// image buffer.
+   class RemoteReleaseControlImpl : public RemoteReleaseControl
+   {
+   public:
+      /// ctor
+      RemoteReleaseControlImpl(RefSp ref, std::shared_ptr<Camera> camera);
+      /// dtor
+      virtual ~RemoteReleaseControlImpl();
+
+      // RemoteReleaseControl virtual functions
+
+      virtual bool GetCapability(T_enRemoteCapability remoteCapability) const override;
+
+      virtual void SetReleaseSettings(const ShutterReleaseSettings& settings) override;
+
+      virtual int AddPropertyEventHandler(RemoteReleaseControl::T_fnOnPropertyChanged onPropertyChanged) override
+      {
+         return m_subjectPropertyEvent.Add(onPropertyChanged);
+      }
+
+      virtual void RemovePropertyEventHandler(int handlerId) override
+      {
+         m_subjectPropertyEvent.Remove(handlerId);
+      }
+
+      virtual int AddStateEventHandler(RemoteReleaseControl::T_fnOnStateChanged onStateChanged) override
+      {
+         return m_subjectStateEvent.Add(onStateChanged);
+      }
+
+      virtual void RemoveStateEventHandler(int handlerId) override
+      {
+         m_subjectStateEvent.Remove(handlerId);
+      }
+
+      virtual int AddDownloadEventHandler(RemoteReleaseControl::T_fnOnDownloadChanged onDownloadChanged) override
+      {
+         return m_subjectDownloadEvent.Add(onDownloadChanged);
+      }
+
+      virtual void RemoveDownloadEventHandler(int handlerId) override
+      {
+         m_subjectDownloadEvent.Remove(handlerId);
+      }
+
+      virtual unsigned int MapImagePropertyTypeToId(T_enImagePropertyType imagePropertyType) const override;
+
+      virtual ImageProperty MapShootingModeToImagePropertyValue(T_enShootingMode shootingMode) const override;
+
+      virtual std::vector<unsigned int> EnumImageProperties() const override;
+
+      virtual ImageProperty GetImageProperty(unsigned int imagePropertyId) const override;
+
+      virtual void SetImageProperty(const ImageProperty& imageProperty) override;
+
+      virtual void EnumImagePropertyValues(unsigned int imagePropertyId, std::vector<ImageProperty>& valuesList) const override;
+
+      virtual std::shared_ptr<Viewfinder> StartViewfinder() const override;
+
+      virtual unsigned int NumAvailableShots() const override;
+
+      virtual void SendCommand(T_enCameraCommand cameraCommand) override;
+
+      virtual void Release() override;
+
+      virtual void ReleaseOnTrigger(T_fnReleaseTrigger releaseTrigger) override;
+
+      virtual std::shared_ptr<BulbReleaseControl> StartBulb() override;
+
+      virtual void Close() override;
+
+   private:
+      /// notifies property event handlers that a property changed; called in worker thread
+      void AsyncPropertyChanged(unsigned int imagePropertyId);
+
+      /// captures image, after the trigger function returned, if set; called in worker thread
+      void AsyncRelease(T_fnReleaseTrigger releaseTrigger);
+
+      /// transfers captured image to the host; called in transfer thread
+      void AsyncTransfer(const FileInfo& fileInfo, ShutterReleaseSettings settings);
+
+      /// transfers image data and writes it to the file in the release settings
+      void TransferFile(const FileInfo& fileInfo, ShutterReleaseSettings& settings);
+
+   private:
+      /// simulated camera reference
+      RefSp m_ref;
+
+      /// simulated camera
+      std::shared_ptr<Camera> m_camera;
+
+      /// indicates that the release control was closed
+      std::atomic<bool> m_isClosed;
+
+      /// number of captured images in the camera buffer, waiting to be transferred
+      std::atomic<unsigned int> m_numQueuedTransfers;
+
+      /// event that is set when an image was transferred and left the camera buffer
+      AutoResetEvent m_eventTransferFinished;
+
+      /// mutex to protect m_shutterReleaseSettings
+      LightweightMutex m_mutexShutterReleaseSettings;
+
+      /// shutter release settings
+      ShutterReleaseSettings m_shutterReleaseSettings;
+
+      /// subject of observer pattern; used for property events
+      Subject<void(RemoteReleaseControl::T_enPropertyEvent, unsigned int)> m_subjectPropertyEvent;
+
+      /// subject of observer pattern; used for state events
+      Subject<void(RemoteReleaseControl::T_enStateEvent, unsigned int)> m_subjectStateEvent;
+
+      /// subject of observer pattern; used for download events
+      Subject<void(RemoteReleaseControl::T_enDownloadEvent, unsigned int)> m_subjectDownloadEvent;
+
+      /// background thread executor for captures and property events
+      std::unique_ptr<SingleThreadExecutor> m_releaseThread;
+
+      /// background thread executor for image transfers
+      std::unique_ptr<SingleThreadExecutor> m_transferThread;
+   };
+
+} // namespace Simulated
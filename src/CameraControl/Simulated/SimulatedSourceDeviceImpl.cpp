@@ -0,0 +1,99 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file SimulatedSourceDeviceImpl.cpp Simulated camera - SourceDevice impl
+//
+#include "stdafx.h"
+#include "SimulatedSourceDeviceImpl.hpp"
+#include "SimulatedCamera.hpp"
+#include "SimulatedPropertyAccess.hpp"
+#include "SimulatedRemoteReleaseControlImpl.hpp"
+#include "SimulatedCameraFileSystemImpl.hpp"
+
+using Simulated::SourceDeviceImpl;
+
+SourceDeviceImpl::SourceDeviceImpl(RefSp ref, std::shared_ptr<Camera> camera)
+   :m_ref(ref),
+   m_camera(camera)
+{
+}
+
+SourceDeviceImpl::~SourceDeviceImpl()
+{
+}
+
+bool SourceDeviceImpl::GetDeviceCapability(T_enDeviceCapability deviceCapability) const
+{
+   switch (deviceCapability)
+   {
+   case SourceDevice::capRemoteReleaseControl:
+   case SourceDevice::capRemoteViewfinder:
+   case SourceDevice::capCameraFileSystem:
+      return true;
+
+   default:
+      ATLASSERT(false);
+      break;
+   }
+
+   return false;
+}
+
+CString SourceDeviceImpl::ModelName() const
+{
+   return m_camera->ModelName();
+}
+
+CString SourceDeviceImpl::SerialNumber() const
+{
+   return m_camera->SerialNumber();
+}
+
+std::vector<unsigned int> SourceDeviceImpl::EnumDeviceProperties() const
+{
+   return PropertyAccess::EnumDeviceProperties();
+}
+
+DeviceProperty SourceDeviceImpl::GetDeviceProperty(unsigned int propertyId) const
+{
+   Variant value;
+
+   switch (propertyId)
+   {
+   case devicePropertyModelName:
+      value.Set(ModelName());
+      value.SetType(Variant::typeString);
+      break;
+
+   case devicePropertySerialNumber:
+      value.Set(SerialNumber());
+      value.SetType(Variant::typeString);
+      break;
+
+   case devicePropertyFirmwareVersion:
+      value.Set(CString(_T("1.0.0")));
+      value.SetType(Variant::typeString);
+      break;
+
+   case devicePropertyBatteryLevel:
+      value = m_camera->GetPropertyValue(imagePropertyBatteryLevel);
+      break;
+
+   default:
+      throw CameraException(_T("Simulated::SourceDevice::GetDeviceProperty"),
+         _T("Invalid property id"), 0, __FILE__, __LINE__);
+   }
+
+   return PropertyAccess::CreateDeviceProperty(propertyId, value);
+}
+
+std::shared_ptr<CameraFileSystem> SourceDeviceImpl::GetFileSystem()
+{
+   return std::make_shared<CameraFileSystemImpl>(m_camera);
+}
+
+std::shared_ptr<RemoteReleaseControl> SourceDeviceImpl::EnterReleaseControl()
+{
+   return std::make_shared<RemoteReleaseControlImpl>(m_ref, m_camera);
+}
@@ -0,0 +1,47 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file SimulatedSourceDeviceImpl.hpp Simulated camera - SourceDevice impl
+//
+#pragma once
+
+#include "SimulatedCommon.hpp"
+#include "SourceDevice.hpp"
+
+namespace Simulated
+{
+   /// implementation of SourceDevice for simulated cameras
+   class SourceDeviceImpl : public SourceDevice
+   {
+   public:
+      /// ctor
+      SourceDeviceImpl(RefSp ref, std::shared_ptr<Camera> camera);
+      /// dtor
+      virtual ~SourceDeviceImpl();
+
+      // SourceDevice virtual functions
+
+      virtual bool GetDeviceCapability(T_enDeviceCapability deviceCapability) const override;
+
+      virtual CString ModelName() const override;
+
+      virtual CString SerialNumber() const override;
+
+      virtual std::vector<unsigned int> EnumDeviceProperties() const override;
+
+      virtual DeviceProperty GetDeviceProperty(unsigned int propertyId) const override;
+
+      virtual std::shared_ptr<CameraFileSystem> GetFileSystem() override;
+
+      virtual std::shared_ptr<RemoteReleaseControl> EnterReleaseControl() override;
+
+   private:
+      /// simulated camera reference
+      RefSp m_ref;
+
+      /// simulated camera
+      std::shared_ptr<Camera> m_camera;
+   };
+
+} // namespace Simulated
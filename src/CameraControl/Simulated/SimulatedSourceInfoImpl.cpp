@@ -0,0 +1,32 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file SimulatedSourceInfoImpl.cpp Simulated camera - SourceInfo impl
+//
+#include "stdafx.h"
+#include "SimulatedSourceInfoImpl.hpp"
+#include "SimulatedSourceDeviceImpl.hpp"
+
+using Simulated::SourceInfoImpl;
+
+CString SourceInfoImpl::Name() const
+{
+   CString name;
+   name.Format(_T("Simulated Camera %u [simulated]"), m_cameraIndex + 1);
+
+   return name;
+}
+
+CString SourceInfoImpl::DeviceId() const
+{
+   CString deviceId;
+   deviceId.Format(_T("simulated:%u"), m_cameraIndex + 1);
+
+   return deviceId;
+}
+
+std::shared_ptr<SourceDevice> SourceInfoImpl::Open()
+{
+   return std::make_shared<SourceDeviceImpl>(m_ref, m_camera);
+}
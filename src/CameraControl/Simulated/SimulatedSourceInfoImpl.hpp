@@ -0,0 +1,45 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file SimulatedSourceInfoImpl.hpp Simulated camera - SourceInfo impl
+//
+#pragma once
+
+#include "SimulatedCommon.hpp"
+#include "SourceInfo.hpp"
+
+namespace Simulated
+{
+   /// implementation of SourceInfo for simulated cameras
+   class SourceInfoImpl : public SourceInfo
+   {
+   public:
+      /// ctor
+      SourceInfoImpl(RefSp ref, std::shared_ptr<Camera> camera, unsigned int cameraIndex)
+         :m_ref(ref),
+         m_camera(camera),
+         m_cameraIndex(cameraIndex)
+      {
+      }
+
+      // SourceInfo virtual functions
+
+      virtual CString Name() const override;
+
+      virtual CString DeviceId() const override;
+
+      virtual std::shared_ptr<SourceDevice> Open() override;
+
+   private:
+      /// simulated camera reference
+      RefSp m_ref;
+
+      /// simulated camera
+      std::shared_ptr<Camera> m_camera;
+
+      /// camera index
+      unsigned int m_cameraIndex;
+   };
+
+} // namespace Simulated
@@ -0,0 +1,113 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file SimulatedViewfinderImpl.cpp Simulated camera - Viewfinder impl
+//
+#include "stdafx.h"
+#include "SimulatedViewfinderImpl.hpp"
+#include "SimulatedCamera.hpp"
+#include "SingleThreadExecutor.hpp"
+#include "PeriodicExecuteTimer.hpp"
+
+using Simulated::ViewfinderImpl;
+
+ViewfinderImpl::ViewfinderImpl(std::shared_ptr<Camera> camera)
+   :m_camera(camera),
+   m_executor(std::make_unique<SingleThreadExecutor>(_T("simulated viewfinder thread")))
+{
+}
+
+ViewfinderImpl::~ViewfinderImpl()
+{
+   try
+   {
+      Close();
+   }
+   catch (...)
+   {
+   }
+}
+
+bool ViewfinderImpl::GetCapability(T_enViewfinderCapability viewfinderCapability) const
+{
+   switch (viewfinderCapability)
+   {
+   case Viewfinder::capOutputTypeVideoOut:
+      return false;
+
+   case Viewfinder::capGetHistogram:
+      return true;
+
+   default:
+      ATLASSERT(false);
+      break;
+   }
+
+   return false;
+}
+
+void ViewfinderImpl::SetOutputType(T_enOutputType outputType)
+{
+   // simulated cameras have no display
+   UNUSED(outputType);
+}
+
+/// \details The timer period is rounded to milliseconds; the jitter in the
+/// camera settings delays each image by a random time.
+void ViewfinderImpl::SetAvailImageHandler(T_fnOnAvailViewfinderImage onAvailViewfinderImage)
+{
+   {
+      LightweightMutex::LockType lock(m_mutex);
+
+      m_onAvailViewfinderImage = onAvailViewfinderImage;
+   }
+
+   if (onAvailViewfinderImage == nullptr)
+   {
+      m_viewfinderImageTimer.reset();
+      return;
+   }
+
+   if (m_viewfinderImageTimer != nullptr)
+      return;
+
+   unsigned int framesPerSecond = std::max(1U, m_camera->Settings().m_viewfinderFramesPerSecond);
+
+   m_viewfinderImageTimer = std::make_unique<PeriodicExecuteTimer>(
+      *m_executor,
+      std::max(1U, 1000 / framesPerSecond),
+      std::bind(&ViewfinderImpl::OnSendViewfinderImage, this));
+}
+
+void ViewfinderImpl::GetHistogram(T_enHistogramType histogramType, std::vector<unsigned int>& histogramData)
+{
+   // images are grayscale, so all histograms are the same
+   UNUSED(histogramType);
+
+   LightweightMutex::LockType lock(m_mutex);
+
+   histogramData = m_histogram;
+}
+
+void ViewfinderImpl::Close()
+{
+   SetAvailImageHandler(T_fnOnAvailViewfinderImage());
+}
+
+void ViewfinderImpl::OnSendViewfinderImage()
+{
+   unsigned int jitterInMilliseconds = m_camera->RandomJitterInMilliseconds();
+   if (jitterInMilliseconds > 0)
+      Sleep(jitterInMilliseconds);
+
+   std::vector<unsigned int> histogram;
+   std::vector<BYTE> imageData = m_camera->CreateViewfinderImage(histogram);
+
+   LightweightMutex::LockType lock(m_mutex);
+
+   m_histogram.swap(histogram);
+
+   if (m_onAvailViewfinderImage != nullptr)
+      m_onAvailViewfinderImage(imageData);
+}
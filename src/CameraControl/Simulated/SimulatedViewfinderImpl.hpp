@@ -0,0 +1,70 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file SimulatedViewfinderImpl.hpp Simulated camera - Viewfinder impl
+//
+#pragma once
+
+#include "SimulatedCommon.hpp"
+#include "Viewfinder.hpp"
+#include <ulib/thread/LightweightMutex.hpp>
+
+class SingleThreadExecutor;
+class PeriodicExecuteTimer;
+
+namespace Simulated
+{
+   /// implementation of Viewfinder for simulated cameras; sends live view
+   /// images with the frame rate in the camera settings
+   class ViewfinderImpl : public Viewfinder
+   {
+   public:
+      /// ctor
+      explicit ViewfinderImpl(std::shared_ptr<Camera> camera);
+
+      /// dtor
+      virtual ~ViewfinderImpl();
+
+      // Viewfinder virtual functions
+
+      /// returns capability in live viewfinder mode
+      virtual bool GetCapability(T_enViewfinderCapability viewfinderCapability) const override;
+
+      /// sets viewfinder output type
+      virtual void SetOutputType(T_enOutputType outputType) override;
+
+      /// sets (or resets) viewfinder callback
+      virtual void SetAvailImageHandler(T_fnOnAvailViewfinderImage onAvailViewfinderImage = T_fnOnAvailViewfinderImage()) override;
+
+      /// returns histogram of last captured live viewfinder image (may be empty when none was captured so far)
+      virtual void GetHistogram(T_enHistogramType histogramType, std::vector<unsigned int>& histogramData) override;
+
+      /// closes viewfinder
+      virtual void Close() override;
+
+   private:
+      /// timer handler to send viewfinder image
+      void OnSendViewfinderImage();
+
+   private:
+      /// simulated camera
+      std::shared_ptr<Camera> m_camera;
+
+      /// mutex to protect m_onAvailViewfinderImage and m_histogram
+      LightweightMutex m_mutex;
+
+      /// viewfinder image handler
+      Viewfinder::T_fnOnAvailViewfinderImage m_onAvailViewfinderImage;
+
+      /// luminance histogram of last viewfinder image
+      std::vector<unsigned int> m_histogram;
+
+      /// background thread executor for the timer
+      std::unique_ptr<SingleThreadExecutor> m_executor;
+
+      /// timer for sending viewfinder images
+      std::unique_ptr<PeriodicExecuteTimer> m_viewfinderImageTimer;
+   };
+
+} // namespace Simulated
@@ -0,0 +1,239 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file SynchronizedRelease.cpp Synchronized release of multiple cameras
+//
+
+// includes
+#include "stdafx.h"
+#include "SynchronizedRelease.hpp"
+#include "CameraException.hpp"
+#include "SingleThreadExecutor.hpp"
+#include <ulib/thread/Event.hpp>
+#include <ulib/thread/LightweightMutex.hpp>
+#include <chrono>
+#include <cmath>
+
+/// time between all cameras being armed and the fire time; leaves the
+/// parked threads enough time to wake up before the fire time is reached
+const std::chrono::milliseconds c_fireLeadTime(5);
+
+/// \brief state of a single synchronized release
+/// \details The state is shared with the trigger functions, so that cameras
+/// that are armed late, after the release was canceled, don't access a
+/// destroyed object.
+struct SynchronizedRelease::TriggerState
+{
+   /// ctor
+   explicit TriggerState(size_t numCameras)
+      :m_numCameras(numCameras),
+      m_numArmed(0),
+      m_numTriggered(0),
+      m_isCanceled(false),
+      m_evtAllArmed(false),
+      m_evtFire(false),
+      m_evtAllTriggered(false),
+      m_triggerTimeList(numCameras),
+      m_isTriggeredList(numCameras, false)
+   {
+   }
+
+   /// number of cameras
+   size_t m_numCameras;
+
+   /// mutex to protect the members below
+   LightweightMutex m_mutex;
+
+   /// number of armed cameras
+   size_t m_numArmed;
+
+   /// number of triggered cameras, whose release command was sent
+   size_t m_numTriggered;
+
+   /// indicates that the release was canceled
+   bool m_isCanceled;
+
+   /// event that is set when all cameras are armed
+   ManualResetEvent m_evtAllArmed;
+
+   /// event that is set when the fire time is known, or the release was canceled
+   ManualResetEvent m_evtFire;
+
+   /// event that is set when the release commands of all cameras were sent
+   ManualResetEvent m_evtAllTriggered;
+
+   /// fire time
+   std::chrono::steady_clock::time_point m_fireTime;
+
+   /// trigger times of all cameras; the times when the release commands were sent
+   std::vector<std::chrono::steady_clock::time_point> m_triggerTimeList;
+
+   /// indicates which cameras were triggered
+   std::vector<bool> m_isTriggeredList;
+};
+
+SynchronizedRelease::SynchronizedRelease(const std::vector<std::shared_ptr<RemoteReleaseControl>>& remoteReleaseControlList)
+   :m_remoteReleaseControlList(remoteReleaseControlList)
+{
+   for (size_t cameraIndex = 0; cameraIndex < m_remoteReleaseControlList.size(); cameraIndex++)
+      m_armingThreadList.push_back(std::make_unique<SingleThreadExecutor>(_T("synchronized release arming thread")));
+}
+
+SynchronizedRelease::~SynchronizedRelease()
+{
+   // stop arming threads before the remote release controls are released
+   m_armingThreadList.clear();
+}
+
+SynchronizedRelease::Result SynchronizedRelease::Release(unsigned int armTimeoutInMilliseconds)
+{
+   if (m_remoteReleaseControlList.empty())
+      return Result();
+
+   std::shared_ptr<TriggerState> triggerState = std::make_shared<TriggerState>(m_remoteReleaseControlList.size());
+
+   for (size_t cameraIndex = 0; cameraIndex < m_remoteReleaseControlList.size(); cameraIndex++)
+   {
+      std::shared_ptr<RemoteReleaseControl> remoteReleaseControl = m_remoteReleaseControlList[cameraIndex];
+
+      m_armingThreadList[cameraIndex]->Schedule([remoteReleaseControl, triggerState, cameraIndex]()
+      {
+         try
+         {
+            remoteReleaseControl->ReleaseOnTrigger(
+               std::bind(&SynchronizedRelease::OnTrigger, triggerState, cameraIndex),
+               std::bind(&SynchronizedRelease::OnReleaseCommandSent, triggerState, cameraIndex));
+         }
+         catch (const CameraException& ex)
+         {
+            LOG_TRACE(_T("Exception while arming camera %Iu: %s\n"), cameraIndex, ex.Message().GetString());
+         }
+      });
+   }
+
+   if (!triggerState->m_evtAllArmed.Wait(armTimeoutInMilliseconds))
+   {
+      size_t numArmed = 0;
+      {
+         LightweightMutex::LockType lock(triggerState->m_mutex);
+         triggerState->m_isCanceled = true;
+         numArmed = triggerState->m_numArmed;
+      }
+
+      triggerState->m_evtFire.Set();
+
+      CString message;
+      message.Format(_T("Only %Iu of %Iu cameras could be armed for release"),
+         numArmed, m_remoteReleaseControlList.size());
+
+      throw CameraException(_T("SynchronizedRelease::Release"), message, 0, __FILE__, __LINE__);
+   }
+
+   {
+      LightweightMutex::LockType lock(triggerState->m_mutex);
+      triggerState->m_fireTime = std::chrono::steady_clock::now() + c_fireLeadTime;
+   }
+
+   triggerState->m_evtFire.Set();
+
+   if (!triggerState->m_evtAllTriggered.Wait(armTimeoutInMilliseconds))
+      LOG_TRACE(_T("Not all release commands were sent in time\n"));
+
+   LightweightMutex::LockType lock(triggerState->m_mutex);
+
+   return CalcResult(*triggerState);
+}
+
+/// \details The threads wait on the fire event until the fire time is known,
+/// then spin on the steady clock, which uses the performance counter, so that
+/// the time it takes for each thread to wake up doesn't add to the skew.
+bool SynchronizedRelease::OnTrigger(std::shared_ptr<TriggerState> triggerState, size_t cameraIndex)
+{
+   {
+      LightweightMutex::LockType lock(triggerState->m_mutex);
+
+      if (triggerState->m_isCanceled)
+         return false;
+
+      if (++triggerState->m_numArmed == triggerState->m_numCameras)
+         triggerState->m_evtAllArmed.Set();
+   }
+
+   triggerState->m_evtFire.Wait();
+
+   std::chrono::steady_clock::time_point fireTime;
+   {
+      LightweightMutex::LockType lock(triggerState->m_mutex);
+
+      if (triggerState->m_isCanceled)
+         return false;
+
+      fireTime = triggerState->m_fireTime;
+   }
+
+   while (std::chrono::steady_clock::now() < fireTime)
+      std::this_thread::yield();
+
+   return true;
+}
+
+/// \details The trigger time is taken when the release command was sent,
+/// since the implementations may still queue the command or prepare the
+/// camera after the trigger function returned, which adds to the skew.
+void SynchronizedRelease::OnReleaseCommandSent(std::shared_ptr<TriggerState> triggerState, size_t cameraIndex)
+{
+   std::chrono::steady_clock::time_point triggerTime = std::chrono::steady_clock::now();
+
+   LightweightMutex::LockType lock(triggerState->m_mutex);
+
+   triggerState->m_triggerTimeList[cameraIndex] = triggerTime;
+   triggerState->m_isTriggeredList[cameraIndex] = true;
+
+   if (++triggerState->m_numTriggered == triggerState->m_numCameras)
+      triggerState->m_evtAllTriggered.Set();
+}
+
+/// \details Must be called with the trigger state's mutex locked.
+SynchronizedRelease::Result SynchronizedRelease::CalcResult(const TriggerState& triggerState)
+{
+   Result result;
+   result.m_cameraResultList.resize(triggerState.m_numCameras);
+
+   std::vector<double> offsetList;
+
+   for (size_t cameraIndex = 0; cameraIndex < triggerState.m_numCameras; cameraIndex++)
+   {
+      if (!triggerState.m_isTriggeredList[cameraIndex])
+         continue;
+
+      double offset = std::chrono::duration<double, std::milli>(
+         triggerState.m_triggerTimeList[cameraIndex] - triggerState.m_fireTime).count();
+
+      result.m_cameraResultList[cameraIndex].m_isTriggered = true;
+      result.m_cameraResultList[cameraIndex].m_triggerOffsetInMilliseconds = offset;
+
+      offsetList.push_back(offset);
+   }
+
+   if (offsetList.empty())
+      return result;
+
+   auto minMax = std::minmax_element(offsetList.begin(), offsetList.end());
+   result.m_minOffsetInMilliseconds = *minMax.first;
+   result.m_maxOffsetInMilliseconds = *minMax.second;
+
+   double sum = 0.0;
+   for (double offset : offsetList)
+      sum += offset;
+
+   result.m_meanOffsetInMilliseconds = sum / offsetList.size();
+
+   double sumSquares = 0.0;
+   for (double offset : offsetList)
+      sumSquares += (offset - result.m_meanOffsetInMilliseconds) * (offset - result.m_meanOffsetInMilliseconds);
+
+   result.m_stdDevInMilliseconds = std::sqrt(sumSquares / offsetList.size());
+
+   return result;
+}
@@ -0,0 +1,100 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file ThumbnailCache.cpp Camera file thumbnail cache
+//
+
+// includes
+#include "stdafx.h"
+#include "ThumbnailCache.hpp"
+#include "Fnv1aHash.hpp"
+#include <ulib/Path.hpp>
+#include <shlobj.h>
+
+ThumbnailCache::ThumbnailCache(const CString& cacheFolder)
+   :m_cacheFolder(cacheFolder)
+{
+   if (!Path::FolderExists(m_cacheFolder))
+      Path::CreateDirectoryRecursive(m_cacheFolder);
+}
+
+CString ThumbnailCache::DefaultCacheFolder()
+{
+   return Path::SpecialFolder(CSIDL_LOCAL_APPDATA) + _T("\\RemotePhotoTool\\thumbnails\\");
+}
+
+bool ThumbnailCache::CanCache(const FileInfo& fileInfo)
+{
+   return !fileInfo.m_isInfoPending && fileInfo.m_modifiedTime != -1;
+}
+
+bool ThumbnailCache::Load(const CString& cameraSerialNumber, const FileInfo& fileInfo, std::vector<unsigned char>& data) const
+{
+   if (!CanCache(fileInfo))
+      return false;
+
+   FILE* fd = nullptr;
+   errno_t ret = _tfopen_s(&fd, CacheFilename(cameraSerialNumber, fileInfo), _T("rb"));
+   if (ret != 0 || fd == nullptr)
+      return false;
+
+   std::shared_ptr<FILE> file{ fd, &fclose };
+
+   data.clear();
+
+   unsigned char buffer[4096];
+   size_t read = 0;
+   while ((read = fread(buffer, 1, sizeof(buffer), file.get())) > 0)
+      data.insert(data.end(), buffer, buffer + read);
+
+   return ferror(file.get()) == 0;
+}
+
+/// \details The file is first written to a temporary file and then renamed,
+/// so that other instances browsing the same camera never read a partially
+/// written file.
+void ThumbnailCache::Store(const CString& cameraSerialNumber, const FileInfo& fileInfo, const std::vector<unsigned char>& data)
+{
+   if (!CanCache(fileInfo))
+      return;
+
+   CString cacheFilename = CacheFilename(cameraSerialNumber, fileInfo);
+
+   CString tempFilename;
+   tempFilename.Format(_T("%s.%lu.tmp"), cacheFilename.GetString(), GetCurrentThreadId());
+
+   FILE* fd = nullptr;
+   errno_t ret = _tfopen_s(&fd, tempFilename, _T("wb"));
+   if (ret != 0 || fd == nullptr)
+   {
+      LOG_TRACE(_T("couldn't write thumbnail cache file: %s\n"), tempFilename.GetString());
+      return;
+   }
+
+   size_t written = data.empty() ? 0 : fwrite(data.data(), 1, data.size(), fd);
+   bool error = fclose(fd) != 0 || written != data.size();
+
+   if (error ||
+      !MoveFileEx(tempFilename, cacheFilename, MOVEFILE_REPLACE_EXISTING))
+   {
+      DeleteFile(tempFilename);
+   }
+}
+
+CString ThumbnailCache::CacheFilename(const CString& cameraSerialNumber, const FileInfo& fileInfo) const
+{
+   long long modifiedTime = static_cast<long long>(fileInfo.m_modifiedTime);
+
+   // the terminating zero chars separate the strings
+   Fnv1aHash hash;
+   hash.Add(cameraSerialNumber.GetString(), (cameraSerialNumber.GetLength() + 1) * sizeof(TCHAR));
+   hash.Add(fileInfo.m_filename.GetString(), (fileInfo.m_filename.GetLength() + 1) * sizeof(TCHAR));
+   hash.Add(&fileInfo.m_fileSize, sizeof(fileInfo.m_fileSize));
+   hash.Add(&modifiedTime, sizeof(modifiedTime));
+
+   CString filename;
+   filename.Format(_T("%016I64x.thumb"), hash.Value());
+
+   return Path::Combine(m_cacheFolder, filename);
+}
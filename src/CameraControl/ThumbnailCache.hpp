@@ -0,0 +1,43 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file ThumbnailCache.hpp Camera file thumbnail cache
+//
+#pragma once
+
+// includes
+#include "CameraFileSystem.hpp"
+
+/// \brief on-disk cache for thumbnails of camera files
+/// \details The cache files are keyed by a hash of the camera serial number,
+/// the file path, the file size and the modification time, so that a file
+/// that was replaced on the camera never uses a stale thumbnail. Files
+/// without thumbnail are stored as empty cache files, so that the camera
+/// isn't asked again.
+class ThumbnailCache
+{
+public:
+   /// ctor; the cache folder is created when it doesn't exist yet
+   explicit ThumbnailCache(const CString& cacheFolder);
+
+   /// returns default cache folder, in the local app data folder
+   static CString DefaultCacheFolder();
+
+   /// returns if file infos are complete enough to be used as cache key
+   static bool CanCache(const FileInfo& fileInfo);
+
+   /// loads cached thumbnail; returns false when not cached
+   bool Load(const CString& cameraSerialNumber, const FileInfo& fileInfo, std::vector<unsigned char>& data) const;
+
+   /// stores thumbnail in cache; errors are ignored, since the cache is optional
+   void Store(const CString& cameraSerialNumber, const FileInfo& fileInfo, const std::vector<unsigned char>& data);
+
+private:
+   /// returns cache filename for given file
+   CString CacheFilename(const CString& cameraSerialNumber, const FileInfo& fileInfo) const;
+
+private:
+   /// folder to store thumbnail files
+   CString m_cacheFolder;
+};
@@ -0,0 +1,105 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file ThumbnailQueue.cpp Prioritized thumbnail request queue
+//
+
+// includes
+#include "stdafx.h"
+#include "ThumbnailQueue.hpp"
+#include "ThumbnailCache.hpp"
+#include "CameraException.hpp"
+#include "SingleThreadExecutor.hpp"
+
+ThumbnailQueue::ThumbnailQueue(const CString& cameraSerialNumber,
+   T_fnReadThumbnail fnReadThumbnail,
+   T_fnRetrieveFileInfo fnRetrieveFileInfo)
+   :m_cameraSerialNumber(cameraSerialNumber),
+   m_fnReadThumbnail(fnReadThumbnail),
+   m_fnRetrieveFileInfo(fnRetrieveFileInfo),
+   m_cache(std::make_unique<ThumbnailCache>(ThumbnailCache::DefaultCacheFolder())),
+   m_nextSequenceNumber(0),
+   m_workerThread(std::make_unique<SingleThreadExecutor>(_T("thumbnail thread")))
+{
+}
+
+ThumbnailQueue::~ThumbnailQueue()
+{
+   CancelAll();
+
+   // stop worker thread before the queue and cache are destroyed
+   m_workerThread.reset();
+}
+
+void ThumbnailQueue::Add(const FileInfo& fileInfo,
+   CameraFileSystem::T_fnThumbnailAvailable fnThumbnailAvailable,
+   CameraFileSystem::T_enThumbnailPriority priority)
+{
+   {
+      LightweightMutex::LockType lock(m_mutexQueue);
+
+      Request request;
+      request.m_fileInfo = fileInfo;
+      request.m_fnThumbnailAvailable = fnThumbnailAvailable;
+      request.m_priority = priority;
+      request.m_sequenceNumber = m_nextSequenceNumber++;
+
+      m_requestQueue.push(request);
+   }
+
+   m_workerThread->Schedule(std::bind(&ThumbnailQueue::AsyncProcessNextRequest, this));
+}
+
+void ThumbnailQueue::CancelAll()
+{
+   LightweightMutex::LockType lock(m_mutexQueue);
+
+   m_requestQueue = std::priority_queue<Request>();
+}
+
+/// \details Tasks of canceled requests find an empty queue and return.
+void ThumbnailQueue::AsyncProcessNextRequest()
+{
+   Request request;
+   {
+      LightweightMutex::LockType lock(m_mutexQueue);
+
+      if (m_requestQueue.empty())
+         return;
+
+      request = m_requestQueue.top();
+      m_requestQueue.pop();
+   }
+
+   std::vector<unsigned char> data;
+   try
+   {
+      data = GetThumbnailData(request.m_fileInfo);
+   }
+   catch (const CameraException& ex)
+   {
+      LOG_TRACE(_T("Exception while getting thumbnail of %s: %s\n"),
+         request.m_fileInfo.m_filename.GetString(),
+         ex.Message().GetString());
+   }
+
+   if (request.m_fnThumbnailAvailable != nullptr)
+      request.m_fnThumbnailAvailable(request.m_fileInfo, data);
+}
+
+std::vector<unsigned char> ThumbnailQueue::GetThumbnailData(FileInfo& fileInfo)
+{
+   if (fileInfo.m_isInfoPending && m_fnRetrieveFileInfo != nullptr)
+      m_fnRetrieveFileInfo(fileInfo);
+
+   std::vector<unsigned char> data;
+   if (m_cache->Load(m_cameraSerialNumber, fileInfo, data))
+      return data;
+
+   data = m_fnReadThumbnail(fileInfo);
+
+   m_cache->Store(m_cameraSerialNumber, fileInfo, data);
+
+   return data;
+}
@@ -0,0 +1,105 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file ThumbnailQueue.hpp Prioritized thumbnail request queue
+//
+#pragma once
+
+// includes
+#include "CameraFileSystem.hpp"
+#include <ulib/thread/LightweightMutex.hpp>
+#include <queue>
+
+class SingleThreadExecutor;
+class ThumbnailCache;
+
+/// \brief queue for thumbnail requests of a camera file system
+/// \details Requests are processed in a worker thread, by priority, and with
+/// the same priority, newest first. Thumbnails are looked up in the thumbnail
+/// cache first; only when not cached, the camera file system's function to
+/// read the thumbnail is called.
+class ThumbnailQueue
+{
+public:
+   /// function to read thumbnail from the camera; returns empty data when
+   /// the file has no thumbnail, and throws CameraException on errors
+   typedef std::function<std::vector<unsigned char>(const FileInfo&)> T_fnReadThumbnail;
+
+   /// function to retrieve pending file infos, which are needed for the cache key
+   typedef std::function<void(FileInfo&)> T_fnRetrieveFileInfo;
+
+   /// ctor
+   ThumbnailQueue(const CString& cameraSerialNumber,
+      T_fnReadThumbnail fnReadThumbnail,
+      T_fnRetrieveFileInfo fnRetrieveFileInfo = T_fnRetrieveFileInfo());
+
+   /// dtor; requests that weren't started yet are discarded
+   ~ThumbnailQueue();
+
+   /// adds thumbnail request
+   void Add(const FileInfo& fileInfo,
+      CameraFileSystem::T_fnThumbnailAvailable fnThumbnailAvailable,
+      CameraFileSystem::T_enThumbnailPriority priority);
+
+   /// cancels all requests that weren't started yet
+   void CancelAll();
+
+private:
+   /// thumbnail request
+   struct Request
+   {
+      /// file to get thumbnail for
+      FileInfo m_fileInfo;
+
+      /// handler to call when thumbnail is available
+      CameraFileSystem::T_fnThumbnailAvailable m_fnThumbnailAvailable;
+
+      /// request priority
+      CameraFileSystem::T_enThumbnailPriority m_priority;
+
+      /// sequence number; higher numbers are newer requests
+      unsigned long long m_sequenceNumber;
+
+      /// compares requests; the "largest" request is processed first
+      bool operator<(const Request& other) const
+      {
+         if (m_priority != other.m_priority)
+            return m_priority < other.m_priority;
+
+         return m_sequenceNumber < other.m_sequenceNumber;
+      }
+   };
+
+   /// processes request with highest priority; called in worker thread
+   void AsyncProcessNextRequest();
+
+   /// retrieves thumbnail, from the cache or from the camera
+   std::vector<unsigned char> GetThumbnailData(FileInfo& fileInfo);
+
+private:
+   /// serial number of the camera; part of the cache key
+   CString m_cameraSerialNumber;
+
+   /// function to read thumbnail from the camera
+   T_fnReadThumbnail m_fnReadThumbnail;
+
+   /// function to retrieve pending file infos
+   T_fnRetrieveFileInfo m_fnRetrieveFileInfo;
+
+   /// thumbnail cache
+   std::unique_ptr<ThumbnailCache> m_cache;
+
+   /// mutex to protect m_requestQueue and m_nextSequenceNumber
+   LightweightMutex m_mutexQueue;
+
+   /// queue with requests not started yet
+   std::priority_queue<Request> m_requestQueue;
+
+   /// next request sequence number
+   unsigned long long m_nextSequenceNumber;
+
+   /// worker thread; one task is scheduled per request, and each task
+   /// processes the request with the highest priority at that time
+   std::unique_ptr<SingleThreadExecutor> m_workerThread;
+};
@@ -1,6 +1,6 @@
 //
 // RemotePhotoTool - remote camera control software
-// Copyright (C) 2008-2014 Michael Fink
+// Copyright (C) 2008-2026 Michael Fink
 //
 /// \file Variant.cpp Canon control - Variant data
 //
@@ -119,16 +119,40 @@ CString Variant::ToString() const
       cszValue.Format(_T("%f"), Get<float>());
       break;
 
-   case typeInvalid:
-      cszValue = _T("invalid type");
+   case typeInt64:
+      cszValue.Format(_T("%I64i"), Get<long long>());
       break;
 
-   case typeInt64:
    case typeUInt64:
-   case typeByteBlock:
+      cszValue.Format(_T("%I64u"), Get<unsigned long long>());
+      break;
+
    case typeRational:
+      {
+         Rational rational = Get<Rational>();
+         cszValue.Format(_T("%i/%u"), rational.numerator, rational.denominator);
+      }
+      break;
+
    case typePoint:
+      {
+         Point point = Get<Point>();
+         cszValue.Format(_T("(%i, %i)"), point.x, point.y);
+      }
+      break;
+
    case typeRect:
+      {
+         Rect rect = Get<Rect>();
+         cszValue.Format(_T("(%i, %i) %ix%i"), rect.x, rect.y, rect.width, rect.height);
+      }
+      break;
+
+   case typeInvalid:
+      cszValue = _T("invalid type");
+      break;
+
+   case typeByteBlock:
    case typeTime:
       // not implement
 
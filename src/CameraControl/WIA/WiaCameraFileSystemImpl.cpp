@@ -73,12 +73,18 @@ std::vector<FileInfo> CameraFileSystemImpl::EnumFiles(const CString& path) const
 void CameraFileSystemImpl::StartDownload(const FileInfo& fileInfo, T_fnDownloadFinished fnDownloadFinished)
 {
    CComPtr<IWiaItem> item = FollowPath(m_wiaDeviceRootItem, fileInfo.m_filename);
-   if (item == nullptr)
-      return; // file not available anymore
+   CComQIPtr<IWiaDataTransfer> transfer;
+   if (item != nullptr)
+      transfer = item;
 
-   CComQIPtr<IWiaDataTransfer> transfer{ item };
    if (transfer == nullptr)
-      return; // transfer not possible
+   {
+      // file not available anymore, or transfer not possible
+      if (fnDownloadFinished != nullptr)
+         fnDownloadFinished(fileInfo, std::vector<unsigned char>(), false);
+
+      return;
+   }
 
    // the object frees itself when the refcount goes to zero
    WiaDataCallback* callback = new WiaDataCallback{ fileInfo, fnDownloadFinished };
@@ -79,7 +79,7 @@ HRESULT STDMETHODCALLTYPE WiaDataCallback::BandedDataCallback(LONG lMessage, LON
    }
 
    case IT_MSG_TERMINATION:
-      m_fnDownloadFinished(m_fileInfo, m_fileBuffer);
+      m_fnDownloadFinished(m_fileInfo, m_fileBuffer, true);
       break;
 
    default:
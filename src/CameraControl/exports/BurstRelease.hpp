@@ -0,0 +1,102 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file BurstRelease.hpp Continuous burst release with queued transfers
+//
+#pragma once
+
+// includes
+#include "RemoteReleaseControl.hpp"
+#include "ShutterReleaseSettings.hpp"
+
+/// \brief releases the shutter continuously, while captured images are transferred
+/// \details The next image is released as soon as the camera reports that the
+/// previous image was captured (RemoteReleaseControl::stateEventCaptureComplete),
+/// so the camera shoots at its own frame rate, while the transfers of the
+/// captured images are queued. The number of captured images that are not
+/// transferred yet is bounded; when the download queue is full, the next
+/// release waits until an image was transferred. An image that couldn't be
+/// transferred (RemoteReleaseControl::stateEventTransferError) frees its slot
+/// in the download queue, and the burst continues. Only supported when
+/// RemoteReleaseControl::GetCapability(capBurstMode) returns true.
+class BurstRelease
+{
+public:
+   /// status of the burst
+   struct Status
+   {
+      /// number of released images
+      unsigned int m_numReleased = 0;
+
+      /// number of captured images
+      unsigned int m_numCaptured = 0;
+
+      /// number of transferred images
+      unsigned int m_numTransferred = 0;
+
+      /// number of images whose transfer failed
+      unsigned int m_numFailedTransfers = 0;
+
+      /// indicates if the images are transferred to the host
+      bool m_transferImages = false;
+
+      /// maximum number of images queued for transfer
+      unsigned int m_maxQueuedTransfers = 0;
+
+      /// time since the burst was started, in seconds
+      double m_elapsedTimeInSeconds = 0.0;
+
+      /// sustained frame rate, measured between the first and the last captured image
+      double m_framesPerSecond = 0.0;
+
+      /// indicates if the burst is still releasing images
+      bool m_isRunning = false;
+
+      /// returns number of captured images that are queued for transfer
+      unsigned int NumQueuedTransfers() const
+      {
+         unsigned int numFinished = m_numTransferred + m_numFailedTransfers;
+         return m_transferImages && m_numCaptured > numFinished ? m_numCaptured - numFinished : 0;
+      }
+   };
+
+   /// ctor; takes remote release control and the maximum number of images in the download queue
+   BurstRelease(std::shared_ptr<RemoteReleaseControl> remoteReleaseControl, unsigned int maxQueuedTransfers);
+
+   /// dtor
+   ~BurstRelease();
+
+   /// starts burst; the finished transfer handler of the settings is called for
+   /// each transferred image, until this object is destroyed; when the max.
+   /// number of images is 0, the burst runs until Stop() is called
+   void Start(ShutterReleaseSettings settings, unsigned int maxNumImages = 0);
+
+   /// stops releasing images; already captured images are still transferred
+   void Stop();
+
+   /// returns current status of the burst
+   Status GetStatus() const;
+
+private:
+   struct BurstState;
+
+   /// called when the state of the camera has changed
+   static void OnStateEvent(std::shared_ptr<BurstState> burstState,
+      RemoteReleaseControl::T_enStateEvent enStateEvent, unsigned int eventData);
+
+   /// called when an image was transferred
+   static void OnFinishedTransfer(std::shared_ptr<BurstState> burstState,
+      ShutterReleaseSettings::T_fnOnFinishedTransfer fnOnFinishedTransfer,
+      const ShutterReleaseSettings& settings);
+
+   /// releases next image, when the previous image was captured and the download queue isn't full
+   static void ReleaseNext(BurstState& burstState);
+
+private:
+   /// state shared with the event handlers
+   std::shared_ptr<BurstState> m_burstState;
+
+   /// id of the state event handler
+   int m_stateEventHandlerId;
+};
@@ -15,19 +15,24 @@ struct FileInfo
 {
    /// default ctor
    FileInfo()
-      :m_fileSize(0UL),
-      m_modifiedTime(-1)
+      :m_fileSize(0ULL),
+      m_modifiedTime(-1),
+      m_isInfoPending(false)
    {
    }
 
    /// filename
    CString m_filename;
 
-   /// file size in bytes
-   unsigned long m_fileSize;
+   /// file size in bytes; 64-bit, since videos may be larger than 4 GB
+   unsigned long long m_fileSize;
 
    /// time of last file modification
    time_t m_modifiedTime;
+
+   /// indicates that file size and modification time aren't known yet; they
+   /// are retrieved in the background and passed to the file info handler
+   bool m_isInfoPending;
 };
 
 /// \brief camera file system
@@ -43,12 +48,81 @@ public:
    /// returns list of subfolders in this folder
    virtual std::vector<CString> EnumFolders(const CString& path) const = 0;
 
-   /// returns list of files in the folder
+   /// \brief returns list of files in the folder
+   /// \details File systems that cache listings may return files where the
+   /// file infos are still pending; see SetFileInfoHandler().
    virtual std::vector<FileInfo> EnumFiles(const CString& path) const = 0;
 
-   /// function that is called when download of a file has finished
-   typedef std::function<void(const FileInfo&, const std::vector<unsigned char>&)> T_fnDownloadFinished;
+   /// function that is called when pending file infos were retrieved, with
+   /// the folder path and a batch of updated file infos
+   typedef std::function<void(const CString&, const std::vector<FileInfo>&)> T_fnFileInfoAvailable;
+
+   /// sets handler that is called, in a worker thread, when pending file
+   /// infos were retrieved; file systems that always return complete file
+   /// infos never call the handler
+   virtual void SetFileInfoHandler(T_fnFileInfoAvailable /*fnFileInfoAvailable*/)
+   {
+   }
+
+   /// function that is called when download of a file has finished; the
+   /// third parameter indicates if the download succeeded; when it failed,
+   /// the data is empty
+   typedef std::function<void(const FileInfo&, const std::vector<unsigned char>&, bool)> T_fnDownloadFinished;
 
-   /// starts download of given file in a worker thread
+   /// starts download of given file in a worker thread; the handler is also
+   /// called when the download failed
    virtual void StartDownload(const FileInfo& fileInfo, T_fnDownloadFinished fnDownloadFinished) = 0;
+
+   /// function that is called while downloading a file, with the number of
+   /// bytes already written to the target file; return false to cancel
+   typedef std::function<bool(const FileInfo&, unsigned long long)> T_fnDownloadProgress;
+
+   /// function that is called when download to a file has finished; the
+   /// second parameter is the number of bytes written to the target file,
+   /// and the third indicates if the download was completed
+   typedef std::function<void(const FileInfo&, unsigned long long, bool)> T_fnDownloadToFileFinished;
+
+   /// \brief starts download of given file to a file on the host, in a worker thread
+   /// \details When the start offset isn't 0, the target file is kept and
+   /// the download is resumed at this offset, e.g. with the number of bytes
+   /// reported by the finished handler of a failed download. The default
+   /// implementation uses StartDownload(), so the whole file is kept in
+   /// memory; file systems that can read files in chunks override this.
+   virtual void StartDownloadToFile(const FileInfo& fileInfo, const CString& targetFilename,
+      unsigned long long startOffset,
+      T_fnDownloadProgress fnDownloadProgress,
+      T_fnDownloadToFileFinished fnDownloadFinished);
+
+   /// function that is called when a thumbnail was retrieved, with the
+   /// thumbnail image data, usually JPEG; the data is empty when the file has
+   /// no thumbnail
+   typedef std::function<void(const FileInfo&, const std::vector<unsigned char>&)> T_fnThumbnailAvailable;
+
+   /// priority of thumbnail requests
+   enum T_enThumbnailPriority
+   {
+      thumbnailPriorityLow = 0,     ///< e.g. for prefetching thumbnails of files not shown yet
+      thumbnailPriorityNormal = 1,  ///< for thumbnails of shown files
+      thumbnailPriorityHigh = 2,    ///< for thumbnail of selected file
+   };
+
+   /// \brief starts retrieving thumbnail of given file, in a worker thread
+   /// \details Requests with higher priority are processed first; requests
+   /// with the same priority are processed newest first, since these are
+   /// usually the files the user is looking at. Thumbnails are cached on
+   /// disk, so browsing the same files again doesn't access the camera. The
+   /// default implementation calls the handler right away, without data.
+   virtual void GetThumbnail(const FileInfo& fileInfo, T_fnThumbnailAvailable fnThumbnailAvailable,
+      T_enThumbnailPriority priority = thumbnailPriorityNormal);
+
+   /// cancels all thumbnail requests that weren't started yet, e.g. when
+   /// another folder is shown; handlers of canceled requests aren't called
+   virtual void CancelThumbnailRequests()
+   {
+   }
+
+protected:
+   /// opens target file for downloading; when start offset isn't 0, the
+   /// existing file is opened and positioned at the offset
+   static std::shared_ptr<FILE> OpenDownloadTargetFile(const CString& targetFilename, unsigned long long startOffset);
 };
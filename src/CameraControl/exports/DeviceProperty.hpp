@@ -41,6 +41,7 @@ private:
    friend PSREC::SourceDeviceImpl;
    friend GPhoto2::PropertyAccess;
    friend WIA::PropertyAccess;
+   friend Simulated::PropertyAccess;
    friend RemotePhotoTool::CameraControl::DeviceProperty;
 
    /// ctor
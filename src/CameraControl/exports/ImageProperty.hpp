@@ -84,6 +84,7 @@ private:
    friend GPhoto2::RemoteReleaseControlImpl;
    friend GPhoto2::PropertyAccess;
    friend WIA::RemoteReleaseControlImpl;
+   friend Simulated::PropertyAccess;
    friend class RemoteReleaseControl;
    friend class ShutterSpeedValue;
    friend class ImageFormat;
@@ -0,0 +1,35 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file ImagePropertyValueList.hpp Canon control - List of valid image property values
+//
+#pragma once
+
+// includes
+#include "ImageProperty.hpp"
+#include <unordered_map>
+
+/// list of valid values of an image property, with lookup by raw value
+class ImagePropertyValueList
+{
+public:
+   /// ctor; takes values as returned by RemoteReleaseControl::EnumImagePropertyValues()
+   explicit ImagePropertyValueList(std::vector<ImageProperty> vecValues);
+
+   /// returns all valid values
+   const std::vector<ImageProperty>& Values() const { return m_vecValues; }
+
+   /// finds index of value with given raw value; returns false when it's not a valid value
+   bool FindRawValue(unsigned int uiRawValue, size_t& uiIndex) const;
+
+   /// returns raw value of integer variant; returns false for all other types
+   static bool GetRawValue(const Variant& value, unsigned int& uiRawValue);
+
+private:
+   /// valid values
+   std::vector<ImageProperty> m_vecValues;
+
+   /// mapping from raw value to index into m_vecValues
+   std::unordered_map<unsigned int, size_t> m_mapRawValueToIndex;
+};
@@ -16,6 +16,7 @@ enum T_enSDKVariant
    variantPsrec,
    variantGphoto2,
    variantWia,
+   variantSimulated,
 };
 
 // forward declarations for implementation classes
@@ -54,6 +55,11 @@ namespace WIA
    class RemoteReleaseControlImpl;
 }
 
+namespace Simulated
+{
+   class PropertyAccess;
+}
+
 // forward references when compiling with C++/CLI
 namespace RemotePhotoTool
 {
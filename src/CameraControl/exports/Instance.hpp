@@ -11,6 +11,7 @@
 
 // forward references
 class SourceInfo;
+struct SimulatedCameraSettings;
 
 /// canon control instance class
 class Instance
@@ -19,9 +20,18 @@ public:
    /// callback function type for AsyncWaitForCamera()
    typedef std::function<void()> T_fnOnCameraAdded;
 
+   /// callback function type for SetEventsPendingHandler()
+   typedef std::function<void()> T_fnOnEventsPending;
+
    /// enables or disables logging; default: disabled
    static void EnableLogging(bool bEnable, const CString& cszLogfilePath);
 
+   /// \brief sets settings for simulated cameras
+   /// \details Simulated cameras are enumerated like real cameras, when the
+   /// number of cameras in the settings isn't 0; default: no simulated cameras.
+   /// Changing the settings replaces all simulated cameras.
+   static void SetSimulatedCameraSettings(const SimulatedCameraSettings& settings);
+
    /// returns new camera instance
    static Instance Get();
 
@@ -43,8 +53,16 @@ public:
    /// enumerates all devices
    void EnumerateDevices(std::vector<std::shared_ptr<SourceInfo>>& vecSourceDevices) const;
 
-   /// call this when idle, e.g. in your message loop, to do background processing
-   static void OnIdle();
+   /// call this when idle, e.g. in your message loop, to do background processing;
+   /// returns true when camera events were processed, and more may follow soon
+   static bool OnIdle();
+
+   /// \brief sets handler that is called when camera events are pending
+   /// \details Camera SDKs call the handler, from any thread, when events are
+   /// pending that need a call to OnIdle() to be delivered. Callers can then
+   /// call OnIdle() immediately, instead of waiting for the next poll cycle.
+   /// Only one handler can be set; pass an empty function to remove it.
+   static void SetEventsPendingHandler(T_fnOnEventsPending fnOnEventsPending = T_fnOnEventsPending());
 
 private:
    class Impl;
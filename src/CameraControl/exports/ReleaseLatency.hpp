@@ -0,0 +1,97 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file ReleaseLatency.hpp Canon control - Release latency statistics
+//
+#pragma once
+
+// includes
+#include <vector>
+
+/// stage of a shot, from requesting the release to the file written on disk
+enum T_enReleaseStage
+{
+   releaseStageRequested = 0,          ///< Release() was called
+   releaseStageCommandSent = 1,        ///< release command was sent to the camera
+   releaseStageCaptureComplete = 2,    ///< camera reported that the image was captured
+   releaseStageTransferStarted = 3,    ///< image transfer to the host started
+   releaseStageTransferFinished = 4,   ///< image transfer to the host finished
+   releaseStageFileWritten = 5,        ///< image file was written and the finished transfer handler is called
+   releaseStageMax = 6,
+};
+
+/// histogram of latencies, using logarithmic buckets
+class LatencyHistogram
+{
+public:
+   /// ctor
+   LatencyHistogram();
+
+   /// adds latency
+   void Add(double latencyInMilliseconds);
+
+   /// returns number of latencies added
+   size_t Count() const { return m_count; }
+
+   /// returns minimum latency
+   double Min() const { return m_count == 0 ? 0.0 : m_min; }
+
+   /// returns maximum latency
+   double Max() const { return m_count == 0 ? 0.0 : m_max; }
+
+   /// returns mean latency
+   double Mean() const { return m_count == 0 ? 0.0 : m_sum / m_count; }
+
+   /// returns latency that the given percentage (0..100) of latencies don't
+   /// exceed; the value is exact up to the bucket resolution of about 12%
+   double Percentile(double percentile) const;
+
+   /// returns bucket index for latency; latencies above 100 seconds go into
+   /// the last bucket
+   static size_t BucketFromLatency(double latencyInMilliseconds);
+
+   /// returns upper bound of bucket
+   static double BucketUpperBound(size_t bucketIndex);
+
+private:
+   /// number of latencies in each bucket
+   std::vector<unsigned int> m_bucketCountList;
+
+   /// number of latencies
+   size_t m_count;
+
+   /// minimum latency
+   double m_min;
+
+   /// maximum latency
+   double m_max;
+
+   /// sum of all latencies
+   double m_sum;
+};
+
+/// latency statistics of all shots of a remote release control session
+class ReleaseLatencyStatistics
+{
+public:
+   /// ctor
+   ReleaseLatencyStatistics();
+
+   /// adds latency from release request to given stage
+   void Add(T_enReleaseStage stage, double latencyInMilliseconds);
+
+   /// returns histogram of latencies from release request to given stage;
+   /// the histogram of releaseStageRequested counts the shots requested
+   const LatencyHistogram& Histogram(T_enReleaseStage stage) const;
+
+   /// returns number of shots requested
+   size_t NumShots() const { return Histogram(releaseStageRequested).Count(); }
+
+   /// returns name of release stage
+   static LPCTSTR StageName(T_enReleaseStage stage);
+
+private:
+   /// histograms for all stages
+   std::vector<LatencyHistogram> m_histogramList;
+};
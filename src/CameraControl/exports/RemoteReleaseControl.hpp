@@ -8,6 +8,8 @@
 
 // includes
 #include "ImageProperty.hpp"
+#include "ImagePropertyValueList.hpp"
+#include "ReleaseLatency.hpp"
 
 // forward references
 class ShutterReleaseSettings;
@@ -18,6 +20,9 @@ class BulbReleaseControl;
 class RemoteReleaseControl
 {
 public:
+   /// ctor
+   RemoteReleaseControl();
+
    /// dtor
    virtual ~RemoteReleaseControl() {}
 
@@ -36,6 +41,7 @@ public:
       capAFLock = 5,                   ///< supports AF lock/unlock
       capBulbMode = 6,                 ///< supports bulb mode
       capUILock = 7,                   ///< supports UI lock
+      capBurstMode = 8,                ///< supports burst shooting with BurstRelease, releasing while images are transferred
    };
 
    /// property event type
@@ -55,6 +61,8 @@ public:
       stateEventReleaseError = 3,   ///< error while Release(), e.g. focus couldn't be determined
       stateEventBulbExposureTime = 4,  ///< signals elapsed bulb exposure time (in seconds)
       stateEventInternalError = 5,  ///< an internal error in camera occured
+      stateEventCaptureComplete = 6,   ///< image was captured and the release settings for it were taken; the next image can be released while it is transferred
+      stateEventTransferError = 7,  ///< transfer of a captured image to the host failed; the finished transfer handler isn't called for this image
       stateEventInvalid
    };
 
@@ -158,9 +166,18 @@ public:
    /// sets image property
    virtual void SetImageProperty(const ImageProperty& imageProperty) = 0;
 
+   /// sets multiple image properties, e.g. all values for the next bracketing
+   /// shot; the default implementation sets the properties one by one,
+   /// skipping values that it already set and that didn't change since
+   virtual void SetImageProperties(const std::vector<ImageProperty>& vecImageProperties);
+
    /// enumerates possible values of given image property
    virtual void EnumImagePropertyValues(unsigned int uiImagePropertyId, std::vector<ImageProperty>& vecValues) const = 0;
 
+   /// returns possible values of given image property; the values are cached
+   /// until the camera reports changed values with propEventPropertyDescChanged
+   std::shared_ptr<const ImagePropertyValueList> GetCachedImagePropertyValues(unsigned int uiImagePropertyId) const;
+
    ////////////////////////////////////////////////
    // viewfinder
    ////////////////////////////////////////////////
@@ -181,13 +198,67 @@ public:
    /// presses the shutter release, taking a photo using the set properties and given shutter release settings
    virtual void Release() = 0;
 
+   /// function that is called right before the release command is sent; blocks
+   /// until the shot should be taken, and returns false to cancel the release
+   typedef std::function<bool()> T_fnReleaseTrigger;
+
+   /// presses the shutter release as soon as the trigger function returns; used
+   /// for synchronized release of multiple cameras; the default implementation
+   /// calls the trigger function in the calling thread, then calls Release()
+   virtual void ReleaseOnTrigger(T_fnReleaseTrigger fnReleaseTrigger);
+
+   /// function that is called when the release command was sent to the camera
+   typedef std::function<void()> T_fnReleaseCommandSent;
+
+   /// presses the shutter release as soon as the trigger function returns, and
+   /// calls the command sent function at the point where releaseStageCommandSent
+   /// is recorded; the function isn't called when the release fails
+   void ReleaseOnTrigger(T_fnReleaseTrigger fnReleaseTrigger, T_fnReleaseCommandSent fnReleaseCommandSent);
+
    /// starts bulb release; only supported when GetCapability(capBulbMode) returned true
    virtual std::shared_ptr<BulbReleaseControl> StartBulb() = 0;
 
+   /// returns latency statistics of all shots since the release control was
+   /// started, or since the statistics were last reset
+   ReleaseLatencyStatistics GetReleaseLatencyStatistics() const;
+
+   /// resets latency statistics
+   void ResetReleaseLatencyStatistics();
+
    ////////////////////////////////////////////////
    // cleanup
    ////////////////////////////////////////////////
 
    /// closes remote release control; no further method calls are possible on this instance
    virtual void Close() = 0;
+
+protected:
+   /// coalesces image properties with the same id; the last value is kept
+   static std::vector<ImageProperty> CoalesceImageProperties(const std::vector<ImageProperty>& vecImageProperties);
+
+   /// invalidates cached values of given image property, or all properties
+   /// when 0 is passed; must be called before sending propEventPropertyDescChanged
+   void InvalidateCachedImagePropertyValues(unsigned int uiImagePropertyId);
+
+   /// invalidates the current value of given image property that was set with
+   /// SetImageProperties(), or all values when 0 is passed; must be called
+   /// before sending propEventPropertyChanged
+   void InvalidateCurrentImagePropertyValue(unsigned int uiImagePropertyId);
+
+   /// records that the oldest pending shot reached given release stage;
+   /// releaseStageRequested starts a new shot, releaseStageFileWritten finishes it
+   void RecordReleaseStage(T_enReleaseStage enReleaseStage);
+
+   /// finishes oldest pending shot without a transfer, e.g. when saving to camera only
+   void FinishReleaseWithoutTransfer();
+
+private:
+   class ImagePropertyValueCache;
+   class ReleaseLatencyRecorder;
+
+   /// cache for possible image property values
+   std::shared_ptr<ImagePropertyValueCache> m_spImagePropertyValueCache;
+
+   /// recorder for release latencies
+   std::shared_ptr<ReleaseLatencyRecorder> m_spReleaseLatencyRecorder;
 };
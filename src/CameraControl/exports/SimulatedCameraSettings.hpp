@@ -0,0 +1,71 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file SimulatedCameraSettings.hpp Canon control - Simulated camera settings
+//
+#pragma once
+
+/// \brief settings for simulated cameras
+/// \details Simulated cameras behave like real cameras, without any camera
+/// attached; they produce synthetic JPEG images for live view and captures,
+/// and delay captures and transfers like a camera connected over USB would.
+/// Used for testing and benchmarking, e.g. with multiple cameras.
+struct SimulatedCameraSettings
+{
+   /// ctor; sets defaults resembling a DSLR connected over USB 2.0
+   SimulatedCameraSettings()
+      :m_numCameras(0),
+      m_imageWidth(6000),
+      m_imageHeight(4000),
+      m_imageBitsPerPixel(2.5),
+      m_viewfinderWidth(960),
+      m_viewfinderHeight(640),
+      m_viewfinderFramesPerSecond(30),
+      m_captureLatencyInMilliseconds(120),
+      m_bandwidthInMegabytesPerSecond(35.0),
+      m_jitterInMilliseconds(5),
+      m_numAvailableShots(999),
+      m_bufferSizeInImages(20)
+   {
+   }
+
+   /// number of simulated cameras; 0 disables simulated cameras
+   unsigned int m_numCameras;
+
+   /// width of captured images, in pixels
+   unsigned int m_imageWidth;
+
+   /// height of captured images, in pixels
+   unsigned int m_imageHeight;
+
+   /// size of captured images, in compressed bits per pixel; images are
+   /// padded to this size, so that transfers take realistic time
+   double m_imageBitsPerPixel;
+
+   /// width of live view images, in pixels
+   unsigned int m_viewfinderWidth;
+
+   /// height of live view images, in pixels
+   unsigned int m_viewfinderHeight;
+
+   /// number of live view images per second
+   unsigned int m_viewfinderFramesPerSecond;
+
+   /// time from sending the release command until the image is captured
+   unsigned int m_captureLatencyInMilliseconds;
+
+   /// bandwidth of the connection to the camera, used for image transfers
+   double m_bandwidthInMegabytesPerSecond;
+
+   /// maximum random delay added to captures, transfers and live view images
+   unsigned int m_jitterInMilliseconds;
+
+   /// number of shots that fit onto the simulated memory card
+   unsigned int m_numAvailableShots;
+
+   /// number of captured images the camera buffers until they are
+   /// transferred; when the buffer is full, the next capture waits until an
+   /// image was transferred, like a real camera shooting continuously
+   unsigned int m_bufferSizeInImages;
+};
@@ -0,0 +1,89 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file SynchronizedRelease.hpp Synchronized release of multiple cameras
+//
+#pragma once
+
+// includes
+#include "RemoteReleaseControl.hpp"
+
+// forward references
+class SingleThreadExecutor;
+
+/// \brief releases the shutters of multiple cameras at the same time
+/// \details Before each release, all cameras are armed: the release of each
+/// camera is started on the camera's release thread, which then waits on a
+/// barrier until all cameras are armed. Then a common fire time shortly in the
+/// future is set, and all threads wait on the high resolution steady clock
+/// until the fire time is reached. The time when the release command of each
+/// camera was sent is recorded, so that the remaining skew between the cameras
+/// can be reported.
+class SynchronizedRelease
+{
+public:
+   /// result of release for a single camera
+   struct CameraResult
+   {
+      /// indicates if the camera was triggered and the release command was sent
+      bool m_isTriggered = false;
+
+      /// time when the release command was sent, relative to the fire time
+      double m_triggerOffsetInMilliseconds = 0.0;
+   };
+
+   /// result of synchronized release
+   struct Result
+   {
+      /// results of all cameras, in the order the cameras were passed in
+      std::vector<CameraResult> m_cameraResultList;
+
+      /// earliest trigger offset of all triggered cameras
+      double m_minOffsetInMilliseconds = 0.0;
+
+      /// latest trigger offset of all triggered cameras
+      double m_maxOffsetInMilliseconds = 0.0;
+
+      /// mean trigger offset of all triggered cameras
+      double m_meanOffsetInMilliseconds = 0.0;
+
+      /// standard deviation of the trigger offsets
+      double m_stdDevInMilliseconds = 0.0;
+
+      /// returns skew, the time between the earliest and the latest trigger
+      double SkewInMilliseconds() const { return m_maxOffsetInMilliseconds - m_minOffsetInMilliseconds; }
+   };
+
+   /// ctor; takes remote release controls of all cameras to release
+   explicit SynchronizedRelease(const std::vector<std::shared_ptr<RemoteReleaseControl>>& remoteReleaseControlList);
+
+   /// dtor
+   ~SynchronizedRelease();
+
+   /// arms all cameras and releases them at the same time; returns when the
+   /// release commands of all cameras were sent, or the timeout elapsed;
+   /// throws CameraException when not all cameras could be armed within the
+   /// given timeout, and no camera is released
+   Result Release(unsigned int armTimeoutInMilliseconds = 2000);
+
+private:
+   struct TriggerState;
+
+   /// waits for the fire time; called on the release thread of a camera
+   static bool OnTrigger(std::shared_ptr<TriggerState> triggerState, size_t cameraIndex);
+
+   /// records the trigger time; called when the release command of a camera was sent
+   static void OnReleaseCommandSent(std::shared_ptr<TriggerState> triggerState, size_t cameraIndex);
+
+   /// calculates result from the recorded trigger times
+   static Result CalcResult(const TriggerState& triggerState);
+
+private:
+   /// remote release controls of all cameras
+   std::vector<std::shared_ptr<RemoteReleaseControl>> m_remoteReleaseControlList;
+
+   /// threads that arm the cameras; one thread per camera, since the default
+   /// implementation of RemoteReleaseControl::ReleaseOnTrigger() blocks
+   std::vector<std::unique_ptr<SingleThreadExecutor>> m_armingThreadList;
+};
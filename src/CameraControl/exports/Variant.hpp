@@ -1,6 +1,6 @@
 //
 // RemotePhotoTool - remote camera control software
-// Copyright (C) 2008-2019 Michael Fink
+// Copyright (C) 2008-2026 Michael Fink
 //
 /// \file Variant.hpp Canon control - Variant data
 //
@@ -8,9 +8,40 @@
 
 // includes
 #include <vector>
-#include <any>
+#include <variant>
+#include <memory>
+#include <cstring>
+#include <type_traits>
+
+namespace VariantDetail
+{
+   /// maps types to the type they are stored as in a Variant
+   template <typename T>
+   struct StorageTypeMapping
+   {
+      typedef T type; ///< stored type
+   };
+
+   /// maps long to a fixed size type
+   template <>
+   struct StorageTypeMapping<long>
+   {
+      typedef std::conditional<sizeof(long) == sizeof(int), int, long long>::type type; ///< stored type
+   };
+
+   /// maps unsigned long to a fixed size type
+   template <>
+   struct StorageTypeMapping<unsigned long>
+   {
+      typedef std::conditional<sizeof(unsigned long) == sizeof(unsigned int), unsigned int, unsigned long long>::type type; ///< stored type
+   };
+} // namespace VariantDetail
 
 /// variant class to hold values with dynamic type
+/// \details Scalar values, rationals, points and rects are stored inline.
+/// Strings use the reference counted CString buffer, and arrays are stored in
+/// a small inline buffer or in a shared, immutable buffer, so that copying a
+/// Variant never allocates memory.
 class Variant
 {
 public:
@@ -40,6 +71,47 @@ public:
       typeInvalid         = -1
    };
 
+   /// rational value
+   struct Rational
+   {
+      int numerator;          ///< numerator
+      unsigned int denominator;  ///< denominator
+
+      /// equality operator
+      bool operator==(const Rational& rhs) const
+      {
+         return numerator == rhs.numerator && denominator == rhs.denominator;
+      }
+   };
+
+   /// point value
+   struct Point
+   {
+      int x;   ///< x coordinate
+      int y;   ///< y coordinate
+
+      /// equality operator
+      bool operator==(const Point& rhs) const
+      {
+         return x == rhs.x && y == rhs.y;
+      }
+   };
+
+   /// rect value
+   struct Rect
+   {
+      int x;      ///< left coordinate
+      int y;      ///< top coordinate
+      int width;  ///< width
+      int height; ///< height
+
+      /// equality operator
+      bool operator==(const Rect& rhs) const
+      {
+         return x == rhs.x && y == rhs.y && width == rhs.width && height == rhs.height;
+      }
+   };
+
    /// returns current type
    VariantType Type() const { return m_enType; }
 
@@ -52,40 +124,16 @@ public:
    template <typename T>
    void Set(const T& val)
    {
-      m_variant = val;
+      m_value = static_cast<StorageType<T>>(val);
       m_bIsArray = false;
    }
 
-   /// sets value; specialized for unsigned long type
-   template <>
-   void Set(const unsigned long& val)
-   {
-      static_assert(sizeof(unsigned long) == sizeof(unsigned int),
-         "this only works when unsigned long and unsigned int have the same size");
-      Set<unsigned int>(val);
-   }
-
-   /// returns value
+   /// returns value; throws std::bad_variant_access when another type is stored
    template <typename T>
    T Get() const
    {
       ATLASSERT(m_bIsArray == false);
-      return std::any_cast<T>(m_variant);
-   }
-
-   /// returns string value
-   template <>
-   CString Get() const
-   {
-      ATLASSERT(m_bIsArray == false);
-      return std::any_cast<CString>(m_variant);
-   }
-
-   /// returns unsigned long value
-   template <>
-   unsigned long Get() const
-   {
-      return Get<unsigned int>();
+      return static_cast<T>(std::get<StorageType<T>>(m_value));
    }
 
    // array get/set
@@ -94,16 +142,30 @@ public:
    template <typename T>
    void SetArray(const std::vector<T>& vecVal)
    {
-      m_variant = vecVal;
+      static_assert(std::is_trivially_copyable<T>::value, "array elements must be trivially copyable");
+
+      m_value = ArrayData(vecVal.data(), vecVal.size() * sizeof(T), sizeof(T));
       m_bIsArray = true;
    }
 
-   /// returns array data
+   /// returns array data; arrays of bytes can be returned as any element type
    template <typename T>
    std::vector<T> GetArray() const
    {
+      static_assert(std::is_trivially_copyable<T>::value, "array elements must be trivially copyable");
+
       ATLASSERT(m_bIsArray == true);
-      return std::any_cast<std::vector<T>>(m_variant);
+      const ArrayData& arrayData = std::get<ArrayData>(m_value);
+
+      if ((arrayData.ElementSize() != sizeof(T) && arrayData.ElementSize() != 1) ||
+         arrayData.Size() % sizeof(T) != 0)
+         throw std::bad_variant_access();
+
+      std::vector<T> vecVal(arrayData.Size() / sizeof(T));
+      if (!vecVal.empty())
+         memcpy(vecVal.data(), arrayData.Data(), arrayData.Size());
+
+      return vecVal;
    }
 
    /// converts variant to string representation
@@ -115,30 +177,12 @@ public:
    /// formats variant type as string
    static LPCTSTR TypeAsString(VariantType vt);
 
-   /// sets raw variant value
-   void SetRaw(std::any& variant, VariantType enType, bool bIsArray)
-   {
-      m_variant = variant;
-      m_enType = enType;
-      m_bIsArray = bIsArray;
-   }
-
    /// equality operator
    bool operator==(const Variant& rhs) const
    {
-      if (m_enType == typeUInt32)
-         return IsValueEqual<unsigned int>(rhs);
-      else
-      if (m_enType == typeUInt16)
-         return IsValueEqual<unsigned short>(rhs);
-      else
-      if (m_enType == typeUInt8)
-         return IsValueEqual<unsigned char>(rhs);
-      else
-      {
-         ATLASSERT(false); // implement more comparison types when needed
-         return false;
-      }
+      return m_enType == rhs.m_enType &&
+         m_bIsArray == rhs.m_bIsArray &&
+         m_value == rhs.m_value;
    }
 
    /// compare function
@@ -148,31 +192,95 @@ public:
       if (m_enType != rhs.m_enType)
          return false;
 
-      if (!m_variant.has_value() && !rhs.m_variant.has_value())
+      if (m_value.index() == 0 && rhs.m_value.index() == 0)
          return true; // empty variants are equal
 
-      if ((!m_variant.has_value() && rhs.m_variant.has_value()) ||
-          (m_variant.has_value() && !rhs.m_variant.has_value()))
-         return false; // one of them is non-empty
+      const StorageType<T>* left = std::get_if<StorageType<T>>(&m_value);
+      const StorageType<T>* right = std::get_if<StorageType<T>>(&rhs.m_value);
+
+      return left != nullptr && right != nullptr && *left == *right;
+   }
+
+private:
+   /// array data, as raw bytes
+   class ArrayData
+   {
+   public:
+      /// ctor; creates empty array
+      ArrayData()
+         :m_uiSize(0),
+         m_uiElementSize(1)
+      {
+      }
 
-      try
+      /// ctor; copies array data
+      ArrayData(const void* pData, size_t uiSize, size_t uiElementSize)
+         :m_uiSize(uiSize),
+         m_uiElementSize(uiElementSize)
       {
-         T left = std::any_cast<T>(m_variant);
-         T right = std::any_cast<T>(rhs.m_variant);
+         const unsigned char* pBytes = static_cast<const unsigned char*>(pData);
 
-         return left == right;
+         if (uiSize <= c_uiInlineSize)
+         {
+            if (uiSize > 0)
+               memcpy(m_abInlineData, pBytes, uiSize);
+         }
+         else
+            m_spHeapData = std::make_shared<const std::vector<unsigned char>>(pBytes, pBytes + uiSize);
       }
-      catch (const std::bad_any_cast& ex)
+
+      /// returns array data
+      const unsigned char* Data() const
       {
-         ATLTRACE(_T("caught std::bad_any_cast: %hs\n"), ex.what());
+         return m_spHeapData != nullptr ? m_spHeapData->data() : m_abInlineData;
       }
 
-      return false;
-   }
+      /// returns size of array data, in bytes
+      size_t Size() const { return m_uiSize; }
+
+      /// returns size of an array element, in bytes
+      size_t ElementSize() const { return m_uiElementSize; }
+
+      /// equality operator
+      bool operator==(const ArrayData& rhs) const
+      {
+         return m_uiSize == rhs.m_uiSize &&
+            (m_uiSize == 0 || memcmp(Data(), rhs.Data(), m_uiSize) == 0);
+      }
+
+   private:
+      /// max. number of bytes stored inline
+      static const size_t c_uiInlineSize = 16;
+
+      /// inline data; used for small arrays
+      unsigned char m_abInlineData[c_uiInlineSize];
+
+      /// size of array data, in bytes
+      size_t m_uiSize;
+
+      /// size of an array element, in bytes
+      size_t m_uiElementSize;
+
+      /// heap data; used for arrays larger than the inline buffer
+      std::shared_ptr<const std::vector<unsigned char>> m_spHeapData;
+   };
+
+   /// type that a value of type T is stored as
+   template <typename T>
+   using StorageType = typename VariantDetail::StorageTypeMapping<T>::type;
 
-private:
    /// variant value
-   std::any m_variant;
+   std::variant<
+      std::monostate,
+      bool,
+      char, signed char, unsigned char,
+      short, unsigned short,
+      int, unsigned int,
+      long long, unsigned long long,
+      float, double,
+      Rational, Point, Rect,
+      CString,
+      ArrayData> m_value;
 
    /// variant type
    VariantType m_enType;
@@ -9,6 +9,8 @@
 #include "Instance.hpp"
 #include "CameraException.hpp"
 #include "SdkReferenceBase.hpp"
+#include <mutex>
+#include <atomic>
 
 struct _GPContext;
 struct _Camera;
@@ -69,4 +71,48 @@ namespace GPhoto2
    /// smart pointer to gPhoto2 reference
    typedef std::shared_ptr<Ref> RefSp;
 
+   /// \brief mutex to serialize access to a camera
+   /// \details libgphoto2 camera access must not be done from multiple threads
+   /// at once. The mutex is created by the source device and shared by all
+   /// objects accessing the camera, and is taken around every gp_camera_*()
+   /// call. It is recursive, so that functions holding it can call each other.
+   /// Threads waiting to lock the mutex are counted, so that the event loop
+   /// can let them go first.
+   class CameraMutex
+   {
+   public:
+      /// locks mutex; waits until other threads have unlocked it
+      void lock()
+      {
+         m_numWaitingThreads++;
+         m_mutex.lock();
+         m_numWaitingThreads--;
+      }
+
+      /// tries to lock mutex; returns false when another thread holds it
+      bool try_lock()
+      {
+         return m_mutex.try_lock();
+      }
+
+      /// unlocks mutex
+      void unlock()
+      {
+         m_mutex.unlock();
+      }
+
+      /// returns if other threads are waiting to lock the mutex
+      bool IsLockPending() const
+      {
+         return m_numWaitingThreads > 0;
+      }
+
+   private:
+      /// mutex
+      std::recursive_mutex m_mutex;
+
+      /// number of threads currently waiting in lock()
+      std::atomic<unsigned int> m_numWaitingThreads{ 0 };
+   };
+
 } // namespace GPhoto2
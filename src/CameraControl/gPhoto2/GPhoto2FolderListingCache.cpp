@@ -0,0 +1,164 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2020 Michael Fink
+//
+/// \file GPhoto2FolderListingCache.cpp gPhoto2 - Folder listing cache
+//
+#include "stdafx.h"
+#include "GPhoto2FolderListingCache.hpp"
+#include <algorithm>
+
+using GPhoto2::FolderListingCache;
+
+bool FolderListingCache::GetFolders(const CString& folder, std::vector<CString>& folderList) const
+{
+   LightweightMutex::LockType lock(m_mutex);
+
+   auto iter = m_folderListings.find(folder);
+   if (iter == m_folderListings.end())
+      return false;
+
+   folderList = iter->second;
+   return true;
+}
+
+void FolderListingCache::SetFolders(const CString& folder, const std::vector<CString>& folderList)
+{
+   LightweightMutex::LockType lock(m_mutex);
+
+   m_folderListings[folder] = folderList;
+}
+
+bool FolderListingCache::GetFiles(const CString& folder, std::vector<FileInfo>& fileList) const
+{
+   LightweightMutex::LockType lock(m_mutex);
+
+   auto iter = m_fileListings.find(folder);
+   if (iter == m_fileListings.end())
+      return false;
+
+   fileList = iter->second;
+   return true;
+}
+
+void FolderListingCache::SetFiles(const CString& folder, const std::vector<FileInfo>& fileList)
+{
+   LightweightMutex::LockType lock(m_mutex);
+
+   m_fileListings[folder] = fileList;
+}
+
+std::vector<FileInfo> FolderListingCache::GetPendingFiles(const CString& folder, size_t maxCount) const
+{
+   std::vector<FileInfo> pendingFileList;
+
+   LightweightMutex::LockType lock(m_mutex);
+
+   auto iter = m_fileListings.find(folder);
+   if (iter == m_fileListings.end())
+      return pendingFileList;
+
+   for (const FileInfo& fileInfo : iter->second)
+   {
+      if (pendingFileList.size() >= maxCount)
+         break;
+
+      if (fileInfo.m_isInfoPending)
+         pendingFileList.push_back(fileInfo);
+   }
+
+   return pendingFileList;
+}
+
+/// \details The folder may have been changed by camera events while the file
+/// infos were retrieved, so the files are looked up by filename.
+void FolderListingCache::UpdateFileInfos(const CString& folder, const std::vector<FileInfo>& fileList)
+{
+   LightweightMutex::LockType lock(m_mutex);
+
+   auto iter = m_fileListings.find(folder);
+   if (iter == m_fileListings.end())
+      return;
+
+   std::vector<FileInfo>& cachedFileList = iter->second;
+
+   for (const FileInfo& fileInfo : fileList)
+   {
+      auto iterFile = std::find_if(cachedFileList.begin(), cachedFileList.end(),
+         [&fileInfo](const FileInfo& cachedFileInfo) { return cachedFileInfo.m_filename == fileInfo.m_filename; });
+
+      if (iterFile == cachedFileList.end())
+         continue;
+
+      *iterFile = fileInfo;
+      iterFile->m_isInfoPending = false;
+   }
+}
+
+/// \details When the folder isn't cached yet, nothing is done, since the new
+/// file is part of the listing when the folder is enumerated the first time.
+void FolderListingCache::OnFileAdded(const CString& folder, const CString& name)
+{
+   LightweightMutex::LockType lock(m_mutex);
+
+   auto iter = m_fileListings.find(folder);
+   if (iter == m_fileListings.end())
+      return;
+
+   CString filename = GetFilename(folder, name);
+
+   std::vector<FileInfo>& cachedFileList = iter->second;
+
+   auto iterFile = std::find_if(cachedFileList.begin(), cachedFileList.end(),
+      [&filename](const FileInfo& cachedFileInfo) { return cachedFileInfo.m_filename == filename; });
+
+   if (iterFile != cachedFileList.end())
+   {
+      // file was overwritten; get file info again
+      iterFile->m_isInfoPending = true;
+      return;
+   }
+
+   FileInfo fileInfo;
+   fileInfo.m_filename = filename;
+   fileInfo.m_isInfoPending = true;
+
+   cachedFileList.push_back(fileInfo);
+}
+
+void FolderListingCache::OnFileRemoved(const CString& folder, const CString& name)
+{
+   LightweightMutex::LockType lock(m_mutex);
+
+   auto iter = m_fileListings.find(folder);
+   if (iter == m_fileListings.end())
+      return;
+
+   CString filename = GetFilename(folder, name);
+
+   std::vector<FileInfo>& cachedFileList = iter->second;
+
+   cachedFileList.erase(
+      std::remove_if(cachedFileList.begin(), cachedFileList.end(),
+         [&filename](const FileInfo& cachedFileInfo) { return cachedFileInfo.m_filename == filename; }),
+      cachedFileList.end());
+}
+
+void FolderListingCache::OnFolderAdded(const CString& folder, const CString& name)
+{
+   LightweightMutex::LockType lock(m_mutex);
+
+   auto iter = m_folderListings.find(folder);
+   if (iter == m_folderListings.end())
+      return;
+
+   std::vector<CString>& cachedFolderList = iter->second;
+
+   if (std::find(cachedFolderList.begin(), cachedFolderList.end(), name) == cachedFolderList.end())
+      cachedFolderList.push_back(name);
+}
+
+CString FolderListingCache::GetFilename(const CString& folder, const CString& name)
+{
+   return folder + _T("/") + name;
+}
@@ -0,0 +1,70 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2020 Michael Fink
+//
+/// \file GPhoto2FolderListingCache.hpp gPhoto2 - Folder listing cache
+//
+#pragma once
+
+#include "CameraFileSystem.hpp"
+#include <ulib/thread/LightweightMutex.hpp>
+#include <map>
+
+namespace GPhoto2
+{
+   /// \brief cache for folder and file listings of a camera
+   /// \details Listing a folder is cheap, but retrieving file infos needs a
+   /// USB round trip per file. The cache stores the listings, and file infos
+   /// are filled in later, in batches. The cache is shared by the camera file
+   /// system and the remote release control of a camera; camera events update
+   /// the cached listings instead of having to enumerate the folder again.
+   /// Folder paths are camera folder paths, e.g. /store_00010001/DCIM.
+   class FolderListingCache
+   {
+   public:
+      /// ctor
+      FolderListingCache() {}
+
+      /// returns cached subfolders of folder; returns false when not cached
+      bool GetFolders(const CString& folder, std::vector<CString>& folderList) const;
+
+      /// stores subfolders of folder
+      void SetFolders(const CString& folder, const std::vector<CString>& folderList);
+
+      /// returns cached files of folder; returns false when not cached
+      bool GetFiles(const CString& folder, std::vector<FileInfo>& fileList) const;
+
+      /// stores files of folder
+      void SetFiles(const CString& folder, const std::vector<FileInfo>& fileList);
+
+      /// returns up to given number of files in folder with pending file infos
+      std::vector<FileInfo> GetPendingFiles(const CString& folder, size_t maxCount) const;
+
+      /// updates file infos of cached files; the pending flag is reset for
+      /// all given files, even when their infos couldn't be retrieved
+      void UpdateFileInfos(const CString& folder, const std::vector<FileInfo>& fileList);
+
+      /// called when a file was added on the camera
+      void OnFileAdded(const CString& folder, const CString& name);
+
+      /// called when a file was deleted from the camera
+      void OnFileRemoved(const CString& folder, const CString& name);
+
+      /// called when a folder was added on the camera
+      void OnFolderAdded(const CString& folder, const CString& name);
+
+      /// returns camera filename for file in folder
+      static CString GetFilename(const CString& folder, const CString& name);
+
+   private:
+      /// mutex to protect the listings
+      mutable LightweightMutex m_mutex;
+
+      /// subfolders, by folder
+      std::map<CString, std::vector<CString>> m_folderListings;
+
+      /// files, by folder
+      std::map<CString, std::vector<FileInfo>> m_fileListings;
+   };
+
+} // namespace GPhoto2
@@ -8,46 +8,176 @@
 #include "GPhoto2PropertyAccess.hpp"
 #include "GPhoto2Include.hpp"
 #include "CameraException.hpp"
+#include <chrono>
 
 using GPhoto2::PropertyAccess;
 
-PropertyAccess::PropertyAccess(RefSp ref, std::shared_ptr<_GPContext> context, std::shared_ptr<_Camera> camera)
+/// returns the time elapsed since given start time, in milliseconds
+static double ElapsedMilliseconds(std::chrono::steady_clock::time_point startTime)
+{
+   return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+PropertyAccess::PropertyAccess(RefSp ref, std::shared_ptr<_GPContext> context, std::shared_ptr<_Camera> camera,
+   std::shared_ptr<CameraMutex> cameraMutex)
    :m_ref(ref),
    m_context(context),
-   m_camera(camera)
+   m_camera(camera),
+   m_cameraMutex(cameraMutex),
+   m_isSingleConfigSupported(true),
+   m_isWidgetTreeDumped(false)
 {
    Refresh();
 }
 
+/// \details The widget tree is only dumped to logging on the first refresh.
 void PropertyAccess::Refresh()
 {
-   m_mapImageProperties.clear();
-   m_mapPropertyNames.clear();
+   std::lock_guard<CameraMutex> lock(*m_cameraMutex);
+
+   std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
 
    CameraWidget* widget = nullptr;
    int ret = gp_camera_get_config(m_camera.get(), &widget, m_context.get());
    CheckError(_T("gp_camera_get_config"), ret, __FILE__, __LINE__);
 
+   m_mapWidgetsByName.clear();
+   m_mapWidgetsByLabel.clear();
+   m_mapWidgetsById.clear();
+   m_mapDeviceProperties.clear();
+   m_mapImageProperties.clear();
+   m_mapPropertyNames.clear();
+   m_mapSingleWidgets.clear();
+
    m_widget.reset(widget, gp_widget_free);
 
-   DumpWidgetTree(m_widget.get(), 0);
+   if (!m_isWidgetTreeDumped)
+   {
+      DumpWidgetTree(m_widget.get(), 0);
+      m_isWidgetTreeDumped = true;
+   }
+
+   RecursiveIndexWidgets(m_widget.get());
    RecursiveAddProperties(m_widget.get());
+
+   LOG_TRACE(_T("gPhoto2: refreshed all %Iu properties in %.1f ms\n"),
+      m_mapWidgetsById.size(),
+      ElapsedMilliseconds(startTime));
 }
 
-int PropertyAccess::LookupWidget(CameraWidget* widget, const char* key, CameraWidget** child)
+/// \details When the camera driver doesn't support single config values,
+/// or the property isn't known yet, all properties are refreshed instead.
+unsigned int PropertyAccess::RefreshPropertyByName(LPCSTR propertyName)
 {
-   int ret = gp_widget_get_child_by_name(widget, key, child);
+   std::lock_guard<CameraMutex> lock(*m_cameraMutex);
 
-   if (ret < GP_OK)
-      ret = gp_widget_get_child_by_label(widget, key, child);
+   auto iter = propertyName != nullptr ? m_mapWidgetsByName.find(propertyName) : m_mapWidgetsByName.end();
+   if (!m_isSingleConfigSupported || iter == m_mapWidgetsByName.end())
+   {
+      Refresh();
+      return 0;
+   }
+
+   std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+   CameraWidget* widget = nullptr;
+   int ret = gp_camera_get_single_config(m_camera.get(), propertyName, &widget, m_context.get());
+   if (ret == GP_ERROR_NOT_SUPPORTED)
+   {
+      LOG_TRACE(_T("gPhoto2: camera driver doesn't support single config values\n"));
+      m_isSingleConfigSupported = false;
+
+      Refresh();
+      return 0;
+   }
+
+   CheckError(_T("gp_camera_get_single_config"), ret, __FILE__, __LINE__);
+
+   std::shared_ptr<CameraWidget> newWidget(widget, gp_widget_free);
+
+   ReplaceWidget(iter->second, newWidget);
+
+   LOG_TRACE(_T("gPhoto2: refreshed property %hs in %.1f ms\n"),
+      propertyName,
+      ElapsedMilliseconds(startTime));
+
+   return GetPropertyIdFromWidget(newWidget.get());
+}
+
+/// \details Like gp_widget_get_child_by_name() and gp_widget_get_child_by_label(),
+/// names are looked up before labels, and the first widget in the tree wins.
+int PropertyAccess::LookupWidget(const char* key, CameraWidget** child) const
+{
+   auto iterName = m_mapWidgetsByName.find(key);
+   if (iterName != m_mapWidgetsByName.end())
+   {
+      *child = iterName->second;
+      return GP_OK;
+   }
+
+   auto iterLabel = m_mapWidgetsByLabel.find(key);
+   if (iterLabel != m_mapWidgetsByLabel.end())
+   {
+      *child = iterLabel->second;
+      return GP_OK;
+   }
+
+   return GP_ERROR_BAD_PARAMETERS;
+}
+
+void PropertyAccess::RecursiveIndexWidgets(CameraWidget* widget)
+{
+   const char* name = nullptr;
+   if (gp_widget_get_name(widget, &name) >= GP_OK && name != nullptr)
+      m_mapWidgetsByName.insert(std::make_pair(std::string(name), widget));
 
-   return ret;
+   const char* label = nullptr;
+   if (gp_widget_get_label(widget, &label) >= GP_OK && label != nullptr)
+      m_mapWidgetsByLabel.insert(std::make_pair(std::string(label), widget));
+
+   int count = gp_widget_count_children(widget);
+
+   for (int i = 0; i < count; i++)
+   {
+      CameraWidget* child = nullptr;
+      if (gp_widget_get_child(widget, i, &child) >= GP_OK)
+         RecursiveIndexWidgets(child);
+   }
+}
+
+/// \details The old widget is either part of the widget tree, which stays
+/// alive until the next refresh, or a previously retrieved single widget,
+/// which is freed here.
+void PropertyAccess::ReplaceWidget(CameraWidget* oldWidget, std::shared_ptr<CameraWidget> newWidget)
+{
+   auto replace = [&](auto& mapWidgets)
+   {
+      for (auto& value : mapWidgets)
+      {
+         if (value.second == oldWidget)
+            value.second = newWidget.get();
+      }
+   };
+
+   replace(m_mapWidgetsByName);
+   replace(m_mapWidgetsByLabel);
+   replace(m_mapWidgetsById);
+   replace(m_mapDeviceProperties);
+   replace(m_mapImageProperties);
+
+   const char* name = nullptr;
+   int ret = gp_widget_get_name(newWidget.get(), &name);
+   CheckError(_T("gp_widget_get_name"), ret, __FILE__, __LINE__);
+
+   m_mapSingleWidgets[std::string(name)] = newWidget;
 }
 
 CString PropertyAccess::GetText(LPCSTR configValueName) const
 {
+   std::lock_guard<CameraMutex> lock(*m_cameraMutex);
+
    CameraWidget* child = nullptr;
-   int ret = LookupWidget(m_widget.get(), configValueName, &child);
+   int ret = LookupWidget(configValueName, &child);
    CheckError(_T("LookupWidget"), ret, __FILE__, __LINE__);
 
    // This type check is optional, if you know what type the label
@@ -70,8 +200,10 @@ CString PropertyAccess::GetText(LPCSTR configValueName) const
 
 std::vector<CString> PropertyAccess::GetValidValues(LPCSTR configValueName) const
 {
+   std::lock_guard<CameraMutex> lock(*m_cameraMutex);
+
    CameraWidget* child = nullptr;
-   int ret = LookupWidget(m_widget.get(), configValueName, &child);
+   int ret = LookupWidget(configValueName, &child);
    CheckError(_T("LookupWidget"), ret, __FILE__, __LINE__);
 
    CameraWidgetType type;
@@ -102,6 +234,8 @@ bool PropertyAccess::GetCameraOperationAbility(unsigned int operation) const
 {
    CameraAbilities abilities = { 0 };
 
+   std::lock_guard<CameraMutex> lock(*m_cameraMutex);
+
    int ret = gp_camera_get_abilities(m_camera.get(), &abilities);
    if (ret < GP_OK)
       return false;
@@ -111,14 +245,18 @@ bool PropertyAccess::GetCameraOperationAbility(unsigned int operation) const
 
 bool PropertyAccess::IsAvailPropertyName(LPCSTR configValueName) const
 {
+   std::lock_guard<CameraMutex> lock(*m_cameraMutex);
+
    CameraWidget* child = nullptr;
-   int ret = LookupWidget(m_widget.get(), configValueName, &child);
+   int ret = LookupWidget(configValueName, &child);
 
    return ret == GP_OK && child != nullptr;
 }
 
 unsigned int PropertyAccess::MapImagePropertyTypeToId(T_enImagePropertyType imagePropertyType) const
 {
+   std::lock_guard<CameraMutex> lock(*m_cameraMutex);
+
    LPCSTR propertyName = nullptr;
    switch (imagePropertyType)
    {
@@ -164,7 +302,7 @@ unsigned int PropertyAccess::MapImagePropertyTypeToId(T_enImagePropertyType imag
    if (propertyName != nullptr)
    {
       CameraWidget* child = nullptr;
-      int ret = LookupWidget(m_widget.get(), CStringA(propertyName), &child);
+      int ret = LookupWidget(propertyName, &child);
       if (ret == GP_ERROR_BAD_PARAMETERS)
          return static_cast<unsigned int>(-1);
 
@@ -207,6 +345,8 @@ ImageProperty PropertyAccess::MapShootingModeToImagePropertyValue(RemoteReleaseC
 
 std::vector<unsigned int> PropertyAccess::EnumDeviceProperties() const
 {
+   std::lock_guard<CameraMutex> lock(*m_cameraMutex);
+
    std::vector<unsigned int> devicePropertiesList;
 
    for (const std::pair<unsigned int, CameraWidget*>& value : m_mapDeviceProperties)
@@ -219,6 +359,8 @@ std::vector<unsigned int> PropertyAccess::EnumDeviceProperties() const
 
 DeviceProperty PropertyAccess::GetDeviceProperty(unsigned int propertyId) const
 {
+   std::lock_guard<CameraMutex> lock(*m_cameraMutex);
+
    CameraWidget* child = GetWidgetFromPropertyId(propertyId);
 
    CameraWidgetType type = GP_WIDGET_WINDOW;
@@ -242,6 +384,8 @@ DeviceProperty PropertyAccess::GetDeviceProperty(unsigned int propertyId) const
 
 std::vector<unsigned int> PropertyAccess::EnumImageProperties() const
 {
+   std::lock_guard<CameraMutex> lock(*m_cameraMutex);
+
    std::vector<unsigned int> imagePropertiesList;
 
    for (const std::pair<unsigned int, CameraWidget*>& value : m_mapImageProperties)
@@ -254,6 +398,8 @@ std::vector<unsigned int> PropertyAccess::EnumImageProperties() const
 
 ImageProperty PropertyAccess::GetImageProperty(unsigned int imagePropertyId) const
 {
+   std::lock_guard<CameraMutex> lock(*m_cameraMutex);
+
    if (m_mapImageProperties.find(imagePropertyId) == m_mapImageProperties.end())
       CheckError(_T("m_mapImageProperties"), GP_ERROR, __FILE__, __LINE__);
 
@@ -278,6 +424,8 @@ ImageProperty PropertyAccess::GetImageProperty(unsigned int imagePropertyId) con
 
 std::vector<ImageProperty> PropertyAccess::EnumImagePropertyValues(unsigned int imagePropertyId) const
 {
+   std::lock_guard<CameraMutex> lock(*m_cameraMutex);
+
    if (imagePropertyId == static_cast<unsigned int>(-1))
       return std::vector<ImageProperty>();
 
@@ -312,8 +460,10 @@ std::vector<ImageProperty> PropertyAccess::EnumImagePropertyValues(unsigned int
 
 void PropertyAccess::SetPropertyByName(LPCTSTR propertyName, const Variant& value)
 {
+   std::lock_guard<CameraMutex> lock(*m_cameraMutex);
+
    CameraWidget* child = nullptr;
-   int ret = LookupWidget(m_widget.get(), CStringA(propertyName), &child);
+   int ret = LookupWidget(CStringA(propertyName), &child);
    CheckError(_T("LookupWidget"), ret, __FILE__, __LINE__);
 
    SetPropertyByWidget(child, value);
@@ -321,12 +471,129 @@ void PropertyAccess::SetPropertyByName(LPCTSTR propertyName, const Variant& valu
 
 void PropertyAccess::SetPropertyById(unsigned int propertyId, const Variant& value)
 {
+   std::lock_guard<CameraMutex> lock(*m_cameraMutex);
+
    CameraWidget* widget = GetWidgetFromPropertyId(propertyId);
 
    SetPropertyByWidget(widget, value);
 }
 
+/// \details Only properties with a changed value are marked as changed in
+/// the widget tree, and all of them are then written with one
+/// gp_camera_set_config() call.
+void PropertyAccess::SetProperties(const std::vector<ImageProperty>& imagePropertyList)
+{
+   std::lock_guard<CameraMutex> lock(*m_cameraMutex);
+
+   std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+   // don't write values again that were already written by single config calls
+   RecursiveClearChanged(m_widget.get());
+
+   size_t numChangedProperties = 0;
+
+   for (const ImageProperty& imageProperty : imagePropertyList)
+   {
+      CameraWidget* widget = GetWidgetFromPropertyId(imageProperty.Id());
+
+      CameraWidgetType type = GP_WIDGET_WINDOW;
+      int ret = gp_widget_get_type(widget, &type);
+      CheckError(_T("gp_widget_get_type"), ret, __FILE__, __LINE__);
+
+      Variant currentValue;
+      ReadPropertyValue(widget, currentValue, type);
+
+      if (currentValue.ToString() == imageProperty.Value().ToString())
+         continue;
+
+      SetWidgetValue(widget, imageProperty.Value());
+
+      // widgets retrieved by single config calls aren't part of the widget tree
+      const char* name = nullptr;
+      ret = gp_widget_get_name(widget, &name);
+      CheckError(_T("gp_widget_get_name"), ret, __FILE__, __LINE__);
+
+      if (m_mapSingleWidgets.find(name) != m_mapSingleWidgets.end())
+      {
+         CameraWidget* treeWidget = nullptr;
+         ret = gp_widget_get_child_by_name(m_widget.get(), name, &treeWidget);
+         CheckError(_T("gp_widget_get_child_by_name"), ret, __FILE__, __LINE__);
+
+         SetWidgetValue(treeWidget, imageProperty.Value());
+      }
+
+      numChangedProperties++;
+   }
+
+   if (numChangedProperties == 0)
+      return;
+
+   bool retry;
+   do
+   {
+      retry = false;
+
+      int ret = gp_camera_set_config(m_camera.get(), m_widget.get(), m_context.get());
+      if (ret == GP_ERROR_CAMERA_BUSY)
+      {
+         ATLTRACE(_T("retrying setting values\n"));
+         retry = true;
+         Sleep(100);
+      }
+      else
+         CheckError(_T("gp_camera_set_config"), ret, __FILE__, __LINE__);
+   } while (retry);
+
+   LOG_TRACE(_T("gPhoto2: set %Iu of %Iu properties in %.1f ms\n"),
+      numChangedProperties,
+      imagePropertyList.size(),
+      ElapsedMilliseconds(startTime));
+}
+
+/// \details The value is written with gp_camera_set_single_config() when the
+/// camera driver supports it, and with the whole widget tree otherwise.
 void PropertyAccess::SetPropertyByWidget(CameraWidget* widget, const Variant& value)
+{
+   SetWidgetValue(widget, value);
+
+   const char* name = nullptr;
+   int ret = gp_widget_get_name(widget, &name);
+   CheckError(_T("gp_widget_get_name"), ret, __FILE__, __LINE__);
+
+   std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+   bool retry;
+   do
+   {
+      retry = false;
+
+      ret = m_isSingleConfigSupported
+         ? gp_camera_set_single_config(m_camera.get(), name, widget, m_context.get())
+         : gp_camera_set_config(m_camera.get(), m_widget.get(), m_context.get());
+
+      if (ret == GP_ERROR_NOT_SUPPORTED && m_isSingleConfigSupported)
+      {
+         LOG_TRACE(_T("gPhoto2: camera driver doesn't support single config values\n"));
+         m_isSingleConfigSupported = false;
+         retry = true;
+      }
+      else if (ret == GP_ERROR_CAMERA_BUSY)
+      {
+         ATLTRACE(_T("retrying setting value: ") + value.ToString());
+         retry = true;
+         Sleep(100);
+      }
+      else
+         CheckError(m_isSingleConfigSupported ? _T("gp_camera_set_single_config") : _T("gp_camera_set_config"),
+            ret, __FILE__, __LINE__);
+   } while (retry);
+
+   LOG_TRACE(_T("gPhoto2: set property %hs in %.1f ms\n"),
+      name,
+      ElapsedMilliseconds(startTime));
+}
+
+void PropertyAccess::SetWidgetValue(CameraWidget* widget, const Variant& value)
 {
    CameraWidgetType type = GP_WIDGET_WINDOW;
    int ret = gp_widget_get_type(widget, &type);
@@ -369,22 +636,20 @@ void PropertyAccess::SetPropertyByWidget(CameraWidget* widget, const Variant& va
    }
 
    CheckError(_T("gp_widget_set_value"), ret, __FILE__, __LINE__);
+}
 
-   bool retry;
-   do
-   {
-      retry = false;
+void PropertyAccess::RecursiveClearChanged(CameraWidget* widget)
+{
+   gp_widget_set_changed(widget, 0);
 
-      ret = gp_camera_set_config(m_camera.get(), m_widget.get(), m_context.get());
-      if (ret == GP_ERROR_CAMERA_BUSY)
-      {
-         ATLTRACE(_T("retrying setting value: ") + value.ToString());
-         retry = true;
-         Sleep(100);
-      }
-      else
-         CheckError(_T("gp_camera_set_config"), ret, __FILE__, __LINE__);
-   } while (retry);
+   int count = gp_widget_count_children(widget);
+
+   for (int i = 0; i < count; i++)
+   {
+      CameraWidget* child = nullptr;
+      if (gp_widget_get_child(widget, i, &child) >= GP_OK)
+         RecursiveClearChanged(child);
+   }
 }
 
 unsigned int PropertyAccess::GetPropertyIdFromWidget(CameraWidget* widget)
@@ -400,13 +665,9 @@ unsigned int PropertyAccess::GetPropertyIdFromWidget(CameraWidget* widget)
 
 CameraWidget* PropertyAccess::GetWidgetFromPropertyId(unsigned int propertyId) const
 {
-   auto iterDevice = m_mapDeviceProperties.find(propertyId);
-   if (iterDevice != m_mapDeviceProperties.end())
-      return iterDevice->second;
-
-   auto iterImage = m_mapImageProperties.find(propertyId);
-   if (iterImage != m_mapImageProperties.end())
-      return iterImage->second;
+   auto iter = m_mapWidgetsById.find(propertyId);
+   if (iter != m_mapWidgetsById.end())
+      return iter->second;
 
    CheckError(_T("GetPropertyIdFromWidget"), GP_ERROR, __FILE__, __LINE__);
    return nullptr;
@@ -511,6 +772,8 @@ CString PropertyAccess::DisplayTextFromIdAndValue(unsigned int propertyId, Varia
 
 LPCTSTR PropertyAccess::NameFromId(unsigned int propertyId)
 {
+   std::lock_guard<CameraMutex> lock(*m_cameraMutex);
+
    if (m_mapPropertyNames.find(propertyId) == m_mapPropertyNames.end())
       return _T("???");
 
@@ -547,8 +810,10 @@ void PropertyAccess::RecursiveAddProperties(CameraWidget* widget)
    {
       unsigned int propertyId = GetPropertyIdFromWidget(widget);
 
-      if (m_mapDeviceProperties.find(propertyId) != m_mapDeviceProperties.end())
-         return; // already a device property
+      if (m_mapWidgetsById.find(propertyId) != m_mapWidgetsById.end())
+         return; // already added
+
+      m_mapWidgetsById.insert(std::make_pair(propertyId, widget));
 
       const char* name = nullptr;
       gp_widget_get_name(widget, &name);
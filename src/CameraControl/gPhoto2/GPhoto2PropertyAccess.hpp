@@ -11,6 +11,8 @@
 #include "DeviceProperty.hpp"
 #include "ImageProperty.hpp"
 #include "RemoteReleaseControl.hpp"
+#include <ulib/thread/LightweightMutex.hpp>
+#include <unordered_map>
 
 /// camera widget type
 typedef struct _CameraWidget CameraWidget;
@@ -22,11 +24,17 @@ namespace GPhoto2
    {
    public:
       /// ctor
-      PropertyAccess(RefSp ref, std::shared_ptr<_GPContext> context, std::shared_ptr<_Camera> camera);
+      PropertyAccess(RefSp ref, std::shared_ptr<_GPContext> context, std::shared_ptr<_Camera> camera,
+         std::shared_ptr<CameraMutex> cameraMutex);
 
       /// refreshes all properties from the camera
       void Refresh();
 
+      /// refreshes single property with given gPhoto2 name, after it was
+      /// changed on the camera; returns the property ID, or 0 when all
+      /// properties had to be refreshed
+      unsigned int RefreshPropertyByName(LPCSTR propertyName);
+
       /// returns config value of camera, as text
       CString GetText(LPCSTR configValueName) const;
 
@@ -66,6 +74,9 @@ namespace GPhoto2
       /// sets property by property ID
       void SetPropertyById(unsigned int propertyId, const Variant& value);
 
+      /// sets multiple properties with one config write
+      void SetProperties(const std::vector<ImageProperty>& imagePropertyList);
+
       /// returns displayable text from property id and value
       CString DisplayTextFromIdAndValue(unsigned int propertyId, Variant value);
 
@@ -73,12 +84,24 @@ namespace GPhoto2
       LPCTSTR NameFromId(unsigned int propertyId);
 
    private:
-      /// looks up child widget by widget name or label
-      static int LookupWidget(CameraWidget* widget, const char* key, CameraWidget** child);
+      /// looks up widget by widget name or label, using the widget index
+      int LookupWidget(const char* key, CameraWidget** child) const;
+
+      /// adds widget and all sub-widgets to the widget index
+      void RecursiveIndexWidgets(CameraWidget* widget);
+
+      /// replaces widget in all indices with a newly retrieved widget
+      void ReplaceWidget(CameraWidget* oldWidget, std::shared_ptr<CameraWidget> newWidget);
 
       /// sets property value for given widget
       void SetPropertyByWidget(CameraWidget* widget, const Variant& value);
 
+      /// sets value of widget, without writing it to the camera
+      static void SetWidgetValue(CameraWidget* widget, const Variant& value);
+
+      /// clears changed flag of widget and all sub-widgets
+      static void RecursiveClearChanged(CameraWidget* widget);
+
       /// gets a property ID from given widget
       static unsigned int GetPropertyIdFromWidget(CameraWidget* widget);
 
@@ -107,9 +130,32 @@ namespace GPhoto2
       /// camera instance
       std::shared_ptr<_Camera> m_camera;
 
+      /// mutex to serialize camera access; also protects widgets and indices,
+      /// since properties are refreshed from the release control's event
+      /// thread, too
+      std::shared_ptr<CameraMutex> m_cameraMutex;
+
       /// camera widget with all configurable properties
       std::shared_ptr<CameraWidget> m_widget;
 
+      /// widgets retrieved by gp_camera_get_single_config since the last refresh, by name
+      std::map<std::string, std::shared_ptr<CameraWidget>> m_mapSingleWidgets;
+
+      /// indicates if the camera driver supports accessing single config values
+      bool m_isSingleConfigSupported;
+
+      /// indicates if the widget tree was already dumped to logging
+      bool m_isWidgetTreeDumped;
+
+      /// widget index, by widget name
+      std::unordered_map<std::string, CameraWidget*> m_mapWidgetsByName;
+
+      /// widget index, by widget label
+      std::unordered_map<std::string, CameraWidget*> m_mapWidgetsByLabel;
+
+      /// widget index, by property ID
+      std::unordered_map<unsigned int, CameraWidget*> m_mapWidgetsById;
+
       /// device properties, by property ID
       std::map<unsigned int, CameraWidget*> m_mapDeviceProperties;
 
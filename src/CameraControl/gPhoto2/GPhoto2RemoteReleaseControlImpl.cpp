@@ -11,17 +11,34 @@
 #include "SingleThreadExecutor.hpp"
 #include "GPhoto2ViewfinderImpl.hpp"
 #include "GPhoto2BulbReleaseControlImpl.hpp"
+#include "Gphoto2CameraFileSystemImpl.hpp"
+#include "GPhoto2FolderListingCache.hpp"
 #include "GPhoto2Include.hpp"
+#include <ulib/Path.hpp>
+#include <ulib/thread/Event.hpp>
+#include <thread>
 
 using GPhoto2::RemoteReleaseControlImpl;
 
+/// time to wait for a camera event; the release thread and the camera are
+/// blocked for this time, so it should be short enough to not delay Release()
+/// calls and property access
+const int c_eventWaitTimeoutInMilliseconds = 10;
+
 RemoteReleaseControlImpl::RemoteReleaseControlImpl(RefSp ref,
    std::shared_ptr<_Camera> camera,
-   std::shared_ptr<PropertyAccess> properties)
+   std::shared_ptr<CameraMutex> cameraMutex,
+   std::shared_ptr<PropertyAccess> properties,
+   std::shared_ptr<FolderListingCache> folderListingCache)
    :m_ref(ref),
    m_camera(camera),
+   m_cameraMutex(cameraMutex),
    m_properties(properties),
-   m_releaseThread(std::make_unique<SingleThreadExecutor>())
+   m_folderListingCache(folderListingCache),
+   m_releaseThread(std::make_unique<SingleThreadExecutor>(_T("gPhoto2 release control thread"))),
+   m_isClosed(false),
+   m_isFullPropertyRefreshPending(false),
+   m_numQueuedDownloads(0)
 {
    Variant value;
    value.Set(true);
@@ -31,9 +48,7 @@ RemoteReleaseControlImpl::RemoteReleaseControlImpl(RefSp ref,
 
    properties->Refresh();
 
-   // TODO start event listener
-   //result = gp_camera_wait_for_event(gp_params.camera, waittime, type, &data, gp_params.context);
-   //case GP_EVENT_CAPTURE_COMPLETE:
+   m_releaseThread->Schedule(std::bind(&RemoteReleaseControlImpl::AsyncWaitForEvent, this));
 }
 
 RemoteReleaseControlImpl::~RemoteReleaseControlImpl()
@@ -45,6 +60,9 @@ RemoteReleaseControlImpl::~RemoteReleaseControlImpl()
    catch (...)
    {
    }
+
+   // stop event loop before the subjects and settings are destroyed
+   m_releaseThread.reset();
 }
 
 bool RemoteReleaseControlImpl::GetCapability(T_enRemoteCapability remoteCapability) const
@@ -60,6 +78,9 @@ bool RemoteReleaseControlImpl::GetCapability(T_enRemoteCapability remoteCapabili
    case RemoteReleaseControl::capReleaseWhileViewfinder:
       return m_properties->GetCameraOperationAbility(GP_OPERATION_CAPTURE_PREVIEW);
 
+   case RemoteReleaseControl::capBurstMode:
+      return true;
+
    case RemoteReleaseControl::capAFLock:
    case RemoteReleaseControl::capBulbMode: // TODO check for bulb shooting mode property?
    case RemoteReleaseControl::capUILock:
@@ -105,6 +126,11 @@ void RemoteReleaseControlImpl::SetImageProperty(const ImageProperty& imageProper
    m_properties->SetPropertyById(imageProperty.Id(), imageProperty.Value());
 }
 
+void RemoteReleaseControlImpl::SetImageProperties(const std::vector<ImageProperty>& imagePropertyList)
+{
+   m_properties->SetProperties(CoalesceImageProperties(imagePropertyList));
+}
+
 void RemoteReleaseControlImpl::EnumImagePropertyValues(unsigned int imagePropertyId, std::vector<ImageProperty>& valuesList) const
 {
    valuesList = m_properties->EnumImagePropertyValues(imagePropertyId);
@@ -116,7 +142,7 @@ std::shared_ptr<Viewfinder> RemoteReleaseControlImpl::StartViewfinder() const
       throw CameraException(_T("gPhoto2::RemoteReleaseControl::StartViewfinder"),
          _T("Not supported"), 0, __FILE__, __LINE__);
 
-   return std::make_shared<ViewfinderImpl>(m_ref, m_camera, m_properties, *m_releaseThread);
+   return std::make_shared<ViewfinderImpl>(m_ref, m_camera, m_cameraMutex, m_properties, *m_releaseThread);
 }
 
 unsigned int RemoteReleaseControlImpl::NumAvailableShots() const
@@ -138,13 +164,338 @@ void RemoteReleaseControlImpl::SendCommand(T_enCameraCommand cameraCommand)
 
 void RemoteReleaseControlImpl::Release()
 {
-   m_releaseThread->Schedule(std::bind(&RemoteReleaseControlImpl::AsyncRelease, this));
+   RecordReleaseStage(releaseStageRequested);
+
+   m_releaseThread->Schedule(std::bind(&RemoteReleaseControlImpl::AsyncRelease, this, T_fnReleaseTrigger(), false));
+}
+
+/// \details The trigger function is called on the release thread, so that
+/// the release doesn't have to wait for a running gp_camera_wait_for_event()
+/// call when triggered.
+void RemoteReleaseControlImpl::ReleaseOnTrigger(T_fnReleaseTrigger releaseTrigger)
+{
+   m_releaseThread->Schedule(std::bind(&RemoteReleaseControlImpl::AsyncRelease, this, releaseTrigger, false));
+}
+
+/// \details When the release is retried because the camera was busy, the
+/// trigger was already called, and is only passed on to further retries.
+void RemoteReleaseControlImpl::AsyncRelease(T_fnReleaseTrigger releaseTrigger, bool isRetry)
+{
+   if (releaseTrigger != nullptr && !isRetry)
+   {
+      if (!releaseTrigger())
+         return;
+
+      RecordReleaseStage(releaseStageRequested);
+   }
+
+   int ret = GP_OK;
+   {
+      std::lock_guard<CameraMutex> lock(*m_cameraMutex);
+
+      ret = gp_camera_trigger_capture(m_camera.get(), m_ref->GetContext().get());
+   }
+
+   // the camera buffer is full; try again after the next queued download
+   // has freed some space
+   if (ret == GP_ERROR_CAMERA_BUSY && m_numQueuedDownloads > 0 && !m_isClosed)
+   {
+      LOG_TRACE(_T("gPhoto2: camera busy; retrying release after next download\n"));
+
+      m_releaseThread->Schedule(std::bind(&RemoteReleaseControlImpl::AsyncRelease, this, releaseTrigger, true));
+      return;
+   }
+
+   // no error checking with CheckError(), since we're on the background thread
+   if (ret < GP_OK)
+   {
+      LOG_TRACE(_T("gp_camera_trigger_capture() returned %i\n"), ret);
+      FinishReleaseWithoutTransfer();
+      m_subjectStateEvent.Call(RemoteReleaseControl::stateEventReleaseError, static_cast<unsigned int>(ret));
+      return;
+   }
+
+   RecordReleaseStage(releaseStageCommandSent);
+}
+
+/// \details When releases or downloads are queued on the release thread, or
+/// another thread waits for the camera, e.g. to access properties, no new
+/// wait is started; the event loop is scheduled again after the queued work,
+/// so that the work isn't delayed by the wait timeout.
+void RemoteReleaseControlImpl::AsyncWaitForEvent()
+{
+   if (m_isClosed)
+      return;
+
+   if (m_releaseThread->HasPendingFunctions() || m_cameraMutex->IsLockPending())
+   {
+      std::this_thread::yield();
+
+      m_releaseThread->Schedule(std::bind(&RemoteReleaseControlImpl::AsyncWaitForEvent, this));
+      return;
+   }
+
+   CameraEventType eventType = GP_EVENT_UNKNOWN;
+   void* eventData = nullptr;
+
+   int ret = GP_OK;
+   {
+      std::lock_guard<CameraMutex> lock(*m_cameraMutex);
+
+      ret = gp_camera_wait_for_event(m_camera.get(), c_eventWaitTimeoutInMilliseconds,
+         &eventType, &eventData, m_ref->GetContext().get());
+   }
+
+   std::shared_ptr<void> spAutoFreeEventData(eventData, free);
+
+   if (ret < GP_OK)
+   {
+      LOG_TRACE(_T("gp_camera_wait_for_event() returned %i; stopping event loop\n"), ret);
+
+      if (!m_isClosed)
+         m_subjectStateEvent.Call(RemoteReleaseControl::stateEventCameraShutdown, 0);
+
+      return;
+   }
+
+   switch (eventType)
+   {
+   case GP_EVENT_FILE_ADDED:
+      {
+         const CameraFilePath* filePath = reinterpret_cast<const CameraFilePath*>(eventData);
+         m_folderListingCache->OnFileAdded(CString(filePath->folder), CString(filePath->name));
+         OnFileAdded(filePath->folder, filePath->name);
+      }
+      break;
+
+   case GP_EVENT_FOLDER_ADDED:
+      {
+         const CameraFilePath* filePath = reinterpret_cast<const CameraFilePath*>(eventData);
+         m_folderListingCache->OnFolderAdded(CString(filePath->folder), CString(filePath->name));
+      }
+      break;
+
+   case GP_EVENT_CAPTURE_COMPLETE:
+      LOG_TRACE(_T("gPhoto2: capture complete\n"));
+      break;
+
+   case GP_EVENT_UNKNOWN:
+      if (eventData != nullptr)
+         OnUnknownEvent(reinterpret_cast<const char*>(eventData));
+      break;
+
+   case GP_EVENT_TIMEOUT:
+      if (m_isFullPropertyRefreshPending)
+      {
+         m_isFullPropertyRefreshPending = false;
+         RefreshProperties(nullptr);
+      }
+      break;
+
+   default:
+      break;
+   }
+
+   m_releaseThread->Schedule(std::bind(&RemoteReleaseControlImpl::AsyncWaitForEvent, this));
 }
 
-void RemoteReleaseControlImpl::AsyncRelease()
+/// \details The download is scheduled on the release thread, so that it runs
+/// before waiting for the next event, and further images taken in the
+/// meantime are queued by the camera and downloaded in order. A Release()
+/// call from a stateEventCaptureComplete handler is scheduled before the
+/// download, so that the camera captures the next image while this image is
+/// downloaded.
+void RemoteReleaseControlImpl::OnFileAdded(const CStringA& folder, const CStringA& name)
 {
-   int ret = gp_camera_trigger_capture(m_camera.get(), m_ref->GetContext().get());
-   CheckError(_T("gp_camera_trigger_capture"), ret, __FILE__, __LINE__);
+   LOG_TRACE(_T("gPhoto2: file added: %hs/%hs\n"), folder.GetString(), name.GetString());
+
+   RecordReleaseStage(releaseStageCaptureComplete);
+
+   // put current shutter release settings into queue
+   ShutterReleaseSettings settings;
+   {
+      LightweightMutex::LockType lock(m_mutexShutterReleaseSettings);
+      settings = m_shutterReleaseSettings;
+   }
+
+   m_subjectStateEvent.Call(RemoteReleaseControl::stateEventCaptureComplete, 0);
+
+   // only save to camera? then return now
+   if ((settings.SaveTarget() & ShutterReleaseSettings::saveToHost) == 0)
+   {
+      FinishReleaseWithoutTransfer();
+      return;
+   }
+
+   m_numQueuedDownloads++;
+
+   m_releaseThread->Schedule(
+      std::bind(&RemoteReleaseControlImpl::AsyncDownloadAddedFile, this, folder, name, settings));
+}
+
+void RemoteReleaseControlImpl::AsyncDownloadAddedFile(const CStringA& folder, const CStringA& name, ShutterReleaseSettings settings)
+{
+   m_numQueuedDownloads--;
+
+   if (m_isClosed)
+   {
+      FinishReleaseWithoutTransfer();
+      return;
+   }
+
+   try
+   {
+      DownloadFile(folder, name, settings);
+   }
+   catch (const CameraException& ex)
+   {
+      LOG_TRACE(_T("Exception while downloading image: %s\n"), ex.Message().GetString());
+      FinishReleaseWithoutTransfer();
+
+      // the finished handler is never called for this image, so report the
+      // failed transfer to anyone counting transferred images
+      m_subjectStateEvent.Call(RemoteReleaseControl::stateEventTransferError, ex.ErrorCode());
+      return;
+   }
+
+   if (settings.SaveTarget() == ShutterReleaseSettings::saveToHost)
+   {
+      int ret = GP_OK;
+      {
+         std::lock_guard<CameraMutex> lock(*m_cameraMutex);
+
+         ret = gp_camera_file_delete(m_camera.get(), folder, name, m_ref->GetContext().get());
+      }
+
+      if (ret < GP_OK)
+         LOG_TRACE(_T("gp_camera_file_delete(%hs/%hs) returned %i\n"), folder.GetString(), name.GetString(), ret);
+      else
+         m_folderListingCache->OnFileRemoved(CString(folder), CString(name));
+   }
+
+   RecordReleaseStage(releaseStageFileWritten);
+
+   // call finished handler
+   ShutterReleaseSettings::T_fnOnFinishedTransfer fnHandler = settings.HandlerOnFinishedTransfer();
+   if (fnHandler != nullptr)
+      fnHandler(settings);
+}
+
+/// \details Property change events look like "PTP Property d101 changed"; newer
+/// gPhoto2 versions append the config name and new value, e.g.
+/// "PTP Property 5007 changed, "f-number" to "f/5.6"". When the config name is
+/// known, only this property is re-read; otherwise all properties are
+/// refreshed once no more events are pending, since cameras often send a
+/// burst of property change events.
+void RemoteReleaseControlImpl::OnUnknownEvent(const char* eventText)
+{
+   CStringA text{ eventText };
+
+   if (text.Find("PTP Property ") != 0 ||
+      text.Find(" changed") == -1)
+      return;
+
+   CStringA propertyName;
+
+   int startPos = text.Find(" changed, \"");
+   if (startPos != -1)
+   {
+      startPos += 11;
+
+      int endPos = text.Find('\"', startPos);
+      if (endPos != -1)
+         propertyName = text.Mid(startPos, endPos - startPos);
+   }
+
+   if (propertyName.IsEmpty())
+      m_isFullPropertyRefreshPending = true;
+   else
+      RefreshProperties(propertyName);
+}
+
+/// \details A property ID of 0 signals that all properties have to be updated.
+void RemoteReleaseControlImpl::RefreshProperties(LPCSTR propertyName)
+{
+   unsigned int propertyId = 0;
+   try
+   {
+      if (propertyName == nullptr)
+         m_properties->Refresh();
+      else
+         propertyId = m_properties->RefreshPropertyByName(propertyName);
+   }
+   catch (const CameraException& ex)
+   {
+      LOG_TRACE(_T("Exception while refreshing properties: %s\n"), ex.Message().GetString());
+      return;
+   }
+
+   InvalidateCachedImagePropertyValues(propertyId);
+
+   m_subjectPropertyEvent.Call(RemoteReleaseControl::propEventPropertyDescChanged, propertyId);
+   m_subjectPropertyEvent.Call(RemoteReleaseControl::propEventPropertyChanged, propertyId);
+}
+
+void RemoteReleaseControlImpl::DownloadFile(const CStringA& folder, const CStringA& name, ShutterReleaseSettings& settings)
+{
+   RecordReleaseStage(releaseStageTransferStarted);
+
+   m_subjectDownloadEvent.Call(RemoteReleaseControl::downloadEventStarted, 0);
+
+   // camera tells us name of file; add to output folder here
+   CString filename = Path::Combine(
+      Path::FolderName(settings.Filename()),
+      CString(name));
+
+   settings.Filename(filename);
+
+   // get file size, for progress events
+   CameraFileInfo cameraFileInfo = {};
+   int ret = GP_OK;
+   {
+      std::lock_guard<CameraMutex> lock(*m_cameraMutex);
+
+      ret = gp_camera_file_get_info(m_camera.get(), folder, name, &cameraFileInfo, m_ref->GetContext().get());
+   }
+
+   unsigned long long fileSize =
+      ret >= GP_OK && (cameraFileInfo.file.fields & GP_FILE_INFO_SIZE) != 0 ? cameraFileInfo.file.size : 0;
+
+   FILE* fd = nullptr;
+   errno_t err = _tfopen_s(&fd, filename, _T("wb"));
+   if (err != 0 || fd == nullptr)
+      throw CameraException(_T("gPhoto2::RemoteReleaseControl::DownloadFile"),
+         _T("Couldn't create file: ") + filename, 0, __FILE__, __LINE__);
+
+   std::shared_ptr<FILE> spAutoCloseFile(fd, fclose);
+
+   // the camera is locked for each chunk only, so that properties can be
+   // accessed while downloading
+   std::unique_lock<CameraMutex> lock(*m_cameraMutex);
+
+   CameraFileSystemImpl::ReadFileChunked(m_camera.get(), m_ref->GetContext().get(), folder, name, 0,
+      [&](const char* data, size_t size, unsigned long long offset)
+   {
+      lock.unlock();
+
+      if (fwrite(data, 1, size, fd) != size)
+         throw CameraException(_T("gPhoto2::RemoteReleaseControl::DownloadFile"),
+            _T("Couldn't write file: ") + filename, 0, __FILE__, __LINE__);
+
+      if (fileSize > 0)
+         m_subjectDownloadEvent.Call(RemoteReleaseControl::downloadEventInProgress,
+            static_cast<unsigned int>(std::min(offset, fileSize) * 100 / fileSize));
+
+      lock.lock();
+
+      return true;
+   });
+
+   lock.unlock();
+
+   RecordReleaseStage(releaseStageTransferFinished);
+
+   m_subjectDownloadEvent.Call(RemoteReleaseControl::downloadEventFinished, 0);
 }
 
 std::shared_ptr<BulbReleaseControl> RemoteReleaseControlImpl::StartBulb()
@@ -156,7 +507,44 @@ std::shared_ptr<BulbReleaseControl> RemoteReleaseControlImpl::StartBulb()
    return std::make_shared<BulbReleaseControlImpl>(m_ref, m_properties);
 }
 
+/// \details Capture mode is left on the release thread, after the running
+/// release, download or event wait has finished, so that the camera isn't
+/// accessed from two threads at once. Queued downloads are skipped.
 void RemoteReleaseControlImpl::Close()
+{
+   if (m_isClosed.exchange(true))
+      return;
+
+   if (m_releaseThread->IsCurrentThread())
+   {
+      AsyncClose();
+      return;
+   }
+
+   std::exception_ptr closeException;
+   ManualResetEvent eventClosed(false);
+
+   m_releaseThread->Schedule([&]()
+   {
+      try
+      {
+         AsyncClose();
+      }
+      catch (...)
+      {
+         closeException = std::current_exception();
+      }
+
+      eventClosed.Set();
+   });
+
+   eventClosed.Wait();
+
+   if (closeException != nullptr)
+      std::rethrow_exception(closeException);
+}
+
+void RemoteReleaseControlImpl::AsyncClose()
 {
    Variant value;
    value.Set(false);
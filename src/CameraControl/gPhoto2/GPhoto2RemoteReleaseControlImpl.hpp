@@ -16,6 +16,8 @@ class SingleThreadExecutor;
 
 namespace GPhoto2
 {
+   class FolderListingCache;
+
    /// implementation of RemoteReleaseControl for gPhoto2 access
    class RemoteReleaseControlImpl : public RemoteReleaseControl
    {
@@ -23,7 +25,9 @@ namespace GPhoto2
       /// ctor
       RemoteReleaseControlImpl(RefSp ref,
          std::shared_ptr<_Camera> camera,
-         std::shared_ptr<PropertyAccess> properties);
+         std::shared_ptr<CameraMutex> cameraMutex,
+         std::shared_ptr<PropertyAccess> properties,
+         std::shared_ptr<FolderListingCache> folderListingCache);
       /// dtor
       virtual ~RemoteReleaseControlImpl();
 
@@ -73,6 +77,8 @@ namespace GPhoto2
 
       virtual void SetImageProperty(const ImageProperty& imageProperty) override;
 
+      virtual void SetImageProperties(const std::vector<ImageProperty>& imagePropertyList) override;
+
       virtual void EnumImagePropertyValues(unsigned int imagePropertyId, std::vector<ImageProperty>& valuesList) const override;
 
       virtual std::shared_ptr<Viewfinder> StartViewfinder() const override;
@@ -83,13 +89,38 @@ namespace GPhoto2
 
       virtual void Release() override;
 
+      virtual void ReleaseOnTrigger(T_fnReleaseTrigger releaseTrigger) override;
+
       virtual std::shared_ptr<BulbReleaseControl> StartBulb() override;
 
       virtual void Close() override;
 
    private:
-      /// releases shutter; called in worker thread
-      void AsyncRelease();
+      /// releases shutter, after the trigger function returned, if set; called in worker thread
+      void AsyncRelease(T_fnReleaseTrigger releaseTrigger, bool isRetry);
+
+      /// leaves capture mode; called in worker thread
+      void AsyncClose();
+
+      /// waits for camera events and handles them; called in worker thread,
+      /// and schedules itself again until the release control is closed
+      void AsyncWaitForEvent();
+
+      /// called when a new file was added on the camera, e.g. after release
+      void OnFileAdded(const CStringA& folder, const CStringA& name);
+
+      /// downloads file added on the camera and calls the finished handler; called in worker thread
+      void AsyncDownloadAddedFile(const CStringA& folder, const CStringA& name, ShutterReleaseSettings settings);
+
+      /// called for events not known to gPhoto2; handles property change events
+      void OnUnknownEvent(const char* eventText);
+
+      /// refreshes properties and notifies property event handlers
+      void RefreshProperties(LPCSTR propertyName);
+
+      /// downloads file from camera to the folder of the filename in the
+      /// release settings; the filename is updated with the camera's filename
+      void DownloadFile(const CStringA& folder, const CStringA& name, ShutterReleaseSettings& settings);
 
    private:
       /// gPhoto2 reference
@@ -98,12 +129,30 @@ namespace GPhoto2
       /// camera instance
       std::shared_ptr<_Camera> m_camera;
 
+      /// mutex to serialize camera access; shared with the property access,
+      /// the viewfinder and the camera file system
+      std::shared_ptr<CameraMutex> m_cameraMutex;
+
       /// property manager for gPhoto connected camera
       std::shared_ptr<PropertyAccess> m_properties;
 
-      /// background thread executor for release control
+      /// cached folder listings; updated by camera events
+      std::shared_ptr<FolderListingCache> m_folderListingCache;
+
+      /// background thread executor for release control; also runs the
+      /// camera event loop, downloads and the viewfinder
       std::unique_ptr<SingleThreadExecutor> m_releaseThread;
 
+      /// indicates that the release control was closed and the event loop should stop
+      std::atomic<bool> m_isClosed;
+
+      /// indicates that all properties must be refreshed as soon as no more
+      /// events are pending; only accessed in the release thread
+      bool m_isFullPropertyRefreshPending;
+
+      /// number of added files scheduled for download; only accessed in the release thread
+      unsigned int m_numQueuedDownloads;
+
       /// mutex to protect m_shutterReleaseSettings
       LightweightMutex m_mutexShutterReleaseSettings;
 
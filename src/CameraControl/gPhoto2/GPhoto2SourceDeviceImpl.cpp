@@ -12,6 +12,7 @@
 #include "Gphoto2RemoteReleaseControlImpl.hpp"
 #include "GPhoto2PropertyAccess.hpp"
 #include "Gphoto2CameraFileSystemImpl.hpp"
+#include "GPhoto2FolderListingCache.hpp"
 #include "CameraException.hpp"
 
 using GPhoto2::SourceDeviceImpl;
@@ -19,7 +20,9 @@ using GPhoto2::SourceDeviceImpl;
 SourceDeviceImpl::SourceDeviceImpl(RefSp ref, std::shared_ptr<_Camera> camera)
    :m_ref(ref),
    m_camera(camera),
-   m_properties(new PropertyAccess(ref, ref->GetContext(), camera))
+   m_cameraMutex(std::make_shared<CameraMutex>()),
+   m_properties(new PropertyAccess(ref, ref->GetContext(), camera, m_cameraMutex)),
+   m_folderListingCache(std::make_shared<FolderListingCache>())
 {
 }
 
@@ -76,7 +79,19 @@ DeviceProperty SourceDeviceImpl::GetDeviceProperty(unsigned int propertyId) cons
 
 std::shared_ptr<CameraFileSystem> SourceDeviceImpl::GetFileSystem()
 {
-   return std::make_shared<CameraFileSystemImpl>(m_ref->GetContext(), m_camera);
+   // the serial number is part of the thumbnail cache key; not all cameras report one
+   CString serialNumber;
+   try
+   {
+      serialNumber = SerialNumber();
+   }
+   catch (const CameraException& ex)
+   {
+      LOG_TRACE(_T("Couldn't get serial number for thumbnail cache: %s\n"), ex.Message().GetString());
+   }
+
+   return std::make_shared<CameraFileSystemImpl>(m_ref->GetContext(), m_camera, m_cameraMutex,
+      m_folderListingCache, serialNumber);
 }
 
 std::shared_ptr<RemoteReleaseControl> SourceDeviceImpl::EnterReleaseControl()
@@ -87,5 +102,5 @@ std::shared_ptr<RemoteReleaseControl> SourceDeviceImpl::EnterReleaseControl()
          static_cast<unsigned int>(GP_ERROR_NOT_SUPPORTED), __FILE__, __LINE__);
    }
 
-   return std::make_shared<RemoteReleaseControlImpl>(m_ref, m_camera, m_properties);
+   return std::make_shared<RemoteReleaseControlImpl>(m_ref, m_camera, m_cameraMutex, m_properties, m_folderListingCache);
 }
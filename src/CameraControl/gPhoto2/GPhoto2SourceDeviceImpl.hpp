@@ -12,6 +12,8 @@
 
 namespace GPhoto2
 {
+   class FolderListingCache;
+
    /// implementation of SourceDevice for gPhoto2 access
    class SourceDeviceImpl : public SourceDevice
    {
@@ -44,8 +46,15 @@ namespace GPhoto2
       /// camera instance
       std::shared_ptr<_Camera> m_camera;
 
+      /// mutex to serialize camera access; shared with all objects accessing the camera
+      std::shared_ptr<CameraMutex> m_cameraMutex;
+
       /// access to camera properties
       std::shared_ptr<PropertyAccess> m_properties;
+
+      /// cached folder listings; kept for the lifetime of the source device,
+      /// and updated by the camera events of the remote release control
+      std::shared_ptr<FolderListingCache> m_folderListingCache;
    };
 
 } // namespace GPhoto2
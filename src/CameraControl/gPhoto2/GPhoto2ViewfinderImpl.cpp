@@ -15,10 +15,12 @@ using GPhoto2::ViewfinderImpl;
 
 ViewfinderImpl::ViewfinderImpl(RefSp ref,
    std::shared_ptr<_Camera> camera,
+   std::shared_ptr<CameraMutex> cameraMutex,
    std::shared_ptr<PropertyAccess> properties,
    SingleThreadExecutor& executor)
    :m_ref(ref),
    m_camera(camera),
+   m_cameraMutex(cameraMutex),
    m_properties(properties),
    m_executor(executor),
    m_eventTimerStopped(false)
@@ -175,7 +177,12 @@ void ViewfinderImpl::GetImage(std::vector<BYTE>& imageData)
 
    auto file = std::shared_ptr<CameraFile>(rawFile, gp_file_free);
 
-   ret = gp_camera_capture_preview(m_camera.get(), file.get(), m_ref->GetContext().get());
+   {
+      std::lock_guard<CameraMutex> lock(*m_cameraMutex);
+
+      ret = gp_camera_capture_preview(m_camera.get(), file.get(), m_ref->GetContext().get());
+   }
+
    CheckError(_T("gp_camera_capture_preview"), ret, __FILE__, __LINE__);
 
    unsigned long size = 0;
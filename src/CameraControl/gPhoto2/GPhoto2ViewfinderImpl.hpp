@@ -25,8 +25,8 @@ namespace GPhoto2
    {
    public:
       /// ctor
-      ViewfinderImpl(RefSp ref, std::shared_ptr<_Camera> camera, std::shared_ptr<PropertyAccess> properties,
-         SingleThreadExecutor& executor);
+      ViewfinderImpl(RefSp ref, std::shared_ptr<_Camera> camera, std::shared_ptr<CameraMutex> cameraMutex,
+         std::shared_ptr<PropertyAccess> properties, SingleThreadExecutor& executor);
 
       /// dtor
       virtual ~ViewfinderImpl();
@@ -74,6 +74,9 @@ namespace GPhoto2
       /// camera instance
       std::shared_ptr<_Camera> m_camera;
 
+      /// mutex to serialize camera access
+      std::shared_ptr<CameraMutex> m_cameraMutex;
+
       /// camera propertiers
       std::shared_ptr<PropertyAccess> m_properties;
 
@@ -8,14 +8,53 @@
 
 #include "stdafx.h"
 #include "Gphoto2CameraFileSystemImpl.hpp"
+#include "GPhoto2FolderListingCache.hpp"
 #include "Gphoto2Include.hpp"
+#include "ThumbnailQueue.hpp"
+#include "SingleThreadExecutor.hpp"
+#include <algorithm>
 
 using namespace GPhoto2;
 
+/// size of chunks read from the camera when downloading files
+const size_t c_downloadChunkSize = 1024 * 1024;
+
+/// number of times reading a chunk is retried before the download fails
+const unsigned int c_maxChunkReadRetries = 3;
+
+/// time to wait before retrying to read a chunk; multiplied by the retry count
+const DWORD c_chunkReadRetryDelayInMilliseconds = 250;
+
+/// number of file infos retrieved from the camera before other tasks, e.g.
+/// downloads, can use the camera again
+const size_t c_fileInfoBatchSize = 64;
+
+CameraFileSystemImpl::CameraFileSystemImpl(std::shared_ptr<_GPContext> spContext, std::shared_ptr<_Camera> spCamera,
+   std::shared_ptr<CameraMutex> spCameraMutex,
+   std::shared_ptr<FolderListingCache> spFolderListingCache, const CString& cameraSerialNumber)
+   :m_spContext(spContext),
+   m_spCamera(spCamera),
+   m_spCameraMutex(spCameraMutex),
+   m_spFolderListingCache(spFolderListingCache),
+   m_thumbnailQueue(std::make_unique<ThumbnailQueue>(cameraSerialNumber,
+      std::bind(&CameraFileSystemImpl::ReadThumbnail, this, std::placeholders::_1),
+      std::bind(&CameraFileSystemImpl::RetrieveThumbnailFileInfo, this, std::placeholders::_1))),
+   m_downloadThread(std::make_unique<SingleThreadExecutor>(_T("gPhoto2 download thread")))
+{
+}
+
+CameraFileSystemImpl::~CameraFileSystemImpl()
+{
+}
+
 std::vector<CString> CameraFileSystemImpl::EnumFolders(const CString& path) const
 {
    std::vector<CString> folderList;
 
+   CString cameraFolder = GetCameraFolder(path);
+   if (m_spFolderListingCache->GetFolders(cameraFolder, folderList))
+      return folderList;
+
    CameraList* list = nullptr;
    int ret = gp_list_new(&list);
    if (ret < GP_OK)
@@ -23,11 +62,9 @@ std::vector<CString> CameraFileSystemImpl::EnumFolders(const CString& path) cons
 
    std::shared_ptr<CameraList> spAutoFreeFolderList(list, gp_list_free);
 
-   CStringA folder(path);
-   if (folder == ".")
-      folder = "/";
-   if (folder.Left(1) == ".")
-      folder.TrimLeft('.');
+   CStringA folder(cameraFolder);
+
+   std::lock_guard<CameraMutex> lock(*m_spCameraMutex);
 
    ret = gp_camera_folder_list_folders(m_spCamera.get(), folder, list, m_spContext.get());
 
@@ -46,83 +83,379 @@ std::vector<CString> CameraFileSystemImpl::EnumFolders(const CString& path) cons
       folderList.push_back(CString(name));
    }
 
+   m_spFolderListingCache->SetFolders(cameraFolder, folderList);
+
    return folderList;
 }
 
+/// \details Only the folder listing is done right away; file infos need a
+/// USB round trip for each file, so they are retrieved in the download
+/// thread and passed to the file info handler.
 std::vector<FileInfo> CameraFileSystemImpl::EnumFiles(const CString& path) const
 {
    std::vector<FileInfo> fileList;
 
-   CameraList* list = nullptr;
-   int ret = gp_list_new(&list);
-   if (ret < GP_OK)
-      return fileList;
+   CString cameraFolder = GetCameraFolder(path);
+   if (!m_spFolderListingCache->GetFiles(cameraFolder, fileList))
+   {
+      CameraList* list = nullptr;
+      int ret = gp_list_new(&list);
+      if (ret < GP_OK)
+         return fileList;
 
-   std::shared_ptr<CameraList> spAutoFreeFileList(list, gp_list_free);
+      std::shared_ptr<CameraList> spAutoFreeFileList(list, gp_list_free);
 
-   CStringA folder(path);
-   if (folder == ".")
-      folder = "/";
-   if (folder.Left(1) == ".")
-      folder.TrimLeft('.');
+      {
+         std::lock_guard<CameraMutex> lock(*m_spCameraMutex);
 
-   ret = gp_camera_folder_list_files(m_spCamera.get(), folder, list, m_spContext.get());
+         ret = gp_camera_folder_list_files(m_spCamera.get(), CStringA(cameraFolder), list, m_spContext.get());
+      }
 
-   if (ret < GP_OK)
-      return fileList;
+      if (ret < GP_OK)
+         return fileList;
 
-   int count = gp_list_count(list);
+      int count = gp_list_count(list);
 
-   for (int index = 0; index < count; index++)
+      for (int index = 0; index < count; index++)
+      {
+         const char* name = nullptr;
+         ret = gp_list_get_name(list, index, &name);
+         if (ret < GP_OK)
+            break;
+
+         FileInfo info;
+         info.m_filename = FolderListingCache::GetFilename(cameraFolder, CString(name));
+         info.m_isInfoPending = true;
+
+         fileList.push_back(info);
+      }
+
+      m_spFolderListingCache->SetFiles(cameraFolder, fileList);
+   }
+
+   bool isInfoPending = std::any_of(fileList.begin(), fileList.end(),
+      [](const FileInfo& fileInfo) { return fileInfo.m_isInfoPending; });
+
+   if (isInfoPending)
+      StartRetrieveFileInfos(cameraFolder);
+
+   return fileList;
+}
+
+void CameraFileSystemImpl::SetFileInfoHandler(T_fnFileInfoAvailable fnFileInfoAvailable)
+{
+   LightweightMutex::LockType lock(m_mutexFileInfo);
+
+   m_fnFileInfoAvailable = fnFileInfoAvailable;
+}
+
+void CameraFileSystemImpl::StartDownload(const FileInfo& fileInfo, T_fnDownloadFinished fnDownloadFinished)
+{
+   m_downloadThread->Schedule(
+      std::bind(&CameraFileSystemImpl::AsyncDownload, this, fileInfo, fnDownloadFinished));
+}
+
+void CameraFileSystemImpl::GetThumbnail(const FileInfo& fileInfo, T_fnThumbnailAvailable fnThumbnailAvailable,
+   T_enThumbnailPriority priority)
+{
+   m_thumbnailQueue->Add(fileInfo, fnThumbnailAvailable, priority);
+}
+
+void CameraFileSystemImpl::CancelThumbnailRequests()
+{
+   m_thumbnailQueue->CancelAll();
+}
+
+void CameraFileSystemImpl::StartDownloadToFile(const FileInfo& fileInfo, const CString& targetFilename,
+   unsigned long long startOffset,
+   T_fnDownloadProgress fnDownloadProgress,
+   T_fnDownloadToFileFinished fnDownloadFinished)
+{
+   m_downloadThread->Schedule(
+      std::bind(&CameraFileSystemImpl::AsyncDownloadToFile, this,
+         fileInfo, targetFilename, startOffset, fnDownloadProgress, fnDownloadFinished));
+}
+
+bool CameraFileSystemImpl::ReadFileChunked(_Camera* camera, _GPContext* context,
+   const CStringA& folder, const CStringA& name,
+   unsigned long long startOffset, T_fnChunkRead fnChunkRead)
+{
+   std::vector<char> buffer(c_downloadChunkSize);
+
+   unsigned long long offset = startOffset;
+   unsigned int retryCount = 0;
+
+   for (;;)
    {
-      const char* name = nullptr;
-      ret = gp_list_get_name(list, index, &name);
-      if (ret < GP_OK)
-         break;
+      uint64_t size = buffer.size();
+
+      int ret = gp_camera_file_read(camera, folder, name, GP_FILE_TYPE_NORMAL,
+         offset, buffer.data(), &size, context);
 
-      FileInfo info;
-      info.m_filename = CString(folder) + "/" + CString(name);
+      if (ret == GP_ERROR_NOT_SUPPORTED)
+         break; // driver can't read partial files
 
-      CameraFileInfo cameraFileInfo = {};
-      cameraFileInfo.file.fields = CameraFileInfoFields(GP_FILE_INFO_SIZE | GP_FILE_INFO_MTIME);
-      cameraFileInfo.preview.fields = GP_FILE_INFO_NONE;
-      cameraFileInfo.audio.fields = GP_FILE_INFO_NONE;
-      ret = gp_camera_file_get_info(m_spCamera.get(), folder, name, &cameraFileInfo, m_spContext.get());
       if (ret < GP_OK)
+      {
+         if (++retryCount > c_maxChunkReadRetries)
+            CheckError(_T("gp_camera_file_read"), ret, __FILE__, __LINE__);
+
+         LOG_TRACE(_T("gp_camera_file_read(%hs/%hs, offset=%I64u) returned %i; retrying\n"),
+            folder.GetString(), name.GetString(), offset, ret);
+
+         Sleep(c_chunkReadRetryDelayInMilliseconds * retryCount);
          continue;
+      }
 
-      info.m_fileSize = static_cast<unsigned long>(cameraFileInfo.file.size);
-      info.m_modifiedTime = cameraFileInfo.file.mtime;
+      retryCount = 0;
 
-      fileList.push_back(info);
+      if (size == 0)
+         return true;
+
+      offset += size;
+
+      if (!fnChunkRead(buffer.data(), static_cast<size_t>(size), offset))
+         return false;
+
+      if (size < buffer.size())
+         return true;
    }
 
-   return fileList;
+   // read whole file at once
+   CameraFile* file = nullptr;
+   int ret = gp_file_new(&file);
+   CheckError(_T("gp_file_new"), ret, __FILE__, __LINE__);
+
+   std::shared_ptr<CameraFile> spAutoFreeFile(file, gp_file_free);
+
+   ret = gp_camera_file_get(camera, folder, name, GP_FILE_TYPE_NORMAL, file, context);
+   CheckError(_T("gp_camera_file_get"), ret, __FILE__, __LINE__);
+
+   const char* data = nullptr;
+   unsigned long size = 0;
+   ret = gp_file_get_data_and_size(file, &data, &size);
+   CheckError(_T("gp_file_get_data_and_size"), ret, __FILE__, __LINE__);
+
+   if (offset >= size)
+      return true;
+
+   return fnChunkRead(data + offset, static_cast<size_t>(size - offset), size);
 }
 
-void CameraFileSystemImpl::StartDownload(const FileInfo& fileInfo, T_fnDownloadFinished fnDownloadFinished)
+CString CameraFileSystemImpl::GetCameraFolder(const CString& path)
+{
+   CString folder(path);
+   if (folder == _T("."))
+      folder = _T("/");
+   if (folder.Left(1) == _T("."))
+      folder.TrimLeft(_T('.'));
+
+   return folder;
+}
+
+void CameraFileSystemImpl::StartRetrieveFileInfos(const CString& folder) const
+{
+   {
+      LightweightMutex::LockType lock(m_mutexFileInfo);
+
+      if (!m_foldersRetrievingFileInfos.insert(folder).second)
+         return; // already retrieving
+   }
+
+   m_downloadThread->Schedule(
+      std::bind(&CameraFileSystemImpl::AsyncRetrieveFileInfos, this, folder));
+}
+
+/// \details The camera is only locked for one batch of file infos, and the
+/// next batch is scheduled after downloads that were started in the
+/// meantime, so that a large folder doesn't block downloads.
+void CameraFileSystemImpl::AsyncRetrieveFileInfos(const CString& folder) const
+{
+   std::vector<FileInfo> fileList = m_spFolderListingCache->GetPendingFiles(folder, c_fileInfoBatchSize);
+
+   if (fileList.empty())
+   {
+      LightweightMutex::LockType lock(m_mutexFileInfo);
+      m_foldersRetrievingFileInfos.erase(folder);
+      return;
+   }
+
+   {
+      std::lock_guard<CameraMutex> lock(*m_spCameraMutex);
+
+      for (FileInfo& fileInfo : fileList)
+         ReadFileInfo(fileInfo);
+   }
+
+   m_spFolderListingCache->UpdateFileInfos(folder, fileList);
+
+   T_fnFileInfoAvailable fnFileInfoAvailable;
+   {
+      LightweightMutex::LockType lock(m_mutexFileInfo);
+      fnFileInfoAvailable = m_fnFileInfoAvailable;
+   }
+
+   if (fnFileInfoAvailable != nullptr)
+      fnFileInfoAvailable(folder, fileList);
+
+   m_downloadThread->Schedule(
+      std::bind(&CameraFileSystemImpl::AsyncRetrieveFileInfos, this, folder));
+}
+
+void CameraFileSystemImpl::ReadFileInfo(FileInfo& fileInfo) const
+{
+   CStringA folder, name;
+   SplitFilename(fileInfo.m_filename, folder, name);
+
+   CameraFileInfo cameraFileInfo = {};
+   cameraFileInfo.file.fields = CameraFileInfoFields(GP_FILE_INFO_SIZE | GP_FILE_INFO_MTIME);
+   cameraFileInfo.preview.fields = GP_FILE_INFO_NONE;
+   cameraFileInfo.audio.fields = GP_FILE_INFO_NONE;
+
+   std::lock_guard<CameraMutex> lock(*m_spCameraMutex);
+
+   int ret = gp_camera_file_get_info(m_spCamera.get(), folder, name, &cameraFileInfo, m_spContext.get());
+   if (ret < GP_OK)
+   {
+      LOG_TRACE(_T("gp_camera_file_get_info(%hs/%hs) returned %i\n"), folder.GetString(), name.GetString(), ret);
+   }
+   else
+   {
+      fileInfo.m_fileSize = cameraFileInfo.file.size;
+      fileInfo.m_modifiedTime = cameraFileInfo.file.mtime;
+   }
+
+   fileInfo.m_isInfoPending = false;
+}
+
+void CameraFileSystemImpl::RetrieveThumbnailFileInfo(FileInfo& fileInfo) const
+{
+   ReadFileInfo(fileInfo);
+
+   CStringA folder, name;
+   SplitFilename(fileInfo.m_filename, folder, name);
+
+   m_spFolderListingCache->UpdateFileInfos(CString(folder), std::vector<FileInfo>{ fileInfo });
+}
+
+/// \details Camera drivers that don't support previews return an error; in
+/// this case, the file has no thumbnail.
+std::vector<unsigned char> CameraFileSystemImpl::ReadThumbnail(const FileInfo& fileInfo) const
+{
+   CStringA folder, name;
+   SplitFilename(fileInfo.m_filename, folder, name);
+
+   CameraFile* file = nullptr;
+   int ret = gp_file_new(&file);
+   CheckError(_T("gp_file_new"), ret, __FILE__, __LINE__);
+
+   std::shared_ptr<CameraFile> spAutoFreeFile(file, gp_file_free);
+
+   {
+      std::lock_guard<CameraMutex> lock(*m_spCameraMutex);
+
+      ret = gp_camera_file_get(m_spCamera.get(), folder, name, GP_FILE_TYPE_PREVIEW, file, m_spContext.get());
+   }
+
+   if (ret == GP_ERROR_NOT_SUPPORTED || ret == GP_ERROR_FILE_NOT_FOUND)
+      return std::vector<unsigned char>();
+
+   CheckError(_T("gp_camera_file_get"), ret, __FILE__, __LINE__);
+
+   const char* data = nullptr;
+   unsigned long size = 0;
+   ret = gp_file_get_data_and_size(file, &data, &size);
+   CheckError(_T("gp_file_get_data_and_size"), ret, __FILE__, __LINE__);
+
+   const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+   return std::vector<unsigned char>(bytes, bytes + size);
+}
+
+void CameraFileSystemImpl::SplitFilename(const CString& filename, CStringA& folder, CStringA& name)
 {
-   int pos = fileInfo.m_filename.ReverseFind(_T('/'));
-   CStringA folder;
-   if (pos != -1)
-      folder = fileInfo.m_filename.Left(pos);
+   int pos = filename.ReverseFind(_T('/'));
 
-   CStringA name{ fileInfo.m_filename.Mid(pos + 1) };
+   folder = pos != -1 ? CStringA(filename.Left(pos)) : CStringA();
+   name = CStringA(filename.Mid(pos + 1));
+}
+
+void CameraFileSystemImpl::AsyncDownload(const FileInfo& fileInfo, T_fnDownloadFinished fnDownloadFinished)
+{
+   CStringA folder, name;
+   SplitFilename(fileInfo.m_filename, folder, name);
 
    std::vector<unsigned char> buffer;
-   buffer.resize(fileInfo.m_fileSize);
+   buffer.reserve(static_cast<size_t>(fileInfo.m_fileSize));
 
-   uint64_t fileSize = fileInfo.m_fileSize;
+   try
+   {
+      std::lock_guard<CameraMutex> lock(*m_spCameraMutex);
+
+      ReadFileChunked(m_spCamera.get(), m_spContext.get(), folder, name, 0,
+         [&](const char* data, size_t size, unsigned long long)
+      {
+         buffer.insert(buffer.end(), data, data + size);
+         return true;
+      });
+   }
+   catch (const CameraException& ex)
+   {
+      LOG_TRACE(_T("Exception while downloading file: %s\n"), ex.Message().GetString());
 
-   int ret = gp_camera_file_read(
-      m_spCamera.get(), folder, name, GP_FILE_TYPE_NORMAL,
-      0,
-      reinterpret_cast<char*>(buffer.data()),
-      &fileSize,
-      m_spContext.get());
+      if (fnDownloadFinished != nullptr)
+         fnDownloadFinished(fileInfo, std::vector<unsigned char>(), false);
 
-   CheckError(_T("CameraFileSystemImpl::StartDownload"), ret, __FILE__, __LINE__);
+      return;
+   }
+
+   if (fnDownloadFinished != nullptr)
+      fnDownloadFinished(fileInfo, buffer, true);
+}
+
+/// \details The camera is locked for each chunk only, so that folders can be
+/// enumerated while downloading. Memory use is one chunk, regardless of the
+/// file size.
+void CameraFileSystemImpl::AsyncDownloadToFile(const FileInfo& fileInfo, const CString& targetFilename,
+   unsigned long long startOffset,
+   T_fnDownloadProgress fnDownloadProgress,
+   T_fnDownloadToFileFinished fnDownloadFinished)
+{
+   CStringA folder, name;
+   SplitFilename(fileInfo.m_filename, folder, name);
+
+   unsigned long long bytesWritten = startOffset;
+   bool completed = false;
+
+   try
+   {
+      std::shared_ptr<FILE> targetFile = OpenDownloadTargetFile(targetFilename, startOffset);
+
+      std::unique_lock<CameraMutex> lock(*m_spCameraMutex);
+
+      completed = ReadFileChunked(m_spCamera.get(), m_spContext.get(), folder, name, startOffset,
+         [&](const char* data, size_t size, unsigned long long offset)
+      {
+         lock.unlock();
+
+         if (fwrite(data, 1, size, targetFile.get()) != size)
+            throw CameraException(_T("gPhoto2::CameraFileSystem::StartDownloadToFile"),
+               _T("Couldn't write file: ") + targetFilename, 0, __FILE__, __LINE__);
+
+         bytesWritten = offset;
+
+         bool continueDownload = fnDownloadProgress == nullptr ||
+            fnDownloadProgress(fileInfo, bytesWritten);
+
+         lock.lock();
+
+         return continueDownload;
+      });
+   }
+   catch (const CameraException& ex)
+   {
+      LOG_TRACE(_T("Exception while downloading file: %s\n"), ex.Message().GetString());
+   }
 
    if (fnDownloadFinished != nullptr)
-      fnDownloadFinished(fileInfo, buffer);
+      fnDownloadFinished(fileInfo, bytesWritten, completed);
 }
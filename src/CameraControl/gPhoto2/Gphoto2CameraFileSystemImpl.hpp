@@ -8,38 +8,127 @@
 
 #include "CameraFileSystem.hpp"
 #include "Gphoto2Common.hpp"
+#include <ulib/thread/LightweightMutex.hpp>
+#include <mutex>
+#include <set>
+
+class SingleThreadExecutor;
+class ThumbnailQueue;
 
 namespace GPhoto2
 {
-   /// file system implementation for gPhoto2
+   class FolderListingCache;
+
+   /// \brief file system implementation for gPhoto2
+   /// \details Folder listings are stored in the folder listing cache of the
+   /// camera. Files are listed with their names only, and the file infos are
+   /// retrieved in batches in the download thread. Thumbnails are the
+   /// previews that gPhoto2 provides for the files.
    class CameraFileSystemImpl :
       public CameraFileSystem
    {
    public:
       /// ctor
-      CameraFileSystemImpl(std::shared_ptr<_GPContext> spContext, std::shared_ptr<_Camera> spCamera)
-         :m_spContext(spContext),
-         m_spCamera(spCamera)
-      {
-      }
+      CameraFileSystemImpl(std::shared_ptr<_GPContext> spContext, std::shared_ptr<_Camera> spCamera,
+         std::shared_ptr<CameraMutex> spCameraMutex,
+         std::shared_ptr<FolderListingCache> spFolderListingCache, const CString& cameraSerialNumber);
 
       /// dtor
-      virtual ~CameraFileSystemImpl()
-      {
-      }
+      virtual ~CameraFileSystemImpl();
 
       virtual std::vector<CString> EnumFolders(const CString& path) const override;
 
       virtual std::vector<FileInfo> EnumFiles(const CString& path) const override;
 
+      virtual void SetFileInfoHandler(T_fnFileInfoAvailable fnFileInfoAvailable) override;
+
       virtual void StartDownload(const FileInfo& fileInfo, T_fnDownloadFinished fnDownloadFinished) override;
 
+      virtual void StartDownloadToFile(const FileInfo& fileInfo, const CString& targetFilename,
+         unsigned long long startOffset,
+         T_fnDownloadProgress fnDownloadProgress,
+         T_fnDownloadToFileFinished fnDownloadFinished) override;
+
+      virtual void GetThumbnail(const FileInfo& fileInfo, T_fnThumbnailAvailable fnThumbnailAvailable,
+         T_enThumbnailPriority priority) override;
+
+      virtual void CancelThumbnailRequests() override;
+
+      /// function that is called for every chunk read from the camera, with
+      /// the data, its size, and the file offset after the chunk; return
+      /// false to cancel reading
+      typedef std::function<bool(const char*, size_t, unsigned long long)> T_fnChunkRead;
+
+      /// \brief reads file from camera in chunks, starting at given offset
+      /// \details When reading a chunk fails, e.g. due to a USB error, the read
+      /// is retried at the same offset a few times. Camera drivers that can't
+      /// read partial files get the whole file at once.
+      /// \return false when reading was canceled by the chunk function
+      static bool ReadFileChunked(_Camera* camera, _GPContext* context,
+         const CStringA& folder, const CStringA& name,
+         unsigned long long startOffset, T_fnChunkRead fnChunkRead);
+
+   private:
+      /// converts file system path to camera folder path
+      static CString GetCameraFolder(const CString& path);
+
+      /// starts retrieving pending file infos of folder, when not already started
+      void StartRetrieveFileInfos(const CString& folder) const;
+
+      /// retrieves the next batch of pending file infos of folder; called in
+      /// worker thread, and schedules itself again until all are retrieved
+      void AsyncRetrieveFileInfos(const CString& folder) const;
+
+      /// reads file size and modification time of file from camera
+      void ReadFileInfo(FileInfo& fileInfo) const;
+
+      /// reads pending file info for thumbnail request, and updates folder listing cache
+      void RetrieveThumbnailFileInfo(FileInfo& fileInfo) const;
+
+      /// reads thumbnail of file from camera; called in thumbnail worker thread
+      std::vector<unsigned char> ReadThumbnail(const FileInfo& fileInfo) const;
+
+      /// splits camera filename into folder and name
+      static void SplitFilename(const CString& filename, CStringA& folder, CStringA& name);
+
+      /// downloads file to memory; called in worker thread
+      void AsyncDownload(const FileInfo& fileInfo, T_fnDownloadFinished fnDownloadFinished);
+
+      /// downloads file to target file; called in worker thread
+      void AsyncDownloadToFile(const FileInfo& fileInfo, const CString& targetFilename,
+         unsigned long long startOffset,
+         T_fnDownloadProgress fnDownloadProgress,
+         T_fnDownloadToFileFinished fnDownloadFinished);
+
    private:
       /// context handle
       std::shared_ptr<_GPContext> m_spContext;
 
       /// camera handle
       std::shared_ptr<_Camera> m_spCamera;
+
+      /// mutex to serialize camera access; shared with the remote release
+      /// control, so that the download thread and the caller's thread don't
+      /// access the camera while the release thread does
+      std::shared_ptr<CameraMutex> m_spCameraMutex;
+
+      /// cached folder listings; shared with the remote release control
+      std::shared_ptr<FolderListingCache> m_spFolderListingCache;
+
+      /// mutex to protect m_fnFileInfoAvailable and m_foldersRetrievingFileInfos
+      mutable LightweightMutex m_mutexFileInfo;
+
+      /// handler that is called when pending file infos were retrieved
+      T_fnFileInfoAvailable m_fnFileInfoAvailable;
+
+      /// folders where file infos are currently retrieved
+      mutable std::set<CString> m_foldersRetrievingFileInfos;
+
+      /// queue for thumbnail requests
+      std::unique_ptr<ThumbnailQueue> m_thumbnailQueue;
+
+      /// background thread executor for downloads
+      std::unique_ptr<SingleThreadExecutor> m_downloadThread;
    };
 
 } // namespace GPhoto2
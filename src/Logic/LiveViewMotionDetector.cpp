@@ -0,0 +1,150 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file LiveViewMotionDetector.cpp Live view motion detector
+//
+
+// includes
+#include "stdafx.h"
+#include "LiveViewMotionDetector.hpp"
+#include "JpegMemorySourceManager.hpp"
+#include "JpegDecoder.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+LiveViewMotionDetector::LiveViewMotionDetector(const MotionDetectorOptions& options)
+   :m_options(options),
+   m_width(0),
+   m_height(0),
+   m_hasBackground(false),
+   m_lastChangedArea(0.0)
+{
+}
+
+bool LiveViewMotionDetector::ProcessFrame(const std::vector<BYTE>& jpegData)
+{
+   if (jpegData.empty())
+      return false;
+
+   DecodeLumaPlane(jpegData);
+
+   return ProcessLumaPlane(m_lumaPlane.data(), m_width, m_height);
+}
+
+bool LiveViewMotionDetector::ProcessLumaPlane(const BYTE* lumaPlane, unsigned int width, unsigned int height)
+{
+   if (!m_hasBackground ||
+      width != m_width ||
+      height != m_height ||
+      m_background.size() != size_t(width) * height)
+   {
+      InitBackground(lumaPlane, width, height);
+      m_lastChangedArea = 0.0;
+      return false;
+   }
+
+   m_lastChangedArea = CompareAndUpdateBackground(lumaPlane);
+
+   return m_lastChangedArea > m_options.m_changedAreaThreshold;
+}
+
+void LiveViewMotionDetector::ResetBackground()
+{
+   m_hasBackground = false;
+}
+
+void LiveViewMotionDetector::DecodeLumaPlane(const std::vector<BYTE>& jpegData)
+{
+   JpegMemorySourceManager sourceManager(jpegData);
+   JpegDecoder decoder(sourceManager);
+
+   decoder.ReadHeader();
+
+   // let the decoder do the downscaling and color conversion; this is much
+   // cheaper than decoding the full RGB image and converting it afterwards
+   decoder.cinfo.out_color_space = JCS_GRAYSCALE;
+   decoder.cinfo.scale_num = 1;
+   decoder.cinfo.scale_denom = m_options.m_scaleDenominator;
+   decoder.cinfo.dct_method = JDCT_IFAST;
+   decoder.cinfo.do_fancy_upsampling = FALSE;
+   decoder.cinfo.do_block_smoothing = FALSE;
+
+   decoder.StartDecompress();
+
+   ATLASSERT(decoder.cinfo.output_components == 1);
+
+   m_width = decoder.cinfo.output_width;
+   m_height = decoder.cinfo.output_height;
+
+   // only allocates when image size has changed
+   m_lumaPlane.resize(size_t(m_width) * m_height);
+
+   while (decoder.HasScanlines())
+   {
+      JSAMPROW scanline = m_lumaPlane.data() + size_t(decoder.cinfo.output_scanline) * m_width;
+
+      JDIMENSION dim = jpeg_read_scanlines(&decoder.cinfo, &scanline, 1);
+      if (dim != 1)
+         break;
+   }
+}
+
+void LiveViewMotionDetector::InitBackground(const BYTE* lumaPlane, unsigned int width, unsigned int height)
+{
+   m_width = width;
+   m_height = height;
+
+   m_background.resize(size_t(width) * height);
+
+   for (size_t index = 0, max = m_background.size(); index < max; index++)
+      m_background[index] = static_cast<unsigned short>(lumaPlane[index] << 8);
+
+   m_hasBackground = true;
+}
+
+double LiveViewMotionDetector::CompareAndUpdateBackground(const BYTE* lumaPlane)
+{
+   unsigned int regionLeft = static_cast<unsigned int>(m_options.m_regionLeft * m_width);
+   unsigned int regionTop = static_cast<unsigned int>(m_options.m_regionTop * m_height);
+   unsigned int regionRight = static_cast<unsigned int>((m_options.m_regionLeft + m_options.m_regionWidth) * m_width);
+   unsigned int regionBottom = static_cast<unsigned int>((m_options.m_regionTop + m_options.m_regionHeight) * m_height);
+
+   regionRight = std::min(regionRight, m_width);
+   regionBottom = std::min(regionBottom, m_height);
+
+   if (regionLeft >= regionRight || regionTop >= regionBottom)
+      return 0.0;
+
+   const int pixelThreshold = static_cast<int>(m_options.m_pixelThreshold) << 8;
+   const unsigned int shift = m_options.m_backgroundAdaptionShift;
+
+   size_t changedPixels = 0;
+
+   for (unsigned int y = 0; y < m_height; y++)
+   {
+      const BYTE* luma = lumaPlane + size_t(y) * m_width;
+      unsigned short* background = m_background.data() + size_t(y) * m_width;
+
+      bool isRegionLine = y >= regionTop && y < regionBottom;
+
+      for (unsigned int x = 0; x < m_width; x++)
+      {
+         int current = luma[x] << 8;
+         int diff = current - background[x];
+
+         if (isRegionLine && x >= regionLeft && x < regionRight &&
+            std::abs(diff) > pixelThreshold)
+         {
+            changedPixels++;
+         }
+
+         // move background towards current frame
+         background[x] = static_cast<unsigned short>(background[x] + (diff >> static_cast<int>(shift)));
+      }
+   }
+
+   size_t regionPixels = size_t(regionRight - regionLeft) * (regionBottom - regionTop);
+
+   return static_cast<double>(changedPixels) / regionPixels;
+}
@@ -0,0 +1,104 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file LiveViewMotionDetector.hpp Live view motion detector
+//
+#pragma once
+
+// includes
+#include <vector>
+
+/// options for motion detection on live view images
+struct MotionDetectorOptions
+{
+   /// left edge of region to watch, relative to image width, in range [0.0; 1.0]
+   double m_regionLeft = 0.0;
+
+   /// top edge of region to watch, relative to image height, in range [0.0; 1.0]
+   double m_regionTop = 0.0;
+
+   /// width of region to watch, relative to image width, in range [0.0; 1.0]
+   double m_regionWidth = 1.0;
+
+   /// height of region to watch, relative to image height, in range [0.0; 1.0]
+   double m_regionHeight = 1.0;
+
+   /// luma difference a single pixel must exceed to count as changed, in range [0; 255]
+   unsigned int m_pixelThreshold = 24;
+
+   /// fraction of changed pixels in region that triggers, in range [0.0; 1.0]
+   double m_changedAreaThreshold = 0.02;
+
+   /// adaption speed of running background; background moves 1/2^n towards each frame
+   unsigned int m_backgroundAdaptionShift = 3;
+
+   /// JPEG decoder scale denominator; 1, 2, 4 or 8; larger values decode faster
+   unsigned int m_scaleDenominator = 8;
+};
+
+/// \brief Motion detector for live view images
+/// \details Decodes the live view JPEG image into a downscaled luma plane and
+/// compares it against a running background. Reports a trigger when the
+/// fraction of changed pixels in the watched region exceeds the threshold.
+/// All buffers are reused between frames, so that no allocations happen as
+/// long as the live view image size stays the same.
+class LiveViewMotionDetector
+{
+public:
+   /// ctor
+   explicit LiveViewMotionDetector(const MotionDetectorOptions& options = MotionDetectorOptions());
+
+   /// returns options
+   const MotionDetectorOptions& Options() const { return m_options; }
+
+   /// processes JPEG live view image; returns true when motion was detected
+   bool ProcessFrame(const std::vector<BYTE>& jpegData);
+
+   /// processes luma plane with given size; returns true when motion was detected
+   bool ProcessLumaPlane(const BYTE* lumaPlane, unsigned int width, unsigned int height);
+
+   /// discards running background; next frame is used as new background
+   void ResetBackground();
+
+   /// returns fraction of changed pixels in region of last processed frame
+   double LastChangedArea() const { return m_lastChangedArea; }
+
+   /// returns width of luma plane
+   unsigned int Width() const { return m_width; }
+
+   /// returns height of luma plane
+   unsigned int Height() const { return m_height; }
+
+private:
+   /// decodes JPEG image into m_lumaPlane
+   void DecodeLumaPlane(const std::vector<BYTE>& jpegData);
+
+   /// (re-)initializes background with given luma plane
+   void InitBackground(const BYTE* lumaPlane, unsigned int width, unsigned int height);
+
+   /// compares luma plane with background, updates background and returns changed area
+   double CompareAndUpdateBackground(const BYTE* lumaPlane);
+
+private:
+   /// options
+   MotionDetectorOptions m_options;
+
+   /// decoded luma plane of last frame
+   std::vector<BYTE> m_lumaPlane;
+
+   /// running background, in 8.8 fixed point format
+   std::vector<unsigned short> m_background;
+
+   /// width of luma plane and background
+   unsigned int m_width;
+
+   /// height of luma plane and background
+   unsigned int m_height;
+
+   /// indicates if background contains valid data
+   bool m_hasBackground;
+
+   /// fraction of changed pixels of last frame
+   double m_lastChangedArea;
+};
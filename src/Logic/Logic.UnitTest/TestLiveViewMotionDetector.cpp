@@ -0,0 +1,130 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file TestLiveViewMotionDetector.cpp tests LiveViewMotionDetector class
+//
+
+// includes
+#include "stdafx.h"
+#include "LiveViewMotionDetector.hpp"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace LogicUnitTest
+{
+   /// Tests for class LiveViewMotionDetector
+   TEST_CLASS(TestLiveViewMotionDetector)
+   {
+   public:
+      /// width of test luma planes
+      static const unsigned int c_width = 80;
+
+      /// height of test luma planes
+      static const unsigned int c_height = 60;
+
+      /// creates luma plane with given brightness, and a bright box in the given area
+      static std::vector<BYTE> CreateLumaPlane(BYTE brightness,
+         unsigned int boxLeft = 0, unsigned int boxTop = 0, unsigned int boxSize = 0)
+      {
+         std::vector<BYTE> lumaPlane(c_width * c_height, brightness);
+
+         for (unsigned int y = boxTop; y < boxTop + boxSize; y++)
+            for (unsigned int x = boxLeft; x < boxLeft + boxSize; x++)
+               lumaPlane[y * c_width + x] = 255;
+
+         return lumaPlane;
+      }
+
+      /// Tests that the first frame only sets up the background.
+      TEST_METHOD(TestFirstFrameDoesntTrigger)
+      {
+         // set up
+         LiveViewMotionDetector detector;
+         std::vector<BYTE> lumaPlane = CreateLumaPlane(128);
+
+         // run
+         bool triggered = detector.ProcessLumaPlane(lumaPlane.data(), c_width, c_height);
+
+         // check
+         Assert::IsFalse(triggered, L"first frame must not trigger");
+         Assert::AreEqual(0.0, detector.LastChangedArea(), L"changed area must be zero");
+      }
+
+      /// Tests that identical frames don't trigger.
+      TEST_METHOD(TestStaticSceneDoesntTrigger)
+      {
+         // set up
+         LiveViewMotionDetector detector;
+         std::vector<BYTE> lumaPlane = CreateLumaPlane(128);
+
+         // run
+         detector.ProcessLumaPlane(lumaPlane.data(), c_width, c_height);
+         bool triggered = detector.ProcessLumaPlane(lumaPlane.data(), c_width, c_height);
+
+         // check
+         Assert::IsFalse(triggered, L"static scene must not trigger");
+      }
+
+      /// Tests that a flash over the whole image triggers.
+      TEST_METHOD(TestFlashTriggers)
+      {
+         // set up
+         LiveViewMotionDetector detector;
+         std::vector<BYTE> darkPlane = CreateLumaPlane(20);
+         std::vector<BYTE> brightPlane = CreateLumaPlane(220);
+
+         // run
+         detector.ProcessLumaPlane(darkPlane.data(), c_width, c_height);
+         bool triggered = detector.ProcessLumaPlane(brightPlane.data(), c_width, c_height);
+
+         // check
+         Assert::IsTrue(triggered, L"flash must trigger");
+         Assert::AreEqual(1.0, detector.LastChangedArea(), L"all pixels must have changed");
+      }
+
+      /// Tests that changes outside of the region don't trigger.
+      TEST_METHOD(TestChangeOutsideRegionDoesntTrigger)
+      {
+         // set up
+         MotionDetectorOptions options;
+         options.m_regionLeft = 0.5;
+         options.m_regionWidth = 0.5;
+
+         LiveViewMotionDetector detector(options);
+         std::vector<BYTE> emptyPlane = CreateLumaPlane(50);
+         std::vector<BYTE> boxLeftPlane = CreateLumaPlane(50, 5, 5, 20);
+         std::vector<BYTE> boxRightPlane = CreateLumaPlane(50, 50, 5, 20);
+
+         // run
+         detector.ProcessLumaPlane(emptyPlane.data(), c_width, c_height);
+         bool triggeredLeft = detector.ProcessLumaPlane(boxLeftPlane.data(), c_width, c_height);
+
+         detector.ResetBackground();
+         detector.ProcessLumaPlane(emptyPlane.data(), c_width, c_height);
+         bool triggeredRight = detector.ProcessLumaPlane(boxRightPlane.data(), c_width, c_height);
+
+         // check
+         Assert::IsFalse(triggeredLeft, L"change outside of region must not trigger");
+         Assert::IsTrue(triggeredRight, L"change inside of region must trigger");
+      }
+
+      /// Tests that the running background adapts to slow changes.
+      TEST_METHOD(TestBackgroundAdaptsToSlowChanges)
+      {
+         // set up
+         LiveViewMotionDetector detector;
+
+         // run
+         bool triggered = false;
+         for (unsigned int brightness = 100; brightness < 150; brightness++)
+         {
+            std::vector<BYTE> lumaPlane = CreateLumaPlane(static_cast<BYTE>(brightness));
+            triggered |= detector.ProcessLumaPlane(lumaPlane.data(), c_width, c_height);
+         }
+
+         // check
+         Assert::IsFalse(triggered, L"slowly changing brightness must not trigger");
+      }
+   };
+} // namespace LogicUnitTest
@@ -35,15 +35,23 @@ LPCTSTR c_pszStateHandlerTable = _T("__StateHandler");
 /// name for table to store DownloadEvent handler functions
 LPCTSTR c_pszDownloadHandlerTable = _T("__DownloadHandler");
 
-/// cycle time for event timer
-const unsigned int c_uiEventTimerCycleInMilliseconds = 100;
+/// cycle time for event timer, right after camera events were processed
+const unsigned int c_uiMinEventTimerCycleInMilliseconds = 10;
+
+/// cycle time for event timer, when no camera events were processed for some
+/// time; EDSDK can only signal follow-up events from its event callbacks, so
+/// the first event after idle time is found by the timer, and the cycle time
+/// must not exceed the former fixed poll cycle of 100 ms
+const unsigned int c_uiMaxEventTimerCycleInMilliseconds = 100;
 
 CameraControlLuaBindings::CameraControlLuaBindings(Lua::State& state, asio::io_service::strand& strand)
 :m_state(state),
 m_strand(strand),
 m_timerEventHandling(m_strand.context()),
 m_evtStopTimer(false),
-m_evtTimerStopped(false)
+m_evtTimerStopped(false),
+m_uiEventTimerCycleInMilliseconds(c_uiMinEventTimerCycleInMilliseconds),
+m_bEventPumpPending(false)
 {
 }
 
@@ -80,9 +88,21 @@ void CameraControlLuaBindings::InitBindings()
       std::bind(&CameraControlLuaBindings::SysGetInstance, shared_from_this(),
          std::placeholders::_1));
 
+   sys.AddFunction("getEventStatistics",
+      std::bind(&CameraControlLuaBindings::SysGetEventStatistics, shared_from_this(),
+         std::placeholders::_1));
+
    InitConstants();
 
    RestartEventTimer();
+
+   std::weak_ptr<CameraControlLuaBindings> wpThis = shared_from_this();
+   Instance::SetEventsPendingHandler([wpThis]()
+   {
+      std::shared_ptr<CameraControlLuaBindings> spThis = wpThis.lock();
+      if (spThis != nullptr)
+         spThis->OnEventsPending();
+   });
 }
 
 void CameraControlLuaBindings::InitConstants()
@@ -169,6 +189,7 @@ void CameraControlLuaBindings::InitRemoteReleaseControlConstants(Lua::Table& con
    remoteReleaseControl.AddValue(_T("capAFLock"), Lua::Value(RemoteReleaseControl::capAFLock));
    remoteReleaseControl.AddValue(_T("capBulbMode"), Lua::Value(RemoteReleaseControl::capBulbMode));
    remoteReleaseControl.AddValue(_T("capUILock"), Lua::Value(RemoteReleaseControl::capUILock));
+   remoteReleaseControl.AddValue(_T("capBurstMode"), Lua::Value(RemoteReleaseControl::capBurstMode));
 
    remoteReleaseControl.AddValue(_T("propEventPropertyChanged"), Lua::Value(RemoteReleaseControl::propEventPropertyChanged));
    remoteReleaseControl.AddValue(_T("propEventPropertyDescChanged"), Lua::Value(RemoteReleaseControl::propEventPropertyDescChanged));
@@ -179,6 +200,8 @@ void CameraControlLuaBindings::InitRemoteReleaseControlConstants(Lua::Table& con
    remoteReleaseControl.AddValue(_T("stateEventReleaseError"), Lua::Value(RemoteReleaseControl::stateEventReleaseError));
    remoteReleaseControl.AddValue(_T("stateEventBulbExposureTime"), Lua::Value(RemoteReleaseControl::stateEventBulbExposureTime));
    remoteReleaseControl.AddValue(_T("stateEventInternalError"), Lua::Value(RemoteReleaseControl::stateEventInternalError));
+   remoteReleaseControl.AddValue(_T("stateEventCaptureComplete"), Lua::Value(RemoteReleaseControl::stateEventCaptureComplete));
+   remoteReleaseControl.AddValue(_T("stateEventTransferError"), Lua::Value(RemoteReleaseControl::stateEventTransferError));
 
    remoteReleaseControl.AddValue(_T("downloadEventStarted"), Lua::Value(RemoteReleaseControl::downloadEventStarted));
    remoteReleaseControl.AddValue(_T("downloadEventInProgress"), Lua::Value(RemoteReleaseControl::downloadEventInProgress));
@@ -349,23 +372,75 @@ void CameraControlLuaBindings::RestartEventTimer()
 {
    m_evtTimerStopped.Reset();
 
-   m_timerEventHandling.expires_from_now(std::chrono::milliseconds(c_uiEventTimerCycleInMilliseconds));
+   m_timerEventHandling.expires_after(std::chrono::milliseconds(m_uiEventTimerCycleInMilliseconds));
    m_timerEventHandling.async_wait(
       m_strand.wrap(
          std::bind(&CameraControlLuaBindings::OnTimerEventHandling, shared_from_this(), std::placeholders::_1)));
 }
 
+/// \details The timer is only a fallback for camera SDKs that can't notify
+/// about pending events. The cycle time adapts: right after events were
+/// processed, the timer runs with the minimum cycle time, since more events
+/// usually follow, e.g. while downloading; when idle, the cycle time is
+/// doubled until it reaches the maximum.
 void CameraControlLuaBindings::OnTimerEventHandling(const std::error_code& error)
 {
-   if (error || m_evtStopTimer.Wait(0))
+   if (m_evtStopTimer.Wait(0))
    {
       // timer was canceled
       m_evtTimerStopped.Set();
       return;
    }
 
+   if (error)
+      return; // timer was restarted by PumpEvents()
+
+   m_eventStatistics.m_uiNumTimerWakeups++;
+
+   bool bEventsProcessed = Instance::OnIdle();
+
+   if (bEventsProcessed)
+      m_uiEventTimerCycleInMilliseconds = c_uiMinEventTimerCycleInMilliseconds;
+   else
+   {
+      m_eventStatistics.m_uiNumIdleTimerWakeups++;
+
+      m_uiEventTimerCycleInMilliseconds =
+         std::min(m_uiEventTimerCycleInMilliseconds * 2, c_uiMaxEventTimerCycleInMilliseconds);
+   }
+
+   RestartEventTimer();
+}
+
+/// \details Called from any thread; multiple notifications before the events
+/// are pumped only lead to one call to PumpEvents().
+void CameraControlLuaBindings::OnEventsPending()
+{
+   if (m_bEventPumpPending.exchange(true))
+      return;
+
+   m_strand.post(
+      std::bind(&CameraControlLuaBindings::PumpEvents, shared_from_this(),
+         std::chrono::steady_clock::now()));
+}
+
+void CameraControlLuaBindings::PumpEvents(std::chrono::steady_clock::time_point notifyTime)
+{
+   m_bEventPumpPending = false;
+
+   if (m_evtStopTimer.Wait(0))
+      return;
+
    Instance::OnIdle();
 
+   double dLatency = std::chrono::duration<double>(std::chrono::steady_clock::now() - notifyTime).count();
+
+   m_eventStatistics.m_uiNumNotifications++;
+   m_eventStatistics.m_dTotalLatency += dLatency;
+   m_eventStatistics.m_dMaxLatency = std::max(m_eventStatistics.m_dMaxLatency, dLatency);
+
+   // more events may follow; poll with minimum cycle time again
+   m_uiEventTimerCycleInMilliseconds = c_uiMinEventTimerCycleInMilliseconds;
    RestartEventTimer();
 }
 
@@ -435,8 +510,11 @@ void CameraControlLuaBindings::CancelHandlers()
 
 void CameraControlLuaBindings::StopTimer()
 {
-   m_timerEventHandling.cancel();
+   Instance::SetEventsPendingHandler();
+
+   // set event before canceling, so that the timer handler doesn't restart the timer
    m_evtStopTimer.Set();
+   m_timerEventHandling.cancel();
 
    std::atomic<bool> finished = false;
 
@@ -458,6 +536,32 @@ void CameraControlLuaBindings::CleanupBindings()
    GetState().CollectGarbage();
 }
 
+/// \return table with event handling statistics; all times are in seconds
+std::vector<Lua::Value> CameraControlLuaBindings::SysGetEventStatistics(Lua::State& state)
+{
+   double dElapsedTime = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - m_eventStatistics.m_startTime).count();
+
+   const EventStatistics& stats = m_eventStatistics;
+
+   Lua::Table statistics = state.AddTable(_T(""));
+
+   statistics.AddValue(_T("elapsedTime"), Lua::Value(dElapsedTime));
+   statistics.AddValue(_T("timerWakeups"), Lua::Value(static_cast<int>(stats.m_uiNumTimerWakeups)));
+   statistics.AddValue(_T("idleTimerWakeups"), Lua::Value(static_cast<int>(stats.m_uiNumIdleTimerWakeups)));
+   statistics.AddValue(_T("idleWakeupsPerSecond"),
+      Lua::Value(dElapsedTime > 0.0 ? stats.m_uiNumIdleTimerWakeups / dElapsedTime : 0.0));
+   statistics.AddValue(_T("notifications"), Lua::Value(static_cast<int>(stats.m_uiNumNotifications)));
+   statistics.AddValue(_T("averageLatency"),
+      Lua::Value(stats.m_uiNumNotifications > 0 ? stats.m_dTotalLatency / stats.m_uiNumNotifications : 0.0));
+   statistics.AddValue(_T("maxLatency"), Lua::Value(stats.m_dMaxLatency));
+
+   std::vector<Lua::Value> vecRetValues;
+   vecRetValues.push_back(Lua::Value(statistics));
+
+   return vecRetValues;
+}
+
 std::vector<Lua::Value> CameraControlLuaBindings::SysGetInstance(Lua::State& state)
 {
    Lua::Table instance = state.AddTable(_T(""));
@@ -835,6 +939,10 @@ void CameraControlLuaBindings::InitRemoteReleaseControlTable(std::shared_ptr<Rem
       std::bind(&CameraControlLuaBindings::RemoteReleaseControlSetImageProperty, shared_from_this(), spRemoteReleaseControl,
          std::placeholders::_1, std::placeholders::_2));
 
+   remoteReleaseControl.AddFunction("setImageProperties",
+      std::bind(&CameraControlLuaBindings::RemoteReleaseControlSetImageProperties, shared_from_this(), spRemoteReleaseControl,
+         std::placeholders::_1, std::placeholders::_2));
+
    remoteReleaseControl.AddFunction("startViewfinder",
       std::bind(&CameraControlLuaBindings::RemoteReleaseControlStartViewfinder, shared_from_this(),
          spRemoteReleaseControl, std::placeholders::_1));
@@ -850,6 +958,12 @@ void CameraControlLuaBindings::InitRemoteReleaseControlTable(std::shared_ptr<Rem
    remoteReleaseControl.AddFunction("startBulb",
       std::bind(&CameraControlLuaBindings::RemoteReleaseControlStartBulb, shared_from_this(),
          spRemoteReleaseControl, std::placeholders::_1));
+   remoteReleaseControl.AddFunction("getReleaseLatencyStatistics",
+      std::bind(&CameraControlLuaBindings::RemoteReleaseControlGetReleaseLatencyStatistics, shared_from_this(),
+         spRemoteReleaseControl, std::placeholders::_1));
+   remoteReleaseControl.AddFunction("resetReleaseLatencyStatistics",
+      std::bind(&CameraControlLuaBindings::RemoteReleaseControlResetReleaseLatencyStatistics, shared_from_this(),
+         spRemoteReleaseControl));
    remoteReleaseControl.AddFunction("close",
       std::bind(&CameraControlLuaBindings::RemoteReleaseControlClose, shared_from_this(), spRemoteReleaseControl));
 
@@ -1452,13 +1566,73 @@ std::vector<Lua::Value> CameraControlLuaBindings::RemoteReleaseControlSetImagePr
 
    Lua::Table imagePropertyTable = vecParams[1].Get<Lua::Table>();
 
-   // first get current image property
+   ImageProperty imageProperty = ImagePropertyFromTable(spRemoteReleaseControl, state, imagePropertyTable);
+
+   spRemoteReleaseControl->SetImageProperty(imageProperty);
+
+   return std::vector<Lua::Value>();
+}
+
+/// \details All image properties are converted first, so that no property is
+/// set when one of the tables can't be converted; then all properties are
+/// set with one call, e.g. Av, Tv and ISO of the next shot of an exposure ramp.
+std::vector<Lua::Value> CameraControlLuaBindings::RemoteReleaseControlSetImageProperties(
+   std::shared_ptr<RemoteReleaseControl> spRemoteReleaseControl,
+   Lua::State& state,
+   const std::vector<Lua::Value>& vecParams)
+{
+   if (vecParams.size() != 2)
+      throw Lua::Exception(_T("invalid number of parameters to RemoteReleaseControl:setImageProperties()"), state.GetState(), __FILE__, __LINE__);
+
+   if (vecParams[0].GetType() != Lua::Value::typeTable)
+      throw Lua::Exception(_T("first parameter must be the RemoteReleaseControl table"), state.GetState(), __FILE__, __LINE__);
+
+   if (vecParams[1].GetType() != Lua::Value::typeTable)
+      throw Lua::Exception(_T("second parameter must be array of image property tables"), state.GetState(), __FILE__, __LINE__);
+
+   Lua::Table imagePropertyListTable = vecParams[1].Get<Lua::Table>();
+
+   std::vector<ImageProperty> vecImageProperties;
+
+   for (int index = 1; ; index++)
+   {
+      Lua::Value imagePropertyValue = imagePropertyListTable.GetValue(index);
+      if (imagePropertyValue.GetType() == Lua::Value::typeNil)
+         break;
+
+      if (imagePropertyValue.GetType() != Lua::Value::typeTable)
+         throw Lua::Exception(_T("array must only contain image property tables"), state.GetState(), __FILE__, __LINE__);
+
+      Lua::Table imagePropertyTable = imagePropertyValue.Get<Lua::Table>();
+
+      vecImageProperties.push_back(ImagePropertyFromTable(spRemoteReleaseControl, state, imagePropertyTable));
+   }
+
+   spRemoteReleaseControl->SetImageProperties(vecImageProperties);
+
+   return std::vector<Lua::Value>();
+}
+
+/// \details The value type expected by the camera is taken from the cached
+/// valid values of the image property, so that no round trip to the camera
+/// is needed; only when the property has no valid values, the current value
+/// is retrieved from the camera.
+ImageProperty CameraControlLuaBindings::ImagePropertyFromTable(
+   std::shared_ptr<RemoteReleaseControl> spRemoteReleaseControl,
+   Lua::State& state,
+   Lua::Table& imagePropertyTable)
+{
    unsigned int propertyId =
       static_cast<unsigned int>(imagePropertyTable.GetValue(_T("id")).Get<int>());
 
-   ImageProperty imageProperty = spRemoteReleaseControl->GetImageProperty(propertyId);
+   std::shared_ptr<const ImagePropertyValueList> spValidValueList =
+      spRemoteReleaseControl->GetCachedImagePropertyValues(propertyId);
+
+   ImageProperty imageProperty = spValidValueList->Values().empty()
+      ? spRemoteReleaseControl->GetImageProperty(propertyId)
+      : spValidValueList->Values().front();
 
-   // then set image property with new value
+   // replace value with the new value from the table
    Lua::Value newValue = imagePropertyTable.GetValue(_T("value"));
 
    if (!ModifyVariantFromLuaValue(newValue, imageProperty.Value()))
@@ -1471,9 +1645,7 @@ std::vector<Lua::Value> CameraControlLuaBindings::RemoteReleaseControlSetImagePr
       throw Lua::Exception(message, state.GetState(), __FILE__, __LINE__);
    }
 
-   spRemoteReleaseControl->SetImageProperty(imageProperty);
-
-   return std::vector<Lua::Value>();
+   return imageProperty;
 }
 
 void CameraControlLuaBindings::AddImageProperty(
@@ -1504,8 +1676,10 @@ void CameraControlLuaBindings::AddImagePropertyValidValues(
    const ImageProperty& imageProperty,
    std::shared_ptr<RemoteReleaseControl> spRemoteReleaseControl)
 {
-   std::vector<ImageProperty> validValues;
-   spRemoteReleaseControl->EnumImagePropertyValues(imageProperty.Id(), validValues);
+   std::shared_ptr<const ImagePropertyValueList> spValidValueList =
+      spRemoteReleaseControl->GetCachedImagePropertyValues(imageProperty.Id());
+
+   const std::vector<ImageProperty>& validValues = spValidValueList->Values();
 
    if (validValues.empty())
    {
@@ -1609,6 +1783,46 @@ std::vector<Lua::Value> CameraControlLuaBindings::RemoteReleaseControlStartBulb(
    return vecRetValues;
 }
 
+std::vector<Lua::Value> CameraControlLuaBindings::RemoteReleaseControlGetReleaseLatencyStatistics(
+   std::shared_ptr<RemoteReleaseControl> spRemoteReleaseControl,
+   Lua::State& state)
+{
+   ReleaseLatencyStatistics statistics = spRemoteReleaseControl->GetReleaseLatencyStatistics();
+
+   Lua::Table statisticsTable = state.AddTable(_T(""));
+   statisticsTable.AddValue(_T("numShots"), Lua::Value(static_cast<int>(statistics.NumShots())));
+
+   for (int stage = releaseStageCommandSent; stage < releaseStageMax; stage++)
+   {
+      T_enReleaseStage enReleaseStage = static_cast<T_enReleaseStage>(stage);
+      const LatencyHistogram& histogram = statistics.Histogram(enReleaseStage);
+
+      Lua::Table stageTable = state.AddTable(_T(""));
+      stageTable.AddValue(_T("count"), Lua::Value(static_cast<int>(histogram.Count())));
+      stageTable.AddValue(_T("min"), Lua::Value(histogram.Min()));
+      stageTable.AddValue(_T("max"), Lua::Value(histogram.Max()));
+      stageTable.AddValue(_T("mean"), Lua::Value(histogram.Mean()));
+      stageTable.AddValue(_T("p50"), Lua::Value(histogram.Percentile(50.0)));
+      stageTable.AddValue(_T("p90"), Lua::Value(histogram.Percentile(90.0)));
+      stageTable.AddValue(_T("p99"), Lua::Value(histogram.Percentile(99.0)));
+
+      statisticsTable.AddValue(ReleaseLatencyStatistics::StageName(enReleaseStage), Lua::Value(stageTable));
+   }
+
+   std::vector<Lua::Value> vecRetValues;
+   vecRetValues.push_back(Lua::Value(statisticsTable));
+
+   return vecRetValues;
+}
+
+std::vector<Lua::Value> CameraControlLuaBindings::RemoteReleaseControlResetReleaseLatencyStatistics(
+   std::shared_ptr<RemoteReleaseControl> spRemoteReleaseControl)
+{
+   spRemoteReleaseControl->ResetReleaseLatencyStatistics();
+
+   return std::vector<Lua::Value>();
+}
+
 std::vector<Lua::Value> CameraControlLuaBindings::RemoteReleaseControlClose(
    std::shared_ptr<RemoteReleaseControl> spRemoteReleaseControl)
 {
@@ -1743,10 +1957,10 @@ void CameraControlLuaBindings::SetAvailImageHandler_OnAvailImageHandler(
 
    vecParams.push_back(Lua::Value(viewfinder));
 
-   // second parameter: image
-   size_t uiSize = vecImage.size();
-   Lua::Userdata userdata = GetState().AddUserdata(uiSize);
-   memcpy(userdata.Data(), vecImage.data(), uiSize);
+   // second parameter: image; uses a shared memory block, so that the frame
+   // isn't copied again when sent over a channel
+   Lua::Userdata userdata = GetState().AddUserdata(
+      std::make_shared<const std::vector<unsigned char>>(vecImage));
 
    vecParams.push_back(Lua::Value(userdata));
 
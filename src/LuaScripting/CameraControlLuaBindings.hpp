@@ -12,6 +12,7 @@
 #include <ulib/thread/RecursiveMutex.hpp>
 #include <ulib/thread/Event.hpp>
 #include <asio.hpp>
+#include <atomic>
 #include "ShutterReleaseSettings.hpp"
 #include "RemoteReleaseControl.hpp"
 
@@ -95,12 +96,21 @@ private:
    /// handler for timer used for event handling
    void OnTimerEventHandling(const std::error_code& error);
 
+   /// called by camera SDKs when events are pending; may be called from any thread
+   void OnEventsPending();
+
+   /// processes pending camera events, after OnEventsPending() was called
+   void PumpEvents(std::chrono::steady_clock::time_point notifyTime);
+
 
    // Sys functions
 
    /// local instance = Sys:getInstance()
    std::vector<Lua::Value> SysGetInstance(Lua::State& state);
 
+   /// local statistics = Sys:getEventStatistics()
+   std::vector<Lua::Value> SysGetEventStatistics(Lua::State& state);
+
 
    // Instance functions
 
@@ -270,6 +280,14 @@ private:
    std::vector<Lua::Value> RemoteReleaseControlSetImageProperty(std::shared_ptr<RemoteReleaseControl> spRemoteReleaseControl,
       Lua::State& state, const std::vector<Lua::Value>& vecParams);
 
+   /// remoteReleaseControl:setImageProperties(imagePropertyList)
+   std::vector<Lua::Value> RemoteReleaseControlSetImageProperties(std::shared_ptr<RemoteReleaseControl> spRemoteReleaseControl,
+      Lua::State& state, const std::vector<Lua::Value>& vecParams);
+
+   /// converts ImageProperty table to image property, using the value type expected by the camera
+   static ImageProperty ImagePropertyFromTable(std::shared_ptr<RemoteReleaseControl> spRemoteReleaseControl,
+      Lua::State& state, Lua::Table& imagePropertyTable);
+
    /// adds ImageProperty table
    void AddImageProperty(Lua::State& state,
       Lua::Table& table,
@@ -301,6 +319,14 @@ private:
    std::vector<Lua::Value> RemoteReleaseControlStartBulb(
       std::shared_ptr<RemoteReleaseControl> spRemoteReleaseControl, Lua::State& state);
 
+   /// local latencyStatistics = remoteReleaseControl:getReleaseLatencyStatistics()
+   std::vector<Lua::Value> RemoteReleaseControlGetReleaseLatencyStatistics(
+      std::shared_ptr<RemoteReleaseControl> spRemoteReleaseControl, Lua::State& state);
+
+   /// remoteReleaseControl:resetReleaseLatencyStatistics()
+   std::vector<Lua::Value> RemoteReleaseControlResetReleaseLatencyStatistics(
+      std::shared_ptr<RemoteReleaseControl> spRemoteReleaseControl);
+
    /// local remoteReleaseControl:close()
    std::vector<Lua::Value> RemoteReleaseControlClose(
       std::shared_ptr<RemoteReleaseControl> spRemoteReleaseControl);
@@ -385,11 +411,42 @@ private:
    RecursiveMutex m_mtxAsyncWaitForCamera_InScript;
 
    /// timer for event handling
-   asio::system_timer m_timerEventHandling;
+   asio::steady_timer m_timerEventHandling;
 
    /// event that is set when the timer should stop
    ManualResetEvent m_evtStopTimer;
 
    /// event that is set when the event handling timer has stopped
    ManualResetEvent m_evtTimerStopped;
+
+   /// current cycle time of event timer; adapts to camera event activity
+   unsigned int m_uiEventTimerCycleInMilliseconds;
+
+   /// indicates if PumpEvents() was already posted to the strand
+   std::atomic<bool> m_bEventPumpPending;
+
+   /// statistics of event handling
+   struct EventStatistics
+   {
+      /// time when the statistics were started
+      std::chrono::steady_clock::time_point m_startTime = std::chrono::steady_clock::now();
+
+      /// number of times the event timer woke up
+      unsigned int m_uiNumTimerWakeups = 0;
+
+      /// number of times the event timer woke up, but no events were processed
+      unsigned int m_uiNumIdleTimerWakeups = 0;
+
+      /// number of times events were pumped after a notification
+      unsigned int m_uiNumNotifications = 0;
+
+      /// total latency between notification and pumping events, in seconds
+      double m_dTotalLatency = 0.0;
+
+      /// maximum latency between notification and pumping events, in seconds
+      double m_dMaxLatency = 0.0;
+   };
+
+   /// event handling statistics
+   EventStatistics m_eventStatistics;
 };
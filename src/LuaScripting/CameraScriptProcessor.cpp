@@ -13,6 +13,8 @@
 #include "CameraControlLuaBindings.hpp"
 #include "LuaScriptWorkerThread.hpp"
 #include "LuaScheduler.hpp"
+#include "LuaProfiler.hpp"
+#include <future>
 
 extern "C"
 {
@@ -44,6 +46,9 @@ public:
    {
       m_fnOutputDebugString = fnOutputDebugString;
 
+      if (m_spSystemLuaBindings != nullptr)
+         m_spSystemLuaBindings->SetOutputDebugStringHandler(fnOutputDebugString);
+
       if (m_spCameraControlLuaBindings != nullptr)
          m_spCameraControlLuaBindings->SetOutputDebugStringHandler(fnOutputDebugString);
 
@@ -139,6 +144,28 @@ public:
       });
    }
 
+   /// starts sampling profiler on the Lua state
+   void StartProfiler()
+   {
+      m_scriptWorkerThread.GetStrand().post([&]()
+      {
+         GetState().StartProfiler();
+      });
+   }
+
+   /// stops sampling profiler; waits until the profiler was stopped on the worker thread
+   std::shared_ptr<LuaProfiler> StopProfiler()
+   {
+      std::promise<std::shared_ptr<LuaProfiler>> profilerPromise;
+
+      m_scriptWorkerThread.GetStrand().post([&]()
+      {
+         profilerPromise.set_value(GetState().StopProfiler());
+      });
+
+      return profilerPromise.get_future().get();
+   }
+
    /// stops Lua worker thread
    void StopThread()
    {
@@ -335,3 +362,17 @@ void CameraScriptProcessor::Stop()
 
    m_spImpl->GetScheduler().CurrentExecutionState(LuaScheduler::stateIdle);
 }
+
+void CameraScriptProcessor::StartProfiler()
+{
+   ATLASSERT(m_spImpl != nullptr);
+
+   m_spImpl->StartProfiler();
+}
+
+std::shared_ptr<LuaProfiler> CameraScriptProcessor::StopProfiler()
+{
+   ATLASSERT(m_spImpl != nullptr);
+
+   return m_spImpl->StopProfiler();
+}
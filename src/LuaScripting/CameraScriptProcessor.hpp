@@ -8,6 +8,7 @@
 
 // forward references
 class LuaScheduler;
+class LuaProfiler;
 
 /// camera Lua script processor
 class CameraScriptProcessor
@@ -39,6 +40,12 @@ public:
    /// stops running script
    void Stop();
 
+   /// starts sampling profiler; call before loading the script
+   void StartProfiler();
+
+   /// stops sampling profiler and returns it, for writing results
+   std::shared_ptr<LuaProfiler> StopProfiler();
+
 private:
    class Impl;
 
@@ -6,6 +6,9 @@
 //
 #include "stdafx.h"
 #include "Lua.hpp"
+#include "LuaBytecodeCache.hpp"
+#include "LuaProfiler.hpp"
+#include <ulib/thread/LightweightMutex.hpp>
 #include <algorithm>
 
 extern "C"
@@ -34,6 +37,19 @@ static const luaL_Reg availableLuaLibs[] = {
    { NULL, NULL }
 };
 
+/// folder for the bytecode cache used by Lua::State::LoadFile(); empty when disabled
+static CString s_cszBytecodeCacheFolder;
+
+/// mutex to protect s_cszBytecodeCacheFolder; states on worker threads load files, too
+static LightweightMutex s_mutexBytecodeCacheFolder;
+
+/// returns a copy of the bytecode cache folder
+static CString GetBytecodeCacheFolder()
+{
+   LightweightMutex::LockType lock(s_mutexBytecodeCacheFolder);
+   return s_cszBytecodeCacheFolder;
+}
+
 //
 // Lua::Exception
 //
@@ -180,80 +196,108 @@ void Ref::OnRemoveStackValue(int iStackIndex)
 
 /// default ctor; constructs nil value
 Value::Value()
-   :m_enType(typeNil)
+   :m_iValue(0),
+   m_enType(typeNil),
+   m_uiStringLength(0)
 {
 }
 
 Value::Value(bool bValue)
-   :m_value(bValue),
-   m_enType(typeBoolean)
+   :m_bValue(bValue),
+   m_enType(typeBoolean),
+   m_uiStringLength(0)
 {
 }
 
 Value::Value(double dValue)
-   :m_value(dValue),
-   m_enType(typeNumber)
+   :m_dValue(dValue),
+   m_enType(typeNumber),
+   m_uiStringLength(0)
 {
 }
 
 Value::Value(int iValue)
-   :m_value(iValue),
-   m_enType(typeInteger)
+   :m_iValue(iValue),
+   m_enType(typeInteger),
+   m_uiStringLength(0)
 {
 }
 
 Value::Value(const CString& cszText)
-   :m_value(CStringA(cszText)),
-   m_enType(typeString)
+   :m_iValue(0),
+   m_enType(typeString),
+   m_uiStringLength(0)
 {
+   CStringA cszaText(cszText);
+   InitString(cszaText.GetString(), static_cast<size_t>(cszaText.GetLength()));
 }
 
 Value::Value(LPCSTR pszText)
-   :m_value(CStringA(pszText)),
-   m_enType(typeString)
+   :m_iValue(0),
+   m_enType(typeString),
+   m_uiStringLength(0)
+{
+   InitString(pszText, strlen(pszText));
+}
+
+Value::Value(LPCSTR pszText, size_t uiLength)
+   :m_iValue(0),
+   m_enType(typeString),
+   m_uiStringLength(0)
 {
+   InitString(pszText, uiLength);
 }
 
 Value::Value(Table table)
-   :m_enType(typeTable),
-   m_value(table),
+   :m_iValue(0),
+   m_enType(typeTable),
+   m_uiStringLength(0),
    m_spRef(table.GetRef())
 {
 }
 
 Value::Value(Userdata userdata)
-   :m_enType(typeUserdata),
-   m_value(userdata),
+   :m_iValue(0),
+   m_enType(typeUserdata),
+   m_uiStringLength(0),
    m_spRef(userdata.GetRef())
 {
 }
 
 Value::Value(Function func)
-   :m_enType(typeFunction),
-   m_value(func),
+   :m_iValue(0),
+   m_enType(typeFunction),
+   m_uiStringLength(0),
    m_spRef(func.GetRef())
 {
 }
 
 Value::Value(Thread thread)
-   :m_enType(typeThread),
-   m_value(thread),
+   :m_iValue(0),
+   m_enType(typeThread),
+   m_uiStringLength(0),
    m_spRef(thread.GetRef())
 {
 }
 
 Value::Value(const Value& val)
-   :m_value(val.m_value),
-   m_enType(val.m_enType),
-   m_spRef(val.GetRef())
+   :m_iValue(0),
+   m_enType(typeNil),
+   m_uiStringLength(0),
+   m_spRef(val.m_spRef)
 {
+   CopyFrom(val);
 }
 
+/// \details Large strings are copied, since CStringA only increments the
+/// reference count of the string data.
 Value::Value(Value&& val) noexcept
-   :m_value(std::move(val.m_value)),
-   m_enType(std::move(val.m_enType)),
+   :m_iValue(0),
+   m_enType(typeNil),
+   m_uiStringLength(0),
    m_spRef(std::move(val.m_spRef))
 {
+   CopyFrom(val);
 }
 
 Value& Value::operator=(const Value& val)
@@ -261,9 +305,9 @@ Value& Value::operator=(const Value& val)
    if (this == &val)
       return *this;
 
-   m_value = val.m_value;
-   m_enType = val.m_enType;
-   m_spRef = val.GetRef();
+   Destroy();
+   CopyFrom(val);
+   m_spRef = val.m_spRef;
 
    return *this;
 }
@@ -273,23 +317,172 @@ Value& Value::operator=(Value&& val) noexcept
    if (this == &val)
       return *this;
 
-   m_value = std::move(val.m_value);
-   m_enType = std::move(val.m_enType);
-   m_spRef = std::move(val.GetRef());
+   Destroy();
+   CopyFrom(val);
+   m_spRef = std::move(val.m_spRef);
 
    return *this;
 }
 
 Value::~Value()
 {
+   Destroy();
+
    State::CleanupRef(m_spRef);
 }
 
-void Value::Attach(std::shared_ptr<Ref> spRef) const
+void Value::InitString(LPCSTR pszText, size_t uiLength)
+{
+   m_uiStringLength = uiLength;
+
+   if (IsSmallString())
+   {
+      memcpy(m_szSmallString, pszText, uiLength);
+      m_szSmallString[uiLength] = 0;
+   }
+   else
+      new (&m_cszLargeString) CStringA(pszText, static_cast<int>(uiLength));
+}
+
+void Value::CopyFrom(const Value& val)
+{
+   m_enType = val.m_enType;
+   m_uiStringLength = val.m_uiStringLength;
+
+   switch (m_enType)
+   {
+   case typeBoolean:
+      m_bValue = val.m_bValue;
+      break;
+
+   case typeNumber:
+      m_dValue = val.m_dValue;
+      break;
+
+   case typeInteger:
+      m_iValue = val.m_iValue;
+      break;
+
+   case typeString:
+      if (IsSmallString())
+         memcpy(m_szSmallString, val.m_szSmallString, m_uiStringLength + 1);
+      else
+         new (&m_cszLargeString) CStringA(val.m_cszLargeString);
+      break;
+
+   default:
+      // nil and all reference types only use m_spRef
+      m_iValue = 0;
+      break;
+   }
+}
+
+void Value::Destroy() noexcept
+{
+   if (m_enType == typeString && !IsSmallString())
+      m_cszLargeString.~CStringA();
+
+   m_enType = typeNil;
+   m_uiStringLength = 0;
+}
+
+LPCSTR Value::GetStringA() const
 {
-   m_spRef = spRef;
+   ATLASSERT(m_enType == typeString);
+
+   return IsSmallString() ? m_szSmallString : m_cszLargeString.GetString();
 }
 
+template <>
+bool Value::Get<bool>() const
+{
+   if (m_enType != typeBoolean)
+      throw ::Exception(_T("Lua value is not a boolean"), __FILE__, __LINE__);
+
+   return m_bValue;
+}
+
+template <>
+double Value::Get<double>() const
+{
+   if (m_enType == typeInteger)
+      return static_cast<double>(m_iValue);
+
+   if (m_enType != typeNumber)
+      throw ::Exception(_T("Lua value is not a number"), __FILE__, __LINE__);
+
+   return m_dValue;
+}
+
+template <>
+int Value::Get<int>() const
+{
+   if (m_enType == typeInteger)
+      return m_iValue;
+
+   if (m_enType != typeNumber)
+      throw ::Exception(_T("Lua value is not a number"), __FILE__, __LINE__);
+
+   return static_cast<int>(m_dValue);
+}
+
+template <>
+CString Value::Get<CString>() const
+{
+   if (m_enType != typeString)
+      throw ::Exception(_T("Lua value is not a string"), __FILE__, __LINE__);
+
+   return CString(GetStringA(), static_cast<int>(m_uiStringLength));
+}
+
+template <>
+std::string Value::Get<std::string>() const
+{
+   if (m_enType != typeString)
+      throw ::Exception(_T("Lua value is not a string"), __FILE__, __LINE__);
+
+   return std::string(GetStringA(), m_uiStringLength);
+}
+
+template <>
+Function Value::Get<Function>() const
+{
+   if (m_enType != typeFunction)
+      throw ::Exception(_T("Lua value is not a function"), __FILE__, __LINE__);
+
+   return Function(m_spRef);
+}
+
+template <>
+Table Value::Get<Table>() const
+{
+   if (m_enType != typeTable)
+      throw ::Exception(_T("Lua value is not a table"), __FILE__, __LINE__);
+
+   return Table(m_spRef, CString());
+}
+
+template <>
+Userdata Value::Get<Userdata>() const
+{
+   if (m_enType != typeUserdata)
+      throw ::Exception(_T("Lua value is not a userdata"), __FILE__, __LINE__);
+
+   return Userdata(m_spRef);
+}
+
+template <>
+Thread Value::Get<Thread>() const
+{
+   if (m_enType != typeThread)
+      throw ::Exception(_T("Lua value is not a thread"), __FILE__, __LINE__);
+
+   return Thread(m_spRef);
+}
+
+/// \details Pushing values doesn't create a reference to the pushed value,
+/// since all callers pass the value on to Lua, which removes it from the
+/// stack.
 void Value::Push(State& state) const
 {
    lua_State* L = state.GetState();
@@ -298,27 +491,22 @@ void Value::Push(State& state) const
    {
    case typeNil:
       lua_pushnil(L);
-      Attach(std::make_shared<Ref>(state, -1));
       break;
 
    case typeBoolean:
-      lua_pushboolean(L, std::any_cast<bool>(m_value) ? 1 : 0);
-      Attach(std::make_shared<Ref>(state, -1));
+      lua_pushboolean(L, m_bValue ? 1 : 0);
       break;
 
    case typeNumber:
-      lua_pushnumber(L, std::any_cast<double>(m_value));
-      Attach(std::make_shared<Ref>(state, -1));
+      lua_pushnumber(L, m_dValue);
       break;
 
    case typeInteger:
-      lua_pushinteger(L, std::any_cast<int>(m_value));
-      Attach(std::make_shared<Ref>(state, -1));
+      lua_pushinteger(L, m_iValue);
       break;
 
    case typeString:
-      lua_pushstring(L, std::any_cast<CStringA>(m_value));
-      Attach(std::make_shared<Ref>(state, -1));
+      lua_pushlstring(L, GetStringA(), m_uiStringLength);
       break;
 
    case typeTable:
@@ -355,82 +543,39 @@ void Value::Push(State& state) const
    }
 }
 
-void Value::Detach() const
-{
-   switch (m_enType)
-   {
-   case typeTable:
-   {
-      Table table = Get<Table>();
-      table.Detach();
-   }
-   break;
-
-   case typeFunction:
-   {
-      Function func = Get<Function>();
-      func.Detach();
-   }
-   break;
-
-   case typeUserdata:
-   {
-      Userdata userdata = Get<Userdata>();
-      userdata.Detach();
-   }
-   break;
-
-   case typeThread:
-   {
-      Thread thread = Get<Thread>();
-      thread.Detach();
-   }
-   break;
-
-   default:
-      m_spRef->Detach();
-      m_spRef.reset();
-   }
-}
-
-Value Value::FromStack(State& state, int iStackIndex)
+Value Value::FromStack(State& state, int iStackIndex, bool bRemoveCopiedValue)
 {
    lua_State* L = state.GetState();
 
+   Value val;
+
    switch (lua_type(L, iStackIndex))
    {
    case LUA_TNONE:
-   case LUA_TNIL:
-   {
-      Value val;
-      val.Attach(std::make_shared<Ref>(state, iStackIndex));
-      state.AddRef(val.GetRef());
       return val;
-   }
+
+   case LUA_TNIL:
+      break;
 
    case LUA_TNUMBER:
-   {
-      Value val(lua_tonumber(L, iStackIndex));
-      val.Attach(std::make_shared<Ref>(state, iStackIndex));
-      state.AddRef(val.GetRef());
-      return val;
-   }
+      val.m_enType = typeNumber;
+      val.m_dValue = lua_tonumber(L, iStackIndex);
+      break;
 
    case LUA_TBOOLEAN:
-   {
-      Value val(lua_toboolean(L, iStackIndex) != 0);
-      val.Attach(std::make_shared<Ref>(state, iStackIndex));
-      state.AddRef(val.GetRef());
-      return val;
-   }
+      val.m_enType = typeBoolean;
+      val.m_bValue = lua_toboolean(L, iStackIndex) != 0;
+      break;
 
    case LUA_TSTRING:
    {
-      Value val(lua_tostring(L, iStackIndex));
-      val.Attach(std::make_shared<Ref>(state, iStackIndex));
-      state.AddRef(val.GetRef());
-      return val;
+      size_t uiLength = 0;
+      LPCSTR pszText = lua_tolstring(L, iStackIndex, &uiLength);
+
+      val.m_enType = typeString;
+      val.InitString(pszText, uiLength);
    }
+   break;
 
    case LUA_TTABLE:
    {
@@ -466,10 +611,13 @@ Value Value::FromStack(State& state, int iStackIndex)
 
    default:
       ATLASSERT(false); // type can't be converted into Value
-      break;
+      return val;
    }
 
-   return Value();
+   if (bRemoveCopiedValue)
+      state.RemoveIndex(lua_absindex(L, iStackIndex));
+
+   return val;
 }
 
 //
@@ -488,6 +636,11 @@ struct FuncData
    /// pushes C closure
    static void PushCClosure(State& state, T_fnCFunction fn);
 
+   /// pushes raw C closure, with instance as upvalue 1 and the table at
+   /// given stack index, or nil when 0, as upvalue 2
+   static void PushRawCClosure(State& state, T_fnRawCFunction fn, std::shared_ptr<void> spInstance,
+      int tableIndex = 0);
+
    /// returns ref to self from upvalue
    static FuncData& GetSelf(lua_State* L);
 
@@ -497,6 +650,9 @@ struct FuncData
    /// garbage collect call
    static int OnFunctionGarbageCollect(lua_State* L);
 
+   /// garbage collect call for instance upvalue of raw C closures
+   static int OnInstanceGarbageCollect(lua_State* L);
+
    /// bound C++ function
    T_fnCFunction m_fn;
 };
@@ -524,6 +680,38 @@ void FuncData::PushCClosure(State& state, T_fnCFunction fn)
    lua_pushcclosure(L, &FuncData::OnFunctionCall, 1);
 }
 
+/// \details The instance is stored as shared_ptr in a userdata value, which
+/// is cleaned up by the __gc metamethod when the closure is garbage collected.
+/// The metatable is shared between all instance userdata values.
+/// \details The table upvalue is used by typed bindings to recognize a
+/// "self" argument when the function is called as Table:method().
+void FuncData::PushRawCClosure(State& state, T_fnRawCFunction fn, std::shared_ptr<void> spInstance,
+   int tableIndex)
+{
+   lua_State* L = state.GetState();
+
+   if (tableIndex != 0)
+      tableIndex = lua_absindex(L, tableIndex);
+
+   void* pUserdata = lua_newuserdatauv(L, sizeof(std::shared_ptr<void>), 0);
+   new (pUserdata) std::shared_ptr<void>(spInstance);
+
+   if (luaL_newmetatable(L, "Lua::FuncData::Instance") != 0)
+   {
+      lua_pushcfunction(L, &FuncData::OnInstanceGarbageCollect);
+      lua_setfield(L, -2, "__gc");
+   }
+
+   lua_setmetatable(L, -2);
+
+   if (tableIndex != 0)
+      lua_pushvalue(L, tableIndex);
+   else
+      lua_pushnil(L);
+
+   lua_pushcclosure(L, fn, 2);
+}
+
 FuncData& FuncData::GetSelf(lua_State* L)
 {
    void* p = lua_touserdata(L, lua_upvalueindex(1));
@@ -546,6 +734,8 @@ int FuncData::OnFunctionCall(lua_State* L)
    if (data.m_fn == nullptr)
       return 0; // no function bound
 
+   LuaProfiler::CppCallScope profilerScope(L);
+
    // collect params
    int iStackDepth = lua_absindex(L, -1);
 
@@ -553,7 +743,7 @@ int FuncData::OnFunctionCall(lua_State* L)
 
    std::vector<Value> vecParams;
    for (int i = 1; i <= iStackDepth; i++)
-      vecParams.push_back(Value::FromStack(paramState, i));
+      vecParams.push_back(Value::FromStack(paramState, i, false));
 
    State::TraceUpvalues(L);
 
@@ -595,7 +785,7 @@ int FuncData::OnFunctionCall(lua_State* L)
 
    // put results on stack
    std::for_each(vecRetVals.begin(), vecRetVals.end(),
-      [&](const Value& value) { value.Push(paramState); value.Detach(); });
+      [&](const Value& value) { value.Push(paramState); });
 
    return vecRetVals.size();
 }
@@ -614,6 +804,17 @@ int FuncData::OnFunctionGarbageCollect(lua_State* L)
    return 0;
 }
 
+int FuncData::OnInstanceGarbageCollect(lua_State* L)
+{
+   void* p = lua_touserdata(L, -1);
+
+   std::shared_ptr<void>* pspInstance = reinterpret_cast<std::shared_ptr<void>*>(p);
+   if (pspInstance != nullptr)
+      pspInstance->~shared_ptr();
+
+   return 0;
+}
+
 //
 // Lua::Function
 //
@@ -654,16 +855,16 @@ std::vector<Value> Function::Call(int iResults, const std::vector<Value>& vecPar
 
    lua_pushvalue(L, m_spRef->GetStackIndex());
 
-   // push to stack and detach, since lua_call consumes all passed parameters
+   // push to stack; lua_call consumes all passed parameters
    std::for_each(vecParam.begin(), vecParam.end(),
-      [&](const Value& value) { value.Push(state); value.Detach(); });
+      [&](const Value& value) { value.Push(state); });
 
    state.InternalCall(vecParam.size(), iResults);
 
    // collect return values
    std::vector<Value> vecResults;
    for (int i = -iResults; i <= -1; i++)
-      vecResults.push_back(Value::FromStack(state, i));
+      vecResults.push_back(Value::FromStack(state, i, true));
 
    return vecResults;
 }
@@ -676,11 +877,6 @@ void Function::Push()
    lua_pushvalue(L, m_spRef->GetStackIndex());
 }
 
-void Function::Detach() const
-{
-   m_spRef.reset();
-}
-
 //
 // Lua::Table
 //
@@ -747,8 +943,6 @@ Table& Table::AddValue(const CString& key, const Value& value)
 
    lua_setfield(L, m_spRef->GetStackIndex(), CStringA(key));
 
-   value.Detach();
-
    return *this;
 }
 
@@ -763,8 +957,6 @@ Table& Table::AddValue(int key, const Value& value)
 
    lua_seti(L, m_spRef->GetStackIndex(), lua_Integer(key));
 
-   value.Detach();
-
    return *this;
 }
 
@@ -782,6 +974,20 @@ Table& Table::AddFunction(LPCSTR pszaName, T_fnCFunction fn)
    return *this;
 }
 
+Table& Table::AddRawFunction(LPCSTR pszaName, T_fnRawCFunction fn, std::shared_ptr<void> spInstance)
+{
+   State& state = m_spRef->GetState();
+   lua_State* L = state.GetState();
+
+   ATLASSERT(lua_istable(L, m_spRef->GetStackIndex()) != 0);
+
+   FuncData::PushRawCClosure(state, fn, spInstance, m_spRef->GetStackIndex());
+
+   lua_setfield(L, m_spRef->GetStackIndex(), pszaName);
+
+   return *this;
+}
+
 Value Table::GetValue(const CString& key)
 {
    State& state = m_spRef->GetState();
@@ -791,7 +997,7 @@ Value Table::GetValue(const CString& key)
 
    lua_gettable(L, m_spRef->GetStackIndex());
 
-   return Value::FromStack(state, -1);
+   return Value::FromStack(state, -1, true);
 }
 
 Value Table::GetValue(int key)
@@ -803,7 +1009,7 @@ Value Table::GetValue(int key)
 
    lua_gettable(L, m_spRef->GetStackIndex());
 
-   return Value::FromStack(state, -1);
+   return Value::FromStack(state, -1, true);
 }
 
 /// \details also pushes table as 'self' parameter before passing all other
@@ -828,14 +1034,14 @@ std::vector<Value> Table::CallFunction(const CString& cszName,
 
    // then params
    std::for_each(vecParam.begin(), vecParam.end(),
-      [&](const Value& value) { value.Push(state); value.Detach(); });
+      [&](const Value& value) { value.Push(state); });
 
    state.InternalCall(vecParam.size() + 1, iResults);
 
    // collect return values
    std::vector<Value> vecResults;
    for (int i = -iResults; i <= -1; i++)
-      vecResults.push_back(Value::FromStack(state, i));
+      vecResults.push_back(Value::FromStack(state, i, true));
 
    return vecResults;
 }
@@ -848,15 +1054,13 @@ void Table::Push()
    lua_pushvalue(L, m_spRef->GetStackIndex());
 }
 
-void Table::Detach() const
-{
-   m_spRef.reset();
-}
-
 //
 // Lua::Userdata
 //
 
+/// name of metatable for userdata values with shared memory block
+const char* const c_pszSharedBufferMetatableName = "Lua::Userdata::SharedBuffer";
+
 Userdata::Userdata(State& state, size_t uiSize)
    :m_pUserdata(nullptr),
    m_uiSize(uiSize)
@@ -870,6 +1074,37 @@ Userdata::Userdata(State& state, size_t uiSize)
    state.AddRef(m_spRef);
 }
 
+/// \details The Lua userdata value only stores the shared_ptr, which is
+/// released by the __gc metamethod; Data() and Size() refer to the shared
+/// memory block instead of the userdata's own memory.
+Userdata::Userdata(State& state, T_spSharedBuffer spSharedBuffer)
+   :m_pUserdata(nullptr),
+   m_uiSize(0),
+   m_spSharedBuffer(spSharedBuffer)
+{
+   ATLASSERT(spSharedBuffer != nullptr);
+
+   lua_State* L = state.GetState();
+
+   void* pUserdata = lua_newuserdatauv(L, sizeof(T_spSharedBuffer), 0);
+   new (pUserdata) T_spSharedBuffer(spSharedBuffer);
+
+   if (luaL_newmetatable(L, c_pszSharedBufferMetatableName) != 0)
+   {
+      lua_pushcfunction(L, &Userdata::OnSharedBufferGarbageCollect);
+      lua_setfield(L, -2, "__gc");
+   }
+
+   lua_setmetatable(L, -2);
+
+   m_pUserdata = const_cast<unsigned char*>(spSharedBuffer->data());
+   m_uiSize = spSharedBuffer->size();
+
+   m_spRef = std::make_shared<Ref>(state, -1);
+
+   state.AddRef(m_spRef);
+}
+
 Userdata::Userdata(std::shared_ptr<Ref> spRef)
    :m_spRef(spRef),
    m_pUserdata(nullptr),
@@ -882,14 +1117,24 @@ Userdata::Userdata(std::shared_ptr<Ref> spRef)
 
    ATLASSERT(lua_isuserdata(L, iStackIndex) != 0);
 
-   m_pUserdata = lua_touserdata(L, iStackIndex);
-   m_uiSize = lua_rawlen(L, iStackIndex);
+   m_spSharedBuffer = SharedBufferFromStack(L, iStackIndex);
+   if (m_spSharedBuffer != nullptr)
+   {
+      m_pUserdata = const_cast<unsigned char*>(m_spSharedBuffer->data());
+      m_uiSize = m_spSharedBuffer->size();
+   }
+   else
+   {
+      m_pUserdata = lua_touserdata(L, iStackIndex);
+      m_uiSize = lua_rawlen(L, iStackIndex);
+   }
 }
 
 Userdata::Userdata(const Userdata& userdata)
    :m_spRef(userdata.GetRef()),
    m_pUserdata(userdata.m_pUserdata),
-   m_uiSize(userdata.m_uiSize)
+   m_uiSize(userdata.m_uiSize),
+   m_spSharedBuffer(userdata.m_spSharedBuffer)
 {
 }
 
@@ -901,6 +1146,7 @@ Userdata& Userdata::operator=(const Userdata& userdata)
    m_spRef = userdata.GetRef();
    m_pUserdata = userdata.m_pUserdata;
    m_uiSize = userdata.m_uiSize;
+   m_spSharedBuffer = userdata.m_spSharedBuffer;
 
    return *this;
 }
@@ -922,9 +1168,24 @@ void Userdata::Push()
    lua_pushvalue(L, m_spRef->GetStackIndex());
 }
 
-void Userdata::Detach() const
+Userdata::T_spSharedBuffer Userdata::SharedBufferFromStack(lua_State* L, int iStackIndex)
 {
-   m_spRef.reset();
+   void* p = luaL_testudata(L, iStackIndex, c_pszSharedBufferMetatableName);
+   if (p == nullptr)
+      return T_spSharedBuffer();
+
+   return *reinterpret_cast<T_spSharedBuffer*>(p);
+}
+
+int Userdata::OnSharedBufferGarbageCollect(lua_State* L)
+{
+   void* p = lua_touserdata(L, -1);
+
+   T_spSharedBuffer* pspSharedBuffer = reinterpret_cast<T_spSharedBuffer*>(p);
+   if (pspSharedBuffer != nullptr)
+      pspSharedBuffer->~shared_ptr();
+
+   return 0;
 }
 
 //
@@ -973,9 +1234,19 @@ void State::LoadFile(const CString& cszFilename)
    lua_State* L = GetState();
    StackChecker checker(L);
 
-   CStringA cszaFilename(cszFilename);
+   CString cszCacheFolder = GetBytecodeCacheFolder();
 
-   int iRet = luaL_dofile(L, cszaFilename.GetString());
+   int iRet = LUA_OK;
+   if (cszCacheFolder.IsEmpty())
+      iRet = luaL_loadfile(L, CStringA(cszFilename).GetString());
+   else
+   {
+      LuaBytecodeCache cache(cszCacheFolder);
+      iRet = cache.LoadFile(L, cszFilename);
+   }
+
+   if (iRet == LUA_OK)
+      iRet = lua_pcall(L, 0, LUA_MULTRET, 0);
 
    if (iRet != 0)
    {
@@ -1060,16 +1331,16 @@ std::vector<Value> State::CallFunction(const CString& cszName, int iResults, con
       throw Lua::Exception(_T("function not found: ") + cszName, L, __FILE__, __LINE__);
    }
 
-   // push to stack and detach, since lua_call consumes all passed parameters
+   // push to stack; lua_call consumes all passed parameters
    std::for_each(vecParam.begin(), vecParam.end(),
-      [&](const Value& value) { value.Push(*this); value.Detach(); });
+      [&](const Value& value) { value.Push(*this); });
 
    InternalCall(vecParam.size(), iResults);
 
    // collect return values
    std::vector<Value> vecResults;
    for (int i = -iResults; i <= -1; i++)
-      vecResults.push_back(Value::FromStack(*this, i));
+      vecResults.push_back(Value::FromStack(*this, i, true));
 
    return vecResults;
 }
@@ -1084,6 +1355,11 @@ Userdata State::AddUserdata(size_t uiSize)
    return Userdata(*this, uiSize);
 }
 
+Userdata State::AddUserdata(Userdata::T_spSharedBuffer spSharedBuffer)
+{
+   return Userdata(*this, spSharedBuffer);
+}
+
 void State::AddFunction(LPCTSTR pszaName, T_fnCFunction fn)
 {
    lua_State* L = GetState();
@@ -1093,6 +1369,15 @@ void State::AddFunction(LPCTSTR pszaName, T_fnCFunction fn)
    lua_setglobal(L, CStringA(pszaName));
 }
 
+void State::AddRawFunction(LPCTSTR pszaName, T_fnRawCFunction fn, std::shared_ptr<void> spInstance)
+{
+   lua_State* L = GetState();
+
+   FuncData::PushRawCClosure(*this, fn, spInstance);
+
+   lua_setglobal(L, CStringA(pszaName));
+}
+
 void State::AddValue(LPCTSTR pszaName, Value value)
 {
    lua_State* L = GetState();
@@ -1100,8 +1385,6 @@ void State::AddValue(LPCTSTR pszaName, Value value)
    value.Push(*this);
 
    lua_setglobal(L, CStringA(pszaName));
-
-   value.Detach();
 }
 
 Value State::GetValue(const CString& cszName)
@@ -1110,7 +1393,7 @@ Value State::GetValue(const CString& cszName)
 
    lua_getglobal(L, CStringA(cszName).GetString());
 
-   return Value::FromStack(*this, -1);
+   return Value::FromStack(*this, -1, true);
 }
 
 Table State::GetTable(const CString& cszName)
@@ -1154,6 +1437,8 @@ void State::InternalCall(int iArguments, int iResults)
 {
    lua_State* L = GetState();
 
+   LuaProfiler::OnEnterLua(L);
+
    try
    {
       lua_call(L, iArguments, iResults);
@@ -1360,6 +1645,34 @@ LPCTSTR State::GetVersion()
    return _T(LUA_RELEASE);
 }
 
+void State::SetBytecodeCacheFolder(const CString& cszCacheFolder)
+{
+   LightweightMutex::LockType lock(s_mutexBytecodeCacheFolder);
+   s_cszBytecodeCacheFolder = cszCacheFolder;
+}
+
+void State::StartProfiler(unsigned int uiInstructionsPerSample)
+{
+   if (m_spProfiler != nullptr)
+      throw Lua::Exception(_T("profiler was already started"), GetState(), __FILE__, __LINE__);
+
+   m_spProfiler = std::make_shared<LuaProfiler>(uiInstructionsPerSample);
+   m_spProfiler->Attach(GetState());
+}
+
+std::shared_ptr<LuaProfiler> State::StopProfiler()
+{
+   std::shared_ptr<LuaProfiler> spProfiler = m_spProfiler;
+
+   if (spProfiler != nullptr)
+   {
+      spProfiler->Detach(GetState());
+      m_spProfiler.reset();
+   }
+
+   return spProfiler;
+}
+
 void State::AddRef(std::shared_ptr<Ref> spRef)
 {
    m_vecRefsOnStack.push_back(spRef);
@@ -1467,7 +1780,7 @@ Value Thread::GetValue(const CString& cszName)
 
    lua_getglobal(L, CStringA(cszName).GetString());
 
-   return Value::FromStack(m_threadState, -1);
+   return Value::FromStack(m_threadState, -1, true);
 }
 
 Table Thread::GetTable(const CString& cszName)
@@ -1505,9 +1818,6 @@ std::pair<Thread::T_enThreadStatus, std::vector<Lua::Value>> Thread::Start(Lua::
 
    funcValue.Push(m_threadState);
 
-   // detach in case the thread yields; then the stack is empty
-   funcValue.Detach();
-
    return InternalResume(vecParam);
 }
 
@@ -1532,7 +1842,7 @@ void Thread::Yield(State& localParamState, const std::vector<Value>& vecRetValue
    int iIndexLastValue = lua_gettop(L);
 
    std::for_each(vecRetValues.begin(), vecRetValues.end(),
-      [&](const Value& value) { value.Push(m_threadState); value.Detach(); });
+      [&](const Value& value) { value.Push(m_threadState); });
 
    m_state.DetachAll();
    m_threadState.DetachAll();
@@ -1571,7 +1881,7 @@ std::pair<Thread::T_enThreadStatus, std::vector<Lua::Value>> Thread::InternalRes
       iIndexLastValue--;
 
    std::for_each(vecParam.begin(), vecParam.end(),
-      [&](const Value& value) { value.Push(m_threadState); value.Detach(); });
+      [&](const Value& value) { value.Push(m_threadState); });
 
    // since lua_resume removes everything from stack, detach all values still referenced on the stack
    m_threadState.DetachAll();
@@ -1580,6 +1890,8 @@ std::pair<Thread::T_enThreadStatus, std::vector<Lua::Value>> Thread::InternalRes
    for (int iIndex = iIndexLastValue; iIndex >= 1; iIndex--)
       lua_remove(m_threadState.GetState(), iIndex);
 
+   LuaProfiler::OnEnterLua(L);
+
    int valuesOnStack = 0;
    int iRet = lua_resume(L, m_state.GetState(), vecParam.size(), &valuesOnStack);
 
@@ -1601,8 +1913,8 @@ std::pair<Thread::T_enThreadStatus, std::vector<Lua::Value>> Thread::InternalRes
    // always start at the first element.
    int iTopIndex = lua_gettop(L);
 
-   for (int i = 1; i <= iTopIndex; i++)
-      vecResults.push_back(Value::FromStack(m_threadState, i));
+   for (int i = -iTopIndex; i <= -1; i++)
+      vecResults.push_back(Value::FromStack(m_threadState, i, true));
 
    return retVal;
 }
@@ -1626,7 +1938,7 @@ int Thread::InternalYield(lua_State* L, int status, lua_KContext context)
    int iTopIndex = lua_gettop(L);
 
    for (int iStackIndex = 1; iStackIndex <= iTopIndex; iStackIndex++)
-      vecParams.push_back(Value::FromStack(paramState, iStackIndex));
+      vecParams.push_back(Value::FromStack(paramState, iStackIndex, false));
 
    std::vector<Lua::Value> vecResults;
    try
@@ -1636,7 +1948,7 @@ int Thread::InternalYield(lua_State* L, int status, lua_KContext context)
 
       // put results on stack
       std::for_each(vecResults.begin(), vecResults.end(),
-         [&](const Value& value) { value.Push(paramState); value.Detach(); });
+         [&](const Value& value) { value.Push(paramState); });
    }
    catch (const ::Exception& ex)
    {
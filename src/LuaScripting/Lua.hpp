@@ -8,13 +8,15 @@
 
 #include <functional>
 #include <memory>
+#include <string>
 #include <vector>
-#include <any>
+#include <type_traits>
 #include <ulib/Exception.hpp>
 
 // forward references
 struct lua_State;
 struct FuncData;
+class LuaProfiler;
 
 // WinBase.h defines Yield(), so undef again...
 #undef Yield
@@ -183,6 +185,9 @@ private:
 /// return values, e.g. in a C++ closure (see the T_fnCFunction type and where
 /// it is used. Some objects, such as Function and Table, are stored in their
 /// own classes, as there are more interactions possible with these types.
+/// Numbers, integers, booleans and short strings are stored inline, so that
+/// creating, copying and moving these values doesn't allocate memory; only
+/// the reference types keep a reference to the Lua stack.
 class Value
 {
 public:
@@ -218,6 +223,9 @@ public:
    /// ctor for ANSI string value
    explicit Value(LPCSTR pszText);
 
+   /// ctor for ANSI string value with given length; the text may contain zero bytes
+   Value(LPCSTR pszText, size_t uiLength);
+
    /// ctor; used to wrap Table object
    explicit Value(class Table table);
 
@@ -248,38 +256,12 @@ public:
    /// returns type
    T_enType GetType() const { return m_enType; }
 
-   /// returns value
+   /// returns value; see the specializations below for allowed types
    template <typename T>
    T Get() const
    {
-      // list of allowed types; if this asserts, you're requesting the wrong type
-      static_assert(
-         std::is_same<T, bool>::value ||
-         std::is_same<T, double>::value ||
-         std::is_same<T, int>::value ||
-         std::is_same<T, CString>::value ||
-         std::is_same<T, LPCTSTR>::value ||
-         std::is_same<T, Function>::value ||
-         std::is_same<T, Table>::value ||
-         std::is_same<T, Userdata>::value ||
-         std::is_same<T, Thread>::value,
-         "not an allowed type for Get<T>()");
-
-      return std::any_cast<T>(m_value);
-   }
-
-   /// returns value; specialisation for int
-   template <>
-   int Get() const
-   {
-      return static_cast<int>(std::any_cast<double>(m_value));
-   }
-
-   /// returns string value
-   template <>
-   CString Get() const
-   {
-      return CString(std::any_cast<CStringA>(m_value));
+      // if this asserts, you're requesting the wrong type
+      static_assert(!std::is_same<T, T>::value, "not an allowed type for Get<T>()");
    }
 
    /// returns ref object
@@ -292,29 +274,82 @@ private:
    friend State;
    friend Thread;
 
-   /// attaches value to state, using reference
-   void Attach(std::shared_ptr<Ref> spRef) const;
+   /// maximum length of strings that are stored inline, without allocating memory
+   static constexpr size_t c_uiMaxSmallStringLength = 23;
+
+   /// initializes string value
+   void InitString(LPCSTR pszText, size_t uiLength);
+
+   /// copies value from other value; the value must be uninitialized
+   void CopyFrom(const Value& val);
+
+   /// destroys the stored value
+   void Destroy() noexcept;
+
+   /// returns if string value is stored inline
+   bool IsSmallString() const { return m_uiStringLength <= c_uiMaxSmallStringLength; }
+
+   /// returns string value as ANSI string
+   LPCSTR GetStringA() const;
 
    /// pushes value to stack
    void Push(State& state) const;
 
-   /// detaches the object from stack
-   void Detach() const;
-
-   /// constructs Value object from value at stack index
-   static Value FromStack(State& state, int iStackIndex);
+   /// \brief constructs Value object from value at stack index
+   /// \details Table, function, userdata and thread values are referenced and
+   /// stay on the stack until the last Value referencing them is destroyed.
+   /// All other values are copied into the Value object; when
+   /// bRemoveCopiedValue is set, they are also removed from the stack.
+   static Value FromStack(State& state, int iStackIndex, bool bRemoveCopiedValue);
 
 private:
-   /// value
-   std::any m_value;
+   /// value; the active member is determined by m_enType
+   union
+   {
+      bool m_bValue;                ///< boolean value
+      double m_dValue;              ///< number value
+      int m_iValue;                 ///< integer value
+      char m_szSmallString[c_uiMaxSmallStringLength + 1]; ///< string value, when IsSmallString() is true
+      CStringA m_cszLargeString;    ///< string value, when IsSmallString() is false
+   };
 
    /// type
    T_enType m_enType;
 
-   /// state stack reference
-   mutable std::shared_ptr<Ref> m_spRef;
+   /// length of string value
+   size_t m_uiStringLength;
+
+   /// state stack reference; only used for table, function, userdata and thread values
+   std::shared_ptr<Ref> m_spRef;
 };
 
+/// returns boolean value
+template <> bool Value::Get<bool>() const;
+
+/// returns number value; integer values are converted
+template <> double Value::Get<double>() const;
+
+/// returns integer value; number values are truncated
+template <> int Value::Get<int>() const;
+
+/// returns string value
+template <> CString Value::Get<CString>() const;
+
+/// returns string value as ANSI string; binary safe, including zero bytes
+template <> std::string Value::Get<std::string>() const;
+
+/// returns function value
+template <> Function Value::Get<Function>() const;
+
+/// returns table value
+template <> Table Value::Get<Table>() const;
+
+/// returns userdata value
+template <> Userdata Value::Get<Userdata>() const;
+
+/// returns thread value
+template <> Thread Value::Get<Thread>() const;
+
 /// \brief C++ function that can be registered as closure
 /// \details When a function bound to this type is called, the input params are
 /// deserialized from the stack and put into the in parameter. When the function returns,
@@ -325,6 +360,10 @@ private:
 /// garbage collected, all bound variables (such as shared_from_this()) are destroyed.
 typedef std::function<std::vector<Value>(State& state, const std::vector<Value>&)> T_fnCFunction;
 
+/// \brief raw Lua C function, operating on the Lua stack directly
+/// \details This is used by the typed function bindings; see LuaBinding.hpp
+typedef int (*T_fnRawCFunction)(lua_State* L);
+
 /// \brief Lua function
 /// \details Allows calling a Lua function; this object mostly results from a Lua::Value
 /// object, e.g. when a value on a stack is a Lua function, and Lua::Value::FromStack() is
@@ -358,9 +397,6 @@ private:
    /// pushes function onto stack
    void Push();
 
-   /// detaches function from stack
-   void Detach() const;
-
 private:
    /// state stack reference
    mutable std::shared_ptr<Ref> m_spRef;
@@ -394,6 +430,10 @@ public:
    /// adds a function to the table
    Table& AddFunction(LPCSTR pszaName, T_fnCFunction fn);
 
+   /// adds a typed member function to the table; include LuaBinding.hpp to use
+   template <auto Method, typename Class>
+   Table& AddFunction(LPCSTR pszaName, std::shared_ptr<Class> spInstance);
+
    /// returns value from table
    Value GetValue(const CString& key);
 
@@ -424,8 +464,8 @@ private:
    /// pushes table onto stack
    void Push();
 
-   /// detaches table from stack
-   void Detach() const;
+   /// adds a raw C function to the table, with instance and table stored as upvalues
+   Table& AddRawFunction(LPCSTR pszaName, T_fnRawCFunction fn, std::shared_ptr<void> spInstance);
 
 private:
    /// table name
@@ -441,6 +481,9 @@ private:
 class Userdata
 {
 public:
+   /// shared, read-only memory block of userdata values
+   typedef std::shared_ptr<const std::vector<unsigned char>> T_spSharedBuffer;
+
    /// copy ctor
    Userdata(const Userdata& userdata);
 
@@ -463,6 +506,13 @@ public:
    /// returns ref object
    std::shared_ptr<Ref> GetRef() const { return m_spRef; }
 
+   /// returns shared memory block, or nullptr when the userdata owns its memory block
+   T_spSharedBuffer GetSharedBuffer() const { return m_spSharedBuffer; }
+
+   /// returns shared memory block of userdata at given stack index, or
+   /// nullptr when the value isn't a userdata with a shared memory block
+   static T_spSharedBuffer SharedBufferFromStack(lua_State* L, int iStackIndex);
+
 private:
    friend State;
    friend Value;
@@ -472,15 +522,18 @@ private:
    /// ctor; constructs new userdata object on stack, with given size in bytes
    explicit Userdata(State& state, size_t uiSize);
 
+   /// ctor; constructs new userdata object on stack, sharing the given memory block
+   explicit Userdata(State& state, T_spSharedBuffer spSharedBuffer);
+
    /// ctor; creates userdata object from value on stack
    explicit Userdata(std::shared_ptr<Ref> spRef);
 
+   /// called when a userdata with shared memory block is garbage collected
+   static int OnSharedBufferGarbageCollect(lua_State* L);
+
    /// pushes userdata onto stack
    void Push();
 
-   /// detaches userdata from stack
-   void Detach() const;
-
 private:
    /// raw memory block allocated by ctor
    void* m_pUserdata;
@@ -488,6 +541,9 @@ private:
    /// size of raw memory block
    unsigned long long m_uiSize;
 
+   /// shared memory block; only set for userdata created with a shared memory block
+   T_spSharedBuffer m_spSharedBuffer;
+
    /// state stack reference
    mutable std::shared_ptr<Ref> m_spRef;
 };
@@ -506,7 +562,7 @@ public:
    /// loads a built-in library into state
    void RequireLib(const char* moduleName);
 
-   /// loads Lua script code from file
+   /// loads Lua script code from file; uses the bytecode cache, if set
    void LoadFile(const CString& cszFilename);
 
    /// loads Lua script code from source code string
@@ -526,9 +582,18 @@ public:
    /// adds an unnamed userdata, with a memory block of given size
    Userdata AddUserdata(size_t uiSize);
 
+   /// \brief adds an unnamed userdata that shares the given memory block
+   /// \details The memory block isn't copied, so the same block can be passed
+   /// to several Lua states; it must not be modified through Userdata::Data().
+   Userdata AddUserdata(Userdata::T_spSharedBuffer spSharedBuffer);
+
    /// adds a global function to the state
    void AddFunction(LPCTSTR pszaName, T_fnCFunction fn);
 
+   /// adds a global typed member function to the state; include LuaBinding.hpp to use
+   template <auto Method, typename Class>
+   void AddFunction(LPCTSTR pszaName, std::shared_ptr<Class> spInstance);
+
    /// adds a global value to the state
    void AddValue(LPCTSTR pszaName, Value value);
 
@@ -560,6 +625,22 @@ public:
    /// returns the Lua version used
    static LPCTSTR GetVersion();
 
+   /// \brief sets folder to cache precompiled bytecode of files loaded with LoadFile()
+   /// \details The folder is used by all states, including states running on
+   /// worker threads, and can be changed from any thread; an empty folder name
+   /// disables the cache. See LuaBytecodeCache class.
+   static void SetBytecodeCacheFolder(const CString& cszCacheFolder);
+
+   /// \brief starts sampling profiler; see LuaProfiler class
+   /// \details Call this on the main state only, before running the script.
+   /// Profiling has overhead, so use a larger number of instructions per
+   /// sample for long running scripts.
+   void StartProfiler(unsigned int uiInstructionsPerSample = 1000);
+
+   /// stops sampling profiler and returns it, for writing results; returns
+   /// nullptr when the profiler wasn't started
+   std::shared_ptr<LuaProfiler> StopProfiler();
+
 private:
    friend Ref;
    friend Value;
@@ -575,6 +656,9 @@ private:
    /// no-op deleter, used for non-mainState states
    static void StateDeleterNoop(lua_State*);
 
+   /// adds a global raw C function, with instance stored as upvalue
+   void AddRawFunction(LPCTSTR pszaName, T_fnRawCFunction fn, std::shared_ptr<void> spInstance);
+
    /// calls Lua function with number of arguments and results
    void InternalCall(int iArguments, int iResults);
 
@@ -600,6 +684,10 @@ private:
    static void CleanupRef(std::shared_ptr<Ref>& spRef);
 
 private:
+   /// profiler, when started; declared before the Lua state, since hooks may
+   /// still be called while closing the state
+   std::shared_ptr<LuaProfiler> m_spProfiler;
+
    /// Lua state
    std::shared_ptr<lua_State> m_spState;
 
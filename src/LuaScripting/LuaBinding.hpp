@@ -0,0 +1,261 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file LuaBinding.hpp Typed Lua C++ function bindings
+//
+#pragma once
+
+#include "Lua.hpp"
+#include "LuaProfiler.hpp"
+#include <type_traits>
+#include <utility>
+
+extern "C"
+{
+#include <lua.h>
+#include <lauxlib.h>
+}
+
+struct lua_longjmp;
+
+/// \brief Typed Lua C++ function bindings
+/// \details The functions and classes in this namespace allow binding C++
+/// member functions to Lua functions, using Table::AddFunction<&Class::Method>()
+/// or State::AddFunction<&Class::Method>(). Number and types of the arguments
+/// and the return value are derived at compile time, and values are read from
+/// and written to the Lua stack directly. In contrast to functions bound using
+/// T_fnCFunction, no Lua::Value objects or vectors are created, so a call
+/// doesn't need any heap allocation, unless a parameter or return value type
+/// allocates by itself (e.g. CString).
+///
+/// The bound function may be called with or without a "self" argument, e.g.
+/// as Table:method(1, 2) or Table.method(1, 2); the first argument is only
+/// skipped when it is the table the function was added to. Surplus arguments
+/// are ignored. Supported types are bool, all integer types, float, double,
+/// const char*, CStringA and CString.
+namespace Lua::Binding
+{
+   /// reads and writes C++ values from and to the Lua stack
+   template <typename T, typename Enable = void>
+   struct StackValue;
+
+   /// stack value for bool
+   template <>
+   struct StackValue<bool>
+   {
+      /// reads value from stack
+      static bool Get(lua_State* L, int index) { return lua_toboolean(L, index) != 0; }
+
+      /// pushes value on stack
+      static void Push(lua_State* L, bool value) { lua_pushboolean(L, value ? 1 : 0); }
+   };
+
+   /// stack value for integer types
+   template <typename T>
+   struct StackValue<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>>
+   {
+      /// reads value from stack
+      static T Get(lua_State* L, int index) { return static_cast<T>(luaL_checkinteger(L, index)); }
+
+      /// pushes value on stack
+      static void Push(lua_State* L, T value) { lua_pushinteger(L, static_cast<lua_Integer>(value)); }
+   };
+
+   /// stack value for floating point types
+   template <typename T>
+   struct StackValue<T, std::enable_if_t<std::is_floating_point_v<T>>>
+   {
+      /// reads value from stack
+      static T Get(lua_State* L, int index) { return static_cast<T>(luaL_checknumber(L, index)); }
+
+      /// pushes value on stack
+      static void Push(lua_State* L, T value) { lua_pushnumber(L, static_cast<lua_Number>(value)); }
+   };
+
+   /// stack value for C strings; the pointer is only valid during the call
+   template <>
+   struct StackValue<const char*>
+   {
+      /// reads value from stack
+      static const char* Get(lua_State* L, int index) { return luaL_checkstring(L, index); }
+
+      /// pushes value on stack
+      static void Push(lua_State* L, const char* value) { lua_pushstring(L, value); }
+   };
+
+   /// stack value for ANSI strings
+   template <>
+   struct StackValue<CStringA>
+   {
+      /// reads value from stack
+      static CStringA Get(lua_State* L, int index)
+      {
+         size_t length = 0;
+         const char* text = luaL_checklstring(L, index, &length);
+         return CStringA(text, static_cast<int>(length));
+      }
+
+      /// pushes value on stack
+      static void Push(lua_State* L, const CStringA& value)
+      {
+         lua_pushlstring(L, value.GetString(), static_cast<size_t>(value.GetLength()));
+      }
+   };
+
+   /// stack value for strings
+   template <>
+   struct StackValue<CString>
+   {
+      /// reads value from stack
+      static CString Get(lua_State* L, int index) { return CString(luaL_checkstring(L, index)); }
+
+      /// pushes value on stack
+      static void Push(lua_State* L, const CString& value) { lua_pushstring(L, CStringA(value).GetString()); }
+   };
+
+   /// calls a member function with arguments from the stack
+   template <auto Method>
+   struct MethodInvoker;
+
+   /// method invoker for non-const member functions
+   template <typename Class, typename Ret, typename... Args, Ret(Class::*Method)(Args...)>
+   struct MethodInvoker<Method>
+   {
+      /// class type of member function
+      typedef Class ClassType;
+
+      /// number of arguments
+      static constexpr int NumArgs = static_cast<int>(sizeof...(Args));
+
+      /// calls method and returns number of values pushed on stack
+      static int Call(lua_State* L, Class& instance, int firstArgIndex)
+      {
+         return Invoke(L, instance, firstArgIndex, std::index_sequence_for<Args...>());
+      }
+
+   private:
+      /// calls method, with indices of all arguments
+      template <size_t... Index>
+      static int Invoke(lua_State* L, Class& instance, int firstArgIndex, std::index_sequence<Index...>)
+      {
+         if constexpr (std::is_void_v<Ret>)
+         {
+            (instance.*Method)(
+               StackValue<std::decay_t<Args>>::Get(L, firstArgIndex + static_cast<int>(Index))...);
+            return 0;
+         }
+         else
+         {
+            StackValue<std::decay_t<Ret>>::Push(L, (instance.*Method)(
+               StackValue<std::decay_t<Args>>::Get(L, firstArgIndex + static_cast<int>(Index))...));
+            return 1;
+         }
+      }
+   };
+
+   /// method invoker for const member functions
+   template <typename Class, typename Ret, typename... Args, Ret(Class::*Method)(Args...) const>
+   struct MethodInvoker<Method>
+   {
+      /// class type of member function
+      typedef Class ClassType;
+
+      /// number of arguments
+      static constexpr int NumArgs = static_cast<int>(sizeof...(Args));
+
+      /// calls method and returns number of values pushed on stack
+      static int Call(lua_State* L, const Class& instance, int firstArgIndex)
+      {
+         return Invoke(L, instance, firstArgIndex, std::index_sequence_for<Args...>());
+      }
+
+   private:
+      /// calls method, with indices of all arguments
+      template <size_t... Index>
+      static int Invoke(lua_State* L, const Class& instance, int firstArgIndex, std::index_sequence<Index...>)
+      {
+         if constexpr (std::is_void_v<Ret>)
+         {
+            (instance.*Method)(
+               StackValue<std::decay_t<Args>>::Get(L, firstArgIndex + static_cast<int>(Index))...);
+            return 0;
+         }
+         else
+         {
+            StackValue<std::decay_t<Ret>>::Push(L, (instance.*Method)(
+               StackValue<std::decay_t<Args>>::Get(L, firstArgIndex + static_cast<int>(Index))...));
+            return 1;
+         }
+      }
+   };
+
+   /// \brief Lua C function that calls the bound member function
+   /// \details The instance is stored as std::shared_ptr<void> in upvalue 1,
+   /// and the table the function was added to, or nil, in upvalue 2.
+   /// C++ exceptions are handled the same way as for T_fnCFunction bindings.
+   template <auto Method>
+   int OnTypedFunctionCall(lua_State* L)
+   {
+      typedef MethodInvoker<Method> Invoker;
+      typedef typename Invoker::ClassType ClassType;
+
+      auto pspInstance = reinterpret_cast<std::shared_ptr<void>*>(lua_touserdata(L, lua_upvalueindex(1)));
+      if (pspInstance == nullptr || *pspInstance == nullptr)
+         throw Lua::Exception(_T("typed function call without bound instance"), L, __FILE__, __LINE__);
+
+      ClassType& instance = *static_cast<ClassType*>(pspInstance->get());
+
+      // skip the "self" argument when called as Table:method()
+      int firstArgIndex = 1;
+      if (lua_istable(L, 1) && lua_rawequal(L, 1, lua_upvalueindex(2)))
+         firstArgIndex = 2;
+
+      LuaProfiler::CppCallScope profilerScope(L);
+
+      try
+      {
+         return Invoker::Call(L, instance, firstArgIndex);
+      }
+      catch (const ::Exception& ex)
+      {
+         lua_pushstring(L, CStringA(ex.Message()).GetString());
+         throw;
+      }
+      catch (const std::exception& ex)
+      {
+         lua_pushstring(L, ex.what());
+         throw;
+      }
+      catch (lua_longjmp*)
+      {
+         // lua_longjmp is used for error and yield implementation by Lua
+         throw;
+      }
+   }
+
+} // namespace Lua::Binding
+
+template <auto Method, typename Class>
+Lua::Table& Lua::Table::AddFunction(LPCSTR pszaName, std::shared_ptr<Class> spInstance)
+{
+   static_assert(std::is_base_of_v<typename Binding::MethodInvoker<Method>::ClassType, Class>,
+      "instance must be of the class type of the bound method");
+
+   // store as pointer to the method's class, so that the upvalue can be cast back
+   std::shared_ptr<typename Binding::MethodInvoker<Method>::ClassType> spClassInstance = spInstance;
+
+   return AddRawFunction(pszaName, &Binding::OnTypedFunctionCall<Method>, spClassInstance);
+}
+
+template <auto Method, typename Class>
+void Lua::State::AddFunction(LPCTSTR pszaName, std::shared_ptr<Class> spInstance)
+{
+   static_assert(std::is_base_of_v<typename Binding::MethodInvoker<Method>::ClassType, Class>,
+      "instance must be of the class type of the bound method");
+
+   // store as pointer to the method's class, so that the upvalue can be cast back
+   std::shared_ptr<typename Binding::MethodInvoker<Method>::ClassType> spClassInstance = spInstance;
+
+   AddRawFunction(pszaName, &Binding::OnTypedFunctionCall<Method>, spClassInstance);
+}
@@ -0,0 +1,179 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file LuaBytecodeCache.cpp Lua bytecode cache
+//
+
+// includes
+#include "stdafx.h"
+#include "LuaBytecodeCache.hpp"
+#include "Fnv1aHash.hpp"
+#include <ulib/Path.hpp>
+#include <algorithm>
+
+extern "C"
+{
+#include <lua.h>
+#include <lauxlib.h>
+}
+
+/// reads whole file into buffer; returns false when file can't be read
+static bool ReadAllBytes(const CString& cszFilename, std::vector<char>& vecData)
+{
+   FILE* fd = nullptr;
+   errno_t ret = _tfopen_s(&fd, cszFilename, _T("rb"));
+   if (ret != 0 || fd == nullptr)
+      return false;
+
+   std::shared_ptr<FILE> file{ fd, &fclose };
+
+   vecData.clear();
+
+   char buffer[4096];
+   size_t uiRead = 0;
+   while ((uiRead = fread(buffer, 1, sizeof(buffer), file.get())) > 0)
+      vecData.insert(vecData.end(), buffer, buffer + uiRead);
+
+   return ferror(file.get()) == 0;
+}
+
+LuaBytecodeCache::LuaBytecodeCache(const CString& cszCacheFolder)
+   :m_cszCacheFolder(cszCacheFolder)
+{
+   if (!Path::FolderExists(m_cszCacheFolder))
+      Path::CreateDirectoryRecursive(m_cszCacheFolder);
+}
+
+int LuaBytecodeCache::LoadFile(lua_State* L, const CString& cszFilename)
+{
+   CStringA cszaFilename(cszFilename);
+
+   std::vector<char> vecSource;
+   if (!ReadSourceFile(cszFilename, vecSource))
+      return luaL_loadfile(L, cszaFilename.GetString()); // reports the error
+
+   // same chunk name as luaL_loadfile() uses
+   CStringA cszaChunkName = "@" + cszaFilename;
+
+   // precompiled files don't need to be cached
+   if (!vecSource.empty() && vecSource[0] == LUA_SIGNATURE[0])
+      return luaL_loadbufferx(L, vecSource.data(), vecSource.size(), cszaChunkName.GetString(), "b");
+
+   CString cszCacheFilename = CacheFilename(cszaChunkName, vecSource);
+
+   if (LoadCachedBytecode(L, cszCacheFilename, cszaChunkName))
+      return LUA_OK;
+
+   int iRet = luaL_loadbufferx(L, vecSource.data(), vecSource.size(), cszaChunkName.GetString(), "t");
+   if (iRet == LUA_OK)
+      StoreBytecode(L, cszCacheFilename);
+
+   return iRet;
+}
+
+/// \details The first line is replaced by an empty line, in order to keep
+/// line numbers in error messages the same.
+bool LuaBytecodeCache::ReadSourceFile(const CString& cszFilename, std::vector<char>& vecSource)
+{
+   if (!ReadAllBytes(cszFilename, vecSource))
+      return false;
+
+   if (vecSource.size() >= 3 &&
+      vecSource[0] == '\xEF' && vecSource[1] == '\xBB' && vecSource[2] == '\xBF')
+   {
+      vecSource.erase(vecSource.begin(), vecSource.begin() + 3);
+   }
+
+   if (!vecSource.empty() && vecSource[0] == '#')
+   {
+      auto iterLineEnd = std::find(vecSource.begin(), vecSource.end(), '\n');
+      vecSource.erase(vecSource.begin(), iterLineEnd);
+   }
+
+   return true;
+}
+
+CString LuaBytecodeCache::CacheFilename(const CStringA& cszaChunkName, const std::vector<char>& vecSource) const
+{
+   Fnv1aHash hash;
+   hash.Add(cszaChunkName.GetString(), cszaChunkName.GetLength() + 1);
+   hash.Add(vecSource.data(), vecSource.size());
+
+   CString cszFilename;
+   cszFilename.Format(_T("%016I64x-lua%u-x%u.luac"),
+      hash.Value(),
+      static_cast<unsigned int>(LUA_VERSION_RELEASE_NUM),
+      static_cast<unsigned int>(sizeof(void*) * 8));
+
+   return Path::Combine(m_cszCacheFolder, cszFilename);
+}
+
+bool LuaBytecodeCache::LoadCachedBytecode(lua_State* L, const CString& cszCacheFilename, const CStringA& cszaChunkName)
+{
+   if (!Path::FileExists(cszCacheFilename))
+      return false;
+
+   std::vector<char> vecBytecode;
+   if (!ReadAllBytes(cszCacheFilename, vecBytecode))
+      return false;
+
+   int iRet = luaL_loadbufferx(L, vecBytecode.data(), vecBytecode.size(), cszaChunkName.GetString(), "b");
+   if (iRet != LUA_OK)
+   {
+      ATLTRACE(_T("invalid cached Lua bytecode, removing: %s (%hs)\n"),
+         cszCacheFilename.GetString(),
+         lua_tostring(L, -1));
+
+      lua_pop(L, 1);
+
+      DeleteFile(cszCacheFilename);
+
+      return false;
+   }
+
+   return true;
+}
+
+/// \details The bytecode isn't stripped, so that error messages still contain
+/// line numbers. The file is first written to a temporary file and then
+/// renamed, so that concurrently starting processes never read a partially
+/// written file. Errors while writing are ignored, since the cache is
+/// optional.
+void LuaBytecodeCache::StoreBytecode(lua_State* L, const CString& cszCacheFilename)
+{
+   std::vector<char> vecBytecode;
+   if (lua_dump(L, &LuaBytecodeCache::DumpWriter, &vecBytecode, 0) != 0 ||
+      vecBytecode.empty())
+      return;
+
+   CString cszTempFilename;
+   cszTempFilename.Format(_T("%s.%lu.tmp"), cszCacheFilename.GetString(), GetCurrentProcessId());
+
+   FILE* fd = nullptr;
+   errno_t ret = _tfopen_s(&fd, cszTempFilename, _T("wb"));
+   if (ret != 0 || fd == nullptr)
+   {
+      ATLTRACE(_T("couldn't write Lua bytecode cache file: %s\n"), cszTempFilename.GetString());
+      return;
+   }
+
+   size_t uiWritten = fwrite(vecBytecode.data(), 1, vecBytecode.size(), fd);
+   bool bError = fclose(fd) != 0 || uiWritten != vecBytecode.size();
+
+   if (bError ||
+      !MoveFileEx(cszTempFilename, cszCacheFilename, MOVEFILE_REPLACE_EXISTING))
+   {
+      DeleteFile(cszTempFilename);
+   }
+}
+
+int LuaBytecodeCache::DumpWriter(lua_State* /*L*/, const void* p, size_t uiSize, void* pUserData)
+{
+   std::vector<char>& vecBytecode = *reinterpret_cast<std::vector<char>*>(pUserData);
+
+   const char* pData = reinterpret_cast<const char*>(p);
+   vecBytecode.insert(vecBytecode.end(), pData, pData + uiSize);
+
+   return 0;
+}
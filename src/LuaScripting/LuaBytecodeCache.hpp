@@ -0,0 +1,52 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file LuaBytecodeCache.hpp Lua bytecode cache
+//
+#pragma once
+
+// includes
+#include <vector>
+
+// forward references
+struct lua_State;
+
+/// \brief Cache for precompiled Lua bytecode
+/// \details Stores the bytecode of Lua script files, as written by lua_dump(),
+/// in a cache folder. The cache files are keyed by a hash of chunk name and
+/// file content, the Lua version and the pointer size, so a changed script or
+/// a different Lua version never uses stale bytecode. When a cache file can't
+/// be loaded, the script is compiled from source again and the cache file is
+/// replaced.
+class LuaBytecodeCache
+{
+public:
+   /// ctor; the cache folder is created when it doesn't exist yet
+   explicit LuaBytecodeCache(const CString& cszCacheFolder);
+
+   /// \brief loads Lua script file, using cached bytecode when available
+   /// \details Works like luaL_loadfile(): returns the Lua status code and
+   /// leaves either the compiled chunk or an error message on the stack.
+   int LoadFile(lua_State* L, const CString& cszFilename);
+
+private:
+   /// reads Lua source file; skips UTF-8 BOM and first line comment, like luaL_loadfile()
+   static bool ReadSourceFile(const CString& cszFilename, std::vector<char>& vecSource);
+
+   /// returns cache filename for given chunk name and source
+   CString CacheFilename(const CStringA& cszaChunkName, const std::vector<char>& vecSource) const;
+
+   /// tries to load cached bytecode; returns false when not cached or invalid
+   static bool LoadCachedBytecode(lua_State* L, const CString& cszCacheFilename, const CStringA& cszaChunkName);
+
+   /// writes bytecode of compiled chunk on top of stack to cache file
+   static void StoreBytecode(lua_State* L, const CString& cszCacheFilename);
+
+   /// writer function for lua_dump()
+   static int DumpWriter(lua_State* L, const void* p, size_t uiSize, void* pUserData);
+
+private:
+   /// folder to store bytecode files
+   CString m_cszCacheFolder;
+};
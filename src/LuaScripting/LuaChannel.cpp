@@ -0,0 +1,376 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file LuaChannel.cpp Lua message-passing channel
+//
+
+// includes
+#include "stdafx.h"
+#include "LuaChannel.hpp"
+#include <thread>
+#include <climits>
+
+extern "C"
+{
+#include <lua.h>
+}
+
+/// maximum nesting depth of tables sent over a channel; also guards against cyclic tables
+const unsigned int c_uiMaxTableDepth = 16;
+
+LuaChannel::LuaChannel(size_t uiCapacity)
+:m_uiMask(0),
+m_uiEnqueuePos(0),
+m_uiDequeuePos(0),
+m_semAvailable(0)
+{
+   size_t uiRoundedCapacity = 2;
+   while (uiRoundedCapacity < uiCapacity)
+      uiRoundedCapacity <<= 1;
+
+   m_upCells.reset(new Cell[uiRoundedCapacity]);
+   m_uiMask = uiRoundedCapacity - 1;
+
+   for (size_t ui = 0; ui < uiRoundedCapacity; ui++)
+      m_upCells[ui].m_uiSequence.store(ui, std::memory_order_relaxed);
+}
+
+CString LuaChannel::GetName() const
+{
+   CString cszChannelName;
+   cszChannelName.Format(_T("channel-%08p"), this);
+
+   return cszChannelName;
+}
+
+/// \details The ring buffer uses a sequence number per cell: a producer may
+/// write a cell when its sequence number equals the enqueue position, and
+/// publishes the value by setting the sequence to position + 1, which in turn
+/// allows a consumer at that position to read the cell. No locks are taken,
+/// so sending never blocks, even when called from several Lua states at once.
+bool LuaChannel::TrySend(SerializedValue&& value)
+{
+   Cell* pCell = nullptr;
+   size_t uiPos = m_uiEnqueuePos.load(std::memory_order_relaxed);
+
+   for (;;)
+   {
+      pCell = &m_upCells[uiPos & m_uiMask];
+      size_t uiSequence = pCell->m_uiSequence.load(std::memory_order_acquire);
+      intptr_t iDiff = static_cast<intptr_t>(uiSequence) - static_cast<intptr_t>(uiPos);
+
+      if (iDiff == 0)
+      {
+         if (m_uiEnqueuePos.compare_exchange_weak(uiPos, uiPos + 1, std::memory_order_relaxed))
+            break;
+      }
+      else if (iDiff < 0)
+         return false; // channel is full
+      else
+         uiPos = m_uiEnqueuePos.load(std::memory_order_relaxed);
+   }
+
+   pCell->m_value = std::move(value);
+   pCell->m_uiSequence.store(uiPos + 1, std::memory_order_release);
+
+   m_semAvailable.release();
+
+   if (m_fnOnSend != nullptr)
+      m_fnOnSend();
+
+   return true;
+}
+
+bool LuaChannel::TryReceive(SerializedValue& value)
+{
+   return Receive(value, 0);
+}
+
+/// \details The semaphore counts published values, so a successful acquire
+/// guarantees that a value can be dequeued. When several producers publish
+/// out of order, the cell at the dequeue position may not be published yet,
+/// so dequeueing is retried until the producer has finished writing.
+bool LuaChannel::Receive(SerializedValue& value, DWORD dwTimeoutInMs)
+{
+   if (dwTimeoutInMs == INFINITE)
+      m_semAvailable.acquire();
+   else if (!m_semAvailable.try_acquire_for(std::chrono::milliseconds(dwTimeoutInMs)))
+      return false;
+
+   while (!Dequeue(value))
+      std::this_thread::yield();
+
+   return true;
+}
+
+bool LuaChannel::Dequeue(SerializedValue& value)
+{
+   Cell* pCell = nullptr;
+   size_t uiPos = m_uiDequeuePos.load(std::memory_order_relaxed);
+
+   for (;;)
+   {
+      pCell = &m_upCells[uiPos & m_uiMask];
+      size_t uiSequence = pCell->m_uiSequence.load(std::memory_order_acquire);
+      intptr_t iDiff = static_cast<intptr_t>(uiSequence) - static_cast<intptr_t>(uiPos + 1);
+
+      if (iDiff == 0)
+      {
+         if (m_uiDequeuePos.compare_exchange_weak(uiPos, uiPos + 1, std::memory_order_relaxed))
+            break;
+      }
+      else if (iDiff < 0)
+         return false; // cell not published yet
+      else
+         uiPos = m_uiDequeuePos.load(std::memory_order_relaxed);
+   }
+
+   value = std::move(pCell->m_value);
+   pCell->m_value = SerializedValue();
+   pCell->m_uiSequence.store(uiPos + m_uiMask + 1, std::memory_order_release);
+
+   return true;
+}
+
+void LuaChannel::InitBindings(Lua::Table& channel)
+{
+   channel.AddValue(_T("__name"), Lua::Value(GetName()));
+
+   channel.AddFunction("send",
+      std::bind(&LuaChannel::Send, shared_from_this(),
+         std::placeholders::_1, std::placeholders::_2));
+
+   channel.AddFunction("tryReceive",
+      std::bind(&LuaChannel::TryReceiveValue, shared_from_this(),
+         std::placeholders::_1, std::placeholders::_2));
+}
+
+/// \param[in] state the Lua state for parameters to this function
+/// \param[in] vecParams Lua params; [0] is the channel table, and [1] is the
+/// value to send.
+std::vector<Lua::Value> LuaChannel::Send(Lua::State& state, const std::vector<Lua::Value>& vecParams)
+{
+   if (vecParams.size() != 2)
+      throw Lua::Exception(_T("invalid number of parameters to Channel:send()"), state.GetState(), __FILE__, __LINE__);
+
+   if (vecParams[0].GetType() != Lua::Value::typeTable)
+      throw Lua::Exception(_T("first parameter must be the Channel table"), state.GetState(), __FILE__, __LINE__);
+
+   if (vecParams[1].GetType() == Lua::Value::typeNil)
+      throw Lua::Exception(_T("can't send nil value over channel"), state.GetState(), __FILE__, __LINE__);
+
+   // the value is serialized from the stack, since Lua::Value doesn't tell
+   // integers from other numbers; parameters start at stack index 1
+   SerializedValue value;
+   SerializeStackValue(state.GetState(), 2, 0, value);
+
+   bool bSent = TrySend(std::move(value));
+
+   std::vector<Lua::Value> vecRetValues;
+   vecRetValues.push_back(Lua::Value(bSent));
+
+   return vecRetValues;
+}
+
+std::vector<Lua::Value> LuaChannel::TryReceiveValue(Lua::State& state, const std::vector<Lua::Value>& vecParams)
+{
+   if (vecParams.size() != 1)
+      throw Lua::Exception(_T("invalid number of parameters to Channel:tryReceive()"), state.GetState(), __FILE__, __LINE__);
+
+   if (vecParams[0].GetType() != Lua::Value::typeTable)
+      throw Lua::Exception(_T("first parameter must be the Channel table"), state.GetState(), __FILE__, __LINE__);
+
+   std::vector<Lua::Value> vecRetValues;
+
+   SerializedValue value;
+   if (TryReceive(value))
+      vecRetValues.push_back(Deserialize(state, value));
+   else
+      vecRetValues.push_back(Lua::Value());
+
+   return vecRetValues;
+}
+
+LuaChannel::SerializedValue LuaChannel::Serialize(Lua::State& state, const Lua::Value& value)
+{
+   SerializedValue serializedValue;
+
+   switch (value.GetType())
+   {
+   case Lua::Value::typeNil:
+      break;
+
+   case Lua::Value::typeBoolean:
+      serializedValue.m_enType = Lua::Value::typeBoolean;
+      serializedValue.m_bValue = value.Get<bool>();
+      break;
+
+   case Lua::Value::typeNumber:
+      serializedValue.m_enType = Lua::Value::typeNumber;
+      serializedValue.m_dValue = value.Get<double>();
+      break;
+
+   case Lua::Value::typeInteger:
+      serializedValue.m_enType = Lua::Value::typeInteger;
+      serializedValue.m_iValue = value.Get<int>();
+      break;
+
+   case Lua::Value::typeString:
+      serializedValue.m_enType = Lua::Value::typeString;
+      serializedValue.m_strValue = value.Get<std::string>();
+      break;
+
+   case Lua::Value::typeTable:
+   case Lua::Value::typeUserdata:
+      ATLASSERT(value.GetRef() != nullptr);
+      SerializeStackValue(state.GetState(), value.GetRef()->GetStackIndex(), 0, serializedValue);
+      break;
+
+   default:
+      throw Lua::Exception(_T("can't send function or thread values over channel"), state.GetState(), __FILE__, __LINE__);
+   }
+
+   return serializedValue;
+}
+
+void LuaChannel::SerializeStackValue(lua_State* L, int iStackIndex, unsigned int uiDepth, SerializedValue& value)
+{
+   switch (lua_type(L, iStackIndex))
+   {
+   case LUA_TNIL:
+      value.m_enType = Lua::Value::typeNil;
+      break;
+
+   case LUA_TBOOLEAN:
+      value.m_enType = Lua::Value::typeBoolean;
+      value.m_bValue = lua_toboolean(L, iStackIndex) != 0;
+      break;
+
+   case LUA_TNUMBER:
+      if (lua_isinteger(L, iStackIndex) &&
+         lua_tointeger(L, iStackIndex) >= INT_MIN &&
+         lua_tointeger(L, iStackIndex) <= INT_MAX)
+      {
+         value.m_enType = Lua::Value::typeInteger;
+         value.m_iValue = static_cast<int>(lua_tointeger(L, iStackIndex));
+      }
+      else
+      {
+         value.m_enType = Lua::Value::typeNumber;
+         value.m_dValue = lua_tonumber(L, iStackIndex);
+      }
+      break;
+
+   case LUA_TSTRING:
+      {
+         size_t uiLength = 0;
+         const char* pszaText = lua_tolstring(L, iStackIndex, &uiLength);
+
+         value.m_enType = Lua::Value::typeString;
+         value.m_strValue.assign(pszaText, uiLength);
+      }
+      break;
+
+   case LUA_TUSERDATA:
+      value.m_enType = Lua::Value::typeUserdata;
+      value.m_spBuffer = Lua::Userdata::SharedBufferFromStack(L, iStackIndex);
+
+      if (value.m_spBuffer == nullptr)
+      {
+         const unsigned char* pData = reinterpret_cast<const unsigned char*>(lua_touserdata(L, iStackIndex));
+         size_t uiSize = lua_rawlen(L, iStackIndex);
+
+         value.m_spBuffer = std::make_shared<std::vector<unsigned char>>(pData, pData + uiSize);
+      }
+      break;
+
+   case LUA_TTABLE:
+      {
+         if (uiDepth >= c_uiMaxTableDepth)
+            throw Lua::Exception(_T("table sent over channel is nested too deep, or is cyclic"), L, __FILE__, __LINE__);
+
+         value.m_enType = Lua::Value::typeTable;
+
+         int iTableIndex = lua_absindex(L, iStackIndex);
+
+         lua_pushnil(L);
+         while (lua_next(L, iTableIndex) != 0)
+         {
+            // key is at -2, value at -1
+            int iKeyType = lua_type(L, -2);
+            if (iKeyType != LUA_TSTRING &&
+               (iKeyType != LUA_TNUMBER || !lua_isinteger(L, -2)))
+            {
+               lua_pop(L, 2);
+               throw Lua::Exception(_T("only string and integer keys can be sent over channel"), L, __FILE__, __LINE__);
+            }
+
+            value.m_vecTableKeys.push_back(SerializedValue());
+            value.m_vecTableValues.push_back(SerializedValue());
+
+            try
+            {
+               SerializeStackValue(L, -2, uiDepth + 1, value.m_vecTableKeys.back());
+               SerializeStackValue(L, -1, uiDepth + 1, value.m_vecTableValues.back());
+            }
+            catch (...)
+            {
+               lua_pop(L, 2);
+               throw;
+            }
+
+            lua_pop(L, 1); // keeps key for next iteration
+         }
+      }
+      break;
+
+   default:
+      throw Lua::Exception(_T("can't send function, thread or light userdata values over channel"), L, __FILE__, __LINE__);
+   }
+}
+
+Lua::Value LuaChannel::Deserialize(Lua::State& state, const SerializedValue& value)
+{
+   switch (value.m_enType)
+   {
+   case Lua::Value::typeBoolean:
+      return Lua::Value(value.m_bValue);
+
+   case Lua::Value::typeNumber:
+      return Lua::Value(value.m_dValue);
+
+   case Lua::Value::typeInteger:
+      return Lua::Value(value.m_iValue);
+
+   case Lua::Value::typeString:
+      return Lua::Value(value.m_strValue.data(), value.m_strValue.size());
+
+   case Lua::Value::typeUserdata:
+      ATLASSERT(value.m_spBuffer != nullptr);
+      return Lua::Value(state.AddUserdata(value.m_spBuffer));
+
+   case Lua::Value::typeTable:
+      {
+         Lua::Table table = state.AddTable(_T(""));
+
+         for (size_t ui = 0, uiMax = value.m_vecTableKeys.size(); ui < uiMax; ui++)
+         {
+            const SerializedValue& key = value.m_vecTableKeys[ui];
+            Lua::Value tableValue = Deserialize(state, value.m_vecTableValues[ui]);
+
+            if (key.m_enType == Lua::Value::typeString)
+               table.AddValue(CString(key.m_strValue.data(), static_cast<int>(key.m_strValue.size())), tableValue);
+            else if (key.m_enType == Lua::Value::typeInteger)
+               table.AddValue(key.m_iValue, tableValue);
+            else
+               table.AddValue(static_cast<int>(key.m_dValue), tableValue);
+         }
+
+         return Lua::Value(table);
+      }
+
+   default:
+      return Lua::Value();
+   }
+}
@@ -0,0 +1,134 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file LuaChannel.hpp Lua message-passing channel
+//
+#pragma once
+
+// includes
+#include "Lua.hpp"
+#include <atomic>
+#include <functional>
+#include <semaphore>
+#include <string>
+
+/// \brief Bounded channel to pass values between Lua states
+/// \details A channel is a bounded, lock-free multi-producer multi-consumer
+/// queue. Each Lua state that uses the channel has its own table with bound
+/// functions (see InitBindings()), but all tables refer to the same
+/// LuaChannel object. Values are serialized when sent, so that the sending
+/// and the receiving state never share any Lua objects. Supported are nil,
+/// booleans, numbers, strings (including zero bytes), tables with string or
+/// integer keys, and userdata memory blocks, e.g. viewfinder frames. Userdata
+/// with a shared memory block (see Lua::State::AddUserdata()) is passed on
+/// without copying; the memory block of other userdata values is copied once
+/// when sending. Received userdata values always share the memory block.
+class LuaChannel : public std::enable_shared_from_this<LuaChannel>
+{
+public:
+   /// serialized Lua value
+   struct SerializedValue
+   {
+      /// value type
+      Lua::Value::T_enType m_enType = Lua::Value::typeNil;
+
+      /// boolean value
+      bool m_bValue = false;
+
+      /// number value
+      double m_dValue = 0.0;
+
+      /// integer value; integers that don't fit into an int are sent as number
+      int m_iValue = 0;
+
+      /// string value
+      std::string m_strValue;
+
+      /// table keys; same number of entries as m_vecTableValues
+      std::vector<SerializedValue> m_vecTableKeys;
+
+      /// table values
+      std::vector<SerializedValue> m_vecTableValues;
+
+      /// shared memory block of userdata values
+      std::shared_ptr<const std::vector<unsigned char>> m_spBuffer;
+   };
+
+   /// ctor; creates channel that can hold given number of values; the
+   /// capacity is rounded up to the next power of two
+   explicit LuaChannel(size_t uiCapacity);
+
+   /// returns capacity of channel
+   size_t Capacity() const { return m_uiMask + 1; }
+
+   /// returns channel name, used to identify the channel in Lua tables
+   CString GetName() const;
+
+   /// \brief sets handler that is called after a value was sent
+   /// \details The handler is called on the sending thread, so it must not
+   /// call into the receiving Lua state directly. Set the handler before the
+   /// channel is used by other threads.
+   void SetSendHandler(std::function<void()> fnOnSend) { m_fnOnSend = fnOnSend; }
+
+   /// tries to send value; returns false when the channel is full
+   bool TrySend(SerializedValue&& value);
+
+   /// tries to receive value; returns false when the channel is empty
+   bool TryReceive(SerializedValue& value);
+
+   /// receives value, waiting at most the given time; returns false on timeout
+   bool Receive(SerializedValue& value, DWORD dwTimeoutInMs);
+
+   /// inits send() and tryReceive() functions in given table; the receive()
+   /// function depends on how the Lua state waits, and is added by the caller
+   void InitBindings(Lua::Table& channel);
+
+   /// serializes value; throws Lua::Exception when the value can't be sent
+   static SerializedValue Serialize(Lua::State& state, const Lua::Value& value);
+
+   /// creates value in given state from serialized value
+   static Lua::Value Deserialize(Lua::State& state, const SerializedValue& value);
+
+private:
+   /// single slot of the ring buffer
+   struct Cell
+   {
+      /// sequence number; determines if the cell can be written or read
+      std::atomic<size_t> m_uiSequence;
+
+      /// stored value
+      SerializedValue m_value;
+   };
+
+   /// removes value from the ring buffer, without touching the semaphore
+   bool Dequeue(SerializedValue& value);
+
+   /// channel function send(value); returns false when channel is full
+   std::vector<Lua::Value> Send(Lua::State& state, const std::vector<Lua::Value>& vecParams);
+
+   /// channel function tryReceive(); returns nil when channel is empty
+   std::vector<Lua::Value> TryReceiveValue(Lua::State& state, const std::vector<Lua::Value>& vecParams);
+
+   /// serializes value at given stack index
+   static void SerializeStackValue(lua_State* L, int iStackIndex, unsigned int uiDepth, SerializedValue& value);
+
+private:
+   /// ring buffer cells
+   std::unique_ptr<Cell[]> m_upCells;
+
+   /// mask to map positions to cell indices
+   size_t m_uiMask;
+
+   /// position of next cell to write
+   alignas(64) std::atomic<size_t> m_uiEnqueuePos;
+
+   /// position of next cell to read
+   alignas(64) std::atomic<size_t> m_uiDequeuePos;
+
+   /// number of values that can be received; used for waiting in Receive()
+   std::counting_semaphore<> m_semAvailable;
+
+   /// handler called after a value was sent
+   std::function<void()> m_fnOnSend;
+};
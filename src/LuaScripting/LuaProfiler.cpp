@@ -0,0 +1,307 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file LuaProfiler.cpp Sampling profiler for Lua scripts
+//
+
+// includes
+#include "stdafx.h"
+#include "LuaProfiler.hpp"
+#include <algorithm>
+
+extern "C"
+{
+#include <lua.h>
+}
+
+std::atomic<unsigned int> LuaProfiler::s_uiNumActiveProfilers = 0;
+
+/// key for storing the profiler in the Lua registry; the address is used as key
+static const char s_cRegistryKey = 0;
+
+LuaProfiler::LuaProfiler(unsigned int uiInstructionsPerSample)
+:m_uiInstructionsPerSample(uiInstructionsPerSample),
+m_llLastSampleTicks(Now()),
+m_llCppStartTicks(0),
+m_llSampledDuringCppTicks(0),
+m_uiCppCallDepth(0),
+m_llTotalLuaTicks(0),
+m_llTotalCppTicks(0)
+{
+}
+
+LuaProfiler::~LuaProfiler()
+{
+}
+
+void LuaProfiler::Attach(lua_State* L)
+{
+   lua_pushlightuserdata(L, this);
+   lua_rawsetp(L, LUA_REGISTRYINDEX, &s_cRegistryKey);
+
+   lua_sethook(L, &LuaProfiler::OnHook, LUA_MASKCOUNT, static_cast<int>(m_uiInstructionsPerSample));
+
+   m_llLastSampleTicks = Now();
+
+   s_uiNumActiveProfilers++;
+}
+
+/// \details The hook stays set on threads other than the main thread, but
+/// does nothing there, since the profiler can't be found anymore.
+void LuaProfiler::Detach(lua_State* L)
+{
+   lua_sethook(L, nullptr, 0, 0);
+
+   lua_pushnil(L);
+   lua_rawsetp(L, LUA_REGISTRYINDEX, &s_cRegistryKey);
+
+   s_uiNumActiveProfilers--;
+}
+
+void LuaProfiler::OnEnterLua(lua_State* L)
+{
+   if (s_uiNumActiveProfilers.load(std::memory_order_relaxed) == 0)
+      return;
+
+   LuaProfiler* pProfiler = FromState(L);
+   if (pProfiler == nullptr)
+      return;
+
+   if (lua_gethook(L) != &LuaProfiler::OnHook)
+      lua_sethook(L, &LuaProfiler::OnHook, LUA_MASKCOUNT, static_cast<int>(pProfiler->m_uiInstructionsPerSample));
+
+   if (pProfiler->m_uiCppCallDepth == 0)
+      pProfiler->m_llLastSampleTicks = Now();
+}
+
+LuaProfiler::CppCallScope::CppCallScope(lua_State* L)
+:m_L(L),
+m_pProfiler(nullptr)
+{
+   if (s_uiNumActiveProfilers.load(std::memory_order_relaxed) == 0)
+      return;
+
+   m_pProfiler = FromState(L);
+   if (m_pProfiler != nullptr)
+      m_pProfiler->OnEnterCpp(L);
+}
+
+LuaProfiler::CppCallScope::~CppCallScope()
+{
+   if (m_pProfiler != nullptr)
+      m_pProfiler->OnLeaveCpp(m_L);
+}
+
+LuaProfiler* LuaProfiler::FromState(lua_State* L)
+{
+   lua_rawgetp(L, LUA_REGISTRYINDEX, &s_cRegistryKey);
+   LuaProfiler* pProfiler = reinterpret_cast<LuaProfiler*>(lua_touserdata(L, -1));
+   lua_pop(L, 1);
+
+   return pProfiler;
+}
+
+void LuaProfiler::OnHook(lua_State* L, lua_Debug* /*ar*/)
+{
+   LuaProfiler* pProfiler = FromState(L);
+   if (pProfiler != nullptr)
+      pProfiler->TakeSample(L, 0);
+}
+
+long long LuaProfiler::Now()
+{
+   LARGE_INTEGER counter;
+   QueryPerformanceCounter(&counter);
+
+   return counter.QuadPart;
+}
+
+double LuaProfiler::TicksToSeconds(long long llTicks)
+{
+   LARGE_INTEGER frequency;
+   QueryPerformanceFrequency(&frequency);
+
+   return double(llTicks) / double(frequency.QuadPart);
+}
+
+void LuaProfiler::TakeSample(lua_State* L, int iStartLevel)
+{
+   long long llNow = Now();
+   long long llTicks = llNow - m_llLastSampleTicks;
+   m_llLastSampleTicks = llNow;
+
+   if (llTicks <= 0)
+      return;
+
+   if (m_uiCppCallDepth > 0)
+      m_llSampledDuringCppTicks += llTicks;
+
+   m_llTotalLuaTicks += llTicks;
+
+   Record(L, iStartLevel, llTicks, false);
+}
+
+/// \details When entering the outermost C++ call, the Lua time since the last
+/// sample is attributed to the calling Lua function, at stack level 1.
+void LuaProfiler::OnEnterCpp(lua_State* L)
+{
+   if (m_uiCppCallDepth++ > 0)
+      return;
+
+   TakeSample(L, 1);
+
+   m_llCppStartTicks = m_llLastSampleTicks;
+   m_llSampledDuringCppTicks = 0;
+}
+
+/// \details Time of nested C++ calls is part of the outermost call; Lua code
+/// that was called back from C++ and was already sampled is subtracted.
+void LuaProfiler::OnLeaveCpp(lua_State* L)
+{
+   ATLASSERT(m_uiCppCallDepth > 0);
+
+   if (--m_uiCppCallDepth > 0)
+      return;
+
+   long long llNow = Now();
+   long long llTicks = llNow - m_llCppStartTicks - m_llSampledDuringCppTicks;
+   m_llLastSampleTicks = llNow;
+
+   if (llTicks <= 0)
+      return;
+
+   m_llTotalCppTicks += llTicks;
+
+   Record(L, 0, llTicks, true);
+}
+
+void LuaProfiler::Record(lua_State* L, int iStartLevel, long long llTicks, bool bCppCall)
+{
+   std::vector<std::string> vecFrames;
+   std::string strFunction;
+   std::string strLine;
+
+   lua_Debug ar;
+   for (int iLevel = iStartLevel; lua_getstack(L, iLevel, &ar) != 0; iLevel++)
+   {
+      lua_getinfo(L, "Snl", &ar);
+
+      CStringA cszaFrame;
+      if (iLevel == iStartLevel && bCppCall)
+         cszaFrame.Format("[C++] %s", ar.name != nullptr ? ar.name : "?");
+      else if (*ar.what == 'C')
+         cszaFrame.Format("[C] %s", ar.name != nullptr ? ar.name : "?");
+      else if (*ar.what == 'm')
+         cszaFrame.Format("main chunk (%s)", ar.short_src);
+      else
+         cszaFrame.Format("%s (%s:%d)", ar.name != nullptr ? ar.name : "?", ar.short_src, ar.linedefined);
+
+      // semicolons separate frames in collapsed stacks
+      cszaFrame.Replace(';', ',');
+
+      if (iLevel == iStartLevel)
+         strFunction = cszaFrame.GetString();
+
+      if (strLine.empty() && ar.currentline > 0)
+      {
+         CStringA cszaLine;
+         cszaLine.Format("%s:%d", ar.short_src, ar.currentline);
+         strLine = cszaLine.GetString();
+      }
+
+      vecFrames.push_back(cszaFrame.GetString());
+   }
+
+   if (vecFrames.empty())
+      return;
+
+   std::string strStack;
+   for (auto iter = vecFrames.rbegin(); iter != vecFrames.rend(); ++iter)
+   {
+      if (!strStack.empty())
+         strStack += ';';
+
+      strStack += *iter;
+   }
+
+   m_mapCollapsedStacks[strStack] += llTicks;
+
+   Stats& functionStats = m_mapFunctionStats[strFunction];
+   functionStats.m_ullSamples++;
+   (bCppCall ? functionStats.m_llCppTicks : functionStats.m_llLuaTicks) += llTicks;
+
+   if (!strLine.empty())
+   {
+      Stats& lineStats = m_mapLineStats[strLine];
+      lineStats.m_ullSamples++;
+      (bCppCall ? lineStats.m_llCppTicks : lineStats.m_llLuaTicks) += llTicks;
+   }
+}
+
+void LuaProfiler::WriteCollapsedStacks(const CString& cszFilename) const
+{
+   FILE* fd = nullptr;
+   errno_t ret = _tfopen_s(&fd, cszFilename, _T("wt"));
+   if (ret != 0 || fd == nullptr)
+      throw ::Exception(_T("couldn't write Lua profiler output file: ") + cszFilename, __FILE__, __LINE__);
+
+   std::shared_ptr<FILE> file{ fd, &fclose };
+
+   for (const auto& iter : m_mapCollapsedStacks)
+   {
+      long long llMicroseconds = static_cast<long long>(TicksToSeconds(iter.second) * 1e6);
+      if (llMicroseconds > 0)
+         fprintf(file.get(), "%s %lld\n", iter.first.c_str(), llMicroseconds);
+   }
+}
+
+CString LuaProfiler::GetReport(size_t uiMaxEntries) const
+{
+   double dLuaTime = TotalLuaTime();
+   double dCppTime = TotalCppTime();
+   double dTotalTime = dLuaTime + dCppTime;
+
+   CString cszReport;
+   cszReport.Format(_T("Lua profile: total %.3f s, Lua code %.3f s (%.1f%%), C++ calls %.3f s (%.1f%%)\n"),
+      dTotalTime,
+      dLuaTime, dTotalTime > 0.0 ? dLuaTime * 100.0 / dTotalTime : 0.0,
+      dCppTime, dTotalTime > 0.0 ? dCppTime * 100.0 / dTotalTime : 0.0);
+
+   cszReport += FormatStats(_T("function"), m_mapFunctionStats, uiMaxEntries);
+   cszReport += FormatStats(_T("line"), m_mapLineStats, uiMaxEntries);
+
+   return cszReport;
+}
+
+CString LuaProfiler::FormatStats(LPCTSTR pszTitle, const std::map<std::string, Stats>& mapStats, size_t uiMaxEntries)
+{
+   std::vector<std::pair<std::string, Stats>> vecStats(mapStats.begin(), mapStats.end());
+
+   std::sort(vecStats.begin(), vecStats.end(),
+      [](const std::pair<std::string, Stats>& lhs, const std::pair<std::string, Stats>& rhs)
+   {
+      return lhs.second.m_llLuaTicks + lhs.second.m_llCppTicks >
+         rhs.second.m_llLuaTicks + rhs.second.m_llCppTicks;
+   });
+
+   CString cszText;
+   cszText.Format(_T("\n  total [s]    Lua [s]    C++ [s]  samples  %s\n"), pszTitle);
+
+   for (size_t ui = 0, uiMax = std::min(uiMaxEntries, vecStats.size()); ui < uiMax; ui++)
+   {
+      const Stats& stats = vecStats[ui].second;
+
+      CString cszLine;
+      cszLine.Format(_T("%11.3f %10.3f %10.3f %8I64u  %hs\n"),
+         TicksToSeconds(stats.m_llLuaTicks + stats.m_llCppTicks),
+         TicksToSeconds(stats.m_llLuaTicks),
+         TicksToSeconds(stats.m_llCppTicks),
+         stats.m_ullSamples,
+         vecStats[ui].first.c_str());
+
+      cszText += cszLine;
+   }
+
+   return cszText;
+}
@@ -0,0 +1,160 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file LuaProfiler.hpp Sampling profiler for Lua scripts
+//
+#pragma once
+
+// includes
+#include <atomic>
+#include <map>
+#include <string>
+
+// forward references
+struct lua_State;
+struct lua_Debug;
+
+/// \brief Sampling profiler for Lua scripts
+/// \details The profiler is started with Lua::State::StartProfiler(). It uses
+/// a Lua count hook that takes a sample of the Lua call stack every given
+/// number of instructions. Each sample is weighted with the time elapsed since
+/// the previous sample, so that the result is a time profile, not an
+/// instruction count profile. Time spent in bound C++ functions is measured
+/// separately, at the boundary of the function call (see CppCallScope). Time
+/// where no Lua code runs, e.g. while the main thread is yielded, isn't
+/// counted.
+///
+/// The results are available per function and per source line (see
+/// GetReport()), and as collapsed stacks that can be converted to a flame
+/// graph (see WriteCollapsedStacks()).
+class LuaProfiler
+{
+public:
+   /// ctor
+   explicit LuaProfiler(unsigned int uiInstructionsPerSample);
+
+   /// dtor
+   ~LuaProfiler();
+
+   /// attaches profiler to Lua state, by setting the hook
+   void Attach(lua_State* L);
+
+   /// detaches profiler from Lua state
+   void Detach(lua_State* L);
+
+   /// \brief writes collapsed stacks to file
+   /// \details Each line contains the stack frames, from outermost to
+   /// innermost, separated by semicolons, followed by the time spent in
+   /// microseconds. Use e.g. flamegraph.pl to generate a flame graph.
+   void WriteCollapsedStacks(const CString& cszFilename) const;
+
+   /// returns text report with the functions and lines that took the most time
+   CString GetReport(size_t uiMaxEntries = 20) const;
+
+   /// returns total time in seconds spent in Lua code
+   double TotalLuaTime() const { return TicksToSeconds(m_llTotalLuaTicks); }
+
+   /// returns total time in seconds spent in bound C++ functions
+   double TotalCppTime() const { return TicksToSeconds(m_llTotalCppTicks); }
+
+   /// \brief called when Lua code is entered from C++, e.g. in Lua::State::CallFunction()
+   /// \details Sets the hook on threads that were created before the profiler
+   /// was attached, and skips the time where no Lua code was running.
+   static void OnEnterLua(lua_State* L);
+
+   /// \brief scope of a call to a bound C++ function
+   /// \details Used by the function bindings; when no profiler is active, only
+   /// a single atomic counter is checked.
+   class CppCallScope
+   {
+   public:
+      /// ctor; starts measuring C++ call
+      explicit CppCallScope(lua_State* L);
+
+      /// dtor; stops measuring C++ call
+      ~CppCallScope();
+
+   private:
+      /// Lua state of the call
+      lua_State* m_L;
+
+      /// profiler; nullptr when the state isn't profiled
+      LuaProfiler* m_pProfiler;
+   };
+
+private:
+   /// time statistics of a function or source line
+   struct Stats
+   {
+      /// number of samples
+      unsigned long long m_ullSamples = 0;
+
+      /// time spent in Lua code, in ticks
+      long long m_llLuaTicks = 0;
+
+      /// time spent in bound C++ functions, in ticks
+      long long m_llCppTicks = 0;
+   };
+
+   /// returns profiler attached to Lua state, or nullptr
+   static LuaProfiler* FromState(lua_State* L);
+
+   /// hook function
+   static void OnHook(lua_State* L, lua_Debug* ar);
+
+   /// returns current time, in ticks
+   static long long Now();
+
+   /// converts ticks to seconds
+   static double TicksToSeconds(long long llTicks);
+
+   /// takes a sample of the Lua code that ran since the last sample
+   void TakeSample(lua_State* L, int iStartLevel);
+
+   /// called when entering bound C++ function
+   void OnEnterCpp(lua_State* L);
+
+   /// called when leaving bound C++ function
+   void OnLeaveCpp(lua_State* L);
+
+   /// records time for call stack, starting at given level
+   void Record(lua_State* L, int iStartLevel, long long llTicks, bool bCppCall);
+
+   /// formats a report table of the given statistics
+   static CString FormatStats(LPCTSTR pszTitle, const std::map<std::string, Stats>& mapStats, size_t uiMaxEntries);
+
+private:
+   /// number of instructions between samples
+   unsigned int m_uiInstructionsPerSample;
+
+   /// time of last sample, in ticks
+   long long m_llLastSampleTicks;
+
+   /// time when the outermost C++ call started, in ticks
+   long long m_llCppStartTicks;
+
+   /// time sampled as Lua code while in a C++ call, e.g. in callbacks, in ticks
+   long long m_llSampledDuringCppTicks;
+
+   /// nesting depth of C++ calls
+   unsigned int m_uiCppCallDepth;
+
+   /// total time in Lua code, in ticks
+   long long m_llTotalLuaTicks;
+
+   /// total time in C++ calls, in ticks
+   long long m_llTotalCppTicks;
+
+   /// time for each collapsed stack, in ticks
+   std::map<std::string, long long> m_mapCollapsedStacks;
+
+   /// statistics per function
+   std::map<std::string, Stats> m_mapFunctionStats;
+
+   /// statistics per source line
+   std::map<std::string, Stats> m_mapLineStats;
+
+   /// number of profilers currently attached to any Lua state
+   static std::atomic<unsigned int> s_uiNumActiveProfilers;
+};
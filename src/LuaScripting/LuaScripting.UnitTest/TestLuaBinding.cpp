@@ -0,0 +1,214 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file TestLuaBinding.cpp Tests for typed Lua function bindings
+//
+
+// includes
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "Lua.hpp"
+#include "LuaBinding.hpp"
+#include <chrono>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace LuaScriptingUnitTest
+{
+   /// class with methods to bind in tests
+   class BindingTestObject
+   {
+   public:
+      /// adds two numbers
+      double Add(double a, double b) { return a + b; }
+
+      /// returns length of text
+      int Length(const CString& text) const { return text.GetLength(); }
+
+      /// negates boolean
+      bool Not(bool value) const { return !value; }
+
+      /// returns greeting
+      CStringA Greet(const char* name) { return CStringA("Hello, ") + name; }
+
+      /// stores value
+      void Store(int value) { m_storedValue = value; }
+
+      /// throws an exception
+      void Throw() { throw ::Exception(_T("test exception"), __FILE__, __LINE__); }
+
+      /// stored value
+      int m_storedValue = 0;
+   };
+
+   /// tests typed function bindings in LuaBinding.hpp
+   TEST_CLASS(TestLuaBinding)
+   {
+   public:
+      /// tests binding a global function with arguments and return value
+      TEST_METHOD(TestStateAddTypedFunction)
+      {
+         // set up
+         Lua::State state;
+         auto spObject = std::make_shared<BindingTestObject>();
+
+         state.AddFunction<&BindingTestObject::Add>(_T("add"), spObject);
+         state.LoadSourceString(_T("function test() return add(40, 2.5); end"));
+
+         // run
+         std::vector<Lua::Value> vecRetval = state.CallFunction(_T("test"), 1);
+
+         // check
+         Assert::AreEqual<size_t>(1, vecRetval.size(), _T("must have returned 1 return value"));
+         Assert::AreEqual(42.5, vecRetval[0].Get<double>(), 1e-6, _T("value must be 42.5"));
+      }
+
+      /// tests binding table functions, called with and without self argument
+      TEST_METHOD(TestTableAddTypedFunction)
+      {
+         // set up
+         Lua::State state;
+         auto spObject = std::make_shared<BindingTestObject>();
+
+         {
+            Lua::Table table = state.AddTable(_T("obj"));
+            table.AddFunction<&BindingTestObject::Length>("length", spObject);
+            table.AddFunction<&BindingTestObject::Not>("negate", spObject);
+            table.AddFunction<&BindingTestObject::Greet>("greet", spObject);
+            table.AddFunction<&BindingTestObject::Store>("store", spObject);
+         }
+
+         state.LoadSourceString(_T("function test() obj:store(7); return obj.length(\"abc\"), obj:negate(false), obj:greet(\"Lua\"); end"));
+
+         // run
+         std::vector<Lua::Value> vecRetval = state.CallFunction(_T("test"), 3);
+
+         // check
+         Assert::AreEqual<size_t>(3, vecRetval.size(), _T("must have returned 3 return values"));
+         Assert::AreEqual(3.0, vecRetval[0].Get<double>(), 1e-6, _T("length must be 3"));
+         Assert::IsTrue(vecRetval[1].Get<bool>(), _T("negated value must be true"));
+         Assert::AreEqual(_T("Hello, Lua"), vecRetval[2].Get<CString>().GetString(), _T("greeting must match"));
+         Assert::AreEqual(7, spObject->m_storedValue, _T("stored value must be 7"));
+      }
+
+      /// tests that surplus arguments and table arguments don't shift the bound arguments
+      TEST_METHOD(TestTypedFunctionArgumentIndex)
+      {
+         // set up
+         Lua::State state;
+         auto spObject = std::make_shared<BindingTestObject>();
+
+         state.AddFunction<&BindingTestObject::Add>(_T("add"), spObject);
+
+         {
+            Lua::Table table = state.AddTable(_T("obj"));
+            table.AddFunction<&BindingTestObject::Greet>("greet", spObject);
+            table.AddFunction<&BindingTestObject::Length>("length", spObject);
+         }
+
+         state.LoadSourceString(_T("function test() local other = {}; ")
+            _T("return add(40, 2.5, 99), obj:greet(\"Lua\", 42), obj.greet(\"Lua\", 42), pcall(obj.length, other); end"));
+
+         // run
+         std::vector<Lua::Value> vecRetval = state.CallFunction(_T("test"), 4);
+
+         // check
+         Assert::AreEqual(42.5, vecRetval[0].Get<double>(), 1e-6, _T("surplus argument must be ignored"));
+         Assert::AreEqual(_T("Hello, Lua"), vecRetval[1].Get<CString>().GetString(), _T("self argument must be skipped"));
+         Assert::AreEqual(_T("Hello, Lua"), vecRetval[2].Get<CString>().GetString(), _T("first argument must be used without self"));
+         Assert::IsFalse(vecRetval[3].Get<bool>(), _T("table other than the bound table must not be skipped"));
+      }
+
+      /// tests that C++ exceptions in bound functions result in a Lua::Exception
+      TEST_METHOD(TestTypedFunctionException)
+      {
+         // set up
+         Lua::State state;
+         auto spObject = std::make_shared<BindingTestObject>();
+
+         state.AddFunction<&BindingTestObject::Throw>(_T("throwing"), spObject);
+         state.LoadSourceString(_T("function test() throwing(); end"));
+
+         // run + check
+         try
+         {
+            state.CallFunction(_T("test"));
+         }
+         catch (const ::Exception&)
+         {
+            return;
+         }
+
+         Assert::Fail(_T("must throw exception"));
+      }
+
+      /// tests that the bound instance is released when the function is garbage collected
+      TEST_METHOD(TestTypedFunctionReleasesInstance)
+      {
+         // set up
+         Lua::State state;
+         auto spObject = std::make_shared<BindingTestObject>();
+
+         state.AddFunction<&BindingTestObject::Add>(_T("add"), spObject);
+         Assert::AreEqual<long>(2, spObject.use_count(), _T("instance must be referenced by binding"));
+
+         // run
+         state.AddValue(_T("add"), Lua::Value());
+         state.CollectGarbage();
+
+         // check
+         Assert::AreEqual<long>(1, spObject.use_count(), _T("instance must be released by binding"));
+      }
+
+      /// compares calls per second of T_fnCFunction bindings with typed bindings
+      TEST_METHOD(BenchmarkTypedFunctionCalls)
+      {
+         // set up
+         const unsigned int numCalls = 100000;
+
+         Lua::State state;
+         auto spObject = std::make_shared<BindingTestObject>();
+
+         state.AddFunction(_T("addGeneric"),
+            [spObject](Lua::State&, const std::vector<Lua::Value>& vecParams)
+            {
+               std::vector<Lua::Value> vecRetValues;
+               vecRetValues.push_back(Lua::Value(
+                  spObject->Add(vecParams[0].Get<double>(), vecParams[1].Get<double>())));
+               return vecRetValues;
+            });
+
+         state.AddFunction<&BindingTestObject::Add>(_T("addTyped"), spObject);
+
+         state.LoadSourceString(_T(
+            "function runGeneric(n) local sum = 0; for i = 1, n do sum = addGeneric(sum, 1); end return sum; end\n"
+            "function runTyped(n) local sum = 0; for i = 1, n do sum = addTyped(sum, 1); end return sum; end\n"));
+
+         std::vector<Lua::Value> vecParam;
+         vecParam.push_back(Lua::Value(static_cast<double>(numCalls)));
+
+         // run
+         auto start = std::chrono::steady_clock::now();
+         std::vector<Lua::Value> vecRetvalGeneric = state.CallFunction(_T("runGeneric"), 1, vecParam);
+         auto middle = std::chrono::steady_clock::now();
+         std::vector<Lua::Value> vecRetvalTyped = state.CallFunction(_T("runTyped"), 1, vecParam);
+         auto end = std::chrono::steady_clock::now();
+
+         // check
+         Assert::AreEqual(double(numCalls), vecRetvalGeneric[0].Get<double>(), 1e-6, _T("generic sum must match"));
+         Assert::AreEqual(double(numCalls), vecRetvalTyped[0].Get<double>(), 1e-6, _T("typed sum must match"));
+
+         double genericSeconds = std::chrono::duration<double>(middle - start).count();
+         double typedSeconds = std::chrono::duration<double>(end - middle).count();
+
+         CString text;
+         text.Format(_T("T_fnCFunction binding: %.0f calls/s, typed binding: %.0f calls/s, speedup %.1fx\n"),
+            numCalls / genericSeconds,
+            numCalls / typedSeconds,
+            genericSeconds / typedSeconds);
+
+         Logger::WriteMessage(text.GetString());
+      }
+   };
+} // namespace LuaScriptingUnitTest
@@ -0,0 +1,158 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file TestLuaBytecodeCache.cpp Tests for LuaBytecodeCache class
+//
+
+// includes
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "Lua.hpp"
+#include <ulib/Path.hpp>
+#include <ulib/FileFinder.hpp>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace LuaScriptingUnitTest
+{
+   /// tests LuaBytecodeCache class
+   TEST_CLASS(TestLuaBytecodeCache)
+   {
+   public:
+      /// sets up cache folder and script filename
+      TEST_METHOD_INITIALIZE(SetUp)
+      {
+         m_cacheFolder = Path::Combine(Path::TempFolder(), _T("TestLuaBytecodeCache"));
+         m_scriptFilename = Path::Combine(Path::TempFolder(), _T("TestLuaBytecodeCache.lua"));
+
+         DeleteCacheFiles();
+
+         Lua::State::SetBytecodeCacheFolder(m_cacheFolder);
+      }
+
+      /// disables cache again and removes all files
+      TEST_METHOD_CLEANUP(TearDown)
+      {
+         Lua::State::SetBytecodeCacheFolder(CString());
+
+         DeleteCacheFiles();
+         DeleteFile(m_scriptFilename);
+         RemoveDirectory(m_cacheFolder);
+      }
+
+      /// tests that loading a file stores bytecode, and the bytecode is used again
+      TEST_METHOD(TestLoadFileUsesCache)
+      {
+         // set up
+         WriteScript("function test() return 42; end");
+
+         // run
+         for (int i = 0; i < 2; i++)
+         {
+            Lua::State state;
+            state.LoadFile(m_scriptFilename);
+
+            std::vector<Lua::Value> vecRetval = state.CallFunction(_T("test"), 1);
+
+            // check
+            Assert::AreEqual(42.0, vecRetval[0].Get<double>(), 1e-6, _T("function must return 42"));
+            Assert::AreEqual<size_t>(1, CountCacheFiles(), _T("there must be one cache file"));
+         }
+      }
+
+      /// tests that a changed script is compiled again
+      TEST_METHOD(TestLoadFileChangedScript)
+      {
+         // set up
+         WriteScript("function test() return 42; end");
+         {
+            Lua::State state;
+            state.LoadFile(m_scriptFilename);
+         }
+
+         WriteScript("function test() return 64; end");
+
+         // run
+         Lua::State state;
+         state.LoadFile(m_scriptFilename);
+
+         std::vector<Lua::Value> vecRetval = state.CallFunction(_T("test"), 1);
+
+         // check
+         Assert::AreEqual(64.0, vecRetval[0].Get<double>(), 1e-6, _T("function must return new value"));
+         Assert::AreEqual<size_t>(2, CountCacheFiles(), _T("there must be two cache files"));
+      }
+
+      /// tests that errors still report file name and line number
+      TEST_METHOD(TestLoadFileErrorLineNumber)
+      {
+         // set up
+         WriteScript("#!/usr/bin/lua\nlocal a = 1\nerror(\"test error\")\n");
+
+         // run + check
+         for (int i = 0; i < 2; i++)
+         {
+            try
+            {
+               Lua::State state;
+               state.LoadFile(m_scriptFilename);
+
+               Assert::Fail(_T("must throw exception"));
+            }
+            catch (const Lua::Exception& ex)
+            {
+               Assert::AreEqual(3U, ex.LuaLineNumber(), _T("line number must be correct"));
+            }
+         }
+      }
+
+   private:
+      /// writes script file
+      void WriteScript(const char* pszaScript)
+      {
+         FILE* fd = nullptr;
+         _tfopen_s(&fd, m_scriptFilename, _T("wb"));
+         Assert::IsNotNull(fd, _T("script file must be created"));
+
+         fwrite(pszaScript, 1, strlen(pszaScript), fd);
+         fclose(fd);
+      }
+
+      /// returns all files in the cache folder
+      std::vector<CString> FindCacheFiles() const
+      {
+         std::vector<CString> filenames;
+
+         FileFinder finder(m_cacheFolder, _T("*.*"));
+         if (finder.IsValid())
+         {
+            while (finder.Next())
+               if (!finder.IsDot() && finder.IsFile())
+                  filenames.push_back(finder.Filename());
+         }
+
+         return filenames;
+      }
+
+      /// returns number of files in the cache folder
+      size_t CountCacheFiles() const
+      {
+         return FindCacheFiles().size();
+      }
+
+      /// deletes all files in the cache folder
+      void DeleteCacheFiles() const
+      {
+         for (const CString& filename : FindCacheFiles())
+            DeleteFile(filename);
+      }
+
+   private:
+      /// cache folder
+      CString m_cacheFolder;
+
+      /// script filename
+      CString m_scriptFilename;
+   };
+} // namespace LuaScriptingUnitTest
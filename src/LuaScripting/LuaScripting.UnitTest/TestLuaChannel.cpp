@@ -0,0 +1,282 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file TestLuaChannel.cpp Tests for LuaChannel class
+//
+
+// includes
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "LuaChannel.hpp"
+#include <thread>
+
+extern "C"
+{
+#include <lualib.h>
+}
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace LuaScriptingUnitTest
+{
+   /// tests LuaChannel class
+   TEST_CLASS(TestLuaChannel)
+   {
+   public:
+      /// tests that values are received in order, and that a full channel rejects values
+      TEST_METHOD(TestSendReceiveCapacity)
+      {
+         // set up
+         LuaChannel channel(3);
+         Assert::AreEqual<size_t>(4, channel.Capacity(), _T("capacity must be rounded up to power of two"));
+
+         // run
+         for (int i = 0; i < 4; i++)
+            Assert::IsTrue(channel.TrySend(NumberValue(i)), _T("sending must succeed"));
+
+         bool bSentToFullChannel = channel.TrySend(NumberValue(4));
+
+         // check
+         Assert::IsFalse(bSentToFullChannel, _T("sending to full channel must fail"));
+
+         LuaChannel::SerializedValue value;
+         for (int i = 0; i < 4; i++)
+         {
+            Assert::IsTrue(channel.TryReceive(value), _T("receiving must succeed"));
+            Assert::AreEqual(double(i), value.m_dValue, 1e-6, _T("values must be received in order"));
+         }
+
+         Assert::IsFalse(channel.TryReceive(value), _T("channel must be empty"));
+         Assert::IsFalse(channel.Receive(value, 10), _T("receiving must time out"));
+      }
+
+      /// tests serializing a table and deserializing it in another state
+      TEST_METHOD(TestSerializeTable)
+      {
+         // set up
+         Lua::State sourceState;
+         sourceState.LoadSourceString(_T("value = { name = \"frame\", size = 42, [1] = true, nested = { 7 } };"));
+
+         Lua::State targetState;
+
+         LuaChannel channel(4);
+
+         // run
+         Assert::IsTrue(channel.TrySend(LuaChannel::Serialize(sourceState, sourceState.GetValue(_T("value")))),
+            _T("sending must succeed"));
+
+         LuaChannel::SerializedValue value;
+         Assert::IsTrue(channel.TryReceive(value), _T("receiving must succeed"));
+
+         targetState.AddValue(_T("value"), LuaChannel::Deserialize(targetState, value));
+         targetState.LoadSourceString(_T("function test() return value.name, value.size, value[1], value.nested[1]; end"));
+
+         std::vector<Lua::Value> vecRetval = targetState.CallFunction(_T("test"), 4);
+
+         // check
+         Assert::AreEqual(_T("frame"), vecRetval[0].Get<CString>().GetString(), _T("string value must match"));
+         Assert::AreEqual(42.0, vecRetval[1].Get<double>(), 1e-6, _T("number value must match"));
+         Assert::IsTrue(vecRetval[2].Get<bool>(), _T("boolean value must match"));
+         Assert::AreEqual(7.0, vecRetval[3].Get<double>(), 1e-6, _T("nested value must match"));
+      }
+
+      /// tests that integers arrive as integers, and other numbers as floats
+      TEST_METHOD(TestSerializeIntegerRoundTrip)
+      {
+         // set up
+         Lua::State sourceState;
+         sourceState.LoadSourceString(_T("value = { count = 42, ratio = 0.5, [3] = -7 };"));
+
+         Lua::State targetState;
+         targetState.RequireLib(LUA_MATHLIBNAME);
+         targetState.RequireLib(LUA_STRLIBNAME);
+
+         // run
+         LuaChannel::SerializedValue table = LuaChannel::Serialize(sourceState, sourceState.GetValue(_T("value")));
+         LuaChannel::SerializedValue integer = LuaChannel::Serialize(sourceState, Lua::Value(42));
+
+         targetState.AddValue(_T("value"), LuaChannel::Deserialize(targetState, table));
+         targetState.AddValue(_T("integer"), LuaChannel::Deserialize(targetState, integer));
+         targetState.LoadSourceString(_T("function test() return math.type(value.count), math.type(value.ratio), ")
+            _T("string.format(\"%d\", value[3]), math.type(integer), integer // 5; end"));
+
+         std::vector<Lua::Value> vecRetval = targetState.CallFunction(_T("test"), 5);
+
+         // check
+         Assert::AreEqual(_T("integer"), vecRetval[0].Get<CString>().GetString(), _T("integer in table must stay integer"));
+         Assert::AreEqual(_T("float"), vecRetval[1].Get<CString>().GetString(), _T("float in table must stay float"));
+         Assert::AreEqual(_T("-7"), vecRetval[2].Get<CString>().GetString(), _T("integer key and value must be kept"));
+         Assert::AreEqual(_T("integer"), vecRetval[3].Get<CString>().GetString(), _T("integer value must stay integer"));
+         Assert::AreEqual(8, vecRetval[4].Get<int>(), _T("integer division must work on received value"));
+      }
+
+      /// tests that send() called from a script keeps integers apart from floats
+      TEST_METHOD(TestSendIntegerFromScript)
+      {
+         // set up
+         Lua::State state;
+
+         auto spChannel = std::make_shared<LuaChannel>(4);
+         {
+            Lua::Table channel = state.AddTable(_T("channel"));
+            spChannel->InitBindings(channel);
+         }
+
+         // run
+         state.LoadSourceString(_T("channel:send(42); channel:send(42.0); channel:send(1 << 40);"));
+
+         // check
+         LuaChannel::SerializedValue value;
+         Assert::IsTrue(spChannel->TryReceive(value), _T("receiving must succeed"));
+         Assert::IsTrue(Lua::Value::typeInteger == value.m_enType, _T("integer must be sent as integer"));
+         Assert::AreEqual(42, value.m_iValue, _T("integer value must match"));
+
+         Assert::IsTrue(spChannel->TryReceive(value), _T("receiving must succeed"));
+         Assert::IsTrue(Lua::Value::typeNumber == value.m_enType, _T("float must be sent as number"));
+         Assert::AreEqual(42.0, value.m_dValue, 1e-6, _T("float value must match"));
+
+         Assert::IsTrue(spChannel->TryReceive(value), _T("receiving must succeed"));
+         Assert::IsTrue(Lua::Value::typeNumber == value.m_enType, _T("integer not fitting into int must be sent as number"));
+         Assert::AreEqual(1099511627776.0, value.m_dValue, 1e-6, _T("large integer value must match"));
+      }
+
+      /// tests that strings containing zero bytes are sent unchanged
+      TEST_METHOD(TestSerializeBinaryString)
+      {
+         // set up
+         Lua::State sourceState;
+         sourceState.LoadSourceString(_T("value = \"abc\\0def\"; table = { data = value };"));
+
+         Lua::State targetState;
+
+         // run
+         LuaChannel::SerializedValue value = LuaChannel::Serialize(sourceState, sourceState.GetValue(_T("value")));
+         LuaChannel::SerializedValue table = LuaChannel::Serialize(sourceState, sourceState.GetValue(_T("table")));
+
+         targetState.AddValue(_T("value"), LuaChannel::Deserialize(targetState, value));
+         targetState.AddValue(_T("table"), LuaChannel::Deserialize(targetState, table));
+         targetState.LoadSourceString(_T("function test() return #value, #table.data, value == table.data; end"));
+
+         std::vector<Lua::Value> vecRetval = targetState.CallFunction(_T("test"), 3);
+
+         // check
+         Assert::AreEqual<size_t>(7, value.m_strValue.size(), _T("serialized string must contain zero byte"));
+         Assert::AreEqual(7, vecRetval[0].Get<int>(), _T("string length must match"));
+         Assert::AreEqual(7, vecRetval[1].Get<int>(), _T("string length in table must match"));
+         Assert::IsTrue(vecRetval[2].Get<bool>(), _T("strings must be equal"));
+      }
+
+      /// tests that userdata with shared memory block is passed without copying
+      TEST_METHOD(TestSerializeSharedUserdata)
+      {
+         // set up
+         Lua::State sourceState;
+         Lua::State targetState;
+
+         auto spBuffer = std::make_shared<const std::vector<unsigned char>>(std::vector<unsigned char>{ 1, 2, 3 });
+
+         Lua::Value frame(sourceState.AddUserdata(spBuffer));
+
+         // run
+         LuaChannel::SerializedValue value = LuaChannel::Serialize(sourceState, frame);
+
+         Lua::Value receivedFrame = LuaChannel::Deserialize(targetState, value);
+         Lua::Userdata userdata = receivedFrame.Get<Lua::Userdata>();
+
+         // check
+         Assert::IsTrue(value.m_spBuffer == spBuffer, _T("serialized value must share memory block"));
+         Assert::IsTrue(userdata.GetSharedBuffer() == spBuffer, _T("received userdata must share memory block"));
+         Assert::AreEqual<unsigned long long>(3, userdata.Size(), _T("userdata size must match"));
+         Assert::AreEqual<unsigned char>(3, userdata.Data<unsigned char>()[2], _T("userdata content must match"));
+      }
+
+      /// tests that the send handler is called for each sent value
+      TEST_METHOD(TestSendHandler)
+      {
+         // set up
+         LuaChannel channel(4);
+
+         unsigned int uiNumCalled = 0;
+         channel.SetSendHandler([&uiNumCalled]() { uiNumCalled++; });
+
+         // run
+         channel.TrySend(NumberValue(1));
+         channel.TrySend(NumberValue(2));
+
+         // check
+         Assert::AreEqual(2U, uiNumCalled, _T("send handler must be called for each value"));
+      }
+
+      /// tests that functions can't be sent over channels
+      TEST_METHOD(TestSerializeFunctionFails)
+      {
+         // set up
+         Lua::State state;
+         state.LoadSourceString(_T("function test() end"));
+
+         // run + check
+         try
+         {
+            LuaChannel::Serialize(state, state.GetValue(_T("test")));
+         }
+         catch (const Lua::Exception&)
+         {
+            return;
+         }
+
+         Assert::Fail(_T("must throw exception"));
+      }
+
+      /// tests sending and receiving values from multiple threads
+      TEST_METHOD(TestMultipleProducersConsumers)
+      {
+         // set up
+         const int numThreads = 4;
+         const int numValuesPerThread = 10000;
+
+         LuaChannel channel(64);
+         std::atomic<long long> sumReceived = 0;
+
+         // run
+         std::vector<std::thread> vecThreads;
+         for (int i = 0; i < numThreads; i++)
+         {
+            vecThreads.emplace_back([&]()
+            {
+               for (int value = 1; value <= numValuesPerThread; value++)
+                  while (!channel.TrySend(NumberValue(value)))
+                     std::this_thread::yield();
+            });
+
+            vecThreads.emplace_back([&]()
+            {
+               LuaChannel::SerializedValue value;
+               for (int count = 0; count < numValuesPerThread; count++)
+               {
+                  channel.Receive(value, INFINITE);
+                  sumReceived += static_cast<long long>(value.m_dValue);
+               }
+            });
+         }
+
+         for (std::thread& thread : vecThreads)
+            thread.join();
+
+         // check
+         long long expectedSum = numThreads * (long long(numValuesPerThread) * (numValuesPerThread + 1) / 2);
+         Assert::AreEqual(expectedSum, sumReceived.load(), _T("all values must be received exactly once"));
+      }
+
+   private:
+      /// returns serialized number value
+      static LuaChannel::SerializedValue NumberValue(int iValue)
+      {
+         LuaChannel::SerializedValue value;
+         value.m_enType = Lua::Value::typeNumber;
+         value.m_dValue = iValue;
+
+         return value;
+      }
+   };
+} // namespace LuaScriptingUnitTest
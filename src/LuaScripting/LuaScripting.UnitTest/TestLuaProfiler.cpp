@@ -0,0 +1,99 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file TestLuaProfiler.cpp Tests for LuaProfiler class
+//
+
+// includes
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "Lua.hpp"
+#include "LuaProfiler.hpp"
+#include <ulib/Path.hpp>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace LuaScriptingUnitTest
+{
+   /// tests LuaProfiler class
+   TEST_CLASS(TestLuaProfiler)
+   {
+   public:
+      /// tests that time in Lua code and in C++ calls is measured separately
+      TEST_METHOD(TestProfileLuaAndCppTime)
+      {
+         // set up
+         Lua::State state;
+
+         state.AddFunction(_T("sleep"),
+            [](Lua::State&, const std::vector<Lua::Value>&)
+            {
+               Sleep(50);
+               return std::vector<Lua::Value>();
+            });
+
+         state.StartProfiler(100);
+
+         state.LoadSourceString(_T(
+            "function busy() local sum = 0; for i = 1, 1000000 do sum = sum + i; end return sum; end\n"
+            "function test() busy(); sleep(); end\n"));
+
+         // run
+         state.CallFunction(_T("test"));
+
+         std::shared_ptr<LuaProfiler> spProfiler = state.StopProfiler();
+
+         // check
+         Assert::IsNotNull(spProfiler.get(), _T("profiler must be returned"));
+         Assert::IsTrue(spProfiler->TotalLuaTime() > 0.0, _T("Lua time must be measured"));
+         Assert::IsTrue(spProfiler->TotalCppTime() >= 0.04, _T("C++ time must contain sleep() call"));
+
+         CString cszReport = spProfiler->GetReport();
+         Logger::WriteMessage(cszReport.GetString());
+
+         Assert::IsTrue(cszReport.Find(_T("busy")) != -1, _T("report must contain Lua function"));
+         Assert::IsTrue(cszReport.Find(_T("[C++] sleep")) != -1, _T("report must contain C++ function"));
+      }
+
+      /// tests writing collapsed stacks
+      TEST_METHOD(TestWriteCollapsedStacks)
+      {
+         // set up
+         Lua::State state;
+         state.StartProfiler(100);
+
+         state.LoadSourceString(_T(
+            "function inner() local sum = 0; for i = 1, 1000000 do sum = sum + i; end return sum; end\n"
+            "function outer() return inner(); end\n"));
+
+         state.CallFunction(_T("outer"), 1);
+
+         std::shared_ptr<LuaProfiler> spProfiler = state.StopProfiler();
+
+         CString cszFilename = Path::Combine(Path::TempFolder(), _T("TestLuaProfiler.folded"));
+
+         // run
+         spProfiler->WriteCollapsedStacks(cszFilename);
+
+         // check
+         FILE* fd = nullptr;
+         _tfopen_s(&fd, cszFilename, _T("rt"));
+         Assert::IsNotNull(fd, _T("file must have been written"));
+
+         char buffer[1024] = {};
+         bool bFoundStack = false;
+         while (fgets(buffer, sizeof(buffer), fd) != nullptr)
+         {
+            CStringA cszaLine(buffer);
+            if (cszaLine.Find("outer") != -1 && cszaLine.Find("inner") > cszaLine.Find("outer"))
+               bFoundStack = true;
+         }
+
+         fclose(fd);
+         DeleteFile(cszFilename);
+
+         Assert::IsTrue(bFoundStack, _T("collapsed stack outer;inner must be written"));
+      }
+   };
+} // namespace LuaScriptingUnitTest
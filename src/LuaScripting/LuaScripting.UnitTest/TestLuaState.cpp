@@ -10,6 +10,11 @@
 #include "CppUnitTest.h"
 #include "Lua.hpp"
 
+extern "C"
+{
+#include <lua.h>
+}
+
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
 namespace LuaScriptingUnitTest
@@ -1102,5 +1107,92 @@ namespace LuaScriptingUnitTest
             // stack checker must not report an error
          }
       }
+
+      /// tests storing short and long strings in Lua::Value
+      TEST_METHOD(TestValueStrings)
+      {
+         // set up
+         Lua::State state;
+
+         state.LoadSourceString(_T("function test(text) return text .. \"!\", string.rep(text, 10); end"));
+
+         std::vector<Lua::Value> vecParam;
+         vecParam.push_back(Lua::Value(CString(_T("abc"))));
+
+         // run
+         std::vector<Lua::Value> vecRetval = state.CallFunction(_T("test"), 2, vecParam);
+
+         // check
+         Assert::AreEqual<size_t>(2, vecRetval.size(), _T("must have returned 2 return values"));
+         Assert::AreEqual(_T("abc!"), vecRetval[0].Get<CString>().GetString(), _T("short string must match"));
+         Assert::AreEqual(30, vecRetval[1].Get<CString>().GetLength(), _T("long string must have correct length"));
+         Assert::AreEqual(_T("abcabcabc"), vecRetval[1].Get<CString>().Left(9).GetString(), _T("long string must match"));
+      }
+
+      /// tests copying and moving Lua::Value objects
+      TEST_METHOD(TestValueCopyMove)
+      {
+         // set up
+         CString longText(_T('x'), 100);
+
+         Lua::Value value1(longText);
+         Lua::Value value2(42.0);
+
+         // run
+         Lua::Value value3 = value1;
+         Lua::Value value4 = std::move(value2);
+         value2 = value3;
+         value1 = Lua::Value(true);
+
+         // check
+         Assert::IsTrue(Lua::Value::typeBoolean == value1.GetType(), _T("type must be boolean"));
+         Assert::IsTrue(value1.Get<bool>(), _T("value must be true"));
+         Assert::AreEqual(longText.GetString(), value2.Get<CString>().GetString(), _T("copied string must match"));
+         Assert::AreEqual(longText.GetString(), value3.Get<CString>().GetString(), _T("copied string must match"));
+         Assert::AreEqual(42.0, value4.Get<double>(), 1e-6, _T("moved value must match"));
+      }
+
+      /// tests that Get() converts between number and integer, and throws on wrong type
+      TEST_METHOD(TestValueGet)
+      {
+         Assert::AreEqual(42, Lua::Value(42.5).Get<int>(), _T("number must be truncated to integer"));
+         Assert::AreEqual(42.0, Lua::Value(42).Get<double>(), 1e-6, _T("integer must be converted to number"));
+
+         try
+         {
+            Lua::Value("abc").Get<double>();
+         }
+         catch (const ::Exception&)
+         {
+            return;
+         }
+
+         Assert::Fail(_T("must throw exception on wrong type"));
+      }
+
+      /// tests that returned values that are copied don't stay on the stack
+      TEST_METHOD(TestCallFunctionStackBalanced)
+      {
+         // set up
+         Lua::State state;
+         state.LoadSourceString(_T("abc = {} function test() return 42, abc, \"text\", true; end"));
+
+         // run
+         for (int i = 0; i < 100; i++)
+         {
+            Lua::StackChecker checker(state.GetState());
+
+            int iStackDepth = lua_gettop(state.GetState());
+
+            std::vector<Lua::Value> vecRetval = state.CallFunction(_T("test"), 4);
+
+            // check
+            Assert::AreEqual(iStackDepth + 1, lua_gettop(state.GetState()), _T("only the table must stay on the stack"));
+            Assert::IsTrue(Lua::Value::typeTable == vecRetval[1].GetType(), _T("type must be table"));
+            Assert::AreEqual(_T("text"), vecRetval[2].Get<CString>().GetString(), _T("string must match"));
+
+            // stack checker must not report an error
+         }
+      }
    };
 }
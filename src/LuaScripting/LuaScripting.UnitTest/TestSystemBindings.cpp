@@ -65,5 +65,197 @@ namespace LuaScriptingUnitTest
          // cleanup
          csp.GetScheduler().SetExecutionStateChangedHandler(nullptr);
       }
+
+      /// tests spawning a function that receives and sends values over channels
+      TEST_METHOD(TestSpawnWithChannels)
+      {
+         // set up
+         CameraScriptProcessor csp;
+
+         ManualResetEvent evtIsStarted(false);
+         ManualResetEvent evtIsIdleAgain(false);
+
+         csp.GetScheduler().SetExecutionStateChangedHandler([&](LuaScheduler::T_enExecutionState enExecutionState)
+         {
+            if (enExecutionState == LuaScheduler::stateRunning)
+               evtIsStarted.Set();
+
+            if (enExecutionState == LuaScheduler::stateIdle && evtIsStarted.Wait(0) == true)
+               evtIsIdleAgain.Set();
+         });
+
+         csp.LoadSourceString(
+            _T("testResult = nil;")
+            _T("App = {")
+            _T("  run = function(self)")
+            _T("     local input = Sys:createChannel();")
+            _T("     local output = Sys:createChannel();")
+            _T("     Sys:spawn(function(input, output)")
+            _T("        local value = input:receive();")
+            _T("        output:send({ result = value.number * 2 });")
+            _T("     end, input, output);")
+            _T("     input:send({ number = 21 });")
+            _T("     testResult = output:receive(5.0).result;")
+            _T("  end; }"));
+
+         // run
+         csp.Run();
+
+         evtIsStarted.Wait();
+         evtIsIdleAgain.Wait();
+
+         // check
+         Lua::State& state = csp.GetScheduler().GetState();
+
+         Lua::Value testResult = state.GetValue(_T("testResult"));
+         Assert::AreEqual(42.0, testResult.Get<double>(), 1e-6,
+            _T("spawned function must have sent back result"));
+
+         // cleanup
+         csp.GetScheduler().SetExecutionStateChangedHandler(nullptr);
+      }
+
+      /// tests that timers are called while the main thread sleeps
+      TEST_METHOD(TestTimersWhileSleeping)
+      {
+         // set up
+         CameraScriptProcessor csp;
+
+         ManualResetEvent evtIsStarted(false);
+         ManualResetEvent evtIsIdleAgain(false);
+
+         csp.GetScheduler().SetExecutionStateChangedHandler([&](LuaScheduler::T_enExecutionState enExecutionState)
+         {
+            if (enExecutionState == LuaScheduler::stateRunning)
+               evtIsStarted.Set();
+
+            if (enExecutionState == LuaScheduler::stateIdle && evtIsStarted.Wait(0) == true)
+               evtIsIdleAgain.Set();
+         });
+
+         csp.LoadSourceString(
+            _T("timeoutCalled = false; intervalCount = 0;")
+            _T("App = {")
+            _T("  run = function(self)")
+            _T("     Sys:setTimeout(function() timeoutCalled = true; end, 0.05);")
+            _T("     local timerId = Sys:setInterval(function() intervalCount = intervalCount + 1; end, 0.02);")
+            _T("     Sys:sleep(0.3);")
+            _T("     Sys:clearTimer(timerId);")
+            _T("  end; }"));
+
+         // run
+         csp.Run();
+
+         evtIsStarted.Wait();
+         evtIsIdleAgain.Wait();
+
+         // check
+         Lua::State& state = csp.GetScheduler().GetState();
+
+         Assert::IsTrue(state.GetValue(_T("timeoutCalled")).Get<bool>(),
+            _T("timeout function must have been called while sleeping"));
+
+         Assert::IsTrue(state.GetValue(_T("intervalCount")).Get<int>() >= 3,
+            _T("interval function must have been called multiple times while sleeping"));
+
+         // cleanup
+         csp.GetScheduler().SetExecutionStateChangedHandler(nullptr);
+      }
+
+      /// tests that two coroutines can sleep at the same time
+      TEST_METHOD(TestSleepInTwoCoroutines)
+      {
+         // set up
+         CameraScriptProcessor csp;
+
+         ManualResetEvent evtIsStarted(false);
+         ManualResetEvent evtIsIdleAgain(false);
+
+         csp.GetScheduler().SetExecutionStateChangedHandler([&](LuaScheduler::T_enExecutionState enExecutionState)
+         {
+            if (enExecutionState == LuaScheduler::stateRunning)
+               evtIsStarted.Set();
+
+            if (enExecutionState == LuaScheduler::stateIdle && evtIsStarted.Wait(0) == true)
+               evtIsIdleAgain.Set();
+         });
+
+         csp.LoadSourceString(
+            _T("order = \"\"; returnedBeforeWakeup = false;")
+            _T("App = {")
+            _T("  run = function(self)")
+            _T("     local slow = coroutine.wrap(function() Sys:sleep(0.2); order = order .. \"slow\"; end);")
+            _T("     local fast = coroutine.wrap(function() Sys:sleep(0.1); order = order .. \"fast\"; end);")
+            _T("     slow();")
+            _T("     fast();")
+            _T("     returnedBeforeWakeup = order == \"\";")
+            _T("     Sys:sleep(0.5);")
+            _T("  end; }"));
+
+         // run
+         csp.Run();
+
+         evtIsStarted.Wait();
+         evtIsIdleAgain.Wait();
+
+         // check
+         Lua::State& state = csp.GetScheduler().GetState();
+
+         Assert::IsTrue(state.GetValue(_T("returnedBeforeWakeup")).Get<bool>(),
+            _T("sleeping coroutines must yield back to the main thread"));
+
+         Assert::AreEqual(_T("fastslow"), state.GetValue(_T("order")).Get<CString>().GetString(),
+            _T("both coroutines must have been resumed, in order of their wakeup time"));
+
+         // cleanup
+         csp.GetScheduler().SetExecutionStateChangedHandler(nullptr);
+      }
+
+      /// tests that the event timer backs off when no camera events are processed
+      TEST_METHOD(TestEventStatisticsWhenIdle)
+      {
+         // set up
+         CameraScriptProcessor csp;
+
+         ManualResetEvent evtIsStarted(false);
+         ManualResetEvent evtIsIdleAgain(false);
+
+         csp.GetScheduler().SetExecutionStateChangedHandler([&](LuaScheduler::T_enExecutionState enExecutionState)
+         {
+            if (enExecutionState == LuaScheduler::stateRunning)
+               evtIsStarted.Set();
+
+            if (enExecutionState == LuaScheduler::stateIdle && evtIsStarted.Wait(0) == true)
+               evtIsIdleAgain.Set();
+         });
+
+         csp.LoadSourceString(
+            _T("timerWakeups = 0; idleWakeupsPerSecond = 0;")
+            _T("App = {")
+            _T("  run = function(self)")
+            _T("     Sys:sleep(1.0);")
+            _T("     local statistics = Sys:getEventStatistics();")
+            _T("     timerWakeups = statistics.timerWakeups;")
+            _T("     idleWakeupsPerSecond = statistics.idleWakeupsPerSecond;")
+            _T("  end; }"));
+
+         // run
+         csp.Run();
+
+         evtIsStarted.Wait();
+         evtIsIdleAgain.Wait();
+
+         // check
+         Lua::State& state = csp.GetScheduler().GetState();
+
+         Assert::IsTrue(state.GetValue(_T("timerWakeups")).Get<int>() > 0,
+            _T("event timer must have polled for events"));
+
+         Assert::IsTrue(state.GetValue(_T("idleWakeupsPerSecond")).Get<double>() < 20.0,
+            _T("event timer must poll less often when idle"));
+
+         // cleanup
+         csp.GetScheduler().SetExecutionStateChangedHandler(nullptr);
+      }
    };
 }
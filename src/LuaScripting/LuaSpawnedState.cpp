@@ -0,0 +1,218 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file LuaSpawnedState.cpp Lua state running on its own worker thread
+//
+
+// includes
+#include "stdafx.h"
+#include "LuaSpawnedState.hpp"
+#include "LuaChannel.hpp"
+
+extern "C"
+{
+#include <lua.h>
+#include <lualib.h>
+#include <lauxlib.h>
+}
+
+/// name of global variable that temporarily stores the spawned chunk
+const CString c_cszSpawnedChunkName = _T("__spawnedChunk");
+
+/// number of Lua instructions after which the stop hook checks for stopping
+const int c_iStopHookInstructionCount = 1000;
+
+/// time slice to wait in receive(), before checking for stopping again
+const DWORD c_dwReceiveTimeSliceInMs = 100;
+
+LuaSpawnedState::LuaSpawnedState(T_fnOutputDebugString fnOutputDebugString)
+:m_fnOutputDebugString(fnOutputDebugString),
+m_bIsRunning(false),
+m_bStopRequested(false)
+{
+   m_workerThread.SetOutputDebugStringHandler(fnOutputDebugString);
+}
+
+LuaSpawnedState::~LuaSpawnedState()
+{
+   try
+   {
+      Stop();
+   }
+   catch (...)
+   {
+   }
+}
+
+void LuaSpawnedState::Start(const CStringA& cszaChunk, bool bIsBytecode,
+   const std::vector<std::shared_ptr<LuaChannel>>& vecChannels)
+{
+   m_bIsRunning = true;
+
+   m_workerThread.GetStrand().post([this, cszaChunk, bIsBytecode, vecChannels]()
+   {
+      Run(cszaChunk, bIsBytecode, vecChannels);
+   });
+}
+
+/// \details Sets a flag that is checked by the stop hook and by receive();
+/// the script is then aborted with a Lua error.
+void LuaSpawnedState::Stop()
+{
+   m_bStopRequested = true;
+
+   m_workerThread.Stop();
+}
+
+void LuaSpawnedState::Run(const CStringA& cszaChunk, bool bIsBytecode,
+   const std::vector<std::shared_ptr<LuaChannel>>& vecChannels)
+{
+   try
+   {
+      InitBindings();
+
+      lua_State* L = m_state.GetState();
+
+      int iRet = luaL_loadbufferx(L, cszaChunk.GetString(), static_cast<size_t>(cszaChunk.GetLength()),
+         "=spawned", bIsBytecode ? "b" : "t");
+
+      if (iRet != LUA_OK)
+      {
+         CStringA message = lua_tostring(L, -1);
+         lua_pop(L, 1);
+
+         throw Lua::Exception(_T("error while loading spawned script"), message, L);
+      }
+
+      lua_setglobal(L, CStringA(c_cszSpawnedChunkName).GetString());
+
+      std::vector<Lua::Value> vecParams;
+      for (const std::shared_ptr<LuaChannel>& spChannel : vecChannels)
+      {
+         Lua::Table channel = m_state.AddTable(_T(""));
+         spChannel->InitBindings(channel);
+
+         channel.AddFunction("receive",
+            std::bind(&LuaSpawnedState::ChannelReceive, this, spChannel,
+               std::placeholders::_1, std::placeholders::_2));
+
+         vecParams.push_back(Lua::Value(channel));
+      }
+
+      m_state.CallFunction(c_cszSpawnedChunkName, 0, vecParams);
+   }
+   catch (const Lua::Exception& ex)
+   {
+      if (!m_bStopRequested)
+      {
+         CString cszText;
+         cszText.Format(_T("%s(%u): Lua exception occured in spawned script: %s\n"),
+            ex.LuaSourceFile().GetString(),
+            ex.LuaLineNumber(),
+            ex.LuaErrorMessage().GetString());
+
+         WriteDebugOutput(cszText);
+      }
+   }
+
+   m_bIsRunning = false;
+}
+
+/// \details The spawned state gets the same libraries as the main script,
+/// except the os library, and the same sandboxing; see CameraScriptProcessor.
+void LuaSpawnedState::InitBindings()
+{
+   m_state.RequireLib(LUA_BASICLIBNAME);
+   m_state.RequireLib(LUA_COLIBNAME);
+   m_state.RequireLib(LUA_STRLIBNAME);
+   m_state.RequireLib(LUA_UTF8LIBNAME);
+   m_state.RequireLib(LUA_TABLIBNAME);
+   m_state.RequireLib(LUA_MATHLIBNAME);
+
+   m_state.AddValue(_T("dofile"), Lua::Value());
+   m_state.AddValue(_T("load"), Lua::Value());
+   m_state.AddValue(_T("loadfile"), Lua::Value());
+
+   m_state.AddFunction(_T("print"),
+      std::bind(&LuaSpawnedState::Print, this, std::placeholders::_1, std::placeholders::_2));
+
+   lua_State* L = m_state.GetState();
+
+   *reinterpret_cast<LuaSpawnedState**>(lua_getextraspace(L)) = this;
+   lua_sethook(L, &LuaSpawnedState::OnStopHook, LUA_MASKCOUNT, c_iStopHookInstructionCount);
+}
+
+std::vector<Lua::Value> LuaSpawnedState::Print(Lua::State& state, const std::vector<Lua::Value>& vecParams)
+{
+   lua_State* L = state.GetState();
+
+   lua_concat(L, vecParams.size());
+   CString cszText = lua_tostring(L, -1);
+
+   WriteDebugOutput(cszText);
+
+   return std::vector<Lua::Value>();
+}
+
+/// \param[in] spChannel channel to receive from
+/// \param[in] state the Lua state for parameters to this function
+/// \param[in] vecParams Lua params; [0] is the channel table, and [1] (optional) is a
+/// timeout value, in seconds, to wait. If not specified, the wait is infinite.
+std::vector<Lua::Value> LuaSpawnedState::ChannelReceive(std::shared_ptr<LuaChannel> spChannel,
+   Lua::State& state, const std::vector<Lua::Value>& vecParams)
+{
+   if (vecParams.size() != 1 && vecParams.size() != 2)
+      throw Lua::Exception(_T("invalid number of parameters to Channel:receive()"), state.GetState(), __FILE__, __LINE__);
+
+   if (vecParams.size() == 2 &&
+      vecParams[1].GetType() != Lua::Value::typeNumber &&
+      vecParams[1].GetType() != Lua::Value::typeInteger)
+      throw Lua::Exception(_T("second parameter must be the timeout value in seconds"), state.GetState(), __FILE__, __LINE__);
+
+   ULONGLONG ullStart = GetTickCount64();
+   ULONGLONG ullTimeoutInMs = vecParams.size() == 2
+      ? static_cast<ULONGLONG>(vecParams[1].Get<double>() * 1000.0)
+      : ULLONG_MAX;
+
+   std::vector<Lua::Value> vecRetValues;
+
+   LuaChannel::SerializedValue value;
+   for (;;)
+   {
+      ULONGLONG ullElapsed = GetTickCount64() - ullStart;
+      ULONGLONG ullRemaining = ullElapsed < ullTimeoutInMs ? ullTimeoutInMs - ullElapsed : 0;
+      DWORD dwWaitTime = static_cast<DWORD>(std::min<ULONGLONG>(ullRemaining, c_dwReceiveTimeSliceInMs));
+
+      if (spChannel->Receive(value, dwWaitTime))
+      {
+         vecRetValues.push_back(LuaChannel::Deserialize(state, value));
+         return vecRetValues;
+      }
+
+      if (m_bStopRequested)
+         throw Lua::Exception(_T("spawned script was stopped"), state.GetState(), __FILE__, __LINE__);
+
+      if (ullRemaining <= dwWaitTime)
+         break; // timeout reached
+   }
+
+   vecRetValues.push_back(Lua::Value());
+   return vecRetValues;
+}
+
+void LuaSpawnedState::WriteDebugOutput(const CString& cszText)
+{
+   ATLTRACE(_T("%s\n"), cszText.GetString());
+
+   if (m_fnOutputDebugString != nullptr)
+      m_fnOutputDebugString(cszText);
+}
+
+void LuaSpawnedState::OnStopHook(lua_State* L, lua_Debug* /*ar*/)
+{
+   LuaSpawnedState* pSpawnedState = *reinterpret_cast<LuaSpawnedState**>(lua_getextraspace(L));
+
+   if (pSpawnedState != nullptr && pSpawnedState->m_bStopRequested)
+      luaL_error(L, "spawned script was stopped");
+}
@@ -0,0 +1,83 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file LuaSpawnedState.hpp Lua state running on its own worker thread
+//
+#pragma once
+
+// includes
+#include "Lua.hpp"
+#include "LuaScriptWorkerThread.hpp"
+#include <atomic>
+
+// forward references
+class LuaChannel;
+struct lua_Debug;
+
+/// \brief Lua state running a spawned script on its own worker thread
+/// \details Spawned states are started with Sys:spawn() and run isolated from
+/// the main script; they don't share any Lua objects with other states and
+/// can only communicate using channels, which are passed as arguments to the
+/// script chunk. Spawned scripts have no access to the camera; they are meant
+/// to do work like image analysis in parallel to the main script.
+class LuaSpawnedState : public std::enable_shared_from_this<LuaSpawnedState>
+{
+public:
+   /// function type to output debug strings
+   typedef LuaScriptWorkerThread::T_fnOutputDebugString T_fnOutputDebugString;
+
+   /// ctor
+   explicit LuaSpawnedState(T_fnOutputDebugString fnOutputDebugString);
+
+   /// dtor; stops script
+   ~LuaSpawnedState();
+
+   /// \brief starts running script chunk on the worker thread
+   /// \param cszaChunk Lua source code or bytecode, as produced by lua_dump()
+   /// \param bIsBytecode indicates if the chunk is bytecode
+   /// \param vecChannels channels that are passed as arguments to the chunk
+   void Start(const CStringA& cszaChunk, bool bIsBytecode, const std::vector<std::shared_ptr<LuaChannel>>& vecChannels);
+
+   /// returns if the script is still running
+   bool IsRunning() const { return m_bIsRunning; }
+
+   /// stops script and waits for the worker thread to exit
+   void Stop();
+
+private:
+   /// runs script chunk; called on worker thread
+   void Run(const CStringA& cszaChunk, bool bIsBytecode, const std::vector<std::shared_ptr<LuaChannel>>& vecChannels);
+
+   /// initializes built-in libs and global functions
+   void InitBindings();
+
+   /// prints values as output debug string
+   std::vector<Lua::Value> Print(Lua::State& state, const std::vector<Lua::Value>& vecParams);
+
+   /// channel function receive([timeout]); blocks the worker thread
+   std::vector<Lua::Value> ChannelReceive(std::shared_ptr<LuaChannel> spChannel,
+      Lua::State& state, const std::vector<Lua::Value>& vecParams);
+
+   /// outputs text using the output debug string handler
+   void WriteDebugOutput(const CString& cszText);
+
+   /// Lua hook function that aborts the script when stopping
+   static void OnStopHook(lua_State* L, lua_Debug* ar);
+
+private:
+   /// output debug string handler
+   T_fnOutputDebugString m_fnOutputDebugString;
+
+   /// Lua state of spawned script
+   Lua::State m_state;
+
+   /// indicates if the script is still running
+   std::atomic<bool> m_bIsRunning;
+
+   /// indicates that the script should stop
+   std::atomic<bool> m_bStopRequested;
+
+   /// worker thread; declared last, so that it's stopped before the state is destroyed
+   LuaScriptWorkerThread m_workerThread;
+};
@@ -9,15 +9,24 @@
 #include "stdafx.h"
 #include "SystemLuaBindings.hpp"
 #include "LuaScheduler.hpp"
+#include "LuaSpawnedState.hpp"
 
-#pragma warning(disable: 28159) // Consider using 'GetTickCount64' instead of 'GetTickCount'. Reason: GetTickCount overflows roughly every 49 days.  Code that does not take that into account can loop indefinitely.  GetTickCount64 operates on 64 bit values and does not have that problem
+extern "C"
+{
+#include <lua.h>
+}
+
+/// default capacity of channels
+const size_t c_uiDefaultChannelCapacity = 16;
 
-/// poll time for manual-reset events
-const unsigned int c_uiManualResetEventPollTimeInMs = 50;
+/// name of table in Sys table that stores all timer functions, by timer ID
+LPCTSTR c_pszTimerHandlerTable = _T("__TimerHandler");
 
 SystemLuaBindings::SystemLuaBindings(LuaScheduler& scheduler, asio::io_service::strand& strand)
 :m_scheduler(scheduler),
-m_strand(strand)
+m_strand(strand),
+m_iNextTimerId(1),
+m_timerSleep(strand.context())
 {
 }
 
@@ -43,6 +52,32 @@ void SystemLuaBindings::InitBindings()
    sys.AddFunction("createEvent",
       std::bind(&SystemLuaBindings::SysCreateEvent, shared_from_this(),
          std::placeholders::_1));
+
+   sys.AddFunction("createChannel",
+      std::bind(&SystemLuaBindings::SysCreateChannel, shared_from_this(),
+         std::placeholders::_1, std::placeholders::_2));
+
+   sys.AddFunction("spawn",
+      std::bind(&SystemLuaBindings::SysSpawn, shared_from_this(),
+         std::placeholders::_1, std::placeholders::_2));
+
+   sys.AddFunction("setTimeout",
+      std::bind(&SystemLuaBindings::SysSetTimeout, shared_from_this(),
+         std::placeholders::_1, std::placeholders::_2));
+
+   sys.AddFunction("setInterval",
+      std::bind(&SystemLuaBindings::SysSetInterval, shared_from_this(),
+         std::placeholders::_1, std::placeholders::_2));
+
+   sys.AddFunction("clearTimer",
+      std::bind(&SystemLuaBindings::SysClearTimer, shared_from_this(),
+         std::placeholders::_1, std::placeholders::_2));
+
+   sys.AddFunction("sleep",
+      std::bind(&SystemLuaBindings::SysSleep, shared_from_this(),
+         std::placeholders::_1, std::placeholders::_2));
+
+   sys.AddValue(c_pszTimerHandlerTable, Lua::Value(GetState().AddTable(_T(""))));
 }
 
 /// returns Lua state object
@@ -59,6 +94,23 @@ void SystemLuaBindings::CancelHandlers()
    });
 
    m_vecAllEvents.clear();
+
+   for (std::shared_ptr<LuaSpawnedState>& spSpawnedState : m_vecAllSpawnedStates)
+      spSpawnedState->Stop();
+
+   m_vecAllSpawnedStates.clear();
+
+   for (auto& iter : m_mapAllChannels)
+      iter.second->Cancel();
+
+   m_mapAllChannels.clear();
+
+   for (auto& iter : m_mapAllTimers)
+      iter.second->m_timer.cancel();
+
+   m_mapAllTimers.clear();
+
+   m_timerSleep.cancel();
 }
 
 void SystemLuaBindings::CleanupBindings()
@@ -94,11 +146,387 @@ std::vector<Lua::Value> SystemLuaBindings::SysCreateEvent(Lua::State& state)
    return vecRetValues;
 }
 
+/// \param[in] state the Lua state for parameters to this function
+/// \param[in] vecParams Lua params; [0] is the Sys table, and [1] (optional) is
+/// the number of values the channel can hold. The default capacity is 16.
+std::vector<Lua::Value> SystemLuaBindings::SysCreateChannel(Lua::State& state,
+   const std::vector<Lua::Value>& vecParams)
+{
+   if (vecParams.size() != 1 && vecParams.size() != 2)
+      throw Lua::Exception(_T("invalid number of parameters to Sys:createChannel()"), state.GetState(), __FILE__, __LINE__);
+
+   size_t uiCapacity = c_uiDefaultChannelCapacity;
+   if (vecParams.size() == 2)
+   {
+      if (vecParams[1].GetType() != Lua::Value::typeInteger &&
+         vecParams[1].GetType() != Lua::Value::typeNumber)
+         throw Lua::Exception(_T("second parameter must be the channel capacity"), state.GetState(), __FILE__, __LINE__);
+
+      int iCapacity = vecParams[1].Get<int>();
+      if (iCapacity <= 0)
+         throw Lua::Exception(_T("channel capacity must be greater than 0"), state.GetState(), __FILE__, __LINE__);
+
+      uiCapacity = static_cast<size_t>(iCapacity);
+   }
+
+   std::shared_ptr<Channel> spChannel =
+      std::make_shared<Channel>(m_scheduler, m_strand, uiCapacity);
+
+   m_mapAllChannels[spChannel->GetChannel()->GetName()] = spChannel;
+
+   Lua::Table channel = state.AddTable(_T(""));
+   spChannel->InitBindings(channel);
+
+   std::vector<Lua::Value> vecRetValues;
+   vecRetValues.push_back(Lua::Value(channel));
+
+   return vecRetValues;
+}
+
+/// \details The spawned script runs in its own Lua state, on its own worker
+/// thread, so it can run in parallel to the main script. Functions are passed
+/// to the new state as bytecode, so they must not use upvalues other than
+/// global variables; local variables of the enclosing function are nil in the
+/// spawned state.
+/// \param[in] state the Lua state for parameters to this function
+/// \param[in] vecParams Lua params; [0] is the Sys table, [1] is the script
+/// source code or a function to run, and all further parameters must be
+/// channels, which are passed as arguments to the spawned script.
+/// \return table with function isRunning()
+std::vector<Lua::Value> SystemLuaBindings::SysSpawn(Lua::State& state,
+   const std::vector<Lua::Value>& vecParams)
+{
+   lua_State* L = state.GetState();
+
+   if (vecParams.size() < 2)
+      throw Lua::Exception(_T("invalid number of parameters to Sys:spawn()"), L, __FILE__, __LINE__);
+
+   CStringA cszaChunk;
+   bool bIsBytecode = false;
+
+   if (vecParams[1].GetType() == Lua::Value::typeString)
+      cszaChunk = CStringA(vecParams[1].Get<CString>());
+   else if (vecParams[1].GetType() == Lua::Value::typeFunction)
+   {
+      Lua::Function func = vecParams[1].Get<Lua::Function>();
+
+      lua_pushvalue(L, func.GetRef()->GetStackIndex());
+
+      std::vector<char> vecBytecode;
+      int iRet = lua_dump(L, [](lua_State*, const void* p, size_t uiSize, void* pUserData)
+      {
+         std::vector<char>& vecData = *reinterpret_cast<std::vector<char>*>(pUserData);
+
+         const char* pData = reinterpret_cast<const char*>(p);
+         vecData.insert(vecData.end(), pData, pData + uiSize);
+
+         return 0;
+      }, &vecBytecode, 0);
+
+      lua_pop(L, 1);
+
+      if (iRet != 0 || vecBytecode.empty())
+         throw Lua::Exception(_T("only Lua functions can be spawned"), L, __FILE__, __LINE__);
+
+      cszaChunk = CStringA(vecBytecode.data(), static_cast<int>(vecBytecode.size()));
+      bIsBytecode = true;
+   }
+   else
+      throw Lua::Exception(_T("second parameter must be the script source or a function"), L, __FILE__, __LINE__);
+
+   std::vector<std::shared_ptr<LuaChannel>> vecChannels;
+   for (size_t ui = 2; ui < vecParams.size(); ui++)
+   {
+      if (vecParams[ui].GetType() != Lua::Value::typeTable)
+         throw Lua::Exception(_T("all further parameters must be channels"), L, __FILE__, __LINE__);
+
+      CString cszName = vecParams[ui].Get<Lua::Table>().GetValue(_T("__name")).Get<CString>();
+
+      auto iter = m_mapAllChannels.find(cszName);
+      if (iter == m_mapAllChannels.end())
+         throw Lua::Exception(_T("all further parameters must be channels"), L, __FILE__, __LINE__);
+
+      vecChannels.push_back(iter->second->GetChannel());
+   }
+
+   std::shared_ptr<LuaSpawnedState> spSpawnedState =
+      std::make_shared<LuaSpawnedState>(m_fnOutputDebugString);
+
+   m_vecAllSpawnedStates.push_back(spSpawnedState);
+
+   spSpawnedState->Start(cszaChunk, bIsBytecode, vecChannels);
+
+   Lua::Table spawned = state.AddTable(_T(""));
+   spawned.AddFunction("isRunning",
+      [spSpawnedState](Lua::State&, const std::vector<Lua::Value>&)
+      {
+         std::vector<Lua::Value> vecRetValues;
+         vecRetValues.push_back(Lua::Value(spSpawnedState->IsRunning()));
+
+         return vecRetValues;
+      });
+
+   std::vector<Lua::Value> vecRetValues;
+   vecRetValues.push_back(Lua::Value(spawned));
+
+   return vecRetValues;
+}
+
+/// \param[in] state the Lua state for parameters to this function
+/// \param[in] vecParams Lua params; [0] is the Sys table, [1] is the function
+/// to call, and [2] is the timeout in seconds.
+/// \return timer ID, to be used in Sys:clearTimer()
+std::vector<Lua::Value> SystemLuaBindings::SysSetTimeout(Lua::State& state,
+   const std::vector<Lua::Value>& vecParams)
+{
+   return StartTimer(state, vecParams, false);
+}
+
+/// \param[in] state the Lua state for parameters to this function
+/// \param[in] vecParams Lua params; [0] is the Sys table, [1] is the function
+/// to call, and [2] is the interval in seconds.
+/// \return timer ID, to be used in Sys:clearTimer()
+std::vector<Lua::Value> SystemLuaBindings::SysSetInterval(Lua::State& state,
+   const std::vector<Lua::Value>& vecParams)
+{
+   return StartTimer(state, vecParams, true);
+}
+
+/// \param[in] state the Lua state for parameters to this function
+/// \param[in] vecParams Lua params; [0] is the Sys table, and [1] is the
+/// timer ID returned by Sys:setTimeout() or Sys:setInterval().
+std::vector<Lua::Value> SystemLuaBindings::SysClearTimer(Lua::State& state,
+   const std::vector<Lua::Value>& vecParams)
+{
+   if (vecParams.size() != 2)
+      throw Lua::Exception(_T("invalid number of parameters to Sys:clearTimer()"), state.GetState(), __FILE__, __LINE__);
+
+   if (vecParams[1].GetType() != Lua::Value::typeInteger &&
+      vecParams[1].GetType() != Lua::Value::typeNumber)
+      throw Lua::Exception(_T("second parameter must be the timer id"), state.GetState(), __FILE__, __LINE__);
+
+   int iTimerId = vecParams[1].Get<int>();
+
+   auto iter = m_mapAllTimers.find(iTimerId);
+   if (iter != m_mapAllTimers.end())
+   {
+      iter->second->m_timer.cancel();
+      m_mapAllTimers.erase(iter);
+   }
+
+   Lua::Table sys = state.GetTable(_T("Sys"));
+   Lua::Table handlerTable = sys.GetValue(c_pszTimerHandlerTable).Get<Lua::Table>();
+
+   handlerTable.AddValue(iTimerId, Lua::Value());
+
+   return std::vector<Lua::Value>();
+}
+
+/// \details The calling thread is yielded, and is resumed when the time has
+/// passed. The main thread is resumed by the scheduler; other coroutines are
+/// stored in the timer handler table, like the functions of Sys:setTimeout(),
+/// and are resumed by the timer handler. While sleeping, all other handlers,
+/// e.g. camera events, are still called.
+/// \param[in] state the Lua state for parameters to this function
+/// \param[in] vecParams Lua params; [0] is the Sys table, and [1] is the
+/// time to sleep, in seconds.
+std::vector<Lua::Value> SystemLuaBindings::SysSleep(Lua::State& state,
+   const std::vector<Lua::Value>& vecParams)
+{
+   if (vecParams.size() != 2)
+      throw Lua::Exception(_T("invalid number of parameters to Sys:sleep()"), state.GetState(), __FILE__, __LINE__);
+
+   if (vecParams[1].GetType() != Lua::Value::typeInteger &&
+      vecParams[1].GetType() != Lua::Value::typeNumber)
+      throw Lua::Exception(_T("second parameter must be the time to sleep in seconds"), state.GetState(), __FILE__, __LINE__);
+
+   double dSeconds = vecParams[1].Get<double>();
+   if (dSeconds < 0.0)
+      dSeconds = 0.0;
+
+   asio::steady_timer::duration sleepTime =
+      std::chrono::duration_cast<asio::steady_timer::duration>(std::chrono::duration<double>(dSeconds));
+
+   if (state.GetState() != m_scheduler.GetThread().GetThreadState())
+      SleepCoroutine(state, sleepTime);
+
+   m_timerSleep.expires_after(sleepTime);
+
+   std::shared_ptr<SystemLuaBindings> spThis = shared_from_this();
+   m_timerSleep.async_wait(m_strand.wrap([spThis](const std::error_code& error)
+   {
+      if (error)
+         return; // timer was canceled
+
+      if (spThis->m_scheduler.GetThread().Status() != Lua::Thread::statusYield)
+         return;
+
+      spThis->m_scheduler.ResumeMainThread(std::vector<Lua::Value>());
+   }));
+
+   m_scheduler.GetThread().Yield(state, std::vector<Lua::Value>(),
+      std::bind(&SystemLuaBindings::ResumeAfterSleep, shared_from_this(),
+         std::placeholders::_1, std::placeholders::_2));
+}
+
+/// \details The coroutine is stored in the timer handler table, so that it
+/// isn't garbage collected while sleeping, and so that it is resumed by
+/// OnTimer(). The coroutine must not be resumed by the script while sleeping.
+void SystemLuaBindings::SleepCoroutine(Lua::State& state, asio::steady_timer::duration sleepTime)
+{
+   lua_State* L = state.GetState();
+
+   if (!lua_isyieldable(L))
+      throw Lua::Exception(_T("Sys:sleep() can only be called from the main thread or from coroutines"), L, __FILE__, __LINE__);
+
+   lua_pushthread(L);
+   Lua::Value coroutine = Lua::Value::FromStack(state, -1, true);
+
+   int iTimerId = m_iNextTimerId++;
+
+   std::shared_ptr<Timer> spTimer =
+      std::make_shared<Timer>(m_strand.context(), sleepTime, false);
+
+   m_mapAllTimers[iTimerId] = spTimer;
+
+   {
+      Lua::Table sys = state.GetTable(_T("Sys"));
+      Lua::Table handlerTable = sys.GetValue(c_pszTimerHandlerTable).Get<Lua::Table>();
+
+      handlerTable.AddValue(iTimerId, coroutine);
+   }
+
+   spTimer->m_timer.expires_after(sleepTime);
+   spTimer->m_timer.async_wait(m_strand.wrap(
+      std::bind(&SystemLuaBindings::OnTimer, shared_from_this(),
+         std::placeholders::_1, iTimerId)));
+
+   coroutine.Get<Lua::Thread>().Yield(state, std::vector<Lua::Value>(),
+      std::bind(&SystemLuaBindings::ResumeAfterSleep, shared_from_this(),
+         std::placeholders::_1, std::placeholders::_2));
+}
+
+std::vector<Lua::Value> SystemLuaBindings::ResumeAfterSleep(Lua::State&,
+   const std::vector<Lua::Value>&)
+{
+   return std::vector<Lua::Value>();
+}
+
+/// \details The timer runs on the strand of the Lua script worker thread, so
+/// the function is called between other handlers, without blocking them.
+std::vector<Lua::Value> SystemLuaBindings::StartTimer(Lua::State& state,
+   const std::vector<Lua::Value>& vecParams, bool bRepeat)
+{
+   LPCTSTR pszFunctionName = bRepeat ? _T("Sys:setInterval()") : _T("Sys:setTimeout()");
+
+   if (vecParams.size() != 3)
+      throw Lua::Exception(CString(_T("invalid number of parameters to ")) + pszFunctionName, state.GetState(), __FILE__, __LINE__);
+
+   if (vecParams[1].GetType() != Lua::Value::typeFunction)
+      throw Lua::Exception(_T("second parameter must be the function to call"), state.GetState(), __FILE__, __LINE__);
+
+   if (vecParams[2].GetType() != Lua::Value::typeInteger &&
+      vecParams[2].GetType() != Lua::Value::typeNumber)
+      throw Lua::Exception(_T("third parameter must be the time in seconds"), state.GetState(), __FILE__, __LINE__);
+
+   double dSeconds = vecParams[2].Get<double>();
+   if (dSeconds < 0.0 || (bRepeat && dSeconds <= 0.0))
+      throw Lua::Exception(_T("time in seconds must be greater than 0"), state.GetState(), __FILE__, __LINE__);
+
+   asio::steady_timer::duration interval =
+      std::chrono::duration_cast<asio::steady_timer::duration>(std::chrono::duration<double>(dSeconds));
+
+   int iTimerId = m_iNextTimerId++;
+
+   std::shared_ptr<Timer> spTimer =
+      std::make_shared<Timer>(m_strand.context(), interval, bRepeat);
+
+   m_mapAllTimers[iTimerId] = spTimer;
+
+   // store function in handler table
+   Lua::Table sys = state.GetTable(_T("Sys"));
+   Lua::Table handlerTable = sys.GetValue(c_pszTimerHandlerTable).Get<Lua::Table>();
+
+   handlerTable.AddValue(iTimerId, vecParams[1]);
+
+   spTimer->m_timer.expires_after(interval);
+   spTimer->m_timer.async_wait(m_strand.wrap(
+      std::bind(&SystemLuaBindings::OnTimer, shared_from_this(),
+         std::placeholders::_1, iTimerId)));
+
+   std::vector<Lua::Value> vecRetValues;
+   vecRetValues.push_back(Lua::Value(iTimerId));
+
+   return vecRetValues;
+}
+
+/// \details Intervals are restarted relative to the previous expiry time, so
+/// that they don't drift when the function takes some time. An interval is
+/// stopped when its function raises an error. When the handler table contains
+/// a coroutine instead of a function, the coroutine sleeps in Sys:sleep() and
+/// is resumed.
+void SystemLuaBindings::OnTimer(const std::error_code& error, int iTimerId)
+{
+   if (error)
+      return; // timer was canceled
+
+   auto iter = m_mapAllTimers.find(iTimerId);
+   if (iter == m_mapAllTimers.end())
+      return; // timer was cleared
+
+   std::shared_ptr<Timer> spTimer = iter->second;
+
+   if (spTimer->m_bRepeat)
+   {
+      spTimer->m_timer.expires_at(spTimer->m_timer.expiry() + spTimer->m_interval);
+      spTimer->m_timer.async_wait(m_strand.wrap(
+         std::bind(&SystemLuaBindings::OnTimer, shared_from_this(),
+            std::placeholders::_1, iTimerId)));
+   }
+   else
+      m_mapAllTimers.erase(iter);
+
+   Lua::Table sys = GetState().GetTable(_T("Sys"));
+   Lua::Table handlerTable = sys.GetValue(c_pszTimerHandlerTable).Get<Lua::Table>();
+
+   Lua::Value callbackFunction = handlerTable.GetValue(iTimerId);
+
+   if (!spTimer->m_bRepeat)
+      handlerTable.AddValue(iTimerId, Lua::Value());
+
+   try
+   {
+      if (callbackFunction.GetType() == Lua::Value::typeThread)
+      {
+         Lua::Thread coroutine = callbackFunction.Get<Lua::Thread>();
+         coroutine.Resume(std::vector<Lua::Value>());
+      }
+      else
+      {
+         Lua::Function func = callbackFunction.Get<Lua::Function>();
+         func.Call();
+      }
+   }
+   catch (const Lua::Exception& ex)
+   {
+      if (m_fnOutputDebugString != nullptr)
+         m_fnOutputDebugString(ex.Message() + _T("\n"));
+
+      if (spTimer->m_bRepeat)
+      {
+         spTimer->m_timer.cancel();
+         m_mapAllTimers.erase(iTimerId);
+         handlerTable.AddValue(iTimerId, Lua::Value());
+      }
+   }
+}
+
 SystemLuaBindings::ManualResetEvent::ManualResetEvent(LuaScheduler& scheduler, asio::io_service::strand& strand)
 :m_event(false),
 m_timerWait(strand.context()),
 m_scheduler(scheduler),
-m_strand(strand)
+m_strand(strand),
+m_bWaiting(false)
 {
 }
 
@@ -121,12 +549,13 @@ void SystemLuaBindings::ManualResetEvent::InitBindings(Lua::Table& manualResetEv
 
 void SystemLuaBindings::ManualResetEvent::Cancel()
 {
+   m_bWaiting = false;
+
    m_timerWait.cancel();
-   m_timerWait.wait();
 }
 
-/// \details Just sets the event, so that waiting threads can check for it. See implementation
-/// in ManualResetEventWait() for details.
+/// \details Sets the event; when the main thread is waiting for the event,
+/// it is resumed, after the function that called signal() has returned.
 std::vector<Lua::Value> SystemLuaBindings::ManualResetEvent::Signal(Lua::State& state,
    const std::vector<Lua::Value>& vecParams)
 {
@@ -143,6 +572,9 @@ std::vector<Lua::Value> SystemLuaBindings::ManualResetEvent::Signal(Lua::State&
 
    m_event.Set();
 
+   if (m_bWaiting)
+      ResumeWaitingThread(true);
+
    return std::vector<Lua::Value>();
 }
 
@@ -167,14 +599,10 @@ std::vector<Lua::Value> SystemLuaBindings::ManualResetEvent::Reset(Lua::State& s
 }
 
 /// \details Since we use coroutines and cooperative multitasking, waiting is implemented
-/// in the following way: We wait by posting a handler to the scheduler (represented by
-/// the strand we got in ctor) using a deadline timer, and a small timeout value, e.g. 50 ms.
-/// The handler checks the event if it is set, or if the wait timeout is reached. When
-/// timeout isn't reached, another handler is dispatched, waiting again 50 ms. When the
-/// wait time is up, or the event got set, resume the thread that was yielded in this
-/// method and report the result. So basically we "poll" the event if it is set yet.
-/// This isn't really efficient, but the alternative would be to start another thread that
-/// waits for the event.
+/// in the following way: The main thread is yielded, and is resumed either by signal(),
+/// which is called by Lua code running on the same strand, e.g. an event handler, or by
+/// a timer that expires when the wait timeout is reached. No other thread is blocked, and
+/// other handlers on the strand keep running while waiting.
 /// \param[in] paramState the Lua state for parameters to this function
 /// \param[in] vecParams Lua params; [0] is the event table, and [1] (optional) is a
 /// timeout value, in seconds, to wait. If not specified, the wait is infinite.
@@ -190,7 +618,8 @@ std::vector<Lua::Value> SystemLuaBindings::ManualResetEvent::Wait(Lua::State& pa
       throw Lua::Exception(_T("first parameter must be the ManualResetEvent table"), paramState.GetState(), __FILE__, __LINE__);
 
    if (vecParams.size() == 2 &&
-      vecParams[1].GetType() != Lua::Value::typeNumber)
+      vecParams[1].GetType() != Lua::Value::typeNumber &&
+      vecParams[1].GetType() != Lua::Value::typeInteger)
       throw Lua::Exception(_T("second parameter must be the timeout value in seconds"), paramState.GetState(), __FILE__, __LINE__);
 
    Lua::Table manualResetEvent = vecParams[0].Get<Lua::Table>();
@@ -198,18 +627,39 @@ std::vector<Lua::Value> SystemLuaBindings::ManualResetEvent::Wait(Lua::State& pa
    CString cszName = manualResetEvent.GetValue(_T("__name")).Get<CString>();
    ATLASSERT(cszName == GetEventName());
 
-   DWORD dwWaitTimeout = INFINITE;
-   if (vecParams.size() == 2)
+   bool bEventIsSet;
+
+   try
    {
-      dwWaitTimeout = GetTickCount() + static_cast<DWORD>(vecParams[1].Get<double>() * 1000.0);
-      if (dwWaitTimeout == INFINITE)
-         dwWaitTimeout++; // account for accidentally adding up to INFINITE after 49 days
+      bEventIsSet = m_event.Wait(0);
+   }
+   catch (const SystemException& ex)
+   {
+      throw Exception(_T("exception while waiting for event: ") + ex.Message(),
+         __FILE__, __LINE__);
    }
 
-   // start timer
-   RestartTimer(dwWaitTimeout);
+   if (bEventIsSet)
+   {
+      std::vector<Lua::Value> vecRetValues;
+      vecRetValues.push_back(Lua::Value(true));
 
-   // yield until our wait handler resumes
+      return vecRetValues;
+   }
+
+   m_bWaiting = true;
+
+   if (vecParams.size() == 2)
+   {
+      m_timerWait.expires_after(std::chrono::duration_cast<asio::steady_timer::duration>(
+         std::chrono::duration<double>(vecParams[1].Get<double>())));
+
+      m_timerWait.async_wait(m_strand.wrap(
+         std::bind(&SystemLuaBindings::ManualResetEvent::WaitHandler, shared_from_this(),
+            std::placeholders::_1)));
+   }
+
+   // yield until signal() or our wait handler resumes
    m_scheduler.GetThread().Yield(paramState, std::vector<Lua::Value>(),
       std::bind(&SystemLuaBindings::ManualResetEvent::Resume, shared_from_this(),
          std::placeholders::_1, std::placeholders::_2));
@@ -221,70 +671,237 @@ std::vector<Lua::Value> SystemLuaBindings::ManualResetEvent::Resume(Lua::State&,
    return vecParams;
 }
 
-void SystemLuaBindings::ManualResetEvent::RestartTimer(DWORD dwWaitTimeout)
+void SystemLuaBindings::ManualResetEvent::WaitHandler(const std::error_code& error)
 {
-   m_timerWait.expires_from_now(std::chrono::milliseconds(c_uiManualResetEventPollTimeInMs));
-   m_timerWait.async_wait(m_strand.wrap(
-      std::bind(&SystemLuaBindings::ManualResetEvent::WaitHandler, shared_from_this(),
-         std::placeholders::_1, dwWaitTimeout)
-      ));
+   if (error || !m_bWaiting)
+      return; // timer was canceled, or event was signaled
+
+   ResumeWaitingThread(false);
 }
 
-void SystemLuaBindings::ManualResetEvent::WaitHandler(const std::error_code& error,
-   DWORD dwWaitTimeout)
+/// \details The thread is resumed in a separate handler, so that the code
+/// that called signal() can finish first.
+void SystemLuaBindings::ManualResetEvent::ResumeWaitingThread(bool bEventIsSet)
 {
-   if (error)
-      return; // timer was canceled
+   m_bWaiting = false;
 
-   if (m_scheduler.GetThread().Status() != Lua::Thread::statusYield)
-      return; // someone else resumed our thread already
+   m_timerWait.cancel();
 
-   bool bEventIsSet;
+   std::shared_ptr<ManualResetEvent> spThis = shared_from_this();
+   m_strand.post([spThis, bEventIsSet]()
+   {
+      if (spThis->m_scheduler.GetThread().Status() != Lua::Thread::statusYield)
+         return; // someone else resumed our thread already
 
-   try
+      std::vector<Lua::Value> vecRetvals;
+      vecRetvals.push_back(Lua::Value(bEventIsSet));
+
+      spThis->m_scheduler.ResumeMainThread(vecRetvals);
+   });
+}
+
+CString SystemLuaBindings::ManualResetEvent::GetEventName() const
+{
+   CString cszEventName;
+   cszEventName.Format(_T("event-%08p"), this);
+
+   return cszEventName;
+}
+
+SystemLuaBindings::Channel::Channel(LuaScheduler& scheduler, asio::io_service::strand& strand, size_t uiCapacity)
+:m_spChannel(std::make_shared<LuaChannel>(uiCapacity)),
+m_timerWait(strand.context()),
+m_scheduler(scheduler),
+m_strand(strand),
+m_bWaiting(false),
+m_bYielded(false),
+m_bReceived(false)
+{
+}
+
+/// \details The send handler is set here, since shared_from_this() can't be
+/// used in the ctor; this is done before the channel is passed to any
+/// spawned script.
+void SystemLuaBindings::Channel::InitBindings(Lua::Table& channel)
+{
+   std::weak_ptr<Channel> wpThis = shared_from_this();
+   m_spChannel->SetSendHandler([wpThis]()
    {
-      bEventIsSet = m_event.Wait(0);
-   }
-   catch (const SystemException& ex)
+      std::shared_ptr<Channel> spThis = wpThis.lock();
+      if (spThis != nullptr)
+         spThis->OnSend();
+   });
+
+   m_spChannel->InitBindings(channel);
+
+   channel.AddFunction("receive",
+      std::bind(&SystemLuaBindings::Channel::Receive, shared_from_this(),
+         std::placeholders::_1, std::placeholders::_2));
+}
+
+void SystemLuaBindings::Channel::Cancel()
+{
+   m_bWaiting.store(false);
+   m_timerWait.cancel();
+}
+
+/// \details The main thread is yielded, and is resumed either when a value
+/// was sent to the channel (see OnSend()), or by a timer when the timeout is
+/// reached.
+/// \param[in] paramState the Lua state for parameters to this function
+/// \param[in] vecParams Lua params; [0] is the channel table, and [1] (optional) is a
+/// timeout value, in seconds, to wait. If not specified, the wait is infinite.
+std::vector<Lua::Value> SystemLuaBindings::Channel::Receive(Lua::State& paramState,
+   const std::vector<Lua::Value>& vecParams)
+{
+   lua_State* L = paramState.GetState();
+
+   if (vecParams.size() != 1 && vecParams.size() != 2)
+      throw Lua::Exception(_T("invalid number of parameters to Channel:receive()"), L, __FILE__, __LINE__);
+
+   if (vecParams[0].GetType() != Lua::Value::typeTable)
+      throw Lua::Exception(_T("first parameter must be the Channel table"), L, __FILE__, __LINE__);
+
+   if (vecParams.size() == 2 &&
+      vecParams[1].GetType() != Lua::Value::typeNumber &&
+      vecParams[1].GetType() != Lua::Value::typeInteger)
+      throw Lua::Exception(_T("second parameter must be the timeout value in seconds"), L, __FILE__, __LINE__);
+
+   std::vector<Lua::Value> vecRetValues;
+
+   LuaChannel::SerializedValue value;
+   if (m_spChannel->TryReceive(value))
    {
-      throw Exception(_T("exception while waiting for event: ") + ex.Message(),
-         __FILE__, __LINE__);
+      vecRetValues.push_back(LuaChannel::Deserialize(paramState, value));
+      return vecRetValues;
    }
 
-   bool bResume = false;
-   if (bEventIsSet)
-      bResume = true;
-   else
+   std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+   if (vecParams.size() == 2)
    {
-      // event not set; check timeout
-      DWORD dwNow = GetTickCount();
-      if (dwWaitTimeout != INFINITE && dwNow > dwWaitTimeout)
+      double dTimeout = vecParams[1].Get<double>();
+      if (dTimeout <= 0.0)
       {
-         // timeout reached
-         bResume = true;
+         vecRetValues.push_back(Lua::Value());
+         return vecRetValues;
       }
 
-      // no timeout yet? just restart timer
+      deadline = std::chrono::steady_clock::now() +
+         std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(dTimeout));
    }
 
-   if (bResume)
+   m_bReceived = false;
+
+   // start waiting before checking the channel again, so that a value sent
+   // in the meantime isn't missed
+   m_bWaiting.store(true);
+
+   if (m_spChannel->TryReceive(value))
    {
-      m_strand.post([&]()
-      {
-         std::vector<Lua::Value> vecRetvals;
-         vecRetvals.push_back(Lua::Value(bEventIsSet));
+      m_bWaiting.store(false);
 
-         m_scheduler.ResumeMainThread(vecRetvals);
-      });
+      vecRetValues.push_back(LuaChannel::Deserialize(paramState, value));
+      return vecRetValues;
    }
+
+   if (deadline != std::chrono::steady_clock::time_point::max())
+   {
+      m_timerWait.expires_at(deadline);
+      m_timerWait.async_wait(m_strand.wrap(
+         std::bind(&SystemLuaBindings::Channel::TimeoutHandler, shared_from_this(),
+            std::placeholders::_1)));
+   }
+
+   m_bYielded = true;
+
+   // yield until our wait handler resumes
+   m_scheduler.GetThread().Yield(paramState, std::vector<Lua::Value>(),
+      std::bind(&SystemLuaBindings::Channel::Resume, shared_from_this(),
+         std::placeholders::_1, std::placeholders::_2));
+}
+
+/// \details The received value is deserialized here, since only now the
+/// thread's Lua state can be used to create tables and userdata values.
+std::vector<Lua::Value> SystemLuaBindings::Channel::Resume(Lua::State& state,
+   const std::vector<Lua::Value>&)
+{
+   std::vector<Lua::Value> vecRetValues;
+
+   if (m_bReceived)
+      vecRetValues.push_back(LuaChannel::Deserialize(state, m_receivedValue));
    else
-      RestartTimer(dwWaitTimeout);
+      vecRetValues.push_back(Lua::Value());
+
+   m_bReceived = false;
+   m_receivedValue = LuaChannel::SerializedValue();
+
+   return vecRetValues;
 }
 
-CString SystemLuaBindings::ManualResetEvent::GetEventName() const
+/// \details Only the first value sent while receive() waits posts a handler
+/// to the strand; values sent while nobody waits don't cost more than
+/// checking the flag.
+void SystemLuaBindings::Channel::OnSend()
 {
-   CString cszEventName;
-   cszEventName.Format(_T("event-%08p"), this);
+   if (!m_bWaiting.exchange(false))
+      return;
 
-   return cszEventName;
+   m_strand.post(
+      std::bind(&SystemLuaBindings::Channel::OnValueAvailable, shared_from_this()));
+}
+
+/// \details Spawned scripts may receive from the same channel, so the value
+/// may already be gone; in this case the thread keeps on waiting.
+void SystemLuaBindings::Channel::OnValueAvailable()
+{
+   if (!m_bYielded ||
+      m_scheduler.GetThread().Status() != Lua::Thread::statusYield)
+      return; // not waiting anymore, or someone else resumes our thread already
+
+   m_bReceived = m_spChannel->TryReceive(m_receivedValue);
+   if (!m_bReceived)
+   {
+      m_bWaiting.store(true);
+
+      m_bReceived = m_spChannel->TryReceive(m_receivedValue);
+      if (!m_bReceived)
+         return;
+
+      // when OnSend() posted another call in the meantime, that call returns
+      // since the thread isn't yielded anymore
+      m_bWaiting.store(false);
+   }
+
+   m_timerWait.cancel();
+
+   ResumeThread();
+}
+
+void SystemLuaBindings::Channel::TimeoutHandler(const std::error_code& error)
+{
+   if (error)
+      return; // timer was canceled
+
+   if (!m_bWaiting.exchange(false))
+      return; // a value was sent, and OnValueAvailable() resumes the thread
+
+   if (!m_bYielded ||
+      m_scheduler.GetThread().Status() != Lua::Thread::statusYield)
+      return; // not waiting anymore, or someone else resumes our thread already
+
+   // a value may have been sent just before the timeout
+   m_bReceived = m_spChannel->TryReceive(m_receivedValue);
+
+   ResumeThread();
+}
+
+void SystemLuaBindings::Channel::ResumeThread()
+{
+   m_bYielded = false;
+
+   std::shared_ptr<Channel> spThis = shared_from_this();
+   m_strand.post([spThis]()
+   {
+      spThis->m_scheduler.ResumeMainThread(std::vector<Lua::Value>());
+   });
 }
@@ -8,12 +8,14 @@
 
 // includes
 #include "Lua.hpp"
+#include "LuaChannel.hpp"
 #include <asio.hpp>
 #include <ulib/thread/Event.hpp>
 
 // forward references
 struct SystemEvent;
 class LuaScheduler;
+class LuaSpawnedState;
 
 /// Lua bindings for System library
 class SystemLuaBindings : public std::enable_shared_from_this<SystemLuaBindings>
@@ -29,9 +31,18 @@ public:
    /// the bindings, call this immediately after the ctor
    void InitBindings();
 
-   /// cancels all handlers of async operations
+   /// cancels all handlers of async operations, and stops all spawned scripts
    void CancelHandlers();
 
+   /// function type to output debug strings
+   typedef std::function<void(const CString&)> T_fnOutputDebugString;
+
+   /// sets output debug string handler; used by spawned scripts
+   void SetOutputDebugStringHandler(T_fnOutputDebugString fnOutputDebugString)
+   {
+      m_fnOutputDebugString = fnOutputDebugString;
+   }
+
 private:
    /// returns Lua state object
    Lua::State& GetState();
@@ -47,6 +58,60 @@ private:
    /// system function; creates a manual reset event that can be set and waited on
    std::vector<Lua::Value> SysCreateEvent(Lua::State& state);
 
+   /// system function; creates a channel to pass values between main script and spawned scripts
+   std::vector<Lua::Value> SysCreateChannel(Lua::State& state, const std::vector<Lua::Value>& vecParams);
+
+   /// system function; runs script source or function in a new Lua state on its own thread
+   std::vector<Lua::Value> SysSpawn(Lua::State& state, const std::vector<Lua::Value>& vecParams);
+
+   /// system function; calls function once after given time
+   std::vector<Lua::Value> SysSetTimeout(Lua::State& state, const std::vector<Lua::Value>& vecParams);
+
+   /// system function; calls function repeatedly, in given interval
+   std::vector<Lua::Value> SysSetInterval(Lua::State& state, const std::vector<Lua::Value>& vecParams);
+
+   /// system function; cancels timer started with setTimeout() or setInterval()
+   std::vector<Lua::Value> SysClearTimer(Lua::State& state, const std::vector<Lua::Value>& vecParams);
+
+   /// system function; yields the main thread or the calling coroutine for given time
+   std::vector<Lua::Value> SysSleep(Lua::State& state, const std::vector<Lua::Value>& vecParams);
+
+   // timer functions
+
+   /// starts new timer for setTimeout() and setInterval(); returns timer ID
+   std::vector<Lua::Value> StartTimer(Lua::State& state, const std::vector<Lua::Value>& vecParams, bool bRepeat);
+
+   /// timer handler; calls timer function
+   void OnTimer(const std::error_code& error, int iTimerId);
+
+   /// yields the calling coroutine, and starts a timer that resumes it
+   __declspec(noreturn)
+   void SleepCoroutine(Lua::State& state, asio::steady_timer::duration sleepTime);
+
+   /// called when main thread or coroutine is resumed after sleeping
+   std::vector<Lua::Value> ResumeAfterSleep(Lua::State& state, const std::vector<Lua::Value>& vecParams);
+
+   /// timer started by setTimeout() or setInterval()
+   struct Timer
+   {
+      /// ctor
+      Timer(asio::io_service& ioService, asio::steady_timer::duration interval, bool bRepeat)
+         :m_timer(ioService),
+         m_interval(interval),
+         m_bRepeat(bRepeat)
+      {
+      }
+
+      /// timer
+      asio::steady_timer m_timer;
+
+      /// timeout or interval
+      asio::steady_timer::duration m_interval;
+
+      /// indicates if the timer is restarted after calling the function
+      bool m_bRepeat;
+   };
+
    // manual reset event functions
 
    /// manual reset event for System library
@@ -75,11 +140,11 @@ private:
       /// called when main thread is resumed
       std::vector<Lua::Value> Resume(Lua::State& state, const std::vector<Lua::Value>& vecParams);
 
-      /// restarts timer to wait for event
-      void RestartTimer(DWORD dwWaitTimeout);
+      /// wait handler; resumes thread (yielded in wait()) when the timeout is reached
+      void WaitHandler(const std::error_code& error);
 
-      /// wait handler; checks for event state and resumes thread (yielded in wait())
-      void WaitHandler(const std::error_code& error, DWORD dwWaitTimeout);
+      /// resumes thread yielded in wait(), passing the event state
+      void ResumeWaitingThread(bool bEventIsSet);
 
       /// returns internal event name
       CString GetEventName() const;
@@ -88,14 +153,82 @@ private:
       /// actual manual-reset event
       ::ManualResetEvent m_event;
 
-      /// wait timer
-      asio::system_timer m_timerWait;
+      /// wait timeout timer
+      asio::steady_timer m_timerWait;
+
+      /// Lua scheduler
+      LuaScheduler& m_scheduler;
+
+      /// strand to execute all Lua calls on
+      asio::io_service::strand& m_strand;
+
+      /// indicates if the main thread is currently waiting for the event
+      bool m_bWaiting;
+   };
+
+   // channel functions
+
+   /// channel for System library, used by the main script
+   class Channel : public std::enable_shared_from_this<Channel>
+   {
+   public:
+      /// ctor
+      Channel(LuaScheduler& scheduler, asio::io_service::strand& strand, size_t uiCapacity);
+
+      /// returns channel shared with spawned scripts
+      std::shared_ptr<LuaChannel> GetChannel() const { return m_spChannel; }
+
+      /// init channel object in given table
+      void InitBindings(Lua::Table& channel);
+
+      /// cancels waiting for values
+      void Cancel();
+
+   private:
+      /// receives value, or nil on timeout; yields the main thread
+      std::vector<Lua::Value> Receive(Lua::State& state, const std::vector<Lua::Value>& vecParams);
+
+      /// called when main thread is resumed
+      std::vector<Lua::Value> Resume(Lua::State& state, const std::vector<Lua::Value>& vecParams);
+
+      /// called by the channel on the sending thread, after a value was sent
+      void OnSend();
+
+      /// receives sent value on the strand and resumes thread (yielded in receive())
+      void OnValueAvailable();
+
+      /// timeout handler; resumes thread (yielded in receive()) when no value was received
+      void TimeoutHandler(const std::error_code& error);
+
+      /// posts resuming the thread (yielded in receive()) to the strand
+      void ResumeThread();
+
+   private:
+      /// channel shared with spawned scripts
+      std::shared_ptr<LuaChannel> m_spChannel;
+
+      /// timer for receive() timeout
+      asio::steady_timer m_timerWait;
 
       /// Lua scheduler
       LuaScheduler& m_scheduler;
 
       /// strand to execute all Lua calls on
       asio::io_service::strand& m_strand;
+
+      /// indicates if receive() is waiting for a value; reset by the first
+      /// handler that resumes the thread
+      std::atomic<bool> m_bWaiting;
+
+      /// indicates if the thread is yielded in receive() and resuming it
+      /// wasn't posted yet; only accessed on the strand
+      bool m_bYielded;
+
+      /// indicates if the wait handler received a value
+      bool m_bReceived;
+
+      /// value received by the wait handler
+      LuaChannel::SerializedValue m_receivedValue;
    };
 
 private:
@@ -105,6 +238,24 @@ private:
    /// strand to execute all Lua calls on
    asio::io_service::strand& m_strand;
 
+   /// output debug string handler
+   T_fnOutputDebugString m_fnOutputDebugString;
+
    /// all events created by SysCreateEvent()
    std::vector<std::shared_ptr<ManualResetEvent>> m_vecAllEvents;
+
+   /// all channels created by SysCreateChannel(), by channel name
+   std::map<CString, std::shared_ptr<Channel>> m_mapAllChannels;
+
+   /// all scripts started by SysSpawn()
+   std::vector<std::shared_ptr<LuaSpawnedState>> m_vecAllSpawnedStates;
+
+   /// all active timers started by SysSetTimeout() and SysSetInterval(), by timer ID
+   std::map<int, std::shared_ptr<Timer>> m_mapAllTimers;
+
+   /// next timer ID to use
+   int m_iNextTimerId;
+
+   /// timer for SysSleep()
+   asio::steady_timer m_timerSleep;
 };
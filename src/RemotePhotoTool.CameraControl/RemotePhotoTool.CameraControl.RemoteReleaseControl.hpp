@@ -39,6 +39,7 @@ namespace RemotePhotoTool
             AFLock = 5,                   ///< supports AF lock/unlock
             BulbMode = 6,                 ///< supports bulb mode
             UILock = 7,                   ///< supports UI lock
+            BurstMode = 8,                ///< supports burst shooting, releasing while images are transferred
          };
 
          /// property event type
@@ -58,6 +59,8 @@ namespace RemotePhotoTool
             ReleaseError = 3,       ///< error while Release(), e.g. focus couldn't be determined
             BulbExposureTime = 4,   ///< signals elapsed bulb exposure time (in seconds)
             InternalError = 5,      ///< an internal error in camera occured
+            CaptureComplete = 6,    ///< image was captured; the next image can be released
+            TransferError = 7,      ///< transfer of a captured image to the host failed
             Invalid
          };
 
@@ -0,0 +1,209 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file BurstPhotoModeView.cpp Burst photo mode view
+//
+
+// includes
+#include "stdafx.h"
+#include "resource.h"
+#include "BurstPhotoModeView.hpp"
+#include "IPhotoModeViewHost.hpp"
+#include "ImageFileManager.hpp"
+#include "ShutterReleaseSettings.hpp"
+#include "CameraException.hpp"
+#include "CameraErrorDlg.hpp"
+
+/// timer ID for updating the burst status
+const UINT_PTR c_timerUpdateStatus = 1;
+
+/// update cycle time for the burst status
+const UINT c_updateStatusCycleTime = 250;
+
+/// default number of images in the download queue; the camera's own buffer
+/// may hold fewer images, and then slows down shooting earlier
+const UINT c_defaultMaxQueuedDownloads = 10;
+
+BurstPhotoModeView::BurstPhotoModeView(IPhotoModeViewHost& host)
+   :m_host(host),
+   m_maxQueuedDownloads(c_defaultMaxQueuedDownloads),
+   m_numImages(0),
+   m_isStarted(false)
+{
+}
+
+bool BurstPhotoModeView::CanClose() const
+{
+   if (!m_isStarted)
+      return true;
+
+   int iRet = AtlMessageBox(m_hWnd, _T("A burst shooting is in progress. Do you want to abort the burst?"),
+      IDR_MAINFRAME, MB_YESNO | MB_ICONQUESTION);
+
+   if (iRet == IDNO)
+      return false;
+
+   const_cast<BurstPhotoModeView&>(*this).
+      SendMessage(WM_COMMAND, MAKEWPARAM(IDC_BUTTON_BURST_STOP, 0), 0);
+
+   return true;
+}
+
+LRESULT BurstPhotoModeView::OnInitDialog(UINT /*uMsg*/, WPARAM /*wParam*/, LPARAM /*lParam*/, BOOL& /*bHandled*/)
+{
+   DoDataExchange(DDX_LOAD);
+
+   m_spRemoteReleaseControl = m_host.GetRemoteReleaseControl();
+
+   m_btnStop.EnableWindow(FALSE);
+
+   try
+   {
+      m_upBurstRelease.reset(new BurstRelease(m_spRemoteReleaseControl, m_maxQueuedDownloads));
+   }
+   catch (const CameraException& ex)
+   {
+      CameraErrorDlg dlg(_T("Couldn't start burst photo mode"), ex);
+      dlg.DoModal(m_hWnd);
+
+      m_btnStart.EnableWindow(FALSE);
+      EnableControls(false);
+   }
+
+   return TRUE;
+}
+
+LRESULT BurstPhotoModeView::OnDestroy(UINT /*uMsg*/, WPARAM /*wParam*/, LPARAM /*lParam*/, BOOL& /*bHandled*/)
+{
+   // note: don't reset default release settings; must be done in new view
+
+   KillTimer(c_timerUpdateStatus);
+
+   m_upBurstRelease.reset();
+
+   if (m_isStarted)
+      m_host.LockActionMode(false);
+
+   return 0;
+}
+
+LRESULT BurstPhotoModeView::OnTimer(UINT /*uMsg*/, WPARAM wParam, LPARAM /*lParam*/, BOOL& /*bHandled*/)
+{
+   if (wParam == c_timerUpdateStatus &&
+      !UpdateStatus())
+   {
+      KillTimer(c_timerUpdateStatus);
+
+      m_isStarted = false;
+
+      m_btnStart.EnableWindow(TRUE);
+      m_btnStop.EnableWindow(FALSE);
+      EnableControls(true);
+
+      m_host.LockActionMode(false);
+   }
+
+   return 0;
+}
+
+LRESULT BurstPhotoModeView::OnButtonStart(WORD /*wNotifyCode*/, WORD /*wID*/, HWND /*hWndCtl*/, BOOL& /*bHandled*/)
+{
+   if (!DoDataExchange(DDX_SAVE))
+      return 0;
+
+   try
+   {
+      // the queue size is passed at construction; the previous burst is
+      // destroyed first, so that its state event handler is removed
+      m_upBurstRelease.reset();
+      m_upBurstRelease.reset(new BurstRelease(m_spRemoteReleaseControl, m_maxQueuedDownloads));
+
+      ShutterReleaseSettings settings = m_host.GetReleaseSettings();
+
+      // only the folder is used; the images are stored using the camera's filenames
+      CString filename =
+         m_host.GetImageFileManager().NextFilename(imageTypeNormal);
+      settings.Filename(filename);
+
+      settings.HandlerOnFinishedTransfer(
+         std::bind(&BurstPhotoModeView::OnFinishedTransfer, this, std::placeholders::_1));
+
+      m_upBurstRelease->Start(settings, m_numImages);
+   }
+   catch (const CameraException& ex)
+   {
+      CameraErrorDlg dlg(_T("Couldn't start burst shooting"), ex);
+      dlg.DoModal(m_hWnd);
+      return 0;
+   }
+
+   m_isStarted = true;
+
+   m_host.LockActionMode(true);
+
+   m_btnStart.EnableWindow(FALSE);
+   m_btnStop.EnableWindow(TRUE);
+   EnableControls(false);
+
+   UpdateStatus();
+   SetTimer(c_timerUpdateStatus, c_updateStatusCycleTime);
+
+   return 0;
+}
+
+LRESULT BurstPhotoModeView::OnButtonStop(WORD /*wNotifyCode*/, WORD /*wID*/, HWND /*hWndCtl*/, BOOL& /*bHandled*/)
+{
+   // the timer resets the UI when the remaining images were downloaded
+   if (m_upBurstRelease != nullptr)
+      m_upBurstRelease->Stop();
+
+   m_btnStop.EnableWindow(FALSE);
+
+   return 0;
+}
+
+void BurstPhotoModeView::EnableControls(bool enable)
+{
+   GetDlgItem(IDC_EDIT_BURST_MAX_QUEUED_DOWNLOADS).EnableWindow(enable);
+   GetDlgItem(IDC_EDIT_BURST_NUM_IMAGES).EnableWindow(enable);
+}
+
+bool BurstPhotoModeView::UpdateStatus()
+{
+   BurstRelease::Status status = m_upBurstRelease->GetStatus();
+
+   CString text;
+   text.Format(
+      _T("Images: %u captured, %u downloaded, %u failed\n")
+      _T("Queued downloads: %u of %u\n")
+      _T("Frame rate: %.1f fps\n")
+      _T("Elapsed time: %.1f s"),
+      status.m_numCaptured,
+      status.m_numTransferred,
+      status.m_numFailedTransfers,
+      status.NumQueuedTransfers(),
+      status.m_maxQueuedTransfers,
+      status.m_framesPerSecond,
+      status.m_elapsedTimeInSeconds);
+
+   m_staticStatus.SetWindowText(text);
+
+   CString statusText;
+   statusText.Format(_T("Burst: %u images, %.1f fps, %u queued downloads"),
+      status.m_numCaptured,
+      status.m_framesPerSecond,
+      status.NumQueuedTransfers());
+
+   m_host.SetStatusText(statusText);
+
+   // the last release may not have been captured yet
+   bool isCapturing = status.m_numCaptured < status.m_numReleased;
+
+   return status.m_isRunning || isCapturing || status.NumQueuedTransfers() > 0;
+}
+
+void BurstPhotoModeView::OnFinishedTransfer(const ShutterReleaseSettings& settings)
+{
+   m_host.OnTransferredImage(settings.Filename());
+}
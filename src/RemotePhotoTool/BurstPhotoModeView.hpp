@@ -0,0 +1,134 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file BurstPhotoModeView.hpp Burst photo mode view
+//
+#pragma once
+
+// includes
+#include "IPhotoModeView.hpp"
+#include "BurstRelease.hpp"
+
+// forward references
+class IPhotoModeViewHost;
+
+/// \brief burst photo mode view
+/// \details Shoots images continuously at the camera's frame rate, while the
+/// captured images are downloaded; shows the sustained frame rate and the
+/// number of queued downloads while shooting.
+class BurstPhotoModeView :
+   public CDialogImpl<BurstPhotoModeView>,
+   public CWinDataExchange<BurstPhotoModeView>,
+   public IPhotoModeView
+{
+public:
+   /// ctor
+   BurstPhotoModeView(IPhotoModeViewHost& host);
+   /// dtor
+   virtual ~BurstPhotoModeView() {}
+
+   /// dialog id
+   enum { IDD = IDD_PHOTOMODE_BURST_FORM };
+
+private:
+   // virtual methods from IPhotoModeView
+
+   virtual HWND CreateView(HWND hWndParent) override
+   {
+      return CDialogImpl<BurstPhotoModeView>::Create(hWndParent);
+   }
+
+   virtual BOOL PreTranslateMessage(MSG* pMsg) override
+   {
+      return CWindow::IsDialogMessage(pMsg);
+   }
+
+   virtual bool CanClose() const override;
+
+   virtual void DestroyView() override
+   {
+      ATLVERIFY(TRUE == DestroyWindow());
+   }
+
+private:
+   // DDX map
+   BEGIN_DDX_MAP(BurstPhotoModeView)
+      DDX_CONTROL_HANDLE(IDC_BUTTON_BURST_START, m_btnStart)
+      DDX_CONTROL_HANDLE(IDC_BUTTON_BURST_STOP, m_btnStop)
+      DDX_UINT_RANGE(IDC_EDIT_BURST_MAX_QUEUED_DOWNLOADS, m_maxQueuedDownloads, 1U, 1000U)
+      DDX_UINT(IDC_EDIT_BURST_NUM_IMAGES, m_numImages)
+      DDX_CONTROL_HANDLE(IDC_STATIC_BURST_STATUS, m_staticStatus)
+   END_DDX_MAP()
+
+   // message map
+   BEGIN_MSG_MAP(BurstPhotoModeView)
+      MESSAGE_HANDLER(WM_INITDIALOG, OnInitDialog)
+      MESSAGE_HANDLER(WM_DESTROY, OnDestroy)
+      MESSAGE_HANDLER(WM_TIMER, OnTimer)
+      COMMAND_ID_HANDLER(IDC_BUTTON_BURST_START, OnButtonStart)
+      COMMAND_ID_HANDLER(IDC_BUTTON_BURST_STOP, OnButtonStop)
+      REFLECT_NOTIFICATIONS() // to make sure superclassed controls get notification messages
+   END_MSG_MAP()
+
+   // Handler prototypes (uncomment arguments if needed):
+   // LRESULT MessageHandler(UINT uMsg, WPARAM wParam, LPARAM lParam, BOOL& bHandled)
+   // LRESULT CommandHandler(WORD wNotifyCode, WORD wID, HWND hWndCtl, BOOL& bHandled)
+   // LRESULT NotifyHandler(int /*idCtrl*/, LPNMHDR /*pnmh*/, BOOL& bHandled)
+
+   /// called when dialog is being shown
+   LRESULT OnInitDialog(UINT uMsg, WPARAM wParam, LPARAM lParam, BOOL& bHandled);
+
+   /// called at destruction of dialog
+   LRESULT OnDestroy(UINT uMsg, WPARAM wParam, LPARAM lParam, BOOL& bHandled);
+
+   /// called when status update timer has elapsed
+   LRESULT OnTimer(UINT uMsg, WPARAM wParam, LPARAM lParam, BOOL& bHandled);
+
+   /// called when button "Start" is pressed
+   LRESULT OnButtonStart(WORD wNotifyCode, WORD wID, HWND hWndCtl, BOOL& bHandled);
+
+   /// called when button "Stop" is pressed
+   LRESULT OnButtonStop(WORD wNotifyCode, WORD wID, HWND hWndCtl, BOOL& bHandled);
+
+   /// enables or disables controls
+   void EnableControls(bool enable);
+
+   /// updates status text; returns false when the burst has finished
+   bool UpdateStatus();
+
+   /// called when an image was transferred; called on a camera thread
+   void OnFinishedTransfer(const ShutterReleaseSettings& settings);
+
+private:
+   /// host access
+   IPhotoModeViewHost& m_host;
+
+   // model
+
+   /// remote release control
+   std::shared_ptr<RemoteReleaseControl> m_spRemoteReleaseControl;
+
+   /// burst release
+   std::unique_ptr<BurstRelease> m_upBurstRelease;
+
+   /// maximum number of queued downloads
+   UINT m_maxQueuedDownloads;
+
+   /// number of images to take; 0 when shooting until stopped
+   UINT m_numImages;
+
+   /// indicates if a burst is in progress, including the remaining downloads
+   bool m_isStarted;
+
+   // UI
+
+   /// button to start burst shooting
+   CButton m_btnStart;
+
+   /// button to stop burst shooting
+   CButton m_btnStop;
+
+   /// static control with burst status
+   CStatic m_staticStatus;
+};
@@ -91,9 +91,11 @@ bool CameraFileSystemDropSource::TransferFiles()
       ManualResetEvent eventFinished{ false };
 
       m_draggedFilesInfo.m_cameraFileSystem->StartDownload(fileInfo,
-         [this, &eventFinished, &targetFolder](const FileInfo& fileInfo, const std::vector<unsigned char>& imageData)
+         [this, &eventFinished, &targetFolder](const FileInfo& fileInfo, const std::vector<unsigned char>& imageData, bool succeeded)
          {
-            SaveFile(fileInfo, targetFolder, imageData);
+            if (succeeded)
+               SaveFile(fileInfo, targetFolder, imageData);
+
             eventFinished.Set();
          });
 
@@ -11,9 +11,16 @@
 #include "IPhotoModeViewHost.hpp"
 #include "CameraErrorDlg.hpp"
 #include "ImageFileManager.hpp"
+#include "JpegMemoryReader.hpp"
 #include <ulib/Path.hpp>
 #include "File.hpp"
 
+/// width of thumbnail images in file list
+const int c_thumbnailWidth = 80;
+
+/// height of thumbnail images in file list
+const int c_thumbnailHeight = 60;
+
 void CameraFileSystemFileListView::Init(std::shared_ptr<CameraFileSystem> cameraFileSystem)
 {
    m_cameraFileSystem = cameraFileSystem;
@@ -26,9 +33,20 @@ void CameraFileSystemFileListView::Init(std::shared_ptr<CameraFileSystem> camera
    SetExtendedListViewStyle(dwExStyle, dwExStyle);
 
    ATLASSERT((GetStyle() & LVS_SHAREIMAGELISTS) != 0);
-   SetImageList(SystemImageList::Get(true), LVSIL_SMALL);
+   m_thumbnailImageList.Create(c_thumbnailWidth, c_thumbnailHeight, ILC_COLOR24, 0, 16);
+   SetImageList(m_thumbnailImageList, LVSIL_SMALL);
+
+   m_spPendingThumbnails = std::make_shared<PendingThumbnails>();
 
    m_host.EnableUI(ID_FILESYSTEM_DOWNLOAD, false);
+
+   // file infos may be retrieved in the background; handler is called in a worker thread
+   HWND hWnd = m_hWnd;
+   m_cameraFileSystem->SetFileInfoHandler(
+      [hWnd](const CString&, const std::vector<FileInfo>&)
+      {
+         ::PostMessage(hWnd, WM_FILESYSTEM_FILEINFO_AVAIL, 0, 0);
+      });
 }
 
 void CameraFileSystemFileListView::RefreshList()
@@ -39,6 +57,8 @@ void CameraFileSystemFileListView::RefreshList()
 
    m_mapItemIndexToFileInfo.clear();
 
+   CancelThumbnails();
+
    std::vector<FileInfo> fileInfoList = m_cameraFileSystem->EnumFiles(m_currentPath);
 
    int itemCount = 0;
@@ -49,34 +69,283 @@ void CameraFileSystemFileListView::RefreshList()
       if (pos != -1)
          filename = filename.Mid(pos + 1);
 
-      int itemIndex = InsertItem(itemCount++, filename, SystemImageList::IndexFromFilename(fileInfo.m_filename));
+      int itemIndex = InsertItem(itemCount++, filename, GetFileTypeImageIndex(fileInfo.m_filename));
 
-      CString sizeText;
-      sizeText.Format(_T("%u"), fileInfo.m_fileSize);
-      for (int charIndex = sizeText.GetLength() - 3; charIndex >= 0; charIndex -= 3)
-         sizeText.Insert(charIndex, _T("."));
+      SetItemFileInfoText(itemIndex, fileInfo);
 
-      SetItemText(itemIndex, 1, sizeText);
+      SetItemData(itemIndex, itemIndex);
 
-      CString timeText{ _T("???") };
-      if (fileInfo.m_modifiedTime != -1)
+      m_mapItemIndexToFileInfo[itemIndex] = fileInfo;
+   }
+
+   SetRedraw(TRUE);
+
+   RequestThumbnails();
+}
+
+/// \details Requests with the same priority are processed newest first, so
+/// the items are requested from the bottom up, in order to get the thumbnails
+/// of the first files first.
+void CameraFileSystemFileListView::RequestThumbnails()
+{
+   std::shared_ptr<PendingThumbnails> spPendingThumbnails = m_spPendingThumbnails;
+   HWND hWnd = m_hWnd;
+
+   // handler is called in a worker thread; the JPEG image is decoded there, too
+   CameraFileSystem::T_fnThumbnailAvailable fnThumbnailAvailable =
+      [spPendingThumbnails, hWnd](const FileInfo& fileInfo, const std::vector<unsigned char>& data)
       {
-         struct tm modifiedTime = {};
-         if (0 == localtime_s(&modifiedTime, &fileInfo.m_modifiedTime))
+         if (data.empty())
+            return; // file has no thumbnail; keep file type icon
+
+         JpegMemoryReader jpegReader(data);
+
+         try
+         {
+            jpegReader.Read();
+         }
+         catch (...)
+         {
+            ATLTRACE(_T("Couldn't decode thumbnail of file: %s\n"), fileInfo.m_filename.GetString());
+            return;
+         }
+
+         DecodedThumbnail thumbnail;
+         thumbnail.m_filename = fileInfo.m_filename;
+         thumbnail.m_bitmapData.swap(jpegReader.BitmapData());
+         thumbnail.m_width = jpegReader.ImageInfo().Width();
+         thumbnail.m_height = jpegReader.ImageInfo().Height();
+
          {
-            _tcsftime(timeText.GetBuffer(32), 32, _T("%Y-%m-%d %H:%M:%S"), &modifiedTime);
-            timeText.ReleaseBuffer();
+            LightweightMutex::LockType lock(spPendingThumbnails->m_mutex);
+            spPendingThumbnails->m_thumbnailList.push_back(std::move(thumbnail));
          }
+
+         ::PostMessage(hWnd, WM_FILESYSTEM_THUMBNAIL_AVAIL, 0, 0);
+      };
+
+   int firstVisibleIndex = GetTopIndex();
+   int lastVisibleIndex = firstVisibleIndex + GetCountPerPage();
+
+   for (auto iter = m_mapItemIndexToFileInfo.rbegin(); iter != m_mapItemIndexToFileInfo.rend(); ++iter)
+   {
+      int itemIndex = iter->first;
+      bool isVisible = itemIndex >= firstVisibleIndex && itemIndex <= lastVisibleIndex;
+
+      m_cameraFileSystem->GetThumbnail(iter->second, fnThumbnailAvailable,
+         isVisible ? CameraFileSystem::thumbnailPriorityNormal : CameraFileSystem::thumbnailPriorityLow);
+   }
+}
+
+/// \details Thumbnail requests that were already started still call the
+/// handler; these thumbnails are ignored when no item with the filename is
+/// shown anymore.
+void CameraFileSystemFileListView::CancelThumbnails()
+{
+   m_cameraFileSystem->CancelThumbnailRequests();
+
+   {
+      LightweightMutex::LockType lock(m_spPendingThumbnails->m_mutex);
+      m_spPendingThumbnails->m_thumbnailList.clear();
+   }
+
+   m_thumbnailImageList.RemoveAll();
+   m_mapSystemImageIndexToImageIndex.clear();
+}
+
+/// \details The small system icon of the file type is drawn centered into a
+/// thumbnail sized image, which is added to the image list only once per file
+/// type.
+int CameraFileSystemFileListView::GetFileTypeImageIndex(const CString& filename)
+{
+   int systemImageIndex = SystemImageList::IndexFromFilename(filename);
+
+   auto iter = m_mapSystemImageIndexToImageIndex.find(systemImageIndex);
+   if (iter != m_mapSystemImageIndexToImageIndex.end())
+      return iter->second;
+
+   CClientDC clientDC(m_hWnd);
+
+   CDC dc;
+   dc.CreateCompatibleDC(clientDC);
+
+   CBitmap bmpImage;
+   bmpImage.CreateCompatibleBitmap(clientDC, c_thumbnailWidth, c_thumbnailHeight);
+
+   HBITMAP hOldBitmap = dc.SelectBitmap(bmpImage);
+
+   CRect rcImage(0, 0, c_thumbnailWidth, c_thumbnailHeight);
+   dc.FillRect(rcImage, COLOR_WINDOW);
+
+   CPoint ptIcon(
+      (c_thumbnailWidth - GetSystemMetrics(SM_CXSMICON)) / 2,
+      (c_thumbnailHeight - GetSystemMetrics(SM_CYSMICON)) / 2);
+
+   SystemImageList::Get(true).Draw(dc, systemImageIndex, ptIcon, ILD_NORMAL);
+
+   dc.SelectBitmap(hOldBitmap);
+
+   int imageIndex = m_thumbnailImageList.Add(bmpImage);
+
+   m_mapSystemImageIndexToImageIndex[systemImageIndex] = imageIndex;
+
+   return imageIndex;
+}
+
+/// \details The bitmap data is a top-down 24-bit DIB, as decoded by
+/// JpegMemoryReader; the image is scaled to fit the thumbnail size, keeping
+/// the aspect ratio.
+int CameraFileSystemFileListView::AddThumbnailImage(const std::vector<BYTE>& bitmapData, unsigned int width, unsigned int height)
+{
+   if (width == 0 || height == 0 || bitmapData.empty())
+      return -1;
+
+   BITMAPINFO bi = {0};
+
+   BITMAPINFOHEADER& bih = bi.bmiHeader;
+   bih.biSize = sizeof(bih);
+   bih.biBitCount = 24;
+   bih.biClrUsed = 0;
+   bih.biCompression = BI_RGB;
+   bih.biPlanes = 1;
+
+   bih.biHeight = -static_cast<LONG>(height); // negative, since bytes represent a top-bottom DIB
+   bih.biWidth = width;
+
+   int destWidth = c_thumbnailWidth;
+   int destHeight = MulDiv(height, c_thumbnailWidth, width);
+   if (destHeight > c_thumbnailHeight)
+   {
+      destHeight = c_thumbnailHeight;
+      destWidth = MulDiv(width, c_thumbnailHeight, height);
+   }
+
+   CClientDC clientDC(m_hWnd);
+
+   CDC dc;
+   dc.CreateCompatibleDC(clientDC);
+
+   CBitmap bmpImage;
+   bmpImage.CreateCompatibleBitmap(clientDC, c_thumbnailWidth, c_thumbnailHeight);
+
+   HBITMAP hOldBitmap = dc.SelectBitmap(bmpImage);
+
+   CRect rcImage(0, 0, c_thumbnailWidth, c_thumbnailHeight);
+   dc.FillRect(rcImage, COLOR_WINDOW);
+
+   dc.SetStretchBltMode(HALFTONE);
+   dc.SetBrushOrg(0, 0);
+
+   dc.StretchDIBits(
+      (c_thumbnailWidth - destWidth) / 2, (c_thumbnailHeight - destHeight) / 2, destWidth, destHeight,
+      0, 0, width, height,
+      bitmapData.data(), &bi, DIB_RGB_COLORS, SRCCOPY);
+
+   dc.SelectBitmap(hOldBitmap);
+
+   return m_thumbnailImageList.Add(bmpImage);
+}
+
+void CameraFileSystemFileListView::SetItemFileInfoText(int itemIndex, const FileInfo& fileInfo)
+{
+   if (fileInfo.m_isInfoPending)
+   {
+      SetItemText(itemIndex, 1, _T(""));
+      SetItemText(itemIndex, 2, _T(""));
+      return;
+   }
+
+   CString sizeText;
+   sizeText.Format(_T("%I64u"), fileInfo.m_fileSize);
+   for (int charIndex = sizeText.GetLength() - 3; charIndex > 0; charIndex -= 3)
+      sizeText.Insert(charIndex, _T("."));
+
+   SetItemText(itemIndex, 1, sizeText);
+
+   CString timeText{ _T("???") };
+   if (fileInfo.m_modifiedTime != -1)
+   {
+      struct tm modifiedTime = {};
+      if (0 == localtime_s(&modifiedTime, &fileInfo.m_modifiedTime))
+      {
+         _tcsftime(timeText.GetBuffer(32), 32, _T("%Y-%m-%d %H:%M:%S"), &modifiedTime);
+         timeText.ReleaseBuffer();
       }
+   }
 
-      SetItemText(itemIndex, 2, timeText);
+   SetItemText(itemIndex, 2, timeText);
+}
 
-      SetItemData(itemIndex, itemIndex);
+/// \details handles WM_FILESYSTEM_FILEINFO_AVAIL message; the file list is
+/// listed again, which is cheap since it's cached, and only the items with
+/// changed file infos are updated, so that the selection is kept.
+LRESULT CameraFileSystemFileListView::OnMessageFileInfoAvailable(UINT /*uMsg*/, WPARAM /*wParam*/, LPARAM /*lParam*/, BOOL& /*bHandled*/)
+{
+   std::vector<FileInfo> fileInfoList = m_cameraFileSystem->EnumFiles(m_currentPath);
 
-      m_mapItemIndexToFileInfo[itemIndex] = fileInfo;
+   std::map<CString, const FileInfo*> mapFilenameToFileInfo;
+   for (const FileInfo& fileInfo : fileInfoList)
+      mapFilenameToFileInfo[fileInfo.m_filename] = &fileInfo;
+
+   for (auto& iter : m_mapItemIndexToFileInfo)
+   {
+      FileInfo& itemFileInfo = iter.second;
+      if (!itemFileInfo.m_isInfoPending)
+         continue;
+
+      auto iterFileInfo = mapFilenameToFileInfo.find(itemFileInfo.m_filename);
+      if (iterFileInfo == mapFilenameToFileInfo.end() ||
+         iterFileInfo->second->m_isInfoPending)
+         continue;
+
+      itemFileInfo = *iterFileInfo->second;
+      SetItemFileInfoText(iter.first, itemFileInfo);
    }
 
-   SetRedraw(TRUE);
+   return 0;
+}
+
+/// \details handles WM_FILESYSTEM_THUMBNAIL_AVAIL message; the decoded
+/// thumbnails are added to the image list and shown for the items with the
+/// same filename. Thumbnails of files from a previously shown folder are
+/// ignored.
+LRESULT CameraFileSystemFileListView::OnMessageThumbnailAvailable(UINT /*uMsg*/, WPARAM /*wParam*/, LPARAM /*lParam*/, BOOL& /*bHandled*/)
+{
+   std::vector<DecodedThumbnail> thumbnailList;
+
+   {
+      LightweightMutex::LockType lock(m_spPendingThumbnails->m_mutex);
+      thumbnailList.swap(m_spPendingThumbnails->m_thumbnailList);
+   }
+
+   if (thumbnailList.empty())
+      return 0; // already processed by a previous message
+
+   std::map<CString, int> mapFilenameToItemIndex;
+   for (const auto& iter : m_mapItemIndexToFileInfo)
+      mapFilenameToItemIndex[iter.second.m_filename] = iter.first;
+
+   for (const DecodedThumbnail& thumbnail : thumbnailList)
+   {
+      auto iterItem = mapFilenameToItemIndex.find(thumbnail.m_filename);
+      if (iterItem == mapFilenameToItemIndex.end())
+         continue;
+
+      int imageIndex = AddThumbnailImage(thumbnail.m_bitmapData, thumbnail.m_width, thumbnail.m_height);
+      if (imageIndex != -1)
+         SetItem(iterItem->second, 0, LVIF_IMAGE, nullptr, imageIndex, 0, 0, 0);
+   }
+
+   return 0;
+}
+
+LRESULT CameraFileSystemFileListView::OnDestroy(UINT /*uMsg*/, WPARAM /*wParam*/, LPARAM /*lParam*/, BOOL& bHandled)
+{
+   if (m_cameraFileSystem != nullptr)
+      m_cameraFileSystem->CancelThumbnailRequests();
+
+   bHandled = FALSE;
+   return 0;
 }
 
 void CameraFileSystemFileListView::NavigateToPath(const CString& path)
@@ -158,7 +427,8 @@ void CameraFileSystemFileListView::DownloadFiles(const std::vector<FileInfo>& fi
       try
       {
          m_cameraFileSystem->StartDownload(fileInfo,
-            std::bind(&CameraFileSystemFileListView::OnDownloadFinished, this, std::placeholders::_1, std::placeholders::_2));
+            std::bind(&CameraFileSystemFileListView::OnDownloadFinished, this,
+               std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
       }
       catch (const CameraException& ex)
       {
@@ -174,8 +444,14 @@ void CameraFileSystemFileListView::DownloadFiles(const std::vector<FileInfo>& fi
    waitCursor.Restore();
 }
 
-void CameraFileSystemFileListView::OnDownloadFinished(const FileInfo& fileInfo, const std::vector<unsigned char>& data)
+void CameraFileSystemFileListView::OnDownloadFinished(const FileInfo& fileInfo, const std::vector<unsigned char>& data,
+   bool succeeded)
 {
+   if (!succeeded)
+   {
+      ATLTRACE(_T("Couldn't download file: %s\n"), fileInfo.m_filename.GetString());
+      return;
+   }
    ImageFileManager& mgr = m_host.GetImageFileManager();
 
    CString nextFilename = mgr.NextFilename(T_enImageType::imageTypeNormal, fileInfo.m_modifiedTime, false);
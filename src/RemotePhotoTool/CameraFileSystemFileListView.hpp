@@ -8,6 +8,7 @@
 
 #include "resource.h"
 #include <CameraFileSystem.hpp>
+#include <ulib/thread/LightweightMutex.hpp>
 
 class IPhotoModeViewHost;
 class CameraFileSystemTreeView;
@@ -56,6 +57,9 @@ private:
       NOTIFY_CODE_HANDLER(LVN_ITEMCHANGED, OnItemChanged)
       COMMAND_ID_HANDLER(ID_FILESYSTEM_DOWNLOAD, OnFileSystemDownload)
       NOTIFY_CODE_HANDLER(LVN_BEGINDRAG, OnBeginDrag)
+      MESSAGE_HANDLER(WM_FILESYSTEM_FILEINFO_AVAIL, OnMessageFileInfoAvailable)
+      MESSAGE_HANDLER(WM_FILESYSTEM_THUMBNAIL_AVAIL, OnMessageThumbnailAvailable)
+      MESSAGE_HANDLER(WM_DESTROY, OnDestroy)
    END_MSG_MAP()
 
    // Handler prototypes (uncomment arguments if needed):
@@ -72,11 +76,35 @@ private:
    /// called when a file is started to be dragged, e.g. out of this app
    LRESULT OnBeginDrag(int idCtrl, LPNMHDR pnmh, BOOL& bHandled);
 
+   /// called when the camera file system has retrieved pending file infos
+   LRESULT OnMessageFileInfoAvailable(UINT uMsg, WPARAM wParam, LPARAM lParam, BOOL& bHandled);
+
+   /// called when thumbnails were retrieved and decoded
+   LRESULT OnMessageThumbnailAvailable(UINT uMsg, WPARAM wParam, LPARAM lParam, BOOL& bHandled);
+
+   /// called when the list view is destroyed
+   LRESULT OnDestroy(UINT uMsg, WPARAM wParam, LPARAM lParam, BOOL& bHandled);
+
+   /// requests thumbnails of all files in the list; visible files first
+   void RequestThumbnails();
+
+   /// cancels thumbnail requests and discards thumbnails not shown yet
+   void CancelThumbnails();
+
+   /// returns image list index of the file type icon, used until the thumbnail is available
+   int GetFileTypeImageIndex(const CString& filename);
+
+   /// adds image to thumbnail image list, scaled to fit and centered; returns image list index
+   int AddThumbnailImage(const std::vector<BYTE>& bitmapData, unsigned int width, unsigned int height);
+
+   /// sets size and modified date texts of item
+   void SetItemFileInfoText(int itemIndex, const FileInfo& fileInfo);
+
    /// downloads all files in the background
    void DownloadFiles(const std::vector<FileInfo>& fileInfoList);
 
    /// called when download has finished
-   void OnDownloadFinished(const FileInfo& fileInfo, const std::vector<unsigned char>& data);
+   void OnDownloadFinished(const FileInfo& fileInfo, const std::vector<unsigned char>& data, bool succeeded);
 
 private:
    // UI
@@ -97,4 +125,39 @@ private:
 
    /// mapping from list view item index to file info object
    std::map<int, FileInfo> m_mapItemIndexToFileInfo;
+
+   /// decoded thumbnail, waiting to be shown
+   struct DecodedThumbnail
+   {
+      /// filename of thumbnail's file
+      CString m_filename;
+
+      /// bitmap data; RGB bytes, with padded scanlines
+      std::vector<BYTE> m_bitmapData;
+
+      /// bitmap width
+      unsigned int m_width = 0;
+
+      /// bitmap height
+      unsigned int m_height = 0;
+   };
+
+   /// thumbnails decoded by the camera file system's worker thread
+   struct PendingThumbnails
+   {
+      /// mutex to protect thumbnail list
+      LightweightMutex m_mutex;
+
+      /// list of decoded thumbnails
+      std::vector<DecodedThumbnail> m_thumbnailList;
+   };
+
+   /// pending thumbnails; shared with thumbnail handlers, which may be called after the view is gone
+   std::shared_ptr<PendingThumbnails> m_spPendingThumbnails;
+
+   /// image list with file type icons and thumbnails
+   CImageListManaged m_thumbnailImageList;
+
+   /// mapping from system image list index to file type icon index in thumbnail image list
+   std::map<int, int> m_mapSystemImageIndexToImageIndex;
 };
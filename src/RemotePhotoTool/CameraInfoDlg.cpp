@@ -157,6 +157,10 @@ void CameraInfoDlg::CollectCapabilities(std::shared_ptr<RemoteReleaseControl> sp
    cszText += spRemoteReleaseControl->GetCapability(RemoteReleaseControl::capUILock) ? _T("Yes") : _T("NO");
    cszText += _T("\n");
 
+   cszText += _T("- can shoot bursts while transferring images: ");
+   cszText += spRemoteReleaseControl->GetCapability(RemoteReleaseControl::capBurstMode) ? _T("Yes") : _T("NO");
+   cszText += _T("\n");
+
    cszText += _T("\n");
 }
 
@@ -123,9 +123,9 @@ LRESULT HDRPanoramaPhotoModeView::OnButtonAEB(WORD /*wNotifyCode*/, WORD /*wID*/
    return 0;
 }
 
-LRESULT HDRPanoramaPhotoModeView::OnMessageHDRAEBNext(UINT /*uMsg*/, WPARAM /*wParam*/, LPARAM /*lParam*/, BOOL& /*bHandled*/)
+LRESULT HDRPanoramaPhotoModeView::OnMessageHDRAEBNext(UINT /*uMsg*/, WPARAM wParam, LPARAM /*lParam*/, BOOL& /*bHandled*/)
 {
-   m_manager.ReleaseAEBNext();
+   m_manager.OnCapturedAEB(wParam);
    return 0;
 }
 
@@ -133,11 +133,17 @@ LRESULT HDRPanoramaPhotoModeView::OnMessageHDRAEBLast(UINT /*uMsg*/, WPARAM /*wP
 {
    m_host.LockActionMode(false);
 
-   m_manager.OnReleasedAEBLast();
+   m_manager.OnFinishedAEB();
 
    return 0;
 }
 
+LRESULT HDRPanoramaPhotoModeView::OnMessageHDRAEBTransferred(UINT /*uMsg*/, WPARAM wParam, LPARAM /*lParam*/, BOOL& /*bHandled*/)
+{
+   m_manager.OnTransferredAEB(wParam);
+   return 0;
+}
+
 void HDRPanoramaPhotoModeView::UpdateAEBShutterSpeedList()
 {
    int iItem = m_cbAEBBracketedShots.GetCurSel();
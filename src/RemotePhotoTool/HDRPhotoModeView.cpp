@@ -123,9 +123,9 @@ LRESULT HDRPhotoModeView::OnButtonAEB(WORD /*wNotifyCode*/, WORD /*wID*/, HWND /
    return 0;
 }
 
-LRESULT HDRPhotoModeView::OnMessageHDRAEBNext(UINT /*uMsg*/, WPARAM /*wParam*/, LPARAM /*lParam*/, BOOL& /*bHandled*/)
+LRESULT HDRPhotoModeView::OnMessageHDRAEBNext(UINT /*uMsg*/, WPARAM wParam, LPARAM /*lParam*/, BOOL& /*bHandled*/)
 {
-   m_manager.ReleaseAEBNext();
+   m_manager.OnCapturedAEB(wParam);
    return 0;
 }
 
@@ -133,11 +133,17 @@ LRESULT HDRPhotoModeView::OnMessageHDRAEBLast(UINT /*uMsg*/, WPARAM /*wParam*/,
 {
    m_host.LockActionMode(false);
 
-   m_manager.OnReleasedAEBLast();
+   m_manager.OnFinishedAEB();
 
    return 0;
 }
 
+LRESULT HDRPhotoModeView::OnMessageHDRAEBTransferred(UINT /*uMsg*/, WPARAM wParam, LPARAM /*lParam*/, BOOL& /*bHandled*/)
+{
+   m_manager.OnTransferredAEB(wParam);
+   return 0;
+}
+
 void HDRPhotoModeView::UpdateAEBShutterSpeedList()
 {
    int iItem = m_cbAEBBracketedShots.GetCurSel();
@@ -63,6 +63,7 @@ private:
       COMMAND_ID_HANDLER(ID_CAMERA_RELEASE, OnButtonAEB)
       MESSAGE_HANDLER(WM_HDR_AEB_NEXT, OnMessageHDRAEBNext)
       MESSAGE_HANDLER(WM_HDR_AEB_LAST, OnMessageHDRAEBLast)
+      MESSAGE_HANDLER(WM_HDR_AEB_TRANSFERRED, OnMessageHDRAEBTransferred)
       REFLECT_NOTIFICATIONS() // to make sure superclassed controls get notification messages
    END_MSG_MAP()
 
@@ -85,6 +86,8 @@ private:
    LRESULT OnMessageHDRAEBNext(UINT uMsg, WPARAM wParam, LPARAM lParam, BOOL& bHandled);
    /// called when custom message "AEB last" is received
    LRESULT OnMessageHDRAEBLast(UINT uMsg, WPARAM wParam, LPARAM lParam, BOOL& bHandled);
+   /// called when custom message "AEB transferred" is received
+   LRESULT OnMessageHDRAEBTransferred(UINT uMsg, WPARAM wParam, LPARAM lParam, BOOL& bHandled);
 
    /// called when property has changed
    void OnUpdatedProperty(RemoteReleaseControl::T_enPropertyEvent enPropertyEvent, unsigned int uiValue);
@@ -37,7 +37,7 @@ void ImagePropertyCombobox::UpdateValuesList()
 
    try
    {
-      m_spRemoteReleaseControl->EnumImagePropertyValues(m_uiPropertyId, m_vecValues);
+      m_vecValues = m_spRemoteReleaseControl->GetCachedImagePropertyValues(m_uiPropertyId)->Values();
    }
    catch (const CameraException& ex)
    {
@@ -96,7 +96,7 @@ public:
 
       try
       {
-         m_spRemoteReleaseControl->EnumImagePropertyValues(m_uiPropertyId, m_vecValues);
+         m_vecValues = m_spRemoteReleaseControl->GetCachedImagePropertyValues(m_uiPropertyId)->Values();
       }
       catch (CameraException& ex)
       {
@@ -0,0 +1,246 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file LiveViewMotionTrigger.cpp Live view motion trigger
+//
+
+// includes
+#include "stdafx.h"
+#include "LiveViewMotionTrigger.hpp"
+#include "Logging.hpp"
+
+/// returns milliseconds between two time points
+static double MillisecondsBetween(std::chrono::steady_clock::time_point start,
+   std::chrono::steady_clock::time_point end)
+{
+   return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+LiveViewMotionTrigger::LiveViewMotionTrigger(std::shared_ptr<RemoteReleaseControl> spRemoteReleaseControl,
+   std::shared_ptr<Viewfinder> spViewfinder)
+   :m_spRemoteReleaseControl(spRemoteReleaseControl),
+   m_spViewfinder(spViewfinder),
+   m_isStarted(false),
+   m_holdOffTime(0),
+   m_frameCount(0),
+   m_isReleasePending(false),
+   m_releaseEvent(false),
+   m_isReleaseThreadFinished(false)
+{
+}
+
+LiveViewMotionTrigger::~LiveViewMotionTrigger()
+{
+   try
+   {
+      Stop();
+   }
+   catch (...)
+   {
+   }
+}
+
+void LiveViewMotionTrigger::Start(const MotionDetectorOptions& options, unsigned int holdOffTimeInMs,
+   T_fnOnTriggered fnOnTriggered,
+   Viewfinder::T_fnOnAvailViewfinderImage fnForwardImage)
+{
+   {
+      LightweightMutex::LockType lock{ m_mutex };
+
+      m_detector = LiveViewMotionDetector(options);
+      m_holdOffTime = std::chrono::milliseconds(holdOffTimeInMs);
+      m_lastReleaseTime = std::chrono::steady_clock::time_point();
+      m_frameCount = 0;
+      m_spTriggeredHandler = std::make_shared<TriggeredHandler>();
+      m_spTriggeredHandler->m_fnOnTriggered = fnOnTriggered;
+      m_fnForwardImage = fnForwardImage;
+      m_isReleasePending = false;
+   }
+
+   // start release thread before the first frame arrives, so that the
+   // release path is ready when motion is detected
+   if (!m_releaseThread.joinable())
+   {
+      m_isReleaseThreadFinished = false;
+      m_releaseThread = std::thread(std::bind(&LiveViewMotionTrigger::RunReleaseThread, this));
+   }
+
+   m_isStarted = true;
+
+   m_spViewfinder->SetAvailImageHandler(
+      std::bind(&LiveViewMotionTrigger::OnAvailViewfinderImage, this, std::placeholders::_1));
+}
+
+void LiveViewMotionTrigger::Stop()
+{
+   if (m_isStarted)
+   {
+      m_isStarted = false;
+
+      // restore forwarding, so that e.g. the viewfinder window keeps getting images
+      Viewfinder::T_fnOnAvailViewfinderImage fnForwardImage;
+      std::shared_ptr<TriggeredHandler> spTriggeredHandler;
+      {
+         LightweightMutex::LockType lock{ m_mutex };
+         fnForwardImage = m_fnForwardImage;
+         spTriggeredHandler.swap(m_spTriggeredHandler);
+
+         m_fnForwardImage = nullptr;
+         m_isReleasePending = false;
+      }
+
+      // releases that send their release command later don't report anymore
+      if (spTriggeredHandler != nullptr)
+      {
+         LightweightMutex::LockType lock{ spTriggeredHandler->m_mutex };
+         spTriggeredHandler->m_fnOnTriggered = nullptr;
+      }
+
+      m_spViewfinder->SetAvailImageHandler(fnForwardImage);
+   }
+
+   if (m_releaseThread.joinable())
+   {
+      m_isReleaseThreadFinished = true;
+      m_releaseEvent.Set();
+
+      m_releaseThread.join();
+   }
+}
+
+void LiveViewMotionTrigger::OnAvailViewfinderImage(const std::vector<BYTE>& imageData)
+{
+   auto frameArrivalTime = std::chrono::steady_clock::now();
+
+   bool releaseRequested = false;
+   if (m_isStarted)
+   {
+      LightweightMutex::LockType lock{ m_mutex };
+
+      m_frameCount++;
+
+      bool detected = false;
+      try
+      {
+         detected = m_detector.ProcessFrame(imageData);
+      }
+      catch (const Exception& ex)
+      {
+         LOG_TRACE(_T("LiveViewMotionTrigger: couldn't decode live view image: %s\n"), ex.Message().GetString());
+      }
+      catch (const std::exception& ex)
+      {
+         LOG_TRACE(_T("LiveViewMotionTrigger: couldn't decode live view image: %hs\n"), ex.what());
+      }
+
+      if (detected &&
+         !m_isReleasePending &&
+         frameArrivalTime - m_lastReleaseTime >= m_holdOffTime)
+      {
+         // only record the trigger here; the release thread does the release
+         m_isReleasePending = true;
+         m_pendingFrameArrivalTime = frameArrivalTime;
+         m_pendingDetectedTime = std::chrono::steady_clock::now();
+
+         m_pendingInfo.m_changedArea = m_detector.LastChangedArea();
+         m_pendingInfo.m_frameCount = m_frameCount;
+
+         releaseRequested = true;
+      }
+   }
+
+   if (releaseRequested)
+      m_releaseEvent.Set();
+
+   // forward after detection, so that displaying doesn't add latency
+   Viewfinder::T_fnOnAvailViewfinderImage fnForwardImage;
+   {
+      LightweightMutex::LockType lock{ m_mutex };
+      fnForwardImage = m_fnForwardImage;
+   }
+
+   if (fnForwardImage != nullptr)
+      fnForwardImage(imageData);
+}
+
+void LiveViewMotionTrigger::RunReleaseThread()
+{
+   for (;;)
+   {
+      m_releaseEvent.Wait();
+
+      if (m_isReleaseThreadFinished)
+         break;
+
+      TriggerRelease();
+   }
+}
+
+/// \details Runs on the release thread; the mutex is only held to copy the
+/// pending trigger info, so that the viewfinder thread can continue
+/// processing frames while the release command is sent. The release latency
+/// is taken when the release command was sent to the camera, not when
+/// ReleaseOnTrigger() returns, since most cameras only queue the release.
+void LiveViewMotionTrigger::TriggerRelease()
+{
+   MotionTriggerInfo info;
+   std::chrono::steady_clock::time_point frameArrivalTime, detectedTime;
+   std::shared_ptr<TriggeredHandler> spTriggeredHandler;
+   {
+      LightweightMutex::LockType lock{ m_mutex };
+
+      if (!m_isReleasePending || m_spTriggeredHandler == nullptr)
+         return;
+
+      info = m_pendingInfo;
+      frameArrivalTime = m_pendingFrameArrivalTime;
+      detectedTime = m_pendingDetectedTime;
+      spTriggeredHandler = m_spTriggeredHandler;
+   }
+
+   bool released = true;
+   try
+   {
+      m_spRemoteReleaseControl->ReleaseOnTrigger(
+         []() { return true; },
+         [spTriggeredHandler, info, frameArrivalTime, detectedTime]()
+         {
+            ReportTriggered(*spTriggeredHandler, info, frameArrivalTime, detectedTime);
+         });
+   }
+   catch (const CameraException& ex)
+   {
+      LOG_TRACE(_T("LiveViewMotionTrigger: couldn't release shutter: %s\n"), ex.Message().GetString());
+      released = false;
+   }
+
+   LightweightMutex::LockType lock{ m_mutex };
+
+   m_isReleasePending = false;
+
+   if (released)
+      m_lastReleaseTime = std::chrono::steady_clock::now();
+}
+
+void LiveViewMotionTrigger::ReportTriggered(TriggeredHandler& triggeredHandler, MotionTriggerInfo info,
+   std::chrono::steady_clock::time_point frameArrivalTime,
+   std::chrono::steady_clock::time_point detectedTime)
+{
+   auto commandSentTime = std::chrono::steady_clock::now();
+
+   info.m_detectLatencyInMs = MillisecondsBetween(frameArrivalTime, detectedTime);
+   info.m_releaseLatencyInMs = MillisecondsBetween(frameArrivalTime, commandSentTime);
+
+   LOG_TRACE(_T("LiveViewMotionTrigger: released at frame %u, changed area %.1f%%, detect latency %.1f ms, release latency %.1f ms\n"),
+      info.m_frameCount,
+      info.m_changedArea * 100.0,
+      info.m_detectLatencyInMs,
+      info.m_releaseLatencyInMs);
+
+   // the lock ensures that the handler isn't called anymore when Stop() returned
+   LightweightMutex::LockType lock{ triggeredHandler.m_mutex };
+
+   if (triggeredHandler.m_fnOnTriggered != nullptr)
+      triggeredHandler.m_fnOnTriggered(info);
+}
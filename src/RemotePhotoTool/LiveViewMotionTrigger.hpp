@@ -0,0 +1,152 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file LiveViewMotionTrigger.hpp Live view motion trigger
+//
+#pragma once
+
+// includes
+#include "LiveViewMotionDetector.hpp"
+#include <ulib/thread/LightweightMutex.hpp>
+#include <ulib/thread/Event.hpp>
+#include <chrono>
+#include <thread>
+
+class RemoteReleaseControl;
+class Viewfinder;
+
+/// info about a release that was triggered by motion
+struct MotionTriggerInfo
+{
+   /// fraction of changed pixels in region that caused the trigger
+   double m_changedArea = 0.0;
+
+   /// time from frame arrival until motion was detected, in milliseconds
+   double m_detectLatencyInMs = 0.0;
+
+   /// time from frame arrival until the release command was sent to the camera, in milliseconds
+   double m_releaseLatencyInMs = 0.0;
+
+   /// number of live view frames processed so far
+   unsigned int m_frameCount = 0;
+};
+
+/// \brief Triggers shutter release when motion is detected in live view
+/// \details Hooks into the viewfinder image handler and runs the motion
+/// detector directly on the thread delivering the live view images. The
+/// shutter is released from a release thread that is started with the
+/// trigger and waits on an event, so that neither the viewfinder thread nor
+/// the UI thread is blocked by the release, and no thread has to be created
+/// when motion is detected. Release settings have to be set before starting
+/// the trigger.
+class LiveViewMotionTrigger
+{
+public:
+   /// function type that is called after a triggered release
+   typedef std::function<void(const MotionTriggerInfo& info)> T_fnOnTriggered;
+
+   /// ctor
+   LiveViewMotionTrigger(std::shared_ptr<RemoteReleaseControl> spRemoteReleaseControl,
+      std::shared_ptr<Viewfinder> spViewfinder);
+
+   /// dtor
+   ~LiveViewMotionTrigger();
+
+   /// returns if motion trigger is started
+   bool IsStarted() const { return m_isStarted; }
+
+   /// \brief starts motion trigger
+   /// \param options motion detector options
+   /// \param holdOffTimeInMs time after a release in which no other release is triggered
+   /// \param fnOnTriggered function that is called after a triggered release; called
+   ///        on the thread that sent the release command to the camera, so post to
+   ///        the UI thread when necessary
+   /// \param fnForwardImage function that receives all viewfinder images, e.g. to
+   ///        further display them in a window; may be empty
+   void Start(const MotionDetectorOptions& options, unsigned int holdOffTimeInMs,
+      T_fnOnTriggered fnOnTriggered,
+      Viewfinder::T_fnOnAvailViewfinderImage fnForwardImage = Viewfinder::T_fnOnAvailViewfinderImage());
+
+   /// stops motion trigger
+   void Stop();
+
+private:
+   /// called when a new viewfinder image is available
+   void OnAvailViewfinderImage(const std::vector<BYTE>& imageData);
+
+   /// runs release thread
+   void RunReleaseThread();
+
+   /// releases shutter; called on the release thread
+   void TriggerRelease();
+
+   /// handler called after triggered release; shared with releases that
+   /// haven't sent their release command yet, which may finish after the
+   /// trigger was stopped
+   struct TriggeredHandler
+   {
+      /// mutex to protect handler function
+      LightweightMutex m_mutex;
+
+      /// handler function; reset when the trigger is stopped
+      T_fnOnTriggered m_fnOnTriggered;
+   };
+
+   /// reports the trigger; called when the release command was sent
+   static void ReportTriggered(TriggeredHandler& triggeredHandler, MotionTriggerInfo info,
+      std::chrono::steady_clock::time_point frameArrivalTime,
+      std::chrono::steady_clock::time_point detectedTime);
+
+private:
+   /// remote release control
+   std::shared_ptr<RemoteReleaseControl> m_spRemoteReleaseControl;
+
+   /// viewfinder
+   std::shared_ptr<Viewfinder> m_spViewfinder;
+
+   /// mutex to protect detector and handler functions
+   LightweightMutex m_mutex;
+
+   /// motion detector
+   LiveViewMotionDetector m_detector;
+
+   /// indicates if trigger is started
+   std::atomic<bool> m_isStarted;
+
+   /// hold off time after release
+   std::chrono::milliseconds m_holdOffTime;
+
+   /// time of last release
+   std::chrono::steady_clock::time_point m_lastReleaseTime;
+
+   /// number of frames processed since start
+   unsigned int m_frameCount;
+
+   /// handler called after triggered release
+   std::shared_ptr<TriggeredHandler> m_spTriggeredHandler;
+
+   /// handler to forward images to
+   Viewfinder::T_fnOnAvailViewfinderImage m_fnForwardImage;
+
+   /// indicates that a release was requested and not yet carried out
+   bool m_isReleasePending;
+
+   /// info about the pending release; latencies are filled in by the release thread
+   MotionTriggerInfo m_pendingInfo;
+
+   /// arrival time of the frame that caused the pending release
+   std::chrono::steady_clock::time_point m_pendingFrameArrivalTime;
+
+   /// time when motion was detected in that frame
+   std::chrono::steady_clock::time_point m_pendingDetectedTime;
+
+   /// event that wakes up the release thread
+   AutoResetEvent m_releaseEvent;
+
+   /// indicates that the release thread should exit
+   std::atomic<bool> m_isReleaseThreadFinished;
+
+   /// release thread; waits for m_releaseEvent while trigger is started
+   std::thread m_releaseThread;
+};
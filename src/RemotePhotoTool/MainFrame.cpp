@@ -340,6 +340,7 @@ LRESULT MainFrame::OnPhotoMode(WORD /*wNotifyCode*/, WORD wID, HWND /*hWndCtl*/,
    case ID_PHOTO_MODE_HDR_PANO:     enViewType = T_enViewType::viewHDRPanorama; break;
    case ID_PHOTO_MODE_TIMELAPSE:    enViewType = T_enViewType::viewTimeLapse; break;
    case ID_PHOTO_MODE_PHOTOSTACK:   enViewType = T_enViewType::viewPhotoStacking; break;
+   case ID_PHOTO_MODE_BURST:        enViewType = T_enViewType::viewBurst; break;
    case ID_PHOTO_MODE_SCRIPTING:    enViewType = T_enViewType::viewScripting; break;
    case ID_PHOTO_MODE_DEVICE_PROPERTIES:  enViewType = T_enViewType::viewDeviceProperties; break;
    case ID_PHOTO_MODE_IMAGE_PROPERTIES:   enViewType = T_enViewType::viewImageProperties; break;
@@ -1014,6 +1015,12 @@ void MainFrame::EnablePhotoModes(bool isConnected, bool hasReleaseControl)
       m_connection.GetSourceDevice()->GetDeviceCapability(SourceDevice::capCameraFileSystem);
 
    UIEnable(ID_PHOTO_MODE_CAMERA_FILE_SYSTEM, enableCameraFileSystem);
+
+   bool enableBurst =
+      hasReleaseControl &&
+      m_connection.GetRemoteReleaseControl()->GetCapability(RemoteReleaseControl::capBurstMode);
+
+   UIEnable(ID_PHOTO_MODE_BURST, enableBurst);
 }
 
 void MainFrame::EnableViewfinder(bool bEnable)
@@ -1047,6 +1054,7 @@ void MainFrame::EnableViewfinderCommands(bool bEnable)
    UIEnable(ID_VIEWFINDER_SHOW_OVEREXPOSED, bEnable);
    UIEnable(ID_VIEWFINDER_SHOW_OVERLAY_IMAGE, bEnable);
    UIEnable(ID_VIEWFINDER_HISTOGRAM, bEnable);
+   UIEnable(ID_VIEWFINDER_MOTION_TRIGGER, bEnable);
 }
 
 void MainFrame::EnableScriptingUI(bool bScripting)
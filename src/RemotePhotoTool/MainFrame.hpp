@@ -77,6 +77,7 @@ private:
       UPDATE_ELEMENT(ID_PHOTO_MODE_HDR_PANO, UPDUI_MENUPOPUP | UPDUI_RIBBON)
       UPDATE_ELEMENT(ID_PHOTO_MODE_TIMELAPSE, UPDUI_MENUPOPUP | UPDUI_RIBBON)
       UPDATE_ELEMENT(ID_PHOTO_MODE_PHOTOSTACK, UPDUI_MENUPOPUP | UPDUI_RIBBON)
+      UPDATE_ELEMENT(ID_PHOTO_MODE_BURST, UPDUI_MENUPOPUP | UPDUI_RIBBON)
       UPDATE_ELEMENT(ID_PHOTO_MODE_SCRIPTING, UPDUI_MENUPOPUP | UPDUI_RIBBON)
       UPDATE_ELEMENT(ID_PHOTO_MODE_DEVICE_PROPERTIES, UPDUI_MENUPOPUP | UPDUI_RIBBON)
       UPDATE_ELEMENT(ID_PHOTO_MODE_IMAGE_PROPERTIES, UPDUI_MENUPOPUP | UPDUI_RIBBON)
@@ -114,6 +115,7 @@ private:
       UPDATE_ELEMENT(ID_VIEWFINDER_SHOW_OVEREXPOSED, UPDUI_MENUPOPUP | UPDUI_RIBBON)
       UPDATE_ELEMENT(ID_VIEWFINDER_SHOW_OVERLAY_IMAGE, UPDUI_MENUPOPUP | UPDUI_RIBBON)
       UPDATE_ELEMENT(ID_VIEWFINDER_HISTOGRAM, UPDUI_MENUPOPUP | UPDUI_RIBBON)
+      UPDATE_ELEMENT(ID_VIEWFINDER_MOTION_TRIGGER, UPDUI_MENUPOPUP | UPDUI_RIBBON)
 
       UPDATE_ELEMENT(ID_SCRIPTING_OPEN, UPDUI_MENUPOPUP | UPDUI_RIBBON)
       UPDATE_ELEMENT(ID_SCRIPTING_RELOAD, UPDUI_MENUPOPUP | UPDUI_RIBBON)
@@ -142,6 +144,7 @@ private:
       COMMAND_ID_HANDLER(ID_HOME_CONNECT, OnHomeConnect)
       COMMAND_ID_HANDLER(ID_HOME_SETTINGS, OnHomeSettings)
       COMMAND_RANGE_HANDLER(ID_PHOTO_MODE_NORMAL, ID_PHOTO_MODE_CAMERA_FILE_SYSTEM, OnPhotoMode)
+      COMMAND_ID_HANDLER(ID_PHOTO_MODE_BURST, OnPhotoMode)
       COMMAND_ID_HANDLER(ID_VIEWFINDER_SHOW, OnViewfinderShow)
       RIBBON_GALLERY_CONTROL_HANDLER(ID_CAMERA_SETTINGS_SAVETO, OnCameraSettingsSaveToSelChanged)
       COMMAND_RANGE_HANDLER(ID_CAMERA_SETTINGS_SAVETO_CAMERA, ID_CAMERA_SETTINGS_SAVETO_BOTH, OnCameraSettingsSaveToRange)
@@ -19,11 +19,19 @@
 #include "ShutterSpeedValue.hpp"
 #include "HuginInterface.hpp"
 #include "TimeLapseScheduler.hpp"
+#include "Logging.hpp"
 
 //
 // HDRPhotoModeManager
 //
 
+HDRPhotoModeManager::~HDRPhotoModeManager()
+{
+   // the view may be closed while a bracket is still in progress
+   if (m_iStateEventHandlerId != -1)
+      m_spRemoteReleaseControl->RemoveStateEventHandler(m_iStateEventHandlerId);
+}
+
 bool HDRPhotoModeManager::Init(std::shared_ptr<RemoteReleaseControl> spRemoteReleaseControl)
 {
    m_spRemoteReleaseControl = spRemoteReleaseControl;
@@ -87,13 +95,21 @@ bool HDRPhotoModeManager::CheckManualMode()
    return true;
 }
 
-void HDRPhotoModeManager::OnReleasedAEBLast()
+void HDRPhotoModeManager::OnFinishedAEB()
 {
+   m_spRemoteReleaseControl->RemoveStateEventHandler(m_iStateEventHandlerId);
+   m_iStateEventHandlerId = -1;
+
    // close viewfinder, if used at all
    m_spViewfinder.reset();
 
    m_bAEBInProgress = false;
 
+   CString cszBracketTimes = FormatBracketTimes();
+   LOG_TRACE(_T("HDR bracket: %s\n"), cszBracketTimes.GetString());
+
+   m_host.SetStatusText(cszBracketTimes);
+
    // now send images to Photomatix
    PhotomatixInterface pi(m_host.GetAppSettings().m_cszPhotomatixPath);
    if (!pi.IsInstalled())
@@ -102,7 +118,7 @@ void HDRPhotoModeManager::OnReleasedAEBLast()
       return;
    }
 
-   m_host.SetStatusText(_T("Starting Photomatix..."));
+   m_host.SetStatusText(cszBracketTimes + _T("; starting Photomatix..."));
 
    pi.RunUI(m_vecAEBFilenameList);
 
@@ -184,9 +200,42 @@ void HDRPhotoModeManager::ReleaseAEBFirst()
       m_host.LockActionMode(true);
 
    m_bAEBInProgress = true;
-   m_vecAEBFilenameList.clear();
    m_uiCurrentAEBShutterSpeed = 0;
 
+   // all per-image lists are sized up front, so that the camera threads can
+   // write the entries by sequence number while the UI thread releases
+   size_t uiNumShots = m_vecAEBShutterSpeedValues.size();
+   m_vecAEBFilenameList.assign(uiNumShots, CString());
+   m_vecCaptureTimes.assign(uiNumShots, std::chrono::steady_clock::time_point());
+   m_vecTransferTimes.assign(uiNumShots, std::chrono::steady_clock::time_point());
+
+   m_bTransferAEBImages =
+      (m_host.GetReleaseSettings().SaveTarget() & ShutterReleaseSettings::saveToHost) != 0;
+
+   m_bReleaseOnCaptureComplete =
+      m_spRemoteReleaseControl->GetCapability(RemoteReleaseControl::capBurstMode);
+
+   m_vecAEBReleaseSettings.clear();
+   for (size_t uiSequenceNumber = 0; uiSequenceNumber < uiNumShots; uiSequenceNumber++)
+   {
+      ShutterReleaseSettings settings = m_host.GetReleaseSettings();
+
+      settings.HandlerOnFinishedTransfer(
+         std::bind(&HDRPhotoModeManager::OnFinishedTransferAEB, this, std::placeholders::_1, uiSequenceNumber));
+
+      settings.Filename(
+         m_host.GetImageFileManager().NextFilename(imageTypeHDR, uiSequenceNumber == 0));
+
+      m_vecAEBReleaseSettings.push_back(settings);
+   }
+
+   m_uiNumCapturedAEBImages = 0;
+   m_uiNumCaptureMessages = 0;
+   m_uiNumTransferMessages = 0;
+
+   m_iStateEventHandlerId = m_spRemoteReleaseControl->AddStateEventHandler(
+      std::bind(&HDRPhotoModeManager::OnStateEvent, this, std::placeholders::_1, std::placeholders::_2));
+
    if (m_spRemoteReleaseControl->GetCapability(RemoteReleaseControl::capViewfinder) &&
       !m_bViewfinderActiveBeforeStart)
    {
@@ -203,70 +252,206 @@ void HDRPhotoModeManager::ReleaseAEBFirst()
       }
    }
 
+   m_startTime = std::chrono::steady_clock::now();
+
    ReleaseAEBNext();
 }
 
+/// \details For cameras with burst mode, the next image was already released
+/// in the camera thread. The next image is released here for other cameras,
+/// and when releasing failed in the camera thread.
+void HDRPhotoModeManager::OnCapturedAEB(size_t uiSequenceNumber)
+{
+   ATLASSERT(uiSequenceNumber == m_uiNumCaptureMessages);
+
+   m_uiNumCaptureMessages++;
+
+   size_t uiNumReleased = m_uiCurrentAEBShutterSpeed;
+   if (uiNumReleased == uiSequenceNumber + 1 &&
+      uiNumReleased < m_vecAEBShutterSpeedValues.size())
+      ReleaseAEBNext();
+   else if (uiNumReleased > uiSequenceNumber + 1)
+      SetReleaseStatusText(uiSequenceNumber + 1);
+
+   CheckFinishedAEB();
+}
+
+void HDRPhotoModeManager::OnTransferredAEB(size_t uiSequenceNumber)
+{
+   UNUSED(uiSequenceNumber);
+   ATLASSERT(uiSequenceNumber < m_vecAEBFilenameList.size());
+
+   m_uiNumTransferMessages++;
+
+   CheckFinishedAEB();
+}
+
 void HDRPhotoModeManager::ReleaseAEBNext()
 {
-   // called when shutter speed was changed successfully
-   bool bLastShot = m_uiCurrentAEBShutterSpeed + 1 == m_vecAEBShutterSpeedValues.size();
+   size_t uiSequenceNumber = m_uiCurrentAEBShutterSpeed;
 
-   ShutterReleaseSettings& settings = m_host.GetReleaseSettings();
+   SetReleaseStatusText(uiSequenceNumber);
 
-   settings.HandlerOnFinishedTransfer(
-      bLastShot ?
-      std::bind(&HDRPhotoModeManager::OnFinishedTransferLastAEB, this, std::placeholders::_1) :
-      std::bind(&HDRPhotoModeManager::OnFinishedTransferNextAEB, this, std::placeholders::_1));
+   try
+   {
+      ReleaseAEB(uiSequenceNumber);
+   }
+   catch (CameraException& ex)
+   {
+      CameraErrorDlg dlg(_T("Couldn't release AEB shutter"), ex);
+      dlg.DoModal(m_hWnd);
+   }
+}
 
-   CString cszFilename =
-      m_host.GetImageFileManager().NextFilename(imageTypeHDR, m_uiCurrentAEBShutterSpeed == 0);
-   settings.Filename(cszFilename);
+/// \details The camera takes the release settings when the image is
+/// captured, so the settings of the next image can already be set while the
+/// previous image is transferred. The image is counted as released before
+/// Release() is called, since the camera thread may already release the next
+/// image when this image was captured.
+void HDRPhotoModeManager::ReleaseAEB(size_t uiSequenceNumber)
+{
+   m_spRemoteReleaseControl->SetReleaseSettings(m_vecAEBReleaseSettings[uiSequenceNumber]);
 
-   m_spRemoteReleaseControl->SetReleaseSettings(settings);
+   m_spRemoteReleaseControl->SetImageProperty(m_vecAEBShutterSpeedValues[uiSequenceNumber]);
 
-   // set status text
+   m_uiCurrentAEBShutterSpeed = uiSequenceNumber + 1;
+
+   try
+   {
+      m_spRemoteReleaseControl->Release();
+   }
+   catch (...)
+   {
+      m_uiCurrentAEBShutterSpeed = uiSequenceNumber;
+      throw;
+   }
+}
+
+void HDRPhotoModeManager::SetReleaseStatusText(size_t uiSequenceNumber)
+{
    CString cszText;
    cszText.Format(_T("Taking picture %Iu of %Iu with shutter speed %s"),
-      m_uiCurrentAEBShutterSpeed + 1,
+      uiSequenceNumber + 1,
       m_vecAEBShutterSpeedValues.size(),
-      m_vecAEBShutterSpeedValues[m_uiCurrentAEBShutterSpeed].AsString().GetString());
+      m_vecAEBShutterSpeedValues[uiSequenceNumber].AsString().GetString());
    m_host.SetStatusText(cszText);
+}
 
-   try
+void HDRPhotoModeManager::CheckFinishedAEB()
+{
+   size_t uiNumShots = m_vecAEBShutterSpeedValues.size();
+
+   if (m_uiNumCaptureMessages == uiNumShots &&
+      (!m_bTransferAEBImages || m_uiNumTransferMessages == uiNumShots))
    {
-      m_spRemoteReleaseControl->SetImageProperty(m_vecAEBShutterSpeedValues[m_uiCurrentAEBShutterSpeed]);
+      PostMessage(m_hWnd, WM_HDR_AEB_LAST, 0, 0);
+   }
+}
 
-      m_spRemoteReleaseControl->Release();
+/// \details The gaps are the times between capturing two consecutive images;
+/// they show how long the scene could change between the exposures.
+CString HDRPhotoModeManager::FormatBracketTimes() const
+{
+   auto fnSeconds = [](std::chrono::steady_clock::duration duration)
+   {
+      return std::chrono::duration<double>(duration).count();
+   };
+
+   size_t uiNumShots = m_vecCaptureTimes.size();
+   if (uiNumShots == 0)
+      return CString();
+
+   CString cszText;
+   cszText.Format(_T("Bracket of %Iu shots captured in %.2f s"),
+      uiNumShots,
+      fnSeconds(m_vecCaptureTimes.back() - m_startTime));
 
-      m_uiCurrentAEBShutterSpeed++;
+   if (uiNumShots > 1)
+   {
+      CString cszGaps;
+      for (size_t uiIndex = 1; uiIndex < uiNumShots; uiIndex++)
+      {
+         CString cszGap;
+         cszGap.Format(_T("%s%.2f"),
+            uiIndex == 1 ? _T("") : _T("/"),
+            fnSeconds(m_vecCaptureTimes[uiIndex] - m_vecCaptureTimes[uiIndex - 1]));
+
+         cszGaps += cszGap;
+      }
+
+      cszText.AppendFormat(_T(", gaps %s s"), cszGaps.GetString());
    }
-   catch (CameraException& ex)
+
+   if (m_bTransferAEBImages)
    {
-      CameraErrorDlg dlg(_T("Couldn't release AEB shutter"), ex);
-      dlg.DoModal(m_hWnd);
+      auto lastTransferTime = *std::max_element(m_vecTransferTimes.begin(), m_vecTransferTimes.end());
+
+      cszText.AppendFormat(_T(", transferred in %.2f s"),
+         fnSeconds(lastTransferTime - m_startTime));
    }
+
+   return cszText;
 }
 
-void HDRPhotoModeManager::OnFinishedTransferNextAEB(const ShutterReleaseSettings& settings)
+void HDRPhotoModeManager::OnStateEvent(RemoteReleaseControl::T_enStateEvent enStateEvent, unsigned int uiExtraData)
 {
-   // save filename for further processing
-   CString cszFilename = settings.Filename();
-   m_vecAEBFilenameList.push_back(cszFilename);
+   UNUSED(uiExtraData);
 
-   ATLASSERT(m_uiCurrentAEBShutterSpeed < m_vecAEBShutterSpeedValues.size());
+   if (enStateEvent != RemoteReleaseControl::stateEventCaptureComplete)
+      return;
 
-   PostMessage(m_hWnd, WM_HDR_AEB_NEXT, 0, 0);
+   // ignore images captured after the last bracketed image, e.g. when the
+   // shutter release button on the camera was pressed
+   size_t uiSequenceNumber = m_uiNumCapturedAEBImages;
+   if (uiSequenceNumber < m_vecCaptureTimes.size())
+      MarkCapturedAEB(uiSequenceNumber, m_bReleaseOnCaptureComplete);
 }
 
-void HDRPhotoModeManager::OnFinishedTransferLastAEB(const ShutterReleaseSettings& settings)
+/// \details Cameras that don't send stateEventCaptureComplete, and transfer
+/// the image as part of the release, mark the image as captured when it was
+/// transferred. The image is only marked once, and only when all previous
+/// images were marked. The next image is released before WM_HDR_AEB_NEXT is
+/// posted, so that on the camera's release thread the release is queued
+/// before the transfer of this image; when releasing fails here, the UI
+/// thread releases the image again and shows the error.
+void HDRPhotoModeManager::MarkCapturedAEB(size_t uiSequenceNumber, bool bReleaseNext)
 {
+   size_t uiExpectedNumCaptured = uiSequenceNumber;
+   if (!m_uiNumCapturedAEBImages.compare_exchange_strong(uiExpectedNumCaptured, uiSequenceNumber + 1))
+      return;
+
+   m_vecCaptureTimes[uiSequenceNumber] = std::chrono::steady_clock::now();
+
+   if (bReleaseNext && uiSequenceNumber + 1 < m_vecAEBReleaseSettings.size())
+   {
+      try
+      {
+         ReleaseAEB(uiSequenceNumber + 1);
+      }
+      catch (const CameraException& ex)
+      {
+         LOG_TRACE(_T("Couldn't release AEB image %Iu in camera thread: %s\n"),
+            uiSequenceNumber + 1, ex.Message().GetString());
+      }
+   }
+
+   PostMessage(m_hWnd, WM_HDR_AEB_NEXT, uiSequenceNumber, 0);
+}
+
+void HDRPhotoModeManager::OnFinishedTransferAEB(const ShutterReleaseSettings& settings, size_t uiSequenceNumber)
+{
+   ATLASSERT(uiSequenceNumber < m_vecAEBFilenameList.size());
+
    // save filename for further processing
    CString cszFilename = settings.Filename();
-   m_vecAEBFilenameList.push_back(cszFilename);
+   m_vecAEBFilenameList[uiSequenceNumber] = cszFilename;
+   m_vecTransferTimes[uiSequenceNumber] = std::chrono::steady_clock::now();
 
    m_host.OnTransferredImage(cszFilename);
 
-   PostMessage(m_hWnd, WM_HDR_AEB_LAST, 0, 0);
+   MarkCapturedAEB(uiSequenceNumber, false);
+
+   PostMessage(m_hWnd, WM_HDR_AEB_TRANSFERRED, uiSequenceNumber, 0);
 }
 
 //
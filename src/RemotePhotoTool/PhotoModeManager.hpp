@@ -8,7 +8,9 @@
 
 // includes
 #include "ImageProperty.hpp"
+#include "ShutterReleaseSettings.hpp"
 #include <ATLComTime.h>
+#include <chrono>
 
 // forward references
 class IPhotoModeViewHost;
@@ -17,14 +19,26 @@ class Viewfinder;
 class ShutterReleaseSettings;
 class TimeLapseScheduler;
 
-/// message sent when next HDR image can be captured
+/// message sent when an HDR image was captured and the next image can be
+/// released; wParam is the sequence number of the captured image
 #define WM_HDR_AEB_NEXT (WM_USER+1)
 
-/// message sent when last HDR image was captured
+/// message sent when all HDR images were captured and transferred
 #define WM_HDR_AEB_LAST (WM_USER+2)
 
+/// message sent when an HDR image was transferred; wParam is the sequence
+/// number of the transferred image
+#define WM_HDR_AEB_TRANSFERRED (WM_USER+3)
 
-/// HDR photo mode manager
+
+/// \brief HDR photo mode manager
+/// \details The bracketed images are taken pipelined: the next image is
+/// released as soon as the camera reports that the current image was
+/// captured, while earlier images are still transferred. Cameras that
+/// support burst mode report the capture on their release thread; the next
+/// image is released right in the state event handler there, so that the
+/// release is queued before the transfer of the captured image. Each image
+/// has a sequence number, starting at 0, that is used to track the transfers.
 class HDRPhotoModeManager
 {
 public:
@@ -34,10 +48,19 @@ public:
       m_hWnd(hWnd),
       m_bAEBInProgress(false),
       m_bViewfinderActiveBeforeStart(false),
-      m_uiCurrentAEBShutterSpeed(0)
+      m_uiCurrentAEBShutterSpeed(0),
+      m_bReleaseOnCaptureComplete(false),
+      m_iStateEventHandlerId(-1),
+      m_bTransferAEBImages(false),
+      m_uiNumCapturedAEBImages(0),
+      m_uiNumCaptureMessages(0),
+      m_uiNumTransferMessages(0)
    {
    }
 
+   /// dtor
+   ~HDRPhotoModeManager();
+
    /// inits photo manager
    bool Init(std::shared_ptr<RemoteReleaseControl> spRemoteReleaseControl);
 
@@ -56,18 +79,41 @@ public:
    /// releases remote control for first AEB image
    void ReleaseAEBFirst();
 
+   /// called when AEB image with given sequence number was captured; releases next AEB image
+   void OnCapturedAEB(size_t uiSequenceNumber);
+
+   /// called when AEB image with given sequence number was transferred
+   void OnTransferredAEB(size_t uiSequenceNumber);
+
+   /// called when all AEB images were captured and transferred
+   void OnFinishedAEB();
+
+private:
    /// releases remote control for next AEB image
    void ReleaseAEBNext();
 
-   /// called on last AEB release
-   void OnReleasedAEBLast();
+   /// sets shutter speed and release settings of AEB image with given
+   /// sequence number, and releases it; may be called in a camera thread
+   void ReleaseAEB(size_t uiSequenceNumber);
 
-private:
-   /// called when next AEB image has finished transfer
-   void OnFinishedTransferNextAEB(const ShutterReleaseSettings& settings);
+   /// shows status text for AEB image with given sequence number
+   void SetReleaseStatusText(size_t uiSequenceNumber);
+
+   /// posts WM_HDR_AEB_LAST when all AEB images were captured and transferred
+   void CheckFinishedAEB();
+
+   /// formats capture times of the last bracket, for the status bar
+   CString FormatBracketTimes() const;
+
+   /// camera state event handler; called in a camera thread
+   void OnStateEvent(RemoteReleaseControl::T_enStateEvent enStateEvent, unsigned int uiExtraData);
+
+   /// marks AEB image with given sequence number as captured, and releases
+   /// the next image when requested; called in a camera thread
+   void MarkCapturedAEB(size_t uiSequenceNumber, bool bReleaseNext);
 
-   /// called when last AEB image has finished transfer
-   void OnFinishedTransferLastAEB(const ShutterReleaseSettings& settings);
+   /// called when AEB image with given sequence number has finished transfer; called in a camera thread
+   void OnFinishedTransferAEB(const ShutterReleaseSettings& settings, size_t uiSequenceNumber);
 
 private:
    /// host access
@@ -88,14 +134,47 @@ private:
    /// indicates if viewfinder was active before start
    bool m_bViewfinderActiveBeforeStart;
 
-   /// indicates index of current shutter speed, from m_vecAEBShutterSpeedValues
-   size_t m_uiCurrentAEBShutterSpeed;
+   /// indicates index of current shutter speed, from m_vecAEBShutterSpeedValues;
+   /// this is also the number of AEB images released so far; written by the
+   /// UI thread or a camera thread
+   std::atomic<size_t> m_uiCurrentAEBShutterSpeed;
 
    /// shutter speed values for AEB shots
    std::vector<ImageProperty> m_vecAEBShutterSpeedValues;
 
-   /// filenames of bracketed shots
+   /// release settings of AEB shots, by sequence number; set up before the
+   /// first release, so that camera threads don't access the host's settings
+   std::vector<ShutterReleaseSettings> m_vecAEBReleaseSettings;
+
+   /// indicates if the next AEB image is released in the state event handler
+   bool m_bReleaseOnCaptureComplete;
+
+   /// filenames of bracketed shots, by sequence number
    std::vector<CString> m_vecAEBFilenameList;
+
+   /// handler id for state events
+   int m_iStateEventHandlerId;
+
+   /// indicates if the AEB images are transferred to the host
+   bool m_bTransferAEBImages;
+
+   /// number of AEB images captured; written by camera threads
+   std::atomic<size_t> m_uiNumCapturedAEBImages;
+
+   /// number of WM_HDR_AEB_NEXT messages processed
+   size_t m_uiNumCaptureMessages;
+
+   /// number of WM_HDR_AEB_TRANSFERRED messages processed
+   size_t m_uiNumTransferMessages;
+
+   /// time when the first AEB image was released
+   std::chrono::steady_clock::time_point m_startTime;
+
+   /// times when the AEB images were captured, by sequence number
+   std::vector<std::chrono::steady_clock::time_point> m_vecCaptureTimes;
+
+   /// times when the AEB images were transferred, by sequence number
+   std::vector<std::chrono::steady_clock::time_point> m_vecTransferTimes;
 };
 
 
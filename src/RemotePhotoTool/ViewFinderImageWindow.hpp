@@ -45,6 +45,12 @@ public:
    /// enables or disables updates to the viewfinder window
    void EnableUpdate(bool bEnable);
 
+   /// returns handler that shows viewfinder images in this window
+   Viewfinder::T_fnOnAvailViewfinderImage GetAvailImageHandler()
+   {
+      return std::bind(&ViewFinderImageWindow::OnAvailViewfinderImage, this, std::placeholders::_1);
+   }
+
    DECLARE_WND_CLASS_EX(NULL, CS_HREDRAW | CS_VREDRAW, COLOR_APPWORKSPACE)
 
 private:
@@ -13,12 +13,14 @@
 #include "RemoteReleaseControl.hpp"
 #include "CameraException.hpp"
 #include "CameraErrorDlg.hpp"
+#include "WindowMessages.hpp"
 
 ViewFinderView::ViewFinderView(IPhotoModeViewHost& host, std::shared_ptr<RemoteReleaseControl> spRemoteReleaseControl)
 :m_host(host),
  m_spRemoteReleaseControl(spRemoteReleaseControl),
  m_bShowZebraPattern(false),
- m_bShowHistogram(false)
+ m_bShowHistogram(false),
+ m_bMotionTriggerEnabled(false)
 {
 }
 
@@ -26,14 +28,32 @@ void ViewFinderView::SetViewfinder(std::shared_ptr<Viewfinder> spViewfinder)
 {
    ATLASSERT(m_upViewFinderWindow != nullptr);
 
+   StopMotionTrigger();
+
    m_upViewFinderWindow->SetViewfinder(spViewfinder);
+   m_spViewfinder = spViewfinder;
+
+   if (spViewfinder == nullptr)
+      m_bMotionTriggerEnabled = false;
+   else
+      if (m_bMotionTriggerEnabled)
+         StartMotionTrigger();
 }
 
+/// \details The viewfinder window sets its own image handler when updates
+/// are enabled, so the motion trigger is stopped while updates are disabled
+/// and hooked in again afterwards.
 void ViewFinderView::EnableUpdate(bool bEnable)
 {
    ATLASSERT(m_upViewFinderWindow != nullptr);
 
+   if (!bEnable)
+      StopMotionTrigger();
+
    m_upViewFinderWindow->EnableUpdate(bEnable);
+
+   if (bEnable && m_bMotionTriggerEnabled)
+      StartMotionTrigger();
 }
 
 void ViewFinderView::AutoFocus()
@@ -96,6 +116,8 @@ LRESULT ViewFinderView::OnInitDialog(UINT /*uMsg*/, WPARAM /*wParam*/, LPARAM /*
 
 LRESULT ViewFinderView::OnDestroy(UINT /*uMsg*/, WPARAM /*wParam*/, LPARAM /*lParam*/, BOOL& /*bHandled*/)
 {
+   StopMotionTrigger();
+
    m_upViewFinderWindow.reset();
 
    return 0;
@@ -173,6 +195,82 @@ LRESULT ViewFinderView::OnViewfinderShowOverexposed(WORD /*wNotifyCode*/, WORD /
    return 0;
 }
 
+LRESULT ViewFinderView::OnViewfinderMotionTrigger(WORD /*wNotifyCode*/, WORD /*wID*/, HWND /*hWndCtl*/, BOOL& /*bHandled*/)
+{
+   if (m_spViewfinder == nullptr)
+      return 0;
+
+   m_bMotionTriggerEnabled = !m_bMotionTriggerEnabled;
+
+   if (m_bMotionTriggerEnabled)
+   {
+      StartMotionTrigger();
+      m_host.SetStatusText(_T("Motion trigger armed"));
+   }
+   else
+   {
+      StopMotionTrigger();
+      m_host.SetStatusText(_T("Motion trigger stopped"));
+   }
+
+   return 0;
+}
+
+/// \details handles WM_VIEWFINDER_MOTION_TRIGGERED message
+LRESULT ViewFinderView::OnMessageMotionTriggered(UINT /*uMsg*/, WPARAM /*wParam*/, LPARAM /*lParam*/, BOOL& /*bHandled*/)
+{
+   MotionTriggerInfo info;
+   {
+      LightweightMutex::LockType lock{ m_mutexMotionTriggerInfo };
+      info = m_lastMotionTriggerInfo;
+   }
+
+   CString statusText;
+   statusText.Format(_T("Motion trigger released at frame %u: changed area %.1f%%, detect latency %.1f ms, release latency %.1f ms"),
+      info.m_frameCount,
+      info.m_changedArea * 100.0,
+      info.m_detectLatencyInMs,
+      info.m_releaseLatencyInMs);
+
+   m_host.SetStatusText(statusText);
+
+   return 0;
+}
+
+void ViewFinderView::StartMotionTrigger()
+{
+   ATLASSERT(m_spViewfinder != nullptr);
+
+   if (m_upMotionTrigger == nullptr)
+      m_upMotionTrigger.reset(new LiveViewMotionTrigger(m_spRemoteReleaseControl, m_spViewfinder));
+
+   const unsigned int c_holdOffTimeInMs = 2000;
+
+   m_upMotionTrigger->Start(MotionDetectorOptions(), c_holdOffTimeInMs,
+      std::bind(&ViewFinderView::OnMotionTriggered, this, std::placeholders::_1),
+      m_upViewFinderWindow->GetAvailImageHandler());
+}
+
+void ViewFinderView::StopMotionTrigger()
+{
+   if (m_upMotionTrigger == nullptr)
+      return;
+
+   m_upMotionTrigger->Stop();
+   m_upMotionTrigger.reset();
+}
+
+void ViewFinderView::OnMotionTriggered(const MotionTriggerInfo& info)
+{
+   {
+      LightweightMutex::LockType lock{ m_mutexMotionTriggerInfo };
+      m_lastMotionTriggerInfo = info;
+   }
+
+   if (IsWindow())
+      PostMessage(WM_VIEWFINDER_MOTION_TRIGGERED);
+}
+
 void ViewFinderView::SetupZoomControls()
 {
    unsigned int uiPropertyId = m_spRemoteReleaseControl->MapImagePropertyTypeToId(T_enImagePropertyType::propCurrentZoomPos);
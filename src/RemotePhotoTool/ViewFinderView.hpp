@@ -10,6 +10,7 @@
 #include "ViewFinderImageWindow.hpp"
 #include "ImageProperty.hpp"
 #include "Viewfinder.hpp"
+#include "LiveViewMotionTrigger.hpp"
 
 // forward references
 class IPhotoModeViewHost;
@@ -65,12 +66,14 @@ private:
    BEGIN_MSG_MAP(ViewFinderView)
       MESSAGE_HANDLER(WM_INITDIALOG, OnInitDialog)
       MESSAGE_HANDLER(WM_HSCROLL, OnHScroll)
+      MESSAGE_HANDLER(WM_VIEWFINDER_MOTION_TRIGGERED, OnMessageMotionTriggered)
       COMMAND_HANDLER(ID_VIEWFINDER_AUTO_FOCUS, BN_CLICKED, OnViewfinderAutoFocus)
       COMMAND_HANDLER(ID_VIEWFINDER_AUTO_WB, BN_CLICKED, OnViewfinderAutoWhiteBalance)
       COMMAND_HANDLER(ID_VIEWFINDER_ZOOM_OUT, BN_CLICKED, OnViewfinderZoomOut)
       COMMAND_HANDLER(ID_VIEWFINDER_ZOOM_IN, BN_CLICKED, OnViewfinderZoomIn)
       COMMAND_HANDLER(ID_VIEWFINDER_HISTOGRAM, BN_CLICKED, OnViewfinderHistogram)
       COMMAND_HANDLER(ID_VIEWFINDER_SHOW_OVEREXPOSED, BN_CLICKED, OnViewfinderShowOverexposed)
+      COMMAND_HANDLER(ID_VIEWFINDER_MOTION_TRIGGER, BN_CLICKED, OnViewfinderMotionTrigger)
       CHAIN_MSG_MAP(CDialogResize<ViewFinderView>)
       REFLECT_NOTIFICATIONS() // to make sure superclassed controls get notification messages
    END_MSG_MAP()
@@ -98,6 +101,19 @@ private:
    LRESULT OnViewfinderHistogram(WORD wNotifyCode, WORD wID, HWND hWndCtl, BOOL& bHandled);
    /// called when "show overexposed areas" button-checkbox is changed
    LRESULT OnViewfinderShowOverexposed(WORD wNotifyCode, WORD wID, HWND hWndCtl, BOOL& bHandled);
+   /// called when button Motion trigger is pressed
+   LRESULT OnViewfinderMotionTrigger(WORD wNotifyCode, WORD wID, HWND hWndCtl, BOOL& bHandled);
+   /// called when motion trigger released the shutter
+   LRESULT OnMessageMotionTriggered(UINT uMsg, WPARAM wParam, LPARAM lParam, BOOL& bHandled);
+
+   /// starts motion trigger, forwarding viewfinder images to the viewfinder window
+   void StartMotionTrigger();
+
+   /// stops motion trigger, if started
+   void StopMotionTrigger();
+
+   /// called from motion trigger after a triggered release
+   void OnMotionTriggered(const MotionTriggerInfo& info);
 
    /// sets up viewfinder window
    void SetupViewfinderWindow();
@@ -131,6 +147,21 @@ private:
    /// indicates if histogram is shown
    bool m_bShowHistogram;
 
+   /// indicates if motion trigger is enabled
+   bool m_bMotionTriggerEnabled;
+
+   /// viewfinder
+   std::shared_ptr<Viewfinder> m_spViewfinder;
+
+   /// motion trigger; only set when motion trigger is enabled
+   std::unique_ptr<LiveViewMotionTrigger> m_upMotionTrigger;
+
+   /// mutex to protect m_lastMotionTriggerInfo
+   LightweightMutex m_mutexMotionTriggerInfo;
+
+   /// info about last triggered release
+   MotionTriggerInfo m_lastMotionTriggerInfo;
+
    /// list of all possible zoom values
    std::vector<ImageProperty> m_vecAllZoomValues;
 
@@ -21,6 +21,7 @@
 #include "ImagePropertyView.hpp"
 #include "PreviousImagesView.hpp"
 #include "CameraFileSystemView.hpp"
+#include "BurstPhotoModeView.hpp"
 
 std::unique_ptr<IPhotoModeView> ViewManager::CreateView(IPhotoModeViewHost& host, T_enViewType enViewType)
 {
@@ -38,6 +39,7 @@ std::unique_ptr<IPhotoModeView> ViewManager::CreateView(IPhotoModeViewHost& host
    case viewImageProperties:  return std::unique_ptr<IPhotoModeView>(new ImagePropertyView(host));
    case viewPreviousImages:   return std::unique_ptr<IPhotoModeView>(new PreviousImagesView(host));
    case viewCameraFileSystem: return std::unique_ptr<IPhotoModeView>(new CameraFileSystemView(host));
+   case viewBurst:            return std::unique_ptr<IPhotoModeView>(new BurstPhotoModeView(host));
 
    default:
       ATLASSERT(false);
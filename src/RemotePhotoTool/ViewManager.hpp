@@ -28,6 +28,7 @@ enum T_enViewType
    viewImageProperties = 9,
    viewPreviousImages = 10,
    viewCameraFileSystem = 11,
+   viewBurst = 12,
 };
 
 /// view manager
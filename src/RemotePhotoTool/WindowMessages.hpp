@@ -22,3 +22,12 @@
 
 /// sent to PreviousImagesView to update current image
 #define WM_PREV_IMAGES_UPDATE WM_APP + 5
+
+/// sent to CameraFileSystemFileListView when file infos were retrieved
+#define WM_FILESYSTEM_FILEINFO_AVAIL WM_APP + 6
+
+/// sent to ViewFinderView when the motion trigger released the shutter
+#define WM_VIEWFINDER_MOTION_TRIGGERED WM_APP + 7
+
+/// sent to CameraFileSystemFileListView when thumbnails were retrieved
+#define WM_FILESYSTEM_THUMBNAIL_AVAIL WM_APP + 8
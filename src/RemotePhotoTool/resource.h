@@ -23,6 +23,7 @@
 #define IDD_PHOTOMODE_PHOTO_STACKING_FORM 268
 #define IDD_TIMELAPSE_VIDEO_OPTIONS     269
 #define IDD_USB_DRIVER_SWITCHER         270
+#define IDD_PHOTOMODE_BURST_FORM        271
 #define IDC_BUTTON_TIMELAPSE_START      1000
 #define IDC_BUTTON_TIMELAPSE_STOP       1001
 #define IDC_BUTTON_PHOTO_STACKING_START 1002
@@ -89,6 +90,11 @@
 #define IDC_BUTTON_USB_SWITCH_DRIVER    1092
 #define IDC_BUTTON_CONFIG_USB           1093
 #define IDC_BUTTON_USB_OPEN_DEVICE_MANAGER 1094
+#define IDC_BUTTON_BURST_START          1095
+#define IDC_BUTTON_BURST_STOP           1096
+#define IDC_EDIT_BURST_MAX_QUEUED_DOWNLOADS 1097
+#define IDC_EDIT_BURST_NUM_IMAGES       1098
+#define IDC_STATIC_BURST_STATUS         1099
 #define ID_HOME_CONNECT                 32768
 #define ID_HOME_SETTINGS                32769
 #define ID_PHOTO_MODE_NORMAL            32770
@@ -142,6 +148,8 @@
 #define ID_SCRIPTING_EDIT               32818
 #define ID_EXTRA_CREATE_TIMELAPSE_FROM_FILES 32819
 #define ID_FILESYSTEM_DOWNLOAD          32820
+#define ID_PHOTO_MODE_BURST             32821
+#define ID_VIEWFINDER_MOTION_TRIGGER    32822
 #define ID_VIEW_RIBBON                  0xE804
 
 // Next default values for new objects
@@ -149,8 +157,8 @@
 #ifdef APSTUDIO_INVOKED
 #ifndef APSTUDIO_READONLY_SYMBOLS
 #define _APS_NEXT_RESOURCE_VALUE        135
-#define _APS_NEXT_COMMAND_VALUE         32820
-#define _APS_NEXT_CONTROL_VALUE         1095
+#define _APS_NEXT_COMMAND_VALUE         32823
+#define _APS_NEXT_CONTROL_VALUE         1100
 #define _APS_NEXT_SYMED_VALUE           101
 #endif
 #endif
@@ -26,6 +26,10 @@ struct AppCommand
       listenEvents,     ///< listens for events
       releaseShutter,   ///< releases shutter
       runScript,        ///< runs Lua script
+      liveViewServer,   ///< serves live view images via HTTP, on given port
+      ingestFiles,      ///< mirrors camera file system to given local folder
+      benchmarkRelease, ///< releases shutter given number of times and reports latencies
+      syncRelease,      ///< releases shutters of all connected cameras at the same time
    };
 
    /// ctor
@@ -10,7 +10,9 @@
 #include "AppOptions.hpp"
 
 AppOptions::AppOptions(std::vector<AppCommand>& vecCommandList)
-:m_vecCommandList(vecCommandList)
+:m_vecCommandList(vecCommandList),
+m_bProfileScripts(false),
+m_uiNumSimulatedCameras(0)
 {
    RegisterOutputHandler(&ProgramOptions::OutputConsole);
    RegisterHelpOption();
@@ -30,6 +32,9 @@ AppOptions::AppOptions(std::vector<AppCommand>& vecCommandList)
    RegisterOption(_T("f"), _T("dir"), _T("lists all folders and files for the given relative path on the open device"),
       1, std::bind(&AppOptions::OnAddCommandWithParam, this, AppCommand::showFilesystem, std::placeholders::_1));
 
+   RegisterOption(_T(""), _T("ingest"), _T("copies all files on the open device to local folder <arg1>; skips files already copied"),
+      1, std::bind(&AppOptions::OnAddCommandWithParam, this, AppCommand::ingestFiles, std::placeholders::_1));
+
    RegisterOption(_T("d"), _T("device-info"), _T("shows device info of opened device"),
       0, std::bind(&AppOptions::OnAddSimpleCommand, this, AppCommand::deviceInfo));
 
@@ -54,8 +59,27 @@ AppOptions::AppOptions(std::vector<AppCommand>& vecCommandList)
    RegisterOption(_T("r"), _T("release"), _T("releases shutter"),
       0, std::bind(&AppOptions::OnAddSimpleCommand, this, AppCommand::releaseShutter));
 
+   RegisterOption(_T(""), _T("benchmark-release"), _T("releases shutter <arg1> times and reports latency percentiles"),
+      1, std::bind(&AppOptions::OnAddCommandWithParam, this, AppCommand::benchmarkRelease, std::placeholders::_1));
+
+   RegisterOption(_T(""), _T("sync-release"), _T("releases shutters of all connected cameras at the same time and reports the skew"),
+      0, std::bind(&AppOptions::OnAddSimpleCommand, this, AppCommand::syncRelease));
+
    RegisterOption(_T("s"), _T("run-script"), _T("runs Lua script <arg1>"),
       1, std::bind(&AppOptions::OnAddCommandWithParam, this, AppCommand::runScript, std::placeholders::_1));
+
+   RegisterOption(_T(""), _T("profile"), _T("runs Lua scripts with sampling profiler; writes collapsed stacks to <script>.folded"),
+      0, [&]() { m_bProfileScripts = true; return true; });
+
+   RegisterOption(_T(""), _T("simulated-cameras"), _T("adds <arg1> simulated cameras to the device list, e.g. for testing without camera"),
+      1, [&](const std::vector<CString>& vecParam)
+      {
+         m_uiNumSimulatedCameras = static_cast<unsigned int>(_ttoi(vecParam[0]));
+         return true;
+      });
+
+   RegisterOption(_T(""), _T("liveview-server"), _T("serves live view of opened device as MJPEG stream via HTTP on port <arg1>"),
+      1, std::bind(&AppOptions::OnAddCommandWithParam, this, AppCommand::liveViewServer, std::placeholders::_1));
 }
 
 bool AppOptions::OnAddSimpleCommand(AppCommand::T_enCommand enCommand)
@@ -17,6 +17,12 @@ public:
    /// ctor
    AppOptions(std::vector<AppCommand>& vecCommandList);
 
+   /// returns if Lua scripts should be run with the sampling profiler
+   bool IsProfileScriptsEnabled() const { return m_bProfileScripts; }
+
+   /// returns number of simulated cameras to add to the device list
+   unsigned int NumSimulatedCameras() const { return m_uiNumSimulatedCameras; }
+
 private:
    /// command without params
    bool OnAddSimpleCommand(AppCommand::T_enCommand enCommand);
@@ -27,4 +33,10 @@ private:
 private:
    /// command list
    std::vector<AppCommand>& m_vecCommandList;
+
+   /// indicates if Lua scripts should be run with the sampling profiler
+   bool m_bProfileScripts;
+
+   /// number of simulated cameras
+   unsigned int m_uiNumSimulatedCameras;
 };
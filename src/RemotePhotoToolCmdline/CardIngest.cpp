@@ -0,0 +1,350 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file CardIngest.cpp Incremental card ingest
+//
+
+// includes
+#include "stdafx.h"
+#include "CardIngest.hpp"
+#include "SingleThreadExecutor.hpp"
+#include "File.hpp"
+#include "Fnv1aHash.hpp"
+#include <ulib/Path.hpp>
+#include <ulib/Exception.hpp>
+#include <io.h>
+
+/// extension of files that are being downloaded
+LPCTSTR c_partialFileExtension = _T(".part");
+
+/// name of manifest file in the target folder
+LPCTSTR c_manifestFilename = _T("ingest-manifest.txt");
+
+/// size of buffer used to read back downloaded files
+const size_t c_verifyBufferSize = 1024 * 1024;
+
+/// number of verified files after which the files are flushed to disk
+const size_t c_syncBatchNumFiles = 32;
+
+/// number of verified bytes after which the files are flushed to disk
+const unsigned long long c_syncBatchNumBytes = 256ULL * 1024 * 1024;
+
+CardIngest::CardIngest(std::shared_ptr<CameraFileSystem> fileSystem, const CString& targetFolder)
+   :m_fileSystem(fileSystem),
+   m_targetFolder(targetFolder),
+   m_numFilesInProgress(0),
+   m_enumerationFinished(false),
+   m_numFilesFound(0),
+   m_numFilesSkipped(0),
+   m_numFilesIngested(0),
+   m_numFilesFailed(0),
+   m_bytesDownloaded(0),
+   m_unsyncedBytes(0),
+   m_evtFinished(false),
+   m_verifyThread(std::make_unique<SingleThreadExecutor>(_T("ingest verify thread")))
+{
+}
+
+CardIngest::~CardIngest()
+{
+   m_fileSystem->SetFileInfoHandler(nullptr);
+
+   // stop verify thread before the file lists are destroyed
+   m_verifyThread.reset();
+}
+
+void CardIngest::Run(const CString& path)
+{
+   if (!Path::FolderExists(m_targetFolder))
+      Path::CreateDirectoryRecursive(m_targetFolder);
+
+   m_startTime = std::chrono::steady_clock::now();
+
+   m_fileSystem->SetFileInfoHandler(
+      std::bind(&CardIngest::OnFileInfoAvailable, this, std::placeholders::_1, std::placeholders::_2));
+
+   EnumerateFolder(path);
+
+   {
+      LightweightMutex::LockType lock(m_mutex);
+      m_enumerationFinished = true;
+
+      _tprintf(_T("Found %Iu file(s); %Iu file(s) already present.\n"), m_numFilesFound, m_numFilesSkipped);
+
+      CheckFinished();
+   }
+
+   while (!m_evtFinished.Wait(1000))
+   {
+      LightweightMutex::LockType lock(m_mutex);
+
+      _tprintf(_T("%Iu of %Iu file(s) ingested, %.1f MB/s...\r"),
+         m_numFilesIngested,
+         m_numFilesFound - m_numFilesSkipped,
+         Throughput());
+   }
+
+   m_fileSystem->SetFileInfoHandler(nullptr);
+
+   SyncBatch();
+
+   LightweightMutex::LockType lock(m_mutex);
+
+   _tprintf(_T("Ingest finished: %Iu file(s) ingested, %Iu skipped, %Iu failed; %I64u bytes downloaded at %.1f MB/s.\n"),
+      m_numFilesIngested, m_numFilesSkipped, m_numFilesFailed,
+      m_bytesDownloaded,
+      Throughput());
+}
+
+/// \details The file info handler is locked out while the files of a folder
+/// are enumerated, so that file infos arriving for these files are only
+/// processed after the files were registered as waiting.
+void CardIngest::EnumerateFolder(const CString& path)
+{
+   {
+      LightweightMutex::LockType lock(m_mutex);
+
+      std::vector<FileInfo> fileInfoList = m_fileSystem->EnumFiles(path);
+
+      for (const FileInfo& fileInfo : fileInfoList)
+      {
+         m_numFilesFound++;
+
+         if (fileInfo.m_isInfoPending)
+            m_filesWaitingForInfo.insert(fileInfo.m_filename);
+         else
+            CheckFile(fileInfo);
+      }
+   }
+
+   std::vector<CString> folderList = m_fileSystem->EnumFolders(path);
+
+   for (const CString& folder : folderList)
+      EnumerateFolder(path + CameraFileSystem::PathSeparator + folder);
+}
+
+void CardIngest::OnFileInfoAvailable(const CString& /*folder*/, const std::vector<FileInfo>& fileInfoList)
+{
+   LightweightMutex::LockType lock(m_mutex);
+
+   for (const FileInfo& fileInfo : fileInfoList)
+   {
+      if (m_filesWaitingForInfo.erase(fileInfo.m_filename) > 0)
+         CheckFile(fileInfo);
+   }
+
+   CheckFinished();
+}
+
+/// \details Must be called with m_mutex locked. A partially downloaded file
+/// from an earlier ingest is resumed.
+void CardIngest::CheckFile(const FileInfo& fileInfo)
+{
+   IngestFile file;
+   file.m_fileInfo = fileInfo;
+   file.m_targetFilename = GetTargetFilename(fileInfo);
+
+   unsigned long long size = 0;
+   time_t modifiedTime = -1;
+   if (File::GetSizeAndModifiedTime(file.m_targetFilename, size, modifiedTime) &&
+      size == fileInfo.m_fileSize &&
+      (fileInfo.m_modifiedTime == -1 || modifiedTime == fileInfo.m_modifiedTime))
+   {
+      m_numFilesSkipped++;
+      return;
+   }
+
+   CString partialFilename = file.m_targetFilename + c_partialFileExtension;
+
+   unsigned long long startOffset = 0;
+   if (File::GetSizeAndModifiedTime(partialFilename, size, modifiedTime) &&
+      size < fileInfo.m_fileSize)
+   {
+      startOffset = size;
+   }
+
+   CString targetFolder = Path::FolderName(file.m_targetFilename);
+   if (!Path::FolderExists(targetFolder))
+      Path::CreateDirectoryRecursive(targetFolder);
+
+   m_numFilesInProgress++;
+
+   m_fileSystem->StartDownloadToFile(fileInfo, partialFilename, startOffset, nullptr,
+      [this, file, startOffset](const FileInfo&, unsigned long long bytesWritten, bool completed)
+      {
+         OnDownloadFinished(file, startOffset, bytesWritten, completed);
+      });
+}
+
+CString CardIngest::GetTargetFilename(const FileInfo& fileInfo) const
+{
+   CString relativePath = fileInfo.m_filename;
+   relativePath.Replace(CameraFileSystem::PathSeparator, _T("\\"));
+   relativePath.TrimLeft(_T("\\."));
+
+   return Path::Combine(m_targetFolder, relativePath);
+}
+
+void CardIngest::OnDownloadFinished(const IngestFile& file, unsigned long long startOffset,
+   unsigned long long bytesWritten, bool completed)
+{
+   {
+      LightweightMutex::LockType lock(m_mutex);
+
+      if (bytesWritten > startOffset)
+         m_bytesDownloaded += bytesWritten - startOffset;
+   }
+
+   m_verifyThread->Schedule(
+      std::bind(&CardIngest::AsyncVerifyFile, this, file, bytesWritten, completed));
+}
+
+void CardIngest::AsyncVerifyFile(IngestFile file, unsigned long long bytesWritten, bool completed)
+{
+   CString partialFilename = file.m_targetFilename + c_partialFileExtension;
+
+   bool verified = completed &&
+      bytesWritten == file.m_fileInfo.m_fileSize &&
+      HashFile(partialFilename, bytesWritten, file.m_hash);
+
+   if (verified)
+   {
+      m_unsyncedFiles.push_back(file);
+      m_unsyncedBytes += bytesWritten;
+
+      if (m_unsyncedFiles.size() >= c_syncBatchNumFiles ||
+         m_unsyncedBytes >= c_syncBatchNumBytes)
+      {
+         SyncBatch();
+      }
+   }
+   else
+   {
+      _tprintf(_T("Couldn't ingest file: %s (%I64u of %I64u bytes)\n"),
+         file.m_fileInfo.m_filename.GetString(),
+         bytesWritten,
+         file.m_fileInfo.m_fileSize);
+
+      LightweightMutex::LockType lock(m_mutex);
+      m_numFilesFailed++;
+   }
+
+   LightweightMutex::LockType lock(m_mutex);
+
+   m_numFilesInProgress--;
+
+   CheckFinished();
+}
+
+bool CardIngest::HashFile(const CString& filename, unsigned long long expectedSize, unsigned long long& hash)
+{
+   FILE* fd = nullptr;
+   errno_t ret = _tfopen_s(&fd, filename, _T("rb"));
+   if (ret != 0 || fd == nullptr)
+      return false;
+
+   std::shared_ptr<FILE> file{ fd, &fclose };
+
+   std::vector<unsigned char> buffer(c_verifyBufferSize);
+   setvbuf(file.get(), nullptr, _IONBF, 0); // reads are already large
+
+   Fnv1aHash fileHash;
+   unsigned long long size = 0;
+
+   size_t read = 0;
+   while ((read = fread(buffer.data(), 1, buffer.size(), file.get())) > 0)
+   {
+      fileHash.Add(buffer.data(), read);
+      size += read;
+   }
+
+   hash = fileHash.Value();
+
+   return ferror(file.get()) == 0 && size == expectedSize;
+}
+
+/// \details The modified time is set before flushing, so that the metadata
+/// is flushed, too; renaming is done last, so that the final filename only
+/// appears when the file is complete on disk.
+void CardIngest::SyncBatch()
+{
+   if (m_unsyncedFiles.empty())
+      return;
+
+   CString manifestFilename = Path::Combine(m_targetFolder, c_manifestFilename);
+
+   FILE* fd = nullptr;
+   _tfopen_s(&fd, manifestFilename, _T("at"));
+   std::shared_ptr<FILE> manifestFile{ fd, [](FILE* fd) { if (fd != nullptr) fclose(fd); } };
+
+   size_t numIngested = 0;
+   size_t numFailed = 0;
+
+   for (const IngestFile& file : m_unsyncedFiles)
+   {
+      CString partialFilename = file.m_targetFilename + c_partialFileExtension;
+
+      try
+      {
+         if (file.m_fileInfo.m_modifiedTime != -1)
+            File::SetModifiedTime(partialFilename, file.m_fileInfo.m_modifiedTime);
+
+         File::FlushToDisk(partialFilename);
+
+         if (!MoveFileEx(partialFilename, file.m_targetFilename,
+            MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+            throw Exception(_T("couldn't rename file: ") + partialFilename, __FILE__, __LINE__);
+      }
+      catch (const Exception& ex)
+      {
+         _tprintf(_T("Couldn't ingest file: %s (%s)\n"),
+            file.m_fileInfo.m_filename.GetString(),
+            ex.Message().GetString());
+
+         numFailed++;
+         continue;
+      }
+
+      if (manifestFile != nullptr)
+      {
+         _ftprintf(manifestFile.get(), _T("%016I64x %I64u %s\n"),
+            file.m_hash,
+            file.m_fileInfo.m_fileSize,
+            file.m_fileInfo.m_filename.GetString());
+      }
+
+      numIngested++;
+   }
+
+   if (manifestFile != nullptr)
+   {
+      fflush(manifestFile.get());
+      _commit(_fileno(manifestFile.get()));
+   }
+
+   m_unsyncedFiles.clear();
+   m_unsyncedBytes = 0;
+
+   LightweightMutex::LockType lock(m_mutex);
+   m_numFilesIngested += numIngested;
+   m_numFilesFailed += numFailed;
+}
+
+/// \details Must be called with m_mutex locked.
+void CardIngest::CheckFinished()
+{
+   if (m_enumerationFinished &&
+      m_filesWaitingForInfo.empty() &&
+      m_numFilesInProgress == 0)
+   {
+      m_evtFinished.Set();
+   }
+}
+
+double CardIngest::Throughput() const
+{
+   double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_startTime).count();
+
+   return seconds > 0.0 ? double(m_bytesDownloaded) / (1024.0 * 1024.0) / seconds : 0.0;
+}
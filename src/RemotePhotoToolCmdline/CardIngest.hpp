@@ -0,0 +1,133 @@
+//
+// RemotePhotoTool - remote camera control software
+// Copyright (C) 2008-2026 Michael Fink
+//
+/// \file CardIngest.hpp Incremental card ingest
+//
+#pragma once
+
+// includes
+#include "CameraFileSystem.hpp"
+#include <ulib/thread/Event.hpp>
+#include <ulib/thread/LightweightMutex.hpp>
+#include <chrono>
+
+// forward references
+class SingleThreadExecutor;
+
+/// \brief mirrors the camera file system to a local folder, incrementally
+/// \details Files that already exist in the target folder with the same size
+/// and modification time are skipped. Enumeration, download and verification
+/// overlap: the folders are enumerated in the calling thread, the file
+/// system downloads the files in its worker thread, and the downloaded files
+/// are verified in the verify thread. Files are downloaded to a .part file,
+/// which can be resumed when the ingest is interrupted. Verified files are
+/// flushed to disk in batches and only then renamed to their final name, so
+/// that a file with the final name is always complete. The hashes of all
+/// ingested files are written to a manifest file in the target folder.
+class CardIngest
+{
+public:
+   /// ctor
+   CardIngest(std::shared_ptr<CameraFileSystem> fileSystem, const CString& targetFolder);
+
+   /// dtor
+   ~CardIngest();
+
+   /// runs ingest, starting at given path; returns when all files were processed
+   void Run(const CString& path);
+
+private:
+   /// file to ingest
+   struct IngestFile
+   {
+      /// camera file info
+      FileInfo m_fileInfo;
+
+      /// target filename
+      CString m_targetFilename;
+
+      /// hash of the downloaded file
+      unsigned long long m_hash = 0;
+   };
+
+   /// enumerates folder and its subfolders; called in the calling thread
+   void EnumerateFolder(const CString& path);
+
+   /// called when the file system retrieved pending file infos; called in worker thread
+   void OnFileInfoAvailable(const CString& folder, const std::vector<FileInfo>& fileInfoList);
+
+   /// skips file when already present in target folder, or starts download
+   void CheckFile(const FileInfo& fileInfo);
+
+   /// returns target filename for camera file
+   CString GetTargetFilename(const FileInfo& fileInfo) const;
+
+   /// called when a download has finished; called in the file system's worker thread
+   void OnDownloadFinished(const IngestFile& file, unsigned long long startOffset,
+      unsigned long long bytesWritten, bool completed);
+
+   /// verifies downloaded file; called in verify thread
+   void AsyncVerifyFile(IngestFile file, unsigned long long bytesWritten, bool completed);
+
+   /// computes hash of file; returns false when the file couldn't be read completely
+   static bool HashFile(const CString& filename, unsigned long long expectedSize, unsigned long long& hash);
+
+   /// flushes verified files to disk and renames them to their final names
+   void SyncBatch();
+
+   /// sets finished event when all files were processed
+   void CheckFinished();
+
+   /// returns throughput of downloads since start, in MB/s
+   double Throughput() const;
+
+private:
+   /// camera file system
+   std::shared_ptr<CameraFileSystem> m_fileSystem;
+
+   /// target folder
+   CString m_targetFolder;
+
+   /// time when ingest started
+   std::chrono::steady_clock::time_point m_startTime;
+
+   /// mutex to protect the file lists and counters below
+   mutable LightweightMutex m_mutex;
+
+   /// camera filenames of files waiting for their file infos
+   std::set<CString> m_filesWaitingForInfo;
+
+   /// number of files that were started to download, but aren't verified yet
+   size_t m_numFilesInProgress;
+
+   /// indicates that the enumeration has finished
+   bool m_enumerationFinished;
+
+   /// number of files found
+   size_t m_numFilesFound;
+
+   /// number of files skipped, since they were already present
+   size_t m_numFilesSkipped;
+
+   /// number of files downloaded and verified
+   size_t m_numFilesIngested;
+
+   /// number of files that couldn't be downloaded or verified
+   size_t m_numFilesFailed;
+
+   /// number of bytes downloaded
+   unsigned long long m_bytesDownloaded;
+
+   /// verified files not yet flushed to disk; only accessed in verify thread
+   std::vector<IngestFile> m_unsyncedFiles;
+
+   /// number of bytes in unsynced files; only accessed in verify thread
+   unsigned long long m_unsyncedBytes;
+
+   /// event that is set when all files were processed
+   ManualResetEvent m_evtFinished;
+
+   /// thread to verify downloaded files
+   std::unique_ptr<SingleThreadExecutor> m_verifyThread;
+};
@@ -13,13 +13,22 @@
 #include "AppCommand.hpp"
 #include "AppOptions.hpp"
 #include <ulib/thread/Event.hpp>
+#include <ulib/thread/LightweightMutex.hpp>
 #include "CameraScriptProcessor.hpp"
+#include "Lua.hpp"
+#include "LuaProfiler.hpp"
 #include "Instance.hpp"
+#include "SimulatedCameraSettings.hpp"
 #include "SourceInfo.hpp"
 #include "SourceDevice.hpp"
 #include "CameraFileSystem.hpp"
+#include "CardIngest.hpp"
 #include "RemoteReleaseControl.hpp"
 #include "ShutterReleaseSettings.hpp"
+#include "SynchronizedRelease.hpp"
+#include "Viewfinder.hpp"
+#include "SingleThreadExecutor.hpp"
+#include "MjpegHttpServer.hpp"
 #include <ulib/Path.hpp>
 #include <ulib/CrashReporter.hpp>
 #include "../version.h"
@@ -28,6 +37,7 @@
 #include <algorithm>
 
 CmdlineApp::CmdlineApp()
+:m_bProfileScripts(false)
 {
    _tprintf(_T("RemotePhotoTool Command-Line %s\n%s\n\n"),
       _T(VERSIONINFO_FILEVERSION_DISPLAYSTRING),
@@ -58,6 +68,16 @@ void CmdlineApp::Run(int argc, LPCTSTR argv[])
    if (options.IsSelectedHelpOption())
       return;
 
+   m_bProfileScripts = options.IsProfileScriptsEnabled();
+
+   if (options.NumSimulatedCameras() > 0)
+   {
+      SimulatedCameraSettings settings;
+      settings.m_numCameras = options.NumSimulatedCameras();
+
+      Instance::SetSimulatedCameraSettings(settings);
+   }
+
    if (m_vecCommandList.empty())
    {
       options.OutputHelp();
@@ -97,6 +117,7 @@ void CmdlineApp::Exec(const AppCommand& cmd)
       break;
    case AppCommand::deviceInfo: OutputDeviceInfo(); break;
    case AppCommand::showFilesystem: ShowFileSystem(cmd.m_cszData); break;
+   case AppCommand::ingestFiles: IngestFiles(cmd.m_cszData); break;
    case AppCommand::deviceProperties: ListDeviceProperties(); break;
    case AppCommand::checkUnknownDeviceProps: CheckUnknownDeviceProperties(); break;
    case AppCommand::imageProperties: ListImageProperties(); break;
@@ -104,7 +125,10 @@ void CmdlineApp::Exec(const AppCommand& cmd)
    case AppCommand::remoteCapabilities: ListRemoteCapabilities(); break;
    case AppCommand::listenEvents: ListenToEvents(); break;
    case AppCommand::releaseShutter: ReleaseShutter(); break;
+   case AppCommand::benchmarkRelease: BenchmarkRelease(cmd.m_cszData); break;
+   case AppCommand::syncRelease: SyncReleaseAllCameras(); break;
    case AppCommand::runScript: RunScript(cmd.m_cszData); break;
+   case AppCommand::liveViewServer: RunLiveViewServer(cmd.m_cszData); break;
    default:
       ATLASSERT(false);
       break;
@@ -229,8 +253,27 @@ void CmdlineApp::OutputDeviceInfo()
    _tprintf(_T("\n"));
 }
 
-/// recursively lists all files and folders in camera file system, starting from given path
-void ListFilesAndFolders(std::shared_ptr<CameraFileSystem> spFileSystem, const CString& path)
+/// prints file info line, with size and modification time
+void PrintFileInfo(const FileInfo& fileInfo)
+{
+   CString modifiedTimeText;
+   struct tm modifiedTime = {};
+   if (fileInfo.m_modifiedTime != -1 &&
+      0 == localtime_s(&modifiedTime, &fileInfo.m_modifiedTime))
+   {
+      _tcsftime(modifiedTimeText.GetBuffer(64), 64, _T("%Y-%m-%d %H:%M:%S"), &modifiedTime);
+      modifiedTimeText.ReleaseBuffer();
+   }
+
+   _tprintf(_T("File \"%s\", %I64u bytes, modified %s\n"),
+      fileInfo.m_filename.GetString(),
+      fileInfo.m_fileSize,
+      modifiedTimeText.IsEmpty() ? _T("-") : modifiedTimeText.GetString());
+}
+
+/// recursively lists all files and folders in camera file system, starting
+/// from given path; counts files where the file infos are still pending
+void ListFilesAndFolders(std::shared_ptr<CameraFileSystem> spFileSystem, const CString& path, size_t& numPendingFileInfos)
 {
    _tprintf(_T("Path: %s\n"), path.GetString());
 
@@ -251,7 +294,13 @@ void ListFilesAndFolders(std::shared_ptr<CameraFileSystem> spFileSystem, const C
    {
       const FileInfo& fileInfo = allFiles[index];
 
-      _tprintf(_T("File \"%s\"\n"), fileInfo.m_filename.GetString());
+      if (fileInfo.m_isInfoPending)
+      {
+         _tprintf(_T("File \"%s\"\n"), fileInfo.m_filename.GetString());
+         numPendingFileInfos++;
+      }
+      else
+         PrintFileInfo(fileInfo);
    }
 
    _tprintf(_T("%Iu file(s) found.\n\n"), allFiles.size());
@@ -260,10 +309,23 @@ void ListFilesAndFolders(std::shared_ptr<CameraFileSystem> spFileSystem, const C
    {
       CString subPath = path + CameraFileSystem::PathSeparator + allFolders[index];
 
-      ListFilesAndFolders(spFileSystem, subPath);
+      ListFilesAndFolders(spFileSystem, subPath, numPendingFileInfos);
    }
 }
 
+/// file infos that were retrieved by the file system in the background
+struct AvailableFileInfos
+{
+   /// mutex to protect the file info list
+   LightweightMutex m_mutex;
+
+   /// file infos that weren't printed yet
+   std::vector<FileInfo> m_fileInfoList;
+
+   /// event that is set when file infos were added to the list
+   ManualResetEvent m_evtAvailable{ false };
+};
+
 void CmdlineApp::ShowFileSystem(const CString& path)
 {
    _tprintf(_T("Shows file system\n"));
@@ -289,7 +351,84 @@ void CmdlineApp::ShowFileSystem(const CString& path)
       return;
    }
 
-   ListFilesAndFolders(spFileSystem, path);
+   // file infos that aren't known while listing are printed when the file
+   // system has retrieved them; the state is shared with the handler, since
+   // the handler may still run in the worker thread after this function
+   std::shared_ptr<AvailableFileInfos> spAvailableFileInfos = std::make_shared<AvailableFileInfos>();
+
+   spFileSystem->SetFileInfoHandler(
+      [spAvailableFileInfos](const CString&, const std::vector<FileInfo>& fileInfoList)
+      {
+         LightweightMutex::LockType lock(spAvailableFileInfos->m_mutex);
+
+         spAvailableFileInfos->m_fileInfoList.insert(spAvailableFileInfos->m_fileInfoList.end(),
+            fileInfoList.begin(), fileInfoList.end());
+
+         spAvailableFileInfos->m_evtAvailable.Set();
+      });
+
+   size_t numPendingFileInfos = 0;
+   ListFilesAndFolders(spFileSystem, path, numPendingFileInfos);
+
+   if (numPendingFileInfos > 0)
+      _tprintf(_T("Retrieving file infos for %Iu file(s)...\n"), numPendingFileInfos);
+
+   while (numPendingFileInfos > 0)
+   {
+      if (!spAvailableFileInfos->m_evtAvailable.Wait(10 * 1000))
+      {
+         _tprintf(_T("Timeout while retrieving file infos.\n"));
+         break;
+      }
+
+      std::vector<FileInfo> fileInfoList;
+      {
+         LightweightMutex::LockType lock(spAvailableFileInfos->m_mutex);
+
+         fileInfoList.swap(spAvailableFileInfos->m_fileInfoList);
+         spAvailableFileInfos->m_evtAvailable.Reset();
+      }
+
+      for (const FileInfo& fileInfo : fileInfoList)
+         PrintFileInfo(fileInfo);
+
+      numPendingFileInfos -= std::min(numPendingFileInfos, fileInfoList.size());
+   }
+
+   spFileSystem->SetFileInfoHandler(nullptr);
+
+   _tprintf(_T("\n"));
+}
+
+void CmdlineApp::IngestFiles(const CString& targetFolder)
+{
+   _tprintf(_T("Ingests files to folder: %s\n"), targetFolder.GetString());
+
+   if (m_spSourceDevice == nullptr)
+   {
+      _tprintf(_T("No device was opened before.\n"));
+      return;
+   }
+
+   bool canUseFilesystem = m_spSourceDevice->GetDeviceCapability(SourceDevice::capCameraFileSystem);
+   if (!canUseFilesystem)
+   {
+      _tprintf(_T("File system can't be accessed on this device.\n\n"));
+      return;
+   }
+
+   std::shared_ptr<CameraFileSystem> spFileSystem = m_spSourceDevice->GetFileSystem();
+
+   if (spFileSystem == nullptr)
+   {
+      _tprintf(_T("File system couldn't be opened.\n"));
+      return;
+   }
+
+   CardIngest ingest(spFileSystem, targetFolder);
+   ingest.Run(CameraFileSystem::PathSeparator);
+
+   _tprintf(_T("\n"));
 }
 
 void CmdlineApp::ListDeviceProperties()
@@ -485,6 +624,7 @@ void CmdlineApp::ListRemoteCapabilities()
       { RemoteReleaseControl::capReleaseWhileViewfinder,  _T("can capture during live view") },
       { RemoteReleaseControl::capAFLock,                  _T("supports AF lock/unlock") },
       { RemoteReleaseControl::capBulbMode,                _T("supports bulb mode") },
+      { RemoteReleaseControl::capBurstMode,               _T("supports burst shooting") },
    };
 
    for (unsigned int i = 0; i<sizeof(s_capList) / sizeof(*s_capList); i++)
@@ -525,6 +665,8 @@ void CmdlineApp::ListenToEvents()
          enStateEvent == RemoteReleaseControl::stateEventReleaseError ? _T("ReleaseError") :
          enStateEvent == RemoteReleaseControl::stateEventBulbExposureTime ? _T("BulbExposureTime") :
          enStateEvent == RemoteReleaseControl::stateEventInternalError ? _T("InternalError") :
+         enStateEvent == RemoteReleaseControl::stateEventCaptureComplete ? _T("CaptureComplete") :
+         enStateEvent == RemoteReleaseControl::stateEventTransferError ? _T("TransferError") :
          _T("???"),
          uiValue);
    });
@@ -596,10 +738,148 @@ void CmdlineApp::ReleaseShutter()
       Instance::OnIdle();
 }
 
+void CmdlineApp::BenchmarkRelease(const CString& numShots)
+{
+   unsigned int maxShots = _tcstoul(numShots, nullptr, 10);
+   if (maxShots == 0)
+      throw Exception(_T("Invalid number of shots: ") + numShots, __FILE__, __LINE__);
+
+   _tprintf(_T("Benchmark release with %u shots\n"), maxShots);
+
+   EnsureReleaseControl();
+
+   ManualResetEvent evtPictureTaken(false);
+
+   ShutterReleaseSettings settings(
+      ShutterReleaseSettings::saveToBoth,
+      std::bind(&ManualResetEvent::Set, &evtPictureTaken));
+
+   m_spReleaseControl->SetReleaseSettings(settings);
+
+   unsigned int numErrors = 0;
+   int stateEventHandlerId = m_spReleaseControl->AddStateEventHandler(
+      [&evtPictureTaken, &numErrors](RemoteReleaseControl::T_enStateEvent enStateEvent, unsigned int errorCode)
+      {
+         if (enStateEvent == RemoteReleaseControl::stateEventReleaseError)
+         {
+            _tprintf(_T("Error while shutter release: %u\n"), errorCode);
+            numErrors++;
+            evtPictureTaken.Set();
+         }
+      });
+
+   m_spReleaseControl->ResetReleaseLatencyStatistics();
+
+   for (unsigned int shot = 0; shot < maxShots; shot++)
+   {
+      _tprintf(_T("Shot %u of %u...\r"), shot + 1, maxShots);
+
+      evtPictureTaken.Reset();
+
+      m_spReleaseControl->Release();
+
+      while (!evtPictureTaken.Wait(10))
+         Instance::OnIdle();
+   }
+
+   m_spReleaseControl->RemoveStateEventHandler(stateEventHandlerId);
+
+   _tprintf(_T("Benchmark finished, %u shot(s), %u error(s).\n\n"), maxShots, numErrors);
+
+   PrintReleaseLatencyStatistics();
+}
+
+void CmdlineApp::PrintReleaseLatencyStatistics()
+{
+   ReleaseLatencyStatistics statistics = m_spReleaseControl->GetReleaseLatencyStatistics();
+
+   _tprintf(_T("Latencies since release request, in ms:\n"));
+   _tprintf(_T("%-18s %6s %9s %9s %9s %9s %9s %9s\n"),
+      _T("Stage"), _T("Count"), _T("Min"), _T("Mean"), _T("P50"), _T("P90"), _T("P99"), _T("Max"));
+
+   for (int stage = releaseStageCommandSent; stage < releaseStageMax; stage++)
+   {
+      T_enReleaseStage enReleaseStage = static_cast<T_enReleaseStage>(stage);
+      const LatencyHistogram& histogram = statistics.Histogram(enReleaseStage);
+
+      _tprintf(_T("%-18s %6Iu %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f\n"),
+         ReleaseLatencyStatistics::StageName(enReleaseStage),
+         histogram.Count(),
+         histogram.Min(),
+         histogram.Mean(),
+         histogram.Percentile(50.0),
+         histogram.Percentile(90.0),
+         histogram.Percentile(99.0),
+         histogram.Max());
+   }
+}
+
+/// \details All connected cameras are opened, independent of the device
+/// opened with --open. The images are saved on the cameras only.
+void CmdlineApp::SyncReleaseAllCameras()
+{
+   _tprintf(_T("Synchronized release of all cameras\n"));
+
+   Instance inst = Instance::Get();
+
+   std::vector<std::shared_ptr<SourceInfo>> vecSourceDevices;
+   inst.EnumerateDevices(vecSourceDevices);
+
+   std::vector<std::shared_ptr<SourceDevice>> sourceDeviceList;
+   std::vector<std::shared_ptr<RemoteReleaseControl>> remoteReleaseControlList;
+
+   for (std::shared_ptr<SourceInfo> spSourceInfo : vecSourceDevices)
+   {
+      std::shared_ptr<SourceDevice> spSourceDevice = spSourceInfo->Open();
+
+      if (!spSourceDevice->GetDeviceCapability(SourceDevice::capRemoteReleaseControl))
+      {
+         _tprintf(_T("Skipping device without remote release control: \"%s\"\n"), spSourceInfo->Name().GetString());
+         continue;
+      }
+
+      _tprintf(_T("Camera %Iu: \"%s\"\n"), remoteReleaseControlList.size() + 1, spSourceInfo->Name().GetString());
+
+      std::shared_ptr<RemoteReleaseControl> spRemoteReleaseControl = spSourceDevice->EnterReleaseControl();
+      spRemoteReleaseControl->SetReleaseSettings(ShutterReleaseSettings(ShutterReleaseSettings::saveToCamera));
+
+      sourceDeviceList.push_back(spSourceDevice);
+      remoteReleaseControlList.push_back(spRemoteReleaseControl);
+   }
+
+   if (remoteReleaseControlList.empty())
+      throw Exception(_T("No camera with remote release control found."), __FILE__, __LINE__);
+
+   SynchronizedRelease synchronizedRelease(remoteReleaseControlList);
+
+   SynchronizedRelease::Result result = synchronizedRelease.Release();
+
+   _tprintf(_T("\nRelease command sent, relative to fire time, in ms:\n"));
+
+   for (size_t cameraIndex = 0; cameraIndex < result.m_cameraResultList.size(); cameraIndex++)
+   {
+      const SynchronizedRelease::CameraResult& cameraResult = result.m_cameraResultList[cameraIndex];
+
+      if (cameraResult.m_isTriggered)
+         _tprintf(_T("Camera %Iu: %+9.3f\n"), cameraIndex + 1, cameraResult.m_triggerOffsetInMilliseconds);
+      else
+         _tprintf(_T("Camera %Iu: not released\n"), cameraIndex + 1);
+   }
+
+   _tprintf(_T("Skew: %.3f ms, mean: %.3f ms, std. dev.: %.3f ms\n\n"),
+      result.SkewInMilliseconds(),
+      result.m_meanOffsetInMilliseconds,
+      result.m_stdDevInMilliseconds);
+}
+
 void CmdlineApp::RunScript(const CString& cszFilename)
 {
    _tprintf(_T("Loading script: %s\n"), cszFilename.GetString());
 
+   // scripts are often started repeatedly, e.g. by a scheduler; cache compiled bytecode
+   Lua::State::SetBytecodeCacheFolder(
+      Path::SpecialFolder(CSIDL_LOCAL_APPDATA) + _T("\\RemotePhotoToolCmdline\\bytecode\\"));
+
    CameraScriptProcessor proc;
 
    proc.SetOutputDebugStringHandler(
@@ -607,6 +887,9 @@ void CmdlineApp::RunScript(const CString& cszFilename)
          _tprintf(_T("%s"), cszText.GetString());
    });
 
+   if (m_bProfileScripts)
+      proc.StartProfiler();
+
    proc.LoadScript(cszFilename);
 
    proc.Run();
@@ -616,4 +899,60 @@ void CmdlineApp::RunScript(const CString& cszFilename)
    (void)fgetc(stdin);
 
    proc.Stop();
+
+   if (m_bProfileScripts)
+   {
+      std::shared_ptr<LuaProfiler> spProfiler = proc.StopProfiler();
+      if (spProfiler != nullptr)
+      {
+         _tprintf(_T("\n%s\n"), spProfiler->GetReport().GetString());
+
+         CString cszProfileFilename = cszFilename + _T(".folded");
+         spProfiler->WriteCollapsedStacks(cszProfileFilename);
+
+         _tprintf(_T("Collapsed stacks written to: %s\n"), cszProfileFilename.GetString());
+      }
+   }
+}
+
+void CmdlineApp::RunLiveViewServer(const CString& port)
+{
+   _tprintf(_T("Starting live view server\n"));
+
+   EnsureReleaseControl();
+
+   if (!m_spReleaseControl->GetCapability(RemoteReleaseControl::capViewfinder))
+   {
+      _tprintf(_T("Device doesn't support live view.\n\n"));
+      return;
+   }
+
+   unsigned short portNumber = static_cast<unsigned short>(_tcstoul(port, nullptr, 10));
+
+   SingleThreadExecutor executor(_T("MjpegHttpServer"));
+   MjpegHttpServer server(executor, portNumber);
+
+   std::shared_ptr<Viewfinder> spViewfinder = m_spReleaseControl->StartViewfinder();
+
+   spViewfinder->SetAvailImageHandler(
+      std::bind(&MjpegHttpServer::PublishFrame, &server, std::placeholders::_1));
+
+   _tprintf(_T("Serving live view on http://localhost:%u/\n"), unsigned(server.Port()));
+   _tprintf(_T("Press any key to stop live view server...\n\n"));
+
+   // wait for key and run OnIdle() in the meantime
+   ManualResetEvent evtStop(false);
+   std::thread idleThread([&evtStop]()
+   {
+      (void)fgetc(stdin);
+      evtStop.Set();
+   });
+
+   while (!evtStop.Wait(10))
+      Instance::OnIdle();
+
+   idleThread.join();
+
+   spViewfinder->SetAvailImageHandler();
+   spViewfinder->Close();
 }
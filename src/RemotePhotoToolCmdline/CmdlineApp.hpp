@@ -37,6 +37,7 @@ private:
    void OpenByName(const CString& cszName);     ///< opens device by name
    void OutputDeviceInfo();                     ///< outputs device infos
    void ShowFileSystem(const CString& path);    ///< shows file system infos
+   void IngestFiles(const CString& targetFolder); ///< copies files from file system to target folder
    void ListDeviceProperties();                 ///< outputs device properties
    void CheckUnknownDeviceProperties();         ///< checks for unknown device properties
    void PrintValidDevicePropertyValues(const DeviceProperty& dp) const; ///< prints valid device property values
@@ -47,12 +48,19 @@ private:
    void ListenToEvents();                       ///< listens to events
    void EnsureReleaseControl();                 ///< ensures that remote release control is set
    void ReleaseShutter();                       ///< releases shutter
+   void BenchmarkRelease(const CString& numShots); ///< releases shutter multiple times and reports latencies
+   void PrintReleaseLatencyStatistics();        ///< prints release latency statistics
+   void SyncReleaseAllCameras();                ///< releases shutters of all cameras at the same time
    void RunScript(const CString& cszFilename);  ///< runs Lua script
+   void RunLiveViewServer(const CString& port); ///< runs live view HTTP server
 
 private:
    /// app command list
    std::vector<AppCommand> m_vecCommandList;
 
+   /// indicates if Lua scripts are run with the sampling profiler
+   bool m_bProfileScripts;
+
    /// current source device
    std::shared_ptr<SourceDevice> m_spSourceDevice;
 
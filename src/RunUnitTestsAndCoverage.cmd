@@ -29,14 +29,15 @@ REM Run unit tests
 REM
 OpenCppCoverage.exe ^
    --continue_after_cpp_exception --cover_children ^
+   --sources Base --sources CameraControl --sources CameraControl\CameraControl.UnitTest ^
    --sources Logic --sources Logic\Logic.UnitTest ^
    --sources Location --sources Location\Location.UnitTest --sources Location\GPS --sources Location\NMEA0183 ^
    --sources LuaScripting --sources LuaScripting\LuaScripting.UnitTest ^
    --excluded_sources packages\boost --excluded_sources LuaScripting\lua-5.3.5 ^
    --export_type cobertura:RemotePhotoTool-coverage.xml ^
    --export_type html:CoverageReport ^
-   --modules Logic.UnitTest.dll --modules Location.UnitTest.dll --modules LuaScripting.UnitTest.dll ^
+   --modules CameraControl.UnitTest.dll --modules Logic.UnitTest.dll --modules Location.UnitTest.dll --modules LuaScripting.UnitTest.dll ^
    -- "%VSINSTALL%\Common7\IDE\CommonExtensions\Microsoft\TestWindow\vstest.console.exe" ^
-   "..\bin\Debug\Logic.UnitTest.dll" "..\bin\Debug\Location.UnitTest.dll" "..\bin\Debug\LuaScripting.UnitTest.dll" /Platform:x86 /InIsolation /logger:trx
+   "..\bin\Debug\CameraControl.UnitTest.dll" "..\bin\Debug\Logic.UnitTest.dll" "..\bin\Debug\Location.UnitTest.dll" "..\bin\Debug\LuaScripting.UnitTest.dll" /Platform:x86 /InIsolation /logger:trx
 
 pause